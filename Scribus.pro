@@ -56,6 +56,7 @@ HEADERS += scribus/actionmanager.h \
            scribus/canvasmode_objimport.h \
            scribus/canvasmode_panning.h \
            scribus/canvasmode_rotate.h \
+           scribus/canvastilecache.h \
            scribus/cellarea.h \
            scribus/chartablemodel.h \
            scribus/chartableview.h \
@@ -93,6 +94,7 @@ HEADERS += scribus/actionmanager.h \
            scribus/hyphenator.h \
            scribus/iconmanager.h \
            scribus/ioapi.h \
+           scribus/itemspatialindex.h \
            scribus/KarbonCurveFit.h \
            scribus/langdef.h \
            scribus/langmgr.h \
@@ -133,8 +135,10 @@ HEADERS += scribus/actionmanager.h \
            scribus/pagesize.h \
            scribus/pagestructs.h \
            scribus/pdf_analyzer.h \
+           scribus/pdfcontentsink.h \
            scribus/pdflib.h \
            scribus/pdflib_core.h \
+           scribus/pdflinearizer.h \
            scribus/pdfoptions.h \
            scribus/pdfoptionsio.h \
            scribus/pdfstructs.h \
@@ -167,6 +171,7 @@ HEADERS += scribus/actionmanager.h \
            scribus/sccolorstructs.h \
            scribus/scconfig.h \
            scribus/scdebug.h \
+           scribus/scdisplaycolorcache.h \
            scribus/scdocoutput.h \
            scribus/scdocoutput_ps2.h \
            scribus/scdomelement.h \
@@ -180,6 +185,9 @@ HEADERS += scribus/actionmanager.h \
            scribus/scimagecachemanager.h \
            scribus/scimagecacheproxy.h \
            scribus/scimagecachewriteaction.h \
+           scribus/scimageloader.h \
+           scribus/scimagepool.h \
+           scribus/scimageprefetcher.h \
            scribus/scimagestructs.h \
            scribus/sclayer.h \
            scribus/sclimits.h \
@@ -262,6 +270,7 @@ HEADERS += scribus/actionmanager.h \
            scribus/util_layer.h \
            scribus/util_math.h \
            scribus/util_os.h \
+           scribus/util_parallel.h \
            scribus/util_printer.h \
            scribus/util_text.h \
            scribus/vgradient.h \
@@ -326,6 +335,7 @@ HEADERS += scribus/actionmanager.h \
            scribus/fonts/scface_ps.h \
            scribus/fonts/scface_ttf.h \
            scribus/fonts/scfontmetrics.h \
+           scribus/fonts/scfontsubsetcache.h \
            scribus/fonts/sfnt.h \
            scribus/fonts/sfnt_format.h \
            scribus/imagedataloaders/scimgdataloader.h \
@@ -1240,6 +1250,7 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/canvasmode_objimport.cpp \
            scribus/canvasmode_panning.cpp \
            scribus/canvasmode_rotate.cpp \
+           scribus/canvastilecache.cpp \
            scribus/cellarea.cpp \
            scribus/chartablemodel.cpp \
            scribus/chartableview.cpp \
@@ -1277,6 +1288,7 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/hyphenator.cpp \
            scribus/iconmanager.cpp \
            scribus/ioapi.c \
+           scribus/itemspatialindex.cpp \
            scribus/KarbonCurveFit.cpp \
            scribus/langdef.cpp \
            scribus/langmgr.cpp \
@@ -1318,8 +1330,10 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/pageitempreview.cpp \
            scribus/pagesize.cpp \
            scribus/pdf_analyzer.cpp \
+           scribus/pdfcontentsink.cpp \
            scribus/pdflib.cpp \
            scribus/pdflib_core.cpp \
+           scribus/pdflinearizer.cpp \
            scribus/pdfoptions.cpp \
            scribus/pdfoptionsio.cpp \
            scribus/pdfversion.cpp \
@@ -1346,6 +1360,7 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/sccolorengine.cpp \
            scribus/sccolorshade.cpp \
            scribus/sccolorstructs.cpp \
+           scribus/scdisplaycolorcache.cpp \
            scribus/scdocoutput.cpp \
            scribus/scdocoutput_ps2.cpp \
            scribus/scdomelement.cpp \
@@ -1358,6 +1373,9 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/scimagecachemanager.cpp \
            scribus/scimagecacheproxy.cpp \
            scribus/scimagecachewriteaction.cpp \
+           scribus/scimageloader.cpp \
+           scribus/scimagepool.cpp \
+           scribus/scimageprefetcher.cpp \
            scribus/scimagestructs.cpp \
            scribus/sclayer.cpp \
            scribus/sclockedfile.cpp \
@@ -1427,6 +1445,7 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/util_layer.cpp \
            scribus/util_math.cpp \
            scribus/util_os.cpp \
+           scribus/util_parallel.cpp \
            scribus/util_printer.cpp \
            scribus/util_text.cpp \
            scribus/vgradient.cpp \
@@ -1475,6 +1494,7 @@ SOURCES += scribus/actionmanager.cpp \
            scribus/fonts/scface_ps.cpp \
            scribus/fonts/scface_ttf.cpp \
            scribus/fonts/scfontmetrics.cpp \
+           scribus/fonts/scfontsubsetcache.cpp \
            scribus/fonts/sfnt.cpp \
            scribus/imagedataloaders/scimgdataloader.cpp \
            scribus/imagedataloaders/scimgdataloader_gimp.cpp \
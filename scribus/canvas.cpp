@@ -16,9 +16,13 @@
 #if defined(_MSC_VER) && !defined(_USE_MATH_DEFINES)
 #define _USE_MATH_DEFINES
 #endif
+#include <algorithm>
 #include <cmath>
+#include <utility>
 
 // #include <QDebug>
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QToolTip>
 #include <QWidget>
 
@@ -41,6 +45,9 @@
 
 #define DRAW_DEBUG_LINES 0
 
+// milliseconds spent on rendering missing tiles before the event loop gets control again
+static const int tileRenderBudget = 40;
+
 static QPoint contentsToViewport(QPoint p)
 {
 	return p;
@@ -466,8 +473,27 @@ PageItem* Canvas::itemUnderCursor(QPointF globalPos, PageItem* itemAbove, bool a
 
 	QList<PageItem*> *itemList = (itemAbove && itemAbove->isGroupChild()) ? &itemAbove->parentGroup()->groupItemList : m_doc->Items;
 	int currNr = itemAbove ? itemList->indexOf(itemAbove) - 1 : itemList->count() - 1;
+	// only items whose bounds are near the cursor need the exact test
+	const bool useIndex = (itemList == m_doc->Items);
+	QList<int> candidates;
+	if (useIndex)
+	{
+		// each item is in one layer index only, so the positions do not repeat
+		for (const ScLayer& layer : std::as_const(m_doc->Layers))
+			candidates += m_doc->visualIndex(*itemList, layer.ID).itemsIntersecting(mouseArea);
+		std::sort(candidates.begin(), candidates.end());
+	}
+	int candidateNr = candidates.count() - 1;
 	while (currNr >= 0)
 	{
+		if (useIndex)
+		{
+			while (candidateNr >= 0 && candidates.at(candidateNr) > currNr)
+				--candidateNr;
+			if (candidateNr < 0)
+				break;
+			currNr = candidates.at(candidateNr);
+		}
 		currItem = itemList->at(currNr);
 		if ((m_doc->masterPageMode())  && (!((currItem->OwnPage == -1) || (currItem->OwnPage == m_doc->currentPage()->pageNr()))))
 		{
@@ -632,11 +658,18 @@ void Canvas::setRenderMode(RenderMode mode)
 
 
 void Canvas::clearBuffers()
+{
+	discardBuffers();
+	m_tiles.clear();
+}
+
+void Canvas::discardBuffers()
 {
 	m_buffer = QPixmap();
 	m_bufferRect = QRect();
 	m_selectionBuffer = QPixmap();
 	m_selectionRect = QRect();
+	m_pendingRegion = QRegion();
 }
 
 void Canvas::setScale(double scale)
@@ -644,12 +677,13 @@ void Canvas::setScale(double scale)
 	if (m_viewMode.scale == scale)
 		return;
 	m_viewMode.scale = scale;
-	clearBuffers();
+	// the tiles of each zoom level are kept
+	discardBuffers();
 	update();
 }
 
 
-bool Canvas::adjustBuffer()
+bool Canvas::adjustBuffer(bool progressive)
 {
 	bool ret = false;
 	QRect viewport(-x(), -y(), m_view->viewport()->width(), m_view->viewport()->height());
@@ -659,6 +693,8 @@ bool Canvas::adjustBuffer()
 	{
 		m_bufferRect.translate(minCanvasCoordinate.x() - m_oldMinCanvasCoordinate.x(),
 							   minCanvasCoordinate.y() - m_oldMinCanvasCoordinate.y());
+		m_pendingRegion.translate(minCanvasCoordinate.x() - m_oldMinCanvasCoordinate.x(),
+								  minCanvasCoordinate.y() - m_oldMinCanvasCoordinate.y());
 		m_oldMinCanvasCoordinate = minCanvasCoordinate;
 	}
 #if DRAW_DEBUG_LINES
@@ -669,7 +705,8 @@ bool Canvas::adjustBuffer()
 //		qDebug() << "adjust buffer: invalid buffer, viewport" << viewport;
 		m_bufferRect = viewport;
 		m_buffer = createPixmap(m_bufferRect.width(), m_bufferRect.height());
-		fillBuffer(&m_buffer, m_bufferRect.topLeft(), m_bufferRect);
+		m_pendingRegion = QRegion();
+		fillBufferFromTiles(&m_buffer, m_bufferRect.topLeft(), m_bufferRect, progressive);
 		ret = true;
 #if DRAW_DEBUG_LINES
 		QPainter p(&m_buffer);
@@ -697,7 +734,8 @@ bool Canvas::adjustBuffer()
 //			qDebug() << "adjust buffer: fresh buffer" << m_bufferRect << "-->" << newRect;
 			m_bufferRect = newRect;
 			m_buffer = createPixmap(m_bufferRect.width(), m_bufferRect.height());
-			fillBuffer(&m_buffer, m_bufferRect.topLeft(), m_bufferRect);
+			m_pendingRegion = QRegion();
+			fillBufferFromTiles(&m_buffer, m_bufferRect.topLeft(), m_bufferRect, progressive);
 			ret = true;
 #if DRAW_DEBUG_LINES
 			QPainter p(&m_buffer);
@@ -755,22 +793,22 @@ bool Canvas::adjustBuffer()
 			// canvas has just been resized, after an object has been put in scrap area for eg.
 			if (newRect.top() < m_bufferRect.top())
 			{
-				fillBuffer(&newBuffer, newRect.topLeft(), QRect(newRect.left(), newRect.top(), newRect.width(), m_bufferRect.top() - newRect.top() + 2));
+				fillBufferFromTiles(&newBuffer, newRect.topLeft(), QRect(newRect.left(), newRect.top(), newRect.width(), m_bufferRect.top() - newRect.top() + 2), progressive);
 				//ret = true;
 			}
 			if (newRect.bottom() > m_bufferRect.bottom())
 			{
-				fillBuffer(&newBuffer, newRect.topLeft(), QRect(newRect.left(), m_bufferRect.bottom() - 1, newRect.width(), newRect.bottom() - m_bufferRect.bottom() + 2));
+				fillBufferFromTiles(&newBuffer, newRect.topLeft(), QRect(newRect.left(), m_bufferRect.bottom() - 1, newRect.width(), newRect.bottom() - m_bufferRect.bottom() + 2), progressive);
 				//ret = true;
 			}
 			if (newRect.left() < m_bufferRect.left())
 			{
-				fillBuffer(&newBuffer, newRect.topLeft(), QRect(newRect.left(), m_bufferRect.top(), m_bufferRect.left() - newRect.left() + 2, m_bufferRect.height()));
+				fillBufferFromTiles(&newBuffer, newRect.topLeft(), QRect(newRect.left(), m_bufferRect.top(), m_bufferRect.left() - newRect.left() + 2, m_bufferRect.height()), progressive);
 				//ret = true;
 			}
 			if (newRect.right() > m_bufferRect.right())
 			{
-				fillBuffer(&newBuffer, newRect.topLeft(), QRect(m_bufferRect.right() - 1, m_bufferRect.top(), newRect.right() - m_bufferRect.right() + 2, m_bufferRect.height()));
+				fillBufferFromTiles(&newBuffer, newRect.topLeft(), QRect(m_bufferRect.right() - 1, m_bufferRect.top(), newRect.right() - m_bufferRect.right() + 2, m_bufferRect.height()), progressive);
 				//ret = true;
 			}
 			m_buffer = newBuffer;
@@ -798,6 +836,103 @@ void Canvas::fillBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRec
 	painter.end();
 }
 
+void Canvas::fillBufferFromTiles(QPixmap* buffer, QPoint bufferOrigin, QRect clipRect, bool progressive)
+{
+	// selected items are missing from the contents, such tiles are of no use later
+	if (m_viewMode.drawSelectedItemsWithControls)
+	{
+		fillBuffer(buffer, bufferOrigin, clipRect);
+		m_pendingRegion -= clipRect;
+		return;
+	}
+	syncTileSpace();
+	QElapsedTimer timer;
+	timer.start();
+	QPainter painter(buffer);
+	painter.translate(-bufferOrigin.x(), -bufferOrigin.y());
+	QRect range = CanvasTileCache::tileRange(clipRect);
+	for (int y = range.top(); y <= range.bottom(); ++y)
+	{
+		for (int x = range.left(); x <= range.right(); ++x)
+		{
+			QRect tileRect = CanvasTileCache::tileRect(x, y);
+			QRect area = tileRect & clipRect;
+			const QPixmap* tile = m_tiles.tile(x, y);
+			QPixmap rendered;
+			if (tile == nullptr)
+			{
+				if (progressive && timer.elapsed() > tileRenderBudget)
+				{
+					painter.fillRect(area, PrefsManager::instance().appPrefs.displayPrefs.scratchColor);
+					m_pendingRegion += area;
+					continue;
+				}
+				rendered = createPixmap(CanvasTileCache::tileSize, CanvasTileCache::tileSize);
+				fillBuffer(&rendered, tileRect.topLeft(), tileRect);
+				m_tiles.insert(x, y, rendered);
+				tile = &rendered;
+			}
+			drawPixmap(painter, area.x(), area.y(), *tile, area.x() - tileRect.x(), area.y() - tileRect.y(), area.width(), area.height());
+			m_pendingRegion -= area;
+		}
+	}
+	painter.end();
+}
+
+void Canvas::invalidateTiles(const QRectF& canvasRect)
+{
+	if (!canvasRect.isValid())
+		m_tiles.clear();
+	else
+		m_tiles.invalidate(canvasRect);
+}
+
+void Canvas::storeTiles(QRect clipRect)
+{
+	if (m_viewMode.drawSelectedItemsWithControls || m_buffer.isNull())
+		return;
+	syncTileSpace();
+	QRect range = CanvasTileCache::tileRange(clipRect);
+	for (int y = range.top(); y <= range.bottom(); ++y)
+	{
+		for (int x = range.left(); x <= range.right(); ++x)
+		{
+			QRect tileRect = CanvasTileCache::tileRect(x, y);
+			if (!m_bufferRect.contains(tileRect) || m_pendingRegion.intersects(tileRect))
+				continue;
+			QPixmap tile = createPixmap(CanvasTileCache::tileSize, CanvasTileCache::tileSize);
+			QPainter painter(&tile);
+			drawPixmap(painter, 0, 0, m_buffer, tileRect.x() - m_bufferRect.x(), tileRect.y() - m_bufferRect.y(), tileRect.width(), tileRect.height());
+			painter.end();
+			m_tiles.insert(x, y, tile);
+		}
+	}
+}
+
+void Canvas::syncTileSpace()
+{
+	m_tiles.setSpace(m_viewMode.scale, QPointF(m_doc->minCanvasCoordinate.x(), m_doc->minCanvasCoordinate.y()), devicePixelRatioF());
+}
+
+void Canvas::renderPendingTiles()
+{
+	m_tileRenderScheduled = false;
+	m_pendingRegion &= m_bufferRect;
+	if (m_pendingRegion.isEmpty() || m_buffer.isNull())
+		return;
+	if (m_doc->isLoading() || !m_doc->DoDrawing)
+		return;
+	const QRegion pending = m_pendingRegion;
+	for (const QRect& rect : pending)
+	{
+		fillBufferFromTiles(&m_buffer, m_bufferRect.topLeft(), rect, true);
+		if (m_pendingRegion.intersects(rect))
+			break;
+	}
+	// paintEvent() schedules the remaining tiles
+	update(pending.boundingRect());
+}
+
 /**
   Actually we have at least three super-layers:
   - background (page outlines, guides if below)
@@ -819,8 +954,14 @@ void Canvas::paintEvent ( QPaintEvent * p )
 	t1 = t2 = t3 = t4 = t5 = t6 = 0;
 	t.start();
 #endif
-	// fill buffer if necessary
-	bool bufferFilled = adjustBuffer();
+	// changed items drop their tiles through ScribusView::changed(), the text selection is not reported there
+	if (m_viewMode.operTextSelecting)
+	{
+		syncTileSpace();
+		m_tiles.remove(p->rect());
+	}
+	// fill buffer if necessary, tiles not rendered in time are left for later unless a redraw was forced
+	bool bufferFilled = adjustBuffer(!m_viewMode.forceRedraw);
 	QPainter qp(this);
 	switch (m_renderMode)
 	{
@@ -838,6 +979,8 @@ void Canvas::paintEvent ( QPaintEvent * p )
 			{
 //				qDebug() << "Canvas::paintEvent: forceRedraw=" << m_viewMode.forceRedraw << "bufferFilled=" << bufferFilled;
 				fillBuffer(&m_buffer, m_bufferRect.topLeft(), p->rect());
+				m_pendingRegion -= p->rect();
+				storeTiles(p->rect());
 			}
 #ifdef SHOW_ME_WHAT_YOU_GET_IN_D_CANVA
 			t2 = t.elapsed();
@@ -951,6 +1094,11 @@ void Canvas::paintEvent ( QPaintEvent * p )
 	m_viewMode.forceRedraw = false;
 	m_viewMode.operItemSelecting = false;
 	m_viewMode.operTextSelecting = false;
+	if (!m_pendingRegion.isEmpty() && !m_tileRenderScheduled)
+	{
+		m_tileRenderScheduled = true;
+		QTimer::singleShot(0, this, &Canvas::renderPendingTiles);
+	}
 }
 
 
@@ -1474,13 +1622,16 @@ void Canvas::DrawPageItems(ScPainter *painter, const ScLayer& layer, QRect clip,
 	if ((layerCount > 1) && ((layer.blendMode != 0) || (layer.transparency != 1.0)) && (!layer.outlineMode))
 		painter->beginLayer(layer.transparency, layer.blendMode);
 
+	// items in z-order whose bounds intersect the culling area
+	QList<int> candidates = m_doc->visualIndex(*m_doc->Items, layer.ID).itemsIntersecting(cullingArea);
+
 	//if notes are used
 	//then we must be sure that text frames are valid and all notes frames are created before we start drawing
 	if (!notesFramesPass && !m_doc->notesList().isEmpty())
 	{
-		for (auto it = m_doc->Items->begin(); it != m_doc->Items->end(); ++it)
+		for (int it : std::as_const(candidates))
 		{
-			PageItem* currItem = *it;
+			PageItem* currItem = m_doc->Items->at(it);
 			if ( !currItem->isTextFrame()
 				|| currItem->isNoteFrame()
 				|| !currItem->invalid
@@ -1493,9 +1644,13 @@ void Canvas::DrawPageItems(ScPainter *painter, const ScLayer& layer, QRect clip,
 			if (cullingArea.intersects(currItem->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0)))
 				currItem->layout();
 		}
+		// layouts may have added or removed notes frames
+		candidates = m_doc->visualIndex(*m_doc->Items, layer.ID).itemsIntersecting(cullingArea);
 	}
-	for (int it = 0; it < m_doc->Items->count(); ++it)
+	for (int it : std::as_const(candidates))
 	{
+		if (it >= m_doc->Items->count())
+			break;
 		currItem = m_doc->Items->at(it);
 		if (notesFramesPass && !currItem->isNoteFrame())
 			continue;
@@ -29,10 +29,12 @@ scribusview.h  -  description
 #include <QPolygon>
 #include <QRect>
 #include <QRectF>
+#include <QRegion>
 #include <QWidget>
 
 #include "scribusapi.h"
 
+#include "canvastilecache.h"
 #include "commonstrings.h"
 #include "fpoint.h"
 #include "fpointarray.h"
@@ -135,7 +137,12 @@ public:
 	
 	void setRenderMode(RenderMode m);
 	
-	void clearBuffers();              // very expensive
+	void clearBuffers();              // very expensive, drops the tiles too
+	/**
+		Drops the tiles of all kept zoom levels showing a part of canvasRect after
+		contents changed there. An invalid rect drops all tiles.
+	 */
+	void invalidateTiles(const QRectF& canvasRect);
 	
 	// deprecated:
 	void resetRenderMode() { m_renderMode = RENDER_NORMAL; clearBuffers(); }
@@ -240,12 +247,23 @@ private:
 	/**
 		Enlarges the buffer such that it contains the viewport.
 	 */
-	bool adjustBuffer();
+	bool adjustBuffer(bool progressive);
 	/**
 		Fills the given buffer with contents.
 	    bufferOrigin and clipRect are in local coordinates
 	 */
 	void fillBuffer(QPaintDevice* buffer, QPoint bufferOrigin, QRect clipRect);
+	/**
+		Fills the given buffer from the tile cache, rendering missing tiles.
+		If progressive is true, tiles missing after the time budget is used up
+		are left to renderPendingTiles().
+	 */
+	void fillBufferFromTiles(QPixmap* buffer, QPoint bufferOrigin, QRect clipRect, bool progressive);
+	/// Copies the tiles in clipRect from m_buffer after it was rendered.
+	void storeTiles(QRect clipRect);
+	void syncTileSpace();
+	/// Drops the composed buffers, the tiles stay valid.
+	void discardBuffers();
 	void drawContents(QPainter *p, int clipx, int clipy, int clipw, int cliph);
 	void drawBackgroundMasterpage(ScPainter* painter, int clipx, int clipy, int clipw, int cliph);
 	void drawBackgroundPageOutlines(ScPainter* painter, int clipx, int clipy, int clipw, int cliph);
@@ -264,6 +282,9 @@ private:
 	QPixmap createPixmap(double w, double h);
 	// draw a potentially hidpi pixmap
 	void drawPixmap(QPainter &painter, double x, double y, const QPixmap &pixmap, double sx, double sy, double sw, double sh);
+
+private slots:
+	void renderPendingTiles();
 		
 private:
 	ScribusDoc* m_doc;
@@ -276,6 +297,10 @@ private:
 	QPixmap m_selectionBuffer;
 	QRect   m_selectionRect;
 	QPoint  m_oldMinCanvasCoordinate;
+	CanvasTileCache m_tiles;
+	/// parts of m_buffer still waiting for their tiles
+	QRegion m_pendingRegion;
+	bool    m_tileRenderScheduled { false };
 };
 
 
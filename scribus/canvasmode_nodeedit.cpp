@@ -449,6 +449,7 @@ void CanvasMode_NodeEdit::mouseReleaseEvent(QMouseEvent *m)
 			QPointF delta = m.map(QPointF(xposOrig, yposOrig)) - m.map(QPointF(currItem->xPos(), currItem->yPos()));
 			currItem->ContourLine.translate(delta.x(), delta.y());
 		}
+		m_doc->itemBoundsChanged(currItem);
 		m_doc->regionsChanged()->update(QRectF());
 		if (state)
 			m_doc->nodeEdit.finishTransaction2(currItem, state);
@@ -913,6 +914,7 @@ void CanvasMode_NodeEdit::handleNodeEditPress(QMouseEvent* m, QRect r)
 	}
 	if (edited)
 	{
+		m_doc->itemBoundsChanged(currItem);
 		currItem->FrameType = 3;
 		double xp = currItem->xPos();
 		double yp = currItem->yPos();
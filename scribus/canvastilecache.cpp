@@ -0,0 +1,118 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <cmath>
+
+#include "canvastilecache.h"
+
+CanvasTileCache::CanvasTileCache(int maxKBytes) :
+	m_tiles(maxKBytes)
+{
+}
+
+void CanvasTileCache::setSpace(double scale, const QPointF& minCanvasCoordinate, qreal devicePixelRatio)
+{
+	m_space.scale = scale;
+	m_space.minX = minCanvasCoordinate.x();
+	m_space.minY = minCanvasCoordinate.y();
+	m_space.devicePixelRatio = devicePixelRatio;
+
+	for (int i = 0; i < m_spaces.count(); ++i)
+	{
+		if (m_spaces.at(i).sameSpace(m_space))
+		{
+			m_spaces.move(i, 0);
+			return;
+		}
+	}
+	m_spaces.prepend(m_space);
+	if (m_spaces.count() <= maxSpaces)
+		return;
+	TileKey dropped = m_spaces.takeLast();
+	const QList<TileKey> keys = m_tiles.keys();
+	for (const TileKey& tileKey : keys)
+	{
+		if (tileKey.sameSpace(dropped))
+			m_tiles.remove(tileKey);
+	}
+}
+
+const QPixmap* CanvasTileCache::tile(int x, int y) const
+{
+	return m_tiles.object(key(x, y));
+}
+
+void CanvasTileCache::insert(int x, int y, const QPixmap& pixmap)
+{
+	// the cost is the size of the pixel data in KB
+	int cost = qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8192);
+	m_tiles.insert(key(x, y), new QPixmap(pixmap), cost);
+}
+
+void CanvasTileCache::remove(const QRect& rect)
+{
+	if (rect.isEmpty() || m_tiles.isEmpty())
+		return;
+	removeRange(m_space, tileRange(rect));
+}
+
+void CanvasTileCache::invalidate(const QRectF& canvasRect)
+{
+	if (m_tiles.isEmpty())
+		return;
+	QRectF rect = canvasRect.normalized();
+	for (const TileKey& space : std::as_const(m_spaces))
+	{
+		QRectF local((rect.x() - space.minX) * space.scale, (rect.y() - space.minY) * space.scale,
+					 rect.width() * space.scale, rect.height() * space.scale);
+		// antialiased edges reach into the neighbouring pixels
+		removeRange(space, tileRange(local.toAlignedRect().adjusted(-2, -2, 2, 2)));
+	}
+}
+
+void CanvasTileCache::clear()
+{
+	m_tiles.clear();
+}
+
+QRect CanvasTileCache::tileRange(const QRect& rect)
+{
+	int left = static_cast<int>(std::floor(rect.left() / static_cast<double>(tileSize)));
+	int top = static_cast<int>(std::floor(rect.top() / static_cast<double>(tileSize)));
+	int right = static_cast<int>(std::floor(rect.right() / static_cast<double>(tileSize)));
+	int bottom = static_cast<int>(std::floor(rect.bottom() / static_cast<double>(tileSize)));
+	return QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+CanvasTileCache::TileKey CanvasTileCache::key(int x, int y) const
+{
+	TileKey result(m_space);
+	result.x = x;
+	result.y = y;
+	return result;
+}
+
+void CanvasTileCache::removeRange(const TileKey& space, const QRect& range)
+{
+	// large items at high zoom levels cover far more tiles than are cached
+	if (static_cast<qint64>(range.width()) * range.height() > m_tiles.count())
+	{
+		const QList<TileKey> keys = m_tiles.keys();
+		for (const TileKey& tileKey : keys)
+		{
+			if (tileKey.sameSpace(space) && range.contains(tileKey.x, tileKey.y))
+				m_tiles.remove(tileKey);
+		}
+		return;
+	}
+	TileKey tileKey(space);
+	for (tileKey.y = range.top(); tileKey.y <= range.bottom(); ++tileKey.y)
+	{
+		for (tileKey.x = range.left(); tileKey.x <= range.right(); ++tileKey.x)
+			m_tiles.remove(tileKey);
+	}
+}
@@ -0,0 +1,94 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef CANVASTILECACHE_H
+#define CANVASTILECACHE_H
+
+#include <QCache>
+#include <QPixmap>
+#include <QPointF>
+#include <QRect>
+
+#include "scribusapi.h"
+
+/**
+ * The CanvasTileCache class keeps rendered parts of the canvas for reuse while panning and zooming.
+ *
+ * Tiles are square parts of the canvas in local coordinates. Local coordinates depend on the
+ * zoom level, on the minimum canvas coordinate and on the device pixel ratio, together these
+ * make up the current space. The tiles of the last few spaces are kept, so that going back to
+ * a previous zoom level finds its tiles again. The least recently used tiles are dropped when
+ * the cache grows beyond its size.
+ */
+class SCRIBUS_API CanvasTileCache
+{
+public:
+	/// Width and height of a tile in local coordinates
+	static const int tileSize = 256;
+	/// Number of spaces whose tiles are kept
+	static const int maxSpaces = 4;
+
+	/// Constructs an empty cache holding at most @a maxKBytes of pixel data.
+	explicit CanvasTileCache(int maxKBytes = 65536);
+
+	/**
+	 * Selects the space used by tile(), insert() and remove(). The tiles of the spaces
+	 * not among the last maxSpaces selected ones are dropped.
+	 */
+	void setSpace(double scale, const QPointF& minCanvasCoordinate, qreal devicePixelRatio);
+
+	/// Returns the tile at column @a x and row @a y of the current space or nullptr.
+	const QPixmap* tile(int x, int y) const;
+	void insert(int x, int y, const QPixmap& pixmap);
+	/// Removes the tiles of the current space intersecting @a rect.
+	void remove(const QRect& rect);
+	/// Removes the tiles of all spaces showing a part of @a canvasRect, given in canvas coordinates.
+	void invalidate(const QRectF& canvasRect);
+	void clear();
+
+	/// Returns the number of cached tiles of all spaces.
+	int count() const { return m_tiles.count(); }
+
+	/// Returns the area covered by the tile at column @a x and row @a y in local coordinates.
+	static QRect tileRect(int x, int y) { return QRect(x * tileSize, y * tileSize, tileSize, tileSize); }
+	/// Returns the columns and rows of the tiles intersecting @a rect.
+	static QRect tileRange(const QRect& rect);
+
+private:
+	struct TileKey
+	{
+		double scale { 1.0 };
+		double minX { 0.0 };
+		double minY { 0.0 };
+		qreal devicePixelRatio { 1.0 };
+		int x { 0 };
+		int y { 0 };
+
+		bool operator==(const TileKey& other) const
+		{
+			return x == other.x && y == other.y && scale == other.scale
+				&& minX == other.minX && minY == other.minY
+				&& devicePixelRatio == other.devicePixelRatio;
+		}
+		bool sameSpace(const TileKey& other) const
+		{
+			return scale == other.scale && minX == other.minX && minY == other.minY
+				&& devicePixelRatio == other.devicePixelRatio;
+		}
+	};
+	friend size_t qHash(const TileKey& key, size_t seed) { return qHashMulti(seed, key.x, key.y, key.scale, key.minX, key.minY); }
+
+	QCache<TileKey, QPixmap> m_tiles;
+	TileKey m_space;
+	/// the spaces whose tiles are kept, the current one first
+	QList<TileKey> m_spaces;
+
+	TileKey key(int x, int y) const;
+	/// removes the tiles of @a space in the columns and rows of @a range
+	void removeRange(const TileKey& space, const QRect& range);
+};
+
+#endif
@@ -19,6 +19,14 @@ bool operator==(const ScColorTransformInfo& v1, const ScColorTransformInfo& v2)
 			(v1.flags  == v2.flags));
 }
 
+size_t qHash(const ScColorTransformInfo& info, size_t seed)
+{
+	return qHashMulti(seed, info.inputProfile, info.outputProfile, info.proofingProfile,
+	                  static_cast<int>(info.inputFormat), static_cast<int>(info.outputFormat),
+	                  static_cast<int>(info.renderIntent), static_cast<int>(info.proofingIntent),
+	                  static_cast<qint64>(info.flags));
+}
+
 eColorType colorFormatType(eColorFormat format)
 {
 	eColorType type = Color_Unknown;
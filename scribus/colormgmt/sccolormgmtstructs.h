@@ -8,6 +8,7 @@ for which a new license (GPL+exception) is in place.
 #ifndef SCCOLORMGMTSTRUCTS_H
 #define SCCOLORMGMTSTRUCTS_H
 
+#include <QHashFunctions>
 #include <QString>
 
 // If you change that enum do not forget to update functions
@@ -136,6 +137,7 @@ struct ScColorTransformInfo
 };
 
 bool operator==(const ScColorTransformInfo& v1, const ScColorTransformInfo& v2);
+size_t qHash(const ScColorTransformInfo& info, size_t seed = 0);
 
 struct ScXYZ
 {
@@ -5,6 +5,7 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <QMutexLocker>
 #include <QSharedPointer>
 #include "sccolormgmtengine.h"
 #include "sccolormgmtstructs.h"
@@ -17,7 +18,9 @@ ScColorTransformPool::ScColorTransformPool(int engineID) : m_engineID(engineID)
 
 void ScColorTransformPool::clear()
 {
+	QMutexLocker locker(&m_mutex);
 	m_pool.clear();
+	m_purgeSize = 64;
 }
 
 void ScColorTransformPool::addTransform(const ScColorTransform& transform, bool force)
@@ -26,50 +29,62 @@ void ScColorTransformPool::addTransform(const ScColorTransform& transform, bool
 	//  and we MUST NOT add it to the transform pool
 	if (m_engineID != transform.engine().engineID())
 		return;
+	QMutexLocker locker(&m_mutex);
 	ScColorTransform trans;
 	if (!force)
-		trans = findTransform(transform.transformInfo());
-	if (trans.isNull())
-		m_pool.append(transform.weakRef());
+		trans = findTransformLocked(transform.transformInfo());
+	if (!trans.isNull())
+		return;
+	m_pool.insert(transform.transformInfo(), transform.weakRef());
+	if (m_pool.count() >= m_purgeSize)
+		purgeLocked();
 }
 
 void ScColorTransformPool::removeTransform(const ScColorTransform& transform)
 {
 	if (m_engineID != transform.engine().engineID())
 		return;
-	m_pool.removeOne(transform.strongRef());
+	QMutexLocker locker(&m_mutex);
+	auto it = m_pool.find(transform.transformInfo());
+	if ((it != m_pool.end()) && (it.value() == transform.strongRef()))
+		m_pool.erase(it);
 }
 
 void ScColorTransformPool::removeTransform(const ScColorTransformInfo& info)
 {
-	QList< QWeakPointer<ScColorTransformData> >::Iterator it = m_pool.begin();
-	while (it != m_pool.end())
-	{
-		QSharedPointer<ScColorTransformData> ref = it->toStrongRef();
-		if ((info == ref->transformInfo()) || ref.isNull())
-		{
-			it = m_pool.erase(it);
-			continue;
-		}
-		++it;
-	}
+	QMutexLocker locker(&m_mutex);
+	m_pool.remove(info);
+	purgeLocked();
 }
 
 ScColorTransform ScColorTransformPool::findTransform(const ScColorTransformInfo& info) const
+{
+	QMutexLocker locker(&m_mutex);
+	return findTransformLocked(info);
+}
+
+ScColorTransform ScColorTransformPool::findTransformLocked(const ScColorTransformInfo& info) const
 {
 	ScColorTransform transform(nullptr);
-	QList< QWeakPointer<ScColorTransformData> >::ConstIterator it = m_pool.begin();
-	for ( ; it != m_pool.end(); ++it)
+	auto it = m_pool.constFind(info);
+	if (it == m_pool.constEnd())
+		return transform;
+	QSharedPointer<ScColorTransformData> ref = it->toStrongRef();
+	if (!ref.isNull())
+		transform = ScColorTransform(ref);
+	return transform;
+}
+
+void ScColorTransformPool::purgeLocked()
+{
+	auto it = m_pool.begin();
+	while (it != m_pool.end())
 	{
-		QSharedPointer<ScColorTransformData> ref = it->toStrongRef();
-		if (!ref.isNull())
-		{
-			if (info == ref->transformInfo())
-			{
-				transform = ScColorTransform(ref);
-				break;
-			}
-		}
+		if (it->isNull())
+			it = m_pool.erase(it);
+		else
+			++it;
 	}
-	return transform;
+	// transforms in use stay, so purge again once the pool has doubled
+	m_purgeSize = qMax(64, 2 * static_cast<int>(m_pool.count()));
 }
@@ -8,7 +8,8 @@ for which a new license (GPL+exception) is in place.
 #ifndef SCCOLORTRANSFORMPOOL_H
 #define SCCOLORTRANSFORMPOOL_H
 
-#include <QList>
+#include <QHash>
+#include <QMutex>
 #include <QWeakPointer>
 #include "sccolormgmtstructs.h"
 #include "sccolortransform.h"
@@ -29,7 +30,14 @@ public:
 
 protected:
 	int m_engineID;
-	QList< QWeakPointer<ScColorTransformData> > m_pool;
+	// transforms by their info, entries of deleted transforms are dropped when the pool grows
+	QHash< ScColorTransformInfo, QWeakPointer<ScColorTransformData> > m_pool;
+	int m_purgeSize { 64 };
+	// ScImageLoader workers look up and add transforms while the GUI thread does
+	mutable QMutex m_mutex;
+
+	ScColorTransform findTransformLocked(const ScColorTransformInfo& info) const;
+	void purgeLocked();
 };
 
 #endif
@@ -49,6 +49,20 @@ static hb_blob_t* referenceTable(hb_face_t*, hb_tag_t tag, void *userData)
 	return hb_blob_create((const char *) buffer, length, HB_MEMORY_MODE_WRITABLE, buffer, free);
 }
 
+static hb_font_t* createOtFont(FT_Face face)
+{
+	FT_Reference_Face(face);
+	hb_face_t *hbFace = hb_face_create_for_tables(referenceTable, face, (hb_destroy_func_t) FT_Done_Face);
+	hb_face_set_index(hbFace, face->face_index);
+	hb_face_set_upem(hbFace, face->units_per_EM);
+
+	hb_font_t *hbFont = hb_font_create(hbFace);
+	hb_ot_font_set_funcs(hbFont);
+
+	hb_face_destroy(hbFace);
+	return hbFont;
+}
+
 void* ScFace::ScFaceData::hbFont()
 {
 	if (!m_hbFont)
@@ -68,15 +82,7 @@ void* ScFace::ScFaceData::hbFont()
 		{
 			// use HarfBuzz internal font functions for formats it supports,
 			// gives us more consistent glyph metrics.
-			FT_Reference_Face(face);
-			hb_face_t *hbFace = hb_face_create_for_tables(referenceTable, face, (hb_destroy_func_t) FT_Done_Face);
-			hb_face_set_index(hbFace, face->face_index);
-			hb_face_set_upem(hbFace, face->units_per_EM);
-
-			m_hbFont = hb_font_create(hbFace);
-			hb_ot_font_set_funcs(reinterpret_cast<hb_font_t*>(m_hbFont));
-
-			hb_face_destroy(hbFace);
+			m_hbFont = createOtFont(face);
 		}
 		
 		if (!m_hbFont)
@@ -88,6 +94,18 @@ void* ScFace::ScFaceData::hbFont()
 	return m_hbFont;
 }
 
+void* ScFace::createHbFont(FT_Face face) const
+{
+	if (!face)
+		return nullptr;
+	// #14699, see ScFaceData::hbFont()
+	if ((face->num_charmaps == 1) && (face->charmaps[0]->encoding == FT_ENCODING_APPLE_ROMAN))
+		return nullptr;
+	if (m_m->formatCode != ScFace::SFNT && m_m->formatCode != ScFace::TTCF && m_m->formatCode != ScFace::TYPE42)
+		return nullptr;
+	return createOtFont(face);
+}
+
 bool ScFace::ScFaceData::glyphNames(FaceEncoding& /*gList*/) const
 { 
 	return false; 
@@ -389,14 +407,19 @@ void ScFace::unload() const
 }
 
 
-ScFace::gid_type ScFace::emulateGlyph(uint ch) const
+bool ScFace::hasControlGlyph(uint ch)
 {
 	// Don't create a QChar from ch, that would cause a crash if ch >= 0xFFFF
-	if (ch == SpecialChars::LINEBREAK.unicode() || ch == SpecialChars::PARSEP.unicode()
+	return ch == SpecialChars::LINEBREAK.unicode() || ch == SpecialChars::PARSEP.unicode()
 		|| ch == SpecialChars::FRAMEBREAK.unicode() || ch == SpecialChars::COLBREAK.unicode()
 		|| ch == SpecialChars::TAB.unicode() || ch == SpecialChars::SHYPHEN.unicode()
 		|| ch == SpecialChars::ZWSPACE.unicode() || ch == SpecialChars::ZWNBSPACE.unicode()
-		|| ch == SpecialChars::OBJECT.unicode())
+		|| ch == SpecialChars::OBJECT.unicode();
+}
+
+ScFace::gid_type ScFace::emulateGlyph(uint ch) const
+{
+	if (hasControlGlyph(ch))
 		return CONTROL_GLYPHS + ch;
 	if (ch == SpecialChars::NBSPACE.unicode())
 		return  m_m->char2CMap(' ');
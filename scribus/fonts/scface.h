@@ -146,6 +146,8 @@ public:
 		bool isFixedPitch {false};
 		bool hasGlyphNames {false};
 		gid_type maxGlyph {0};
+		ushort embeddingFlags {0};
+		quint32 unicodeRanges[4] {0, 0, 0, 0};
 
 	protected:
 		friend class ScFace;
@@ -290,6 +292,10 @@ public:
 	/// a HarfBuzz font for this font
 	void* hbFont() const { return m_m->hbFont(); }
 
+	/// a new HarfBuzz font reading the tables of face, a face of this font opened by the caller.
+	/// Returns nullptr for fonts which HarfBuzz shapes with FreeType functions. The caller owns the result.
+	void* createHbFont(FT_Face face) const;
+
 	/// path name of the document this face is local to
 	QString localForDocument()  const { return m_m->forDocument; }
 
@@ -334,6 +340,12 @@ public:
 	/// returns the highest glyph index in this face
 	gid_type maxGlyph() const { return m_m->maxGlyph; }
 
+	/// the embedding permissions (fsType) of the OS/2 table, 0 if the face has none
+	ushort embeddingFlags() const { return m_m->embeddingFlags; }
+
+	/// tells if the OS/2 table claims the Unicode range with the given bit (0-127) as covered
+	bool coversUnicodeRange(int bit) const { return bit >= 0 && bit < 128 && (m_m->unicodeRanges[bit / 32] & (1u << (bit % 32))); }
+
 	/// returns the font family as seen by Scribus
 	QString family()   const { return m_m->family; }
 
@@ -399,6 +411,8 @@ public:
 	gid_type char2CMap(uint ch)   const;
 
 	gid_type emulateGlyph(uint ch) const;
+	/// true if emulateGlyph() maps ch to a control glyph, which needs no font data
+	static bool hasControlGlyph(uint ch);
 
 	gid_type hyphenGlyph() const;
 	gid_type hyphenGlyph(const CharStyle& style) const;
@@ -0,0 +1,234 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "scfontsubsetcache.h"
+#include "scface.h"
+#include "scpaths.h"
+
+namespace
+{
+	const quint32 entryMagic = 0x53434653; // "SCFS"
+	/// bump when the subsetters change their output
+	const quint32 entryVersion = 1;
+	const int defaultMaxEntries = 10000;
+	const QString entrySuffix = QStringLiteral("subset");
+
+	struct EntryInfo
+	{
+		QString path;
+		qint64 size;
+		QDateTime modified;
+	};
+}
+
+ScFontSubsetCache::ScFontSubsetCache(const QString& cacheDir) :
+	m_cacheDir(cacheDir),
+	m_maxEntries(defaultMaxEntries)
+{
+	if (!m_cacheDir.endsWith('/'))
+		m_cacheDir += '/';
+}
+
+ScFontSubsetCache& ScFontSubsetCache::instance()
+{
+	static ScFontSubsetCache instance(ScPaths::fontSubsetCacheDir());
+	return instance;
+}
+
+void ScFontSubsetCache::setMaxCacheSizeMiB(int maxCacheSizeMiB)
+{
+	QMutexLocker locker(&m_mutex);
+	m_maxTotalSize = qMax(0, maxCacheSizeMiB) * qint64(1024 * 1024);
+}
+
+void ScFontSubsetCache::setMaxCacheEntries(int maxCacheEntries)
+{
+	QMutexLocker locker(&m_mutex);
+	m_maxEntries = qMax(1, maxCacheEntries);
+}
+
+QByteArray ScFontSubsetCache::faceHash(ScFace& face)
+{
+	QFileInfo info(face.fontFilePath());
+	QString memoKey = info.absoluteFilePath() + '(' + QString::number(face.faceIndex()) + ')';
+	bool haveFile = !face.fontFilePath().isEmpty() && info.isFile();
+	if (haveFile)
+	{
+		QMutexLocker locker(&m_mutex);
+		auto it = m_faceHashes.constFind(memoKey);
+		if (it != m_faceHashes.constEnd() && it->fileSize == info.size() && it->modified == info.lastModified())
+			return it->hash;
+	}
+
+	QByteArray data;
+	face.rawData(data);
+	if (data.isEmpty())
+		return QByteArray();
+	QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+	if (haveFile)
+	{
+		QMutexLocker locker(&m_mutex);
+		FaceHash& faceHash = m_faceHashes[memoKey];
+		faceHash.fileSize = info.size();
+		faceHash.modified = info.lastModified();
+		faceHash.hash = hash;
+	}
+	return hash;
+}
+
+QByteArray ScFontSubsetCache::key(const QByteArray& fontHash, int faceIndex, const QList<uint>& glyphs, const QByteArray& method)
+{
+	if (fontHash.isEmpty())
+		return QByteArray();
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(fontHash);
+	hash.addData(QByteArray::number(faceIndex) + ':' + method + ':' + QByteArray::number(entryVersion) + ':');
+	QByteArray glyphData;
+	glyphData.reserve(glyphs.count() * 4);
+	for (uint glyph : glyphs)
+	{
+		glyphData.append(char(glyph >> 24));
+		glyphData.append(char(glyph >> 16));
+		glyphData.append(char(glyph >> 8));
+		glyphData.append(char(glyph));
+	}
+	hash.addData(glyphData);
+	return hash.result().toHex();
+}
+
+QString ScFontSubsetCache::entryPath(const QByteArray& key) const
+{
+	return m_cacheDir + QString::fromLatin1(key.left(2)) + '/' + QString::fromLatin1(key.mid(2)) + '.' + entrySuffix;
+}
+
+bool ScFontSubsetCache::find(const QByteArray& key, Subset& subset)
+{
+	QMutexLocker locker(&m_mutex);
+	if (!enabled() || key.isEmpty())
+		return false;
+	QFile file(entryPath(key));
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_6_0);
+	quint32 magic = 0;
+	quint32 version = 0;
+	stream >> magic >> version;
+	if (magic != entryMagic || version != entryVersion)
+		return false;
+	Subset result;
+	stream >> result.glyphs >> result.glyphMap >> result.data;
+	if (stream.status() != QDataStream::Ok || result.data.isEmpty())
+		return false;
+
+	// keeps entries in use from being removed first
+	file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+	subset = result;
+	return true;
+}
+
+void ScFontSubsetCache::insert(const QByteArray& key, const Subset& subset)
+{
+	QMutexLocker locker(&m_mutex);
+	if (!enabled() || key.isEmpty() || subset.data.isEmpty())
+		return;
+	if (!m_scanned)
+		scanCache();
+
+	QString path = entryPath(key);
+	QFileInfo oldInfo(path);
+	if (!QDir().mkpath(oldInfo.absolutePath()))
+		return;
+	QSaveFile file(path);
+	if (!file.open(QIODevice::WriteOnly))
+		return;
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_6_0);
+	stream << entryMagic << entryVersion << subset.glyphs << subset.glyphMap << subset.data;
+	qint64 size = file.size();
+	if (stream.status() != QDataStream::Ok || !file.commit())
+		return;
+
+	if (oldInfo.exists())
+		m_totalSize -= oldInfo.size();
+	else
+		++m_entryCount;
+	m_totalSize += size;
+	if (m_totalSize > m_maxTotalSize || m_entryCount > m_maxEntries)
+		cleanupCache();
+}
+
+int ScFontSubsetCache::entryCount()
+{
+	QMutexLocker locker(&m_mutex);
+	if (!m_scanned)
+		scanCache();
+	return m_entryCount;
+}
+
+qint64 ScFontSubsetCache::totalSize()
+{
+	QMutexLocker locker(&m_mutex);
+	if (!m_scanned)
+		scanCache();
+	return m_totalSize;
+}
+
+void ScFontSubsetCache::scanCache()
+{
+	m_entryCount = 0;
+	m_totalSize = 0;
+	QDirIterator it(m_cacheDir, QStringList() << ("*." + entrySuffix), QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext())
+	{
+		it.next();
+		++m_entryCount;
+		m_totalSize += it.fileInfo().size();
+	}
+	m_scanned = true;
+}
+
+void ScFontSubsetCache::cleanupCache()
+{
+	// other instances may have added or removed entries since the last scan
+	QList<EntryInfo> entries;
+	QDirIterator it(m_cacheDir, QStringList() << ("*." + entrySuffix), QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext())
+	{
+		it.next();
+		QFileInfo info = it.fileInfo();
+		entries.append({ info.filePath(), info.size(), info.lastModified() });
+	}
+	std::sort(entries.begin(), entries.end(), [](const EntryInfo& a, const EntryInfo& b) { return a.modified < b.modified; });
+
+	m_entryCount = entries.count();
+	m_totalSize = 0;
+	for (const EntryInfo& entry : std::as_const(entries))
+		m_totalSize += entry.size;
+	for (const EntryInfo& entry : std::as_const(entries))
+	{
+		if (m_totalSize <= m_maxTotalSize && m_entryCount <= m_maxEntries)
+			break;
+		if (!QFile::remove(entry.path) && QFile::exists(entry.path))
+			continue;
+		--m_entryCount;
+		m_totalSize -= entry.size;
+	}
+	m_scanned = true;
+}
@@ -0,0 +1,110 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCFONTSUBSETCACHE_H
+#define SCFONTSUBSETCACHE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+#include "scribusapi.h"
+
+class ScFace;
+
+/**
+ * @brief On-disk cache of the font subsets embedded by the PDF export
+ *
+ * Subsetting parses the whole font file each time a document is exported. The cache keeps
+ * the built subset together with the glyph list and glyph map the subsetter returned, keyed
+ * by a hash of the font data, the face index, the sorted glyph set and the subsetting method,
+ * so exporting documents with the same fonts and glyphs again skips both reading and parsing
+ * the font file.
+ *
+ * Each entry is a file named after the hash of its key, written atomically so that several
+ * Scribus instances can share the cache. Reads refresh the modification time of an entry and,
+ * as in ScImageCacheManager, the oldest entries are removed when the cache grows beyond its
+ * size or entry limit. A size limit of 0 disables the cache.
+ */
+class SCRIBUS_API ScFontSubsetCache
+{
+public:
+	struct Subset
+	{
+		QByteArray data;
+		/// glyph list after subsetting, subsetters append the components of composite glyphs
+		QList<uint> glyphs;
+		QMap<uint, uint> glyphMap;
+	};
+
+	explicit ScFontSubsetCache(const QString& cacheDir);
+
+	/**
+	 * @brief Get the cache shared by all PDF exports
+	 * @return Reference to the instance using ScPaths::fontSubsetCacheDir()
+	 */
+	static ScFontSubsetCache& instance();
+
+	void setMaxCacheSizeMiB(int maxCacheSizeMiB);
+	void setMaxCacheEntries(int maxCacheEntries);
+	bool enabled() const { return m_maxTotalSize > 0; }
+
+	/**
+	 * @brief Hash of the font data of a face
+	 *
+	 * Hashes are remembered for the font file of @a face while the file keeps its size and
+	 * modification time, so only the first export of a session needs to read the font.
+	 */
+	QByteArray faceHash(ScFace& face);
+	/**
+	 * @brief Build the key of a subset
+	 * @param fontHash hash of the font data as returned by faceHash()
+	 * @param faceIndex index of the face in a font collection
+	 * @param glyphs glyphs to subset, in the order passed to the subsetter
+	 * @param method subsetting method and options which change the subset data
+	 */
+	static QByteArray key(const QByteArray& fontHash, int faceIndex, const QList<uint>& glyphs, const QByteArray& method);
+
+	/**
+	 * @brief Look up a subset
+	 * @return \c true if @a subset was filled from the cache
+	 */
+	bool find(const QByteArray& key, Subset& subset);
+	/**
+	 * @brief Add a subset to the cache, removing the oldest entries if the limits are exceeded
+	 */
+	void insert(const QByteArray& key, const Subset& subset);
+
+	int entryCount();
+	qint64 totalSize();
+
+private:
+	struct FaceHash
+	{
+		qint64 fileSize { -1 };
+		QDateTime modified;
+		QByteArray hash;
+	};
+
+	QString entryPath(const QByteArray& key) const;
+	void scanCache();
+	void cleanupCache();
+
+	QMutex m_mutex;
+	QString m_cacheDir;
+	bool m_scanned { false };
+	int m_maxEntries { 0 };
+	qint64 m_maxTotalSize { 0 };
+	int m_entryCount { 0 };
+	qint64 m_totalSize { 0 };
+	QHash<QString, FaceHash> m_faceHashes;
+};
+
+#endif
@@ -0,0 +1,223 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "itemspatialindex.h"
+#include "pageitem.h"
+
+namespace
+{
+	/// items covering more cells than this are kept out of the grid
+	const int maxCellsPerItem = 64;
+}
+
+ItemSpatialIndex::ItemSpatialIndex(BoundsType boundsType, int layerID, double cellSize) :
+	m_boundsType(boundsType),
+	m_layerID(layerID),
+	m_cellSize(cellSize)
+{
+}
+
+void ItemSpatialIndex::update(const QList<PageItem*>& items)
+{
+	if (!sameItems(items))
+	{
+		rebuild(items);
+		return;
+	}
+
+	// items are sent to other layers by assigning m_layerID in many places
+	if (m_layerID >= 0)
+	{
+		for (int i = 0; i < m_items.count(); ++i)
+		{
+			if (m_items.at(i)->m_layerID != m_itemLayers.at(i))
+				m_changedItems.insert(m_items.at(i));
+		}
+	}
+
+	for (const PageItem* item : std::as_const(m_changedItems))
+	{
+		auto position = m_positions.constFind(item);
+		if (position == m_positions.constEnd())
+			continue;
+		int i = position.value();
+		m_itemLayers[i] = m_items.at(i)->m_layerID;
+		QRectF bounds = itemBounds(m_items.at(i));
+		if (bounds == m_bounds.at(i))
+			continue;
+		remove(i);
+		m_bounds[i] = bounds;
+		insert(i);
+	}
+	m_changedItems.clear();
+}
+
+void ItemSpatialIndex::clear()
+{
+	m_items.clear();
+	m_bounds.clear();
+	m_itemLayers.clear();
+	m_positions.clear();
+	m_cells.clear();
+	m_largeItems.clear();
+}
+
+QList<int> ItemSpatialIndex::itemsIntersecting(const QRectF& rect) const
+{
+	QList<int> result;
+	if (rect.isEmpty())
+		return result;
+
+	CellRange range = cellRange(rect);
+	for (int x = range.left; x <= range.right; ++x)
+	{
+		for (int y = range.top; y <= range.bottom; ++y)
+		{
+			auto cell = m_cells.constFind(cellKey(x, y));
+			if (cell == m_cells.constEnd())
+				continue;
+			const QVector<int>& indices = cell.value();
+			for (int i = 0; i < indices.count(); ++i)
+			{
+				if (m_bounds.at(indices.at(i)).intersects(rect))
+					result.append(indices.at(i));
+			}
+		}
+	}
+	for (int i = 0; i < m_largeItems.count(); ++i)
+	{
+		if (m_bounds.at(m_largeItems.at(i)).intersects(rect))
+			result.append(m_largeItems.at(i));
+	}
+
+	// items spanning several cells are found more than once
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+QRectF ItemSpatialIndex::itemBounds(const PageItem* item) const
+{
+	if ((m_layerID >= 0) && (item->m_layerID != m_layerID))
+		return QRectF();
+	switch (m_boundsType)
+	{
+		case TextFlowBounds:
+			if (!item->textFlowAroundObject())
+				return QRectF();
+			return QRectF(item->textInteractionRegion(0.0, 0.0).boundingRect());
+		case VisualBounds:
+			// the canvas culls with the bounding rect grown by one point, lines are hit beside their bounding rect
+			return item->getBoundingRect().adjusted(0.0, 0.0, 1.0, 1.0).united(item->getVisualBoundingRect());
+	}
+	return QRectF();
+}
+
+ItemSpatialIndex::CellRange ItemSpatialIndex::cellRange(const QRectF& rect) const
+{
+	// clamp to the int range, items far out on the pasteboard just share the outermost cells
+	const double limit = 1.0e9;
+	CellRange range;
+	range.left   = static_cast<int>(std::floor(qBound(-limit, rect.left() / m_cellSize, limit)));
+	range.top    = static_cast<int>(std::floor(qBound(-limit, rect.top() / m_cellSize, limit)));
+	range.right  = static_cast<int>(std::floor(qBound(-limit, rect.right() / m_cellSize, limit)));
+	range.bottom = static_cast<int>(std::floor(qBound(-limit, rect.bottom() / m_cellSize, limit)));
+	return range;
+}
+
+void ItemSpatialIndex::insert(int index)
+{
+	const QRectF& bounds = m_bounds.at(index);
+	if (bounds.isEmpty())
+		return;
+
+	CellRange range = cellRange(bounds);
+	if (range.count() > maxCellsPerItem)
+	{
+		m_largeItems.append(index);
+		return;
+	}
+	for (int x = range.left; x <= range.right; ++x)
+	{
+		for (int y = range.top; y <= range.bottom; ++y)
+			m_cells[cellKey(x, y)].append(index);
+	}
+}
+
+void ItemSpatialIndex::remove(int index)
+{
+	const QRectF& bounds = m_bounds.at(index);
+	if (bounds.isEmpty())
+		return;
+
+	CellRange range = cellRange(bounds);
+	if (range.count() > maxCellsPerItem)
+	{
+		m_largeItems.removeOne(index);
+		return;
+	}
+	for (int x = range.left; x <= range.right; ++x)
+	{
+		for (int y = range.top; y <= range.bottom; ++y)
+		{
+			auto cell = m_cells.find(cellKey(x, y));
+			if (cell == m_cells.end())
+				continue;
+			cell.value().removeOne(index);
+			if (cell.value().isEmpty())
+				m_cells.erase(cell);
+		}
+	}
+}
+
+bool ItemSpatialIndex::sameItems(const QList<PageItem*>& items) const
+{
+	if (items.count() != m_items.count())
+		return false;
+	return std::equal(items.cbegin(), items.cend(), m_items.cbegin());
+}
+
+void ItemSpatialIndex::rebuild(const QList<PageItem*>& items)
+{
+	// keep the bounds of the items that are still there and did not change, items mark themselves
+	// as changed when they are constructed and destroyed, so a new item allocated at the address
+	// of a deleted one never inherits its bounds
+	QHash<const PageItem*, int> knownItems;
+	knownItems.reserve(m_items.count());
+	for (int i = 0; i < m_items.count(); ++i)
+	{
+		if (!m_changedItems.contains(m_items.at(i)))
+			knownItems.insert(m_items.at(i), i);
+	}
+	m_changedItems.clear();
+	QVector<QRectF> knownBounds;
+	QVector<int> knownLayers;
+	knownBounds.swap(m_bounds);
+	knownLayers.swap(m_itemLayers);
+
+	clear();
+	m_items.reserve(items.count());
+	m_bounds.reserve(items.count());
+	m_itemLayers.reserve(items.count());
+	m_positions.reserve(items.count());
+	for (int i = 0; i < items.count(); ++i)
+	{
+		PageItem* item = items.at(i);
+		auto known = knownItems.constFind(item);
+		m_items.append(item);
+		if ((known != knownItems.constEnd()) && (knownLayers.at(known.value()) == item->m_layerID))
+			m_bounds.append(knownBounds.at(known.value()));
+		else
+			m_bounds.append(itemBounds(item));
+		m_itemLayers.append(item->m_layerID);
+		m_positions.insert(item, i);
+		insert(i);
+	}
+}
@@ -0,0 +1,91 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef ITEMSPATIALINDEX_H
+#define ITEMSPATIALINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QSet>
+#include <QVector>
+
+#include "scribusapi.h"
+
+class PageItem;
+
+/**
+ * The ItemSpatialIndex class is a uniform grid over the bounds of the items of an item list.
+ *
+ * Bounds are computed again only for the items reported through itemChanged(), which the
+ * geometry setters of PageItem and the item change notifications of the document call.
+ * Item lists are edited directly in many places, so update() still compares the list with
+ * the indexed item pointers. If items were added, removed or reordered the grid is filled
+ * again, reusing the bounds of the items already known. Items report themselves when they are
+ * constructed and destroyed, so bounds are never reused for another item at the same address.
+ * Queries return positions in the list, so that callers can still take the z-order into account.
+ */
+class SCRIBUS_API ItemSpatialIndex
+{
+public:
+	enum BoundsType
+	{
+		TextFlowBounds, ///< bounds of the region text of other items flows around
+		VisualBounds    ///< bounds used by the canvas for drawing and hit testing
+	};
+
+	/**
+	 * Constructs an empty index for the given kind of @a boundsType using square cells of @a cellSize points.
+	 * If @a layerID is not negative only the items of that layer are indexed.
+	 */
+	explicit ItemSpatialIndex(BoundsType boundsType, int layerID = -1, double cellSize = 256.0);
+
+	/// Brings the index up to date with @a items.
+	void update(const QList<PageItem*>& items);
+	/// Marks the bounds of @a item as changed, they are computed again by the next update().
+	void itemChanged(const PageItem* item) { m_changedItems.insert(item); }
+	/// Removes all items from the index.
+	void clear();
+
+	/// Returns the number of indexed items, including those without bounds.
+	int count() const { return m_items.count(); }
+	/// Returns the positions of the items whose bounds intersect @a rect in ascending order.
+	QList<int> itemsIntersecting(const QRectF& rect) const;
+
+private:
+	struct CellRange
+	{
+		int left { 0 };
+		int top { 0 };
+		int right { -1 };
+		int bottom { -1 };
+		int count() const { return (right - left + 1) * (bottom - top + 1); }
+	};
+
+	BoundsType m_boundsType;
+	int m_layerID;
+	double m_cellSize;
+	QVector<PageItem*> m_items;
+	QVector<QRectF> m_bounds;
+	/// layer of each item when its bounds were computed
+	QVector<int> m_itemLayers;
+	QHash<const PageItem*, int> m_positions;
+	QSet<const PageItem*> m_changedItems;
+	QHash<quint64, QVector<int> > m_cells;
+	/// items spanning too many cells, these are checked on every query
+	QVector<int> m_largeItems;
+
+	QRectF itemBounds(const PageItem* item) const;
+	CellRange cellRange(const QRectF& rect) const;
+	void insert(int index);
+	void remove(int index);
+	bool sameItems(const QList<PageItem*>& items) const;
+	void rebuild(const QList<PageItem*>& items);
+
+	static quint64 cellKey(int x, int y) { return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y); }
+};
+
+#endif
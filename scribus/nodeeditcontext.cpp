@@ -341,6 +341,7 @@ void NodeEditContext::moveClipPoint(PageItem *currItem, const FPoint& ip)
 		QPointF delta = m.map(QPointF(xposOrig, yposOrig)) - m.map(QPointF(currItem->xPos(), currItem->yPos()));
 		currItem->ContourLine.translate(delta.x(), delta.y());
 	}
+	Doc->itemBoundsChanged(currItem);
 }
 
 
@@ -368,6 +369,7 @@ void NodeEditContext::reset1Control(PageItem* currItem)
 	if (Doc->nodeEdit.m_isContourLine)
 	{
 		currItem->ContourLine.setPoint(Doc->nodeEdit.m_ClRe, np);
+		Doc->itemBoundsChanged(currItem);
 		Doc->regionsChanged()->update(QRectF());
 		currItem->FrameOnly = true;
 		currItem->update();
@@ -471,6 +473,7 @@ void NodeEditContext::resetControl(PageItem* currItem)
 	else
 	{
 		currItem->ContourLine = Clip.copy();
+		Doc->itemBoundsChanged(currItem);
 		Doc->regionsChanged()->update(QRectF());
 	}
 	Doc->update();
@@ -156,6 +156,7 @@ PageItem::PageItem(const PageItem & other)
 	OwnPage(other.OwnPage),
 	oldOwnPage(other.oldOwnPage),
 	pixm(other.pixm),
+	imagePoolUser(other.imagePoolUser),
 	Pfile(other.Pfile),
 	Pfile2(other.Pfile2),
 	Pfile3(other.Pfile3),
@@ -350,6 +351,7 @@ PageItem::PageItem(const PageItem & other)
 	
 	uniqueNr = m_Doc->TotalItems;
 	invalid = true;
+	m_Doc->itemBoundsChanged(this);
 	if (other.isInlineImage)
 	{
 		QFileInfo inlFi(Pfile);
@@ -674,10 +676,13 @@ PageItem::PageItem(ScribusDoc *doc, ItemType newType, double x, double y, double
 	hatchBackgroundQ = QColor();
 	hatchForeground = "Black";
 	hatchForegroundQ = qcol;
+	m_Doc->itemBoundsChanged(this);
 }
 
 PageItem::~PageItem()
 {
+	// drop the bounds the spatial indexes still keep for this address
+	m_Doc->itemBoundsChanged(this);
 	if (isTempFile && !Pfile.isEmpty())
 		QFile::remove(Pfile);
 	//remove marks
@@ -727,6 +732,7 @@ bool PageItem::isTableCell() const
 void PageItem::setXPos(const double newXPos, bool drawingOnly)
 {
 	m_xPos = newXPos;
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -735,6 +741,7 @@ void PageItem::setXPos(const double newXPos, bool drawingOnly)
 void PageItem::setYPos(const double newYPos, bool drawingOnly)
 {
 	m_yPos = newYPos;
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -744,6 +751,7 @@ void PageItem::setXYPos(const double newXPos, const double newYPos, bool drawing
 {
 	m_xPos = newXPos;
 	m_yPos = newYPos;
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -778,6 +786,7 @@ void PageItem::moveBy(const double dX, const double dY, bool drawingOnly)
 		gYpos += dY;
 		BoundingY += dY;
 	}
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	moveWelded(dX, dY);
@@ -788,6 +797,7 @@ void PageItem::setWidth(double newWidth)
 {
 	m_width = newWidth;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -797,6 +807,7 @@ void PageItem::setHeight(double newHeight)
 {
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -807,6 +818,7 @@ void PageItem::setWidthHeight(double newWidth, double newHeight, bool drawingOnl
 	m_width = newWidth;
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly)
 		return;
 	checkChanges();
@@ -817,6 +829,7 @@ void PageItem::setWidthHeight(const double newWidth, const double newHeight)
 	m_width = newWidth;
 	m_height = newHeight;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -831,6 +844,7 @@ void PageItem::resizeBy(const double dH, const double dW)
 	if (dW != 0.0)
 		m_height += dW;
 	updateConstants();
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -845,6 +859,7 @@ void PageItem::setRotation(const double newRotation, bool drawingOnly)
 		m_rotation += 360.0;
 	while (m_rotation > 360.0)
 		m_rotation -= 360.0;
+	m_Doc->itemBoundsChanged(this);
 	if (drawingOnly || m_Doc->isLoading())
 		return;
 	rotateWelded(dR, oldRot);
@@ -860,6 +875,7 @@ void PageItem::rotateBy(const double dR)
 		m_rotation += 360.0;
 	while (m_rotation > 360.0)
 		m_rotation -= 360.0;
+	m_Doc->itemBoundsChanged(this);
 	if (m_Doc->isLoading())
 		return;
 	checkChanges();
@@ -2392,6 +2408,7 @@ void PageItem::setItemName(const QString& newName)
 	QString oldName = m_itemName;
 	m_itemName = generateUniqueCopyName(newName);
 	AutoName = false;
+	m_Doc->itemNameChanged(this, oldName);
 	if (UndoManager::undoEnabled())
 	{
 		auto *ss = new SimpleState(Um::Rename, QString(Um::FromTo).arg(oldName, newName));
@@ -3956,6 +3973,7 @@ void PageItem::setLineWidth(double newWidth)
 	}
 	m_oldLineWidth = m_lineWidth;
 	m_lineWidth = newWidth;
+	m_Doc->itemBoundsChanged(this);
 }
 
 void PageItem::setLineEnd(Qt::PenCapStyle newStyle)
@@ -4081,6 +4099,8 @@ void PageItem::flipImageH()
 		undoManager->action(this, ss);
 	}
 	m_ImageIsFlippedH = !m_ImageIsFlippedH;
+	// the image clip text may flow around is flipped with the image
+	m_Doc->itemBoundsChanged(this);
 }
 
 void PageItem::setImageFlippedV(bool flipped)
@@ -4098,6 +4118,7 @@ void PageItem::flipImageV()
 		undoManager->action(this, ss);
 	}
 	m_ImageIsFlippedV = !m_ImageIsFlippedV;
+	m_Doc->itemBoundsChanged(this);
 }
 
 void PageItem::setImageScalingMode(bool freeScale, bool keepRatio)
@@ -4412,6 +4433,7 @@ void PageItem::setTextFlowMode(TextFlowMode mode)
 		undoManager->action(this, ss);
 	}
 	m_textFlowMode = mode;
+	m_Doc->itemBoundsChanged(this);
 	
 	checkTextFlowInteractions();
 }
@@ -4617,12 +4639,11 @@ void PageItem::moveUndoAction()
 		QString nxString = QString::number(m_xPos * unitRatio, 'f', unitPrecision) + " " + unitSuffix;
 		QString nyString = QString::number(m_yPos * unitRatio, 'f', unitPrecision) + " " + unitSuffix;
 		QString tooltip  =  QString(Um::MoveFromTo).arg(oxString, oyString, oldp, nxString, nyString, newp);
-		auto *ss = new SimpleState(Um::Move, tooltip, Um::IMove);
-		ss->set("ITEM_MOVE");
-		ss->set("OLD_XPOS", oldXpos);
-		ss->set("OLD_YPOS", oldYpos);
-		ss->set("NEW_XPOS", m_xPos);
-		ss->set("NEW_YPOS", m_yPos);
+		auto *ss = new ScGeometryState(ScGeometryState::Move, Um::Move, tooltip, Um::IMove);
+		ss->oldGeometry().xPos = oldXpos;
+		ss->oldGeometry().yPos = oldYpos;
+		ss->newGeometry().xPos = m_xPos;
+		ss->newGeometry().yPos = m_yPos;
 		undoManager->action(this, ss);
 	}
 	oldXpos = m_xPos;
@@ -4650,27 +4671,28 @@ void PageItem::resizeUndoAction()
 		QString nwString  = QString::number(m_width * unitRatio, 'f', unitPrecision) + " " + unitSuffix;
 		QString nhString  = QString::number(m_height * unitRatio, 'f', unitPrecision) + " " + unitSuffix;
 		QString tooltip   = QString(Um::ResizeFromTo).arg(owString, ohString, nwString, nhString);
-		auto *ss = new SimpleState(Um::Resize, tooltip, Um::IResize);
-		ss->set("ITEM_RESIZE");
+		auto *ss = new ScGeometryState(ScGeometryState::Resize, Um::Resize, tooltip, Um::IResize);
+		ScGeometryState::Geometry& oldGeometry = ss->oldGeometry();
+		ScGeometryState::Geometry& newGeometry = ss->newGeometry();
 		if (!isNoteFrame() || !asNoteFrame()->isAutoWidth())
 		{
-			ss->set("OLD_WIDTH", oldWidth);
-			ss->set("NEW_WIDTH", m_width);
+			oldGeometry.width = oldWidth;
+			newGeometry.width = m_width;
 		}
 		if (!isNoteFrame() || !asNoteFrame()->isAutoHeight())
 		{
-			ss->set("OLD_HEIGHT", oldHeight);
-			ss->set("NEW_HEIGHT", m_height);
+			oldGeometry.height = oldHeight;
+			newGeometry.height = m_height;
 		}
 		if (!isNoteFrame() || !asNoteFrame()->isAutoWelded())
 		{
-			ss->set("OLD_RXPOS", oldXpos);
-			ss->set("OLD_RYPOS", oldYpos);
-			ss->set("NEW_RXPOS", m_xPos);
-			ss->set("NEW_RYPOS", m_yPos);
+			oldGeometry.xPos = oldXpos;
+			oldGeometry.yPos = oldYpos;
+			newGeometry.xPos = m_xPos;
+			newGeometry.yPos = m_yPos;
 		}
-		ss->set("OLD_RROT", oldRot);
-		ss->set("NEW_RROT", m_rotation);
+		oldGeometry.rotation = oldRot;
+		newGeometry.rotation = m_rotation;
 		undoManager->action(this, ss);
 	}
 	if (!isNoteFrame() || !asNoteFrame()->isAutoWidth())
@@ -4692,27 +4714,28 @@ void PageItem::rotateUndoAction()
 		return;
 	if (UndoManager::undoEnabled())
 	{
-		auto *ss = new SimpleState(Um::Rotate, QString(Um::FromTo).arg(oldRot).arg(m_rotation),
-		                           Um::IRotate);
-		ss->set("ITEM_ROTATE");
-		ss->set("OLD_ROT", oldRot);
-		ss->set("NEW_ROT", m_rotation);
+		auto *ss = new ScGeometryState(ScGeometryState::Rotate, Um::Rotate, QString(Um::FromTo).arg(oldRot).arg(m_rotation),
+		                               Um::IRotate);
+		ScGeometryState::Geometry& oldGeometry = ss->oldGeometry();
+		ScGeometryState::Geometry& newGeometry = ss->newGeometry();
+		oldGeometry.rotation = oldRot;
+		newGeometry.rotation = m_rotation;
 		if (!isNoteFrame() || !asNoteFrame()->isAutoWelded())
 		{
-			ss->set("OLD_RXPOS", oldXpos);
-			ss->set("OLD_RYPOS", oldYpos);
-			ss->set("NEW_RXPOS", m_xPos);
-			ss->set("NEW_RYPOS", m_yPos);
+			oldGeometry.xPos = oldXpos;
+			oldGeometry.yPos = oldYpos;
+			newGeometry.xPos = m_xPos;
+			newGeometry.yPos = m_yPos;
 		}
 		if (!isNoteFrame() || !asNoteFrame()->isAutoHeight())
 		{
-			ss->set("OLD_RHEIGHT", oldHeight);
-			ss->set("NEW_RHEIGHT", m_height);
+			oldGeometry.height = oldHeight;
+			newGeometry.height = m_height;
 		}
 		if (!isNoteFrame() || !asNoteFrame()->isAutoWidth())
 		{
-			ss->set("NEW_RWIDTH", m_width);
-			ss->set("OLD_RWIDTH", oldWidth);
+			newGeometry.width = m_width;
+			oldGeometry.width = oldWidth;
 		}
 		undoManager->action(this, ss);
 	}
@@ -4793,7 +4816,19 @@ void PageItem::restore(UndoState *state, bool isUndo)
 		m_Doc->setCurrentPage(m_Doc->MasterPages.at(m_Doc->MasterNames[OnMasterPage]));
 	}
 
-	bool actionFound = checkGradientUndoRedo(ss, isUndo);
+	bool actionFound = false;
+	if (auto* gs = dynamic_cast<ScGeometryState*>(ss))
+	{
+		if (gs->action() == ScGeometryState::Resize)
+			restoreResize(gs, isUndo);
+		else if (gs->action() == ScGeometryState::Rotate)
+			restoreRotate(gs, isUndo);
+		else
+			restoreMove(gs, isUndo);
+		actionFound = true;
+	}
+	else
+		actionFound = checkGradientUndoRedo(ss, isUndo);
 	if (!actionFound)
 	{
 		if (ss->contains("ARC"))
@@ -4808,12 +4843,6 @@ void PageItem::restore(UndoState *state, bool isUndo)
 			restoreStartArrowScale(ss, isUndo);
 		else if (ss->contains("IMAGE_ROTATION"))
 			restoreImageRotation(ss, isUndo);
-		else if (ss->contains("ITEM_RESIZE"))
-			restoreResize(ss, isUndo);
-		else if (ss->contains("ITEM_ROTATE"))
-			restoreRotate(ss, isUndo);
-		else if (ss->contains("ITEM_MOVE"))
-			restoreMove(ss, isUndo);
 		else if (ss->contains("FILL"))
 			restoreFill(ss, isUndo);
 		else if (ss->contains("SHADE"))
@@ -7019,12 +7048,12 @@ void PageItem::restoreCornerRadius(SimpleState *state, bool isUndo)
 	*(doc()->m_Selection) = tmpSelection;
 }
 
-void PageItem::restoreMove(SimpleState *state, bool isUndo)
+void PageItem::restoreMove(ScGeometryState *state, bool isUndo)
 {
-	double ox = state->getDouble("OLD_XPOS");
-	double oy = state->getDouble("OLD_YPOS");
-	double  x = state->getDouble("NEW_XPOS");
-	double  y = state->getDouble("NEW_YPOS");
+	double ox = state->oldGeometry().xPos;
+	double oy = state->oldGeometry().yPos;
+	double  x = state->newGeometry().xPos;
+	double  y = state->newGeometry().yPos;
 	double mx = ox - x;
 	double my = oy - y;
 	if (!isUndo)
@@ -7038,18 +7067,20 @@ void PageItem::restoreMove(SimpleState *state, bool isUndo)
 	oldOwnPage = OwnPage;
 }
 
-void PageItem::restoreResize(SimpleState *state, bool isUndo)
-{
-	double  ow = state->getDouble("OLD_WIDTH");
-	double  oh = state->getDouble("OLD_HEIGHT");
-	double   w = state->getDouble("NEW_WIDTH");
-	double   h = state->getDouble("NEW_HEIGHT");
-	double  ox = state->getDouble("OLD_RXPOS");
-	double  oy = state->getDouble("OLD_RYPOS");
-	double   x = state->getDouble("NEW_RXPOS");
-	double   y = state->getDouble("NEW_RYPOS");
-	double ort = state->getDouble("OLD_RROT");
-	double  rt = state->getDouble("NEW_RROT");
+void PageItem::restoreResize(ScGeometryState *state, bool isUndo)
+{
+	const ScGeometryState::Geometry& oldGeometry = state->oldGeometry();
+	const ScGeometryState::Geometry& newGeometry = state->newGeometry();
+	double  ow = oldGeometry.width;
+	double  oh = oldGeometry.height;
+	double   w = newGeometry.width;
+	double   h = newGeometry.height;
+	double  ox = oldGeometry.xPos;
+	double  oy = oldGeometry.yPos;
+	double   x = newGeometry.xPos;
+	double   y = newGeometry.yPos;
+	double ort = oldGeometry.rotation;
+	double  rt = newGeometry.rotation;
 	double  mx = ox - x;
 	double  my = oy - y;
 	int  stateCode = state->transactionCode;
@@ -7076,18 +7107,20 @@ void PageItem::restoreResize(SimpleState *state, bool isUndo)
 	oldRot = m_rotation;
 }
 
-void PageItem::restoreRotate(SimpleState *state, bool isUndo)
-{
-	double ort = state->getDouble("OLD_ROT");
-	double  rt = state->getDouble("NEW_ROT");
-	double  ox = state->getDouble("OLD_RXPOS");
-	double  oy = state->getDouble("OLD_RYPOS");
-	double   x = state->getDouble("NEW_RXPOS");
-	double   y = state->getDouble("NEW_RYPOS");
-	double  ow = state->getDouble("OLD_RWIDTH");
-	double  oh = state->getDouble("OLD_RHEIGHT");
-	double   w = state->getDouble("NEW_RWIDTH");
-	double   h = state->getDouble("NEW_RHEIGHT");
+void PageItem::restoreRotate(ScGeometryState *state, bool isUndo)
+{
+	const ScGeometryState::Geometry& oldGeometry = state->oldGeometry();
+	const ScGeometryState::Geometry& newGeometry = state->newGeometry();
+	double ort = oldGeometry.rotation;
+	double  rt = newGeometry.rotation;
+	double  ox = oldGeometry.xPos;
+	double  oy = oldGeometry.yPos;
+	double   x = newGeometry.xPos;
+	double   y = newGeometry.yPos;
+	double  ow = oldGeometry.width;
+	double  oh = oldGeometry.height;
+	double   w = newGeometry.width;
+	double   h = newGeometry.height;
 	int  stateCode = state->transactionCode;
 	bool redraw = ((stateCode != 1) && (stateCode != 3));
 	if (isUndo)
@@ -7299,6 +7332,7 @@ void PageItem::restoreTextFlowing(SimpleState *state, bool isUndo)
 		m_textFlowMode = oldMode;
 	else
 		m_textFlowMode = newMode;
+	m_Doc->itemBoundsChanged(this);
 	
 	QList<PageItem*> pList;
 	int id = m_Doc->Items->indexOf(this) - 1;
@@ -7712,6 +7746,7 @@ void PageItem::restoreContourLine(SimpleState *state, bool isUndo)
 	else
 		ContourLine = PoLine.copy();
 	ClipEdited = true;
+	m_Doc->itemBoundsChanged(this);
 }
 
 void PageItem::restoreShapeType(SimpleState *state, bool isUndo)
@@ -7824,6 +7859,7 @@ void PageItem::restoreShapeContour(UndoState *state, bool isUndo)
 		}
 		if (oldClip.count() != newClip.count())
 			m_Doc->nodeEdit.deselect();
+		m_Doc->itemBoundsChanged(this);
 		m_Doc->regionsChanged()->update(QRectF());
 	}
 }
@@ -9527,9 +9563,69 @@ QRectF PageItem::getEndArrowOldBoundingRect() const
 
 QRegion PageItem::textInteractionRegion(double xOffset, double yOffset) const
 {
-	QRegion res;
 	if (m_textFlowMode == TextFlowDisabled)
-		return res;
+		return QRegion();
+	// only the unshifted region is cached, master page items are shifted differently for each page
+	if ((xOffset != 0.0) || (yOffset != 0.0))
+		return computeTextInteractionRegion(xOffset, yOffset);
+	// cheap to compute, and the visual bounds also depend on arrows and group children
+	if (textFlowUsesBoundingBox())
+		return computeTextInteractionRegion(0.0, 0.0);
+	// depends on the document line styles
+	if (!NamedLStyle.isEmpty())
+		return computeTextInteractionRegion(0.0, 0.0);
+	if (textInteractionCacheValid())
+		return m_textInteractionCache.region;
+
+	TextInteractionCache& cache = m_textInteractionCache;
+	cache.region = computeTextInteractionRegion(0.0, 0.0);
+	cache.parent = Parent;
+	cache.xPos = m_xPos;
+	cache.yPos = m_yPos;
+	cache.gXpos = gXpos;
+	cache.gYpos = gYpos;
+	cache.width = m_width;
+	cache.height = m_height;
+	cache.rotation = m_rotation;
+	cache.textFlowMode = m_textFlowMode;
+	cache.flippedH = m_ImageIsFlippedH;
+	cache.flippedV = m_ImageIsFlippedV;
+	cache.lineColor = m_lineColor;
+	cache.strokePattern = patternStrokeVal;
+	cache.strokeGradientType = GrTypeStroke;
+	cache.lineWidth = m_lineWidth;
+	cache.lineEnd = PLineEnd;
+	cache.lineJoin = PLineJoin;
+	cache.clip = Clip;
+	cache.poLine = PoLine;
+	cache.contourLine = ContourLine;
+	cache.imageClip = imageClip;
+	cache.valid = true;
+	return cache.region;
+}
+
+bool PageItem::textInteractionCacheValid() const
+{
+	const TextInteractionCache& cache = m_textInteractionCache;
+	if (!cache.valid || (cache.parent != Parent))
+		return false;
+	if ((cache.xPos != m_xPos) || (cache.yPos != m_yPos) || (cache.gXpos != gXpos) || (cache.gYpos != gYpos))
+		return false;
+	if ((cache.width != m_width) || (cache.height != m_height) || (cache.rotation != m_rotation))
+		return false;
+	if ((cache.textFlowMode != m_textFlowMode) || (cache.flippedH != m_ImageIsFlippedH) || (cache.flippedV != m_ImageIsFlippedV))
+		return false;
+	if ((cache.lineColor != m_lineColor) || (cache.strokePattern != patternStrokeVal) || (cache.strokeGradientType != GrTypeStroke))
+		return false;
+	if ((cache.lineWidth != m_lineWidth) || (cache.lineEnd != PLineEnd) || (cache.lineJoin != PLineJoin))
+		return false;
+	// shared copies compare by pointer first, so this is cheap unless the shapes were edited
+	return (cache.clip == Clip) && (cache.poLine == PoLine) && (cache.contourLine == ContourLine) && (cache.imageClip == imageClip);
+}
+
+QRegion PageItem::computeTextInteractionRegion(double xOffset, double yOffset) const
+{
+	QRegion res;
 
 	QTransform pp;
 	if (this->isGroupChild())
@@ -9686,8 +9782,43 @@ bool PageItem::loadImage(const QString& filename, const bool reload, const int g
 	if (!effectsInUse.isEmpty())
 		imgcache.addModifier("effectsInUse", getImageEffectsModifier());
 
+	// frames showing the same image with the same settings share it,
+	// images with layer requests are specific to their frame
+	ScImagePool& imagePool = m_Doc->imagePool();
+	QString poolKey;
+	if (!pixm.imgInfo.isRequest)
+	{
+		QStringList keyParts;
+		keyParts << fi.absoluteFilePath()
+				 << QString::number(fi.lastModified().toMSecsSinceEpoch())
+				 << QString::number(fi.size())
+				 << QString::number(pixm.imgInfo.actualPageNumber)
+				 << QString::number(pixm.imgInfo.lowResType)
+				 << (effectsInUse.isEmpty() ? QString() : getImageEffectsModifier())
+				 << QString::number(gsRes)
+				 << ImageProfile
+				 << QString::number(static_cast<int>(ImageIntent))
+				 << QString::number(static_cast<int>(UseEmbedded))
+				 << QString::number(static_cast<int>(cms.useColorManagement()))
+				 << QString::number(static_cast<int>(cms.doSoftProofing()))
+				 << QString::number(static_cast<int>(cms.doGamutCheck()))
+				 << QString::number(static_cast<int>(cms.useBlackPoint()))
+				 << m_Doc->cmsSettings().DefaultMonitorProfile
+				 << m_Doc->cmsSettings().DefaultPrinterProfile
+				 << m_Doc->cmsSettings().DefaultImageRGBProfile
+				 << m_Doc->cmsSettings().DefaultImageCMYKProfile
+				 << QString::number(m_Doc->viewAsPreview ? m_Doc->previewVisual : -1);
+		poolKey = keyParts.join(QChar('\n'));
+	}
+	int poolOrigW = 0;
+	int poolOrigH = 0;
+	imagePoolUser.reset();
+	bool fromPool = !poolKey.isEmpty() && imagePool.find(poolKey, pixm, poolOrigW, poolOrigH, imagePoolUser);
+
 	bool fromCache = false;
-	if (!pixm.loadPicture(imgcache, fromCache, pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, gsRes, &dummy, showMsg))
+	// images decoded in the background while the document was opened
+	bool decoded = !fromPool && m_Doc->imageLoader().takeDecodedImage(this, pixm);
+	if (!fromPool && !decoded && !pixm.loadPicture(imgcache, fromCache, pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, gsRes, &dummy, showMsg))
 	{
 		Pfile = fi.absoluteFilePath();
 		imageIsAvailable = false;
@@ -9752,7 +9883,12 @@ bool PageItem::loadImage(const QString& filename, const bool reload, const int g
 	}
 	BBoxX = pixm.imgInfo.BBoxX;
 	BBoxH = pixm.imgInfo.BBoxH;
-	if (fromCache)
+	if (fromPool)
+	{
+		OrigW = poolOrigW;
+		OrigH = poolOrigH;
+	}
+	else if (fromCache)
 	{
 		OrigW = imgcache.getInfo("OrigW").toInt();
 		OrigH = imgcache.getInfo("OrigH").toInt();
@@ -9790,7 +9926,7 @@ bool PageItem::loadImage(const QString& filename, const bool reload, const int g
 	oldLocalScX = m_imageXScale;
 	oldLocalScY = m_imageYScale;
 
-	if (imageIsAvailable && !fromCache)
+	if (imageIsAvailable && !fromCache && !fromPool)
 	{
 		if ((pixm.imgInfo.colorspace == ColorSpaceDuotone) && (pixm.imgInfo.duotoneColors.count() != 0) && (!reload))
 		{
@@ -9939,7 +10075,7 @@ bool PageItem::loadImage(const QString& filename, const bool reload, const int g
 				pixm.imgInfo.lowResScale = 1.0;
 		}
 	}
-	if (imageIsAvailable && m_Doc->viewAsPreview)
+	if (imageIsAvailable && m_Doc->viewAsPreview && !fromPool)
 	{
 		VisionDefectColor defect;
 		QColor tmpC;
@@ -9963,6 +10099,9 @@ bool PageItem::loadImage(const QString& filename, const bool reload, const int g
 			}
 		}
 	}
+	// duotone images add their colors and effect to the frame when loaded
+	if (!poolKey.isEmpty() && !fromPool && (pixm.imgInfo.colorspace != ColorSpaceDuotone))
+		imagePool.insert(poolKey, pixm, OrigW, OrigH, imagePoolUser);
 	return true;
 }
 
@@ -10297,6 +10436,7 @@ void PageItem::setRedrawBounding()
 	BoundingH = bh - BoundingY;
 	if (asLine())
 		BoundingH = qMax(BoundingH, 1.0);
+	m_Doc->itemBoundsChanged(this);
 }
 
 void PageItem::updateGradientVectors()
@@ -10337,6 +10477,12 @@ void PageItem::updateGradientVectors()
 	//unused double dur = m_Doc->unitRatio();
 }
 
+void PageItem::setContour(const FPointArray& val)
+{
+	ContourLine = val;
+	m_Doc->itemBoundsChanged(this);
+}
+
 void PageItem::setPolyClip(int up, int down)
 {
 	if (PoLine.size() < 3)
@@ -10392,6 +10538,7 @@ void PageItem::setPolyClip(int up, int down)
 			Clip.setPoint(Clip.size() - 1, cl2.point(i2));
 		}
 	}
+	m_Doc->itemBoundsChanged(this);
 }
 
 void PageItem::updatePolyClip()
@@ -10588,6 +10735,7 @@ void PageItem::updateClip(bool updateWelded)
 {
 	if (m_Doc->appMode == modeDrawBezierLine)
 		return;
+	m_Doc->itemBoundsChanged(this);
 	if (ContourLine.empty())
 		ContourLine = PoLine.copy();
 //	int ph = static_cast<int>(qMax(1.0, lineWidth() / 2.0));
@@ -35,6 +35,7 @@ for which a new license (GPL+exception) is in place.
 #include <QPointF>
 #include <QRect>
 #include <QRectF>
+#include <QRegion>
 #include <QString>
 #include <QVector>
 #include <QTemporaryFile>
@@ -47,6 +48,7 @@ for which a new license (GPL+exception) is in place.
 #include "observable.h"
 #include "pagestructs.h"
 #include "scimage.h"
+#include "scimagepool.h"
 #include "margins.h"
 #include "scpatterntransform.h"
 #include "sctextstruct.h"
@@ -62,8 +64,8 @@ for which a new license (GPL+exception) is in place.
 
 class QFrame;
 class QGridLayout;
-class QRegion;
 class ResourceCollection;
+class ScGeometryState;
 class ScPainter;
 class ScribusDoc;
 class SimpleState;
@@ -455,7 +457,7 @@ public: // Start public functions
 	FPointArray shape() const { return PoLine; }
 	void setShape(const FPointArray& val) { PoLine = val; }
 	FPointArray contour() const { return ContourLine; }
-	void setContour(const FPointArray& val) { ContourLine = val; }
+	void setContour(const FPointArray& val);
 	bool flipPathText() const { return textPathFlipped; }
 	void setFlipPathText(bool val) { textPathFlipped = val; }
 	int pathTextType() const { return textPathType; }
@@ -1356,6 +1358,7 @@ public:	// Start public variables
 	int oldOwnPage; ///< Old page number tracked for the move undo action
 	int savedOwnPage;
 	ScImage pixm; ///< Darzustellendes Bild
+	ScImagePool::UserToken imagePoolUser; ///< set while pixm is shared with the document's image pool
 	QString Pfile; ///< Dateiname des Bildes
 	QString Pfile2;
 	QString Pfile3;
@@ -1635,7 +1638,7 @@ protected: // Start protected functions
 	void restoreMaskFlip(SimpleState *state, bool isUndo);
 	void restoreMaskTransform(SimpleState *state, bool isUndo);
 	void restoreMaskType(SimpleState *state,bool isUndo);
-	void restoreMove(SimpleState *state, bool isUndo);
+	void restoreMove(ScGeometryState *state, bool isUndo);
 	void restoreMoveMeshGrad(SimpleState *state, bool isUndo);
 	void restoreMoveMeshPatch(SimpleState *state, bool isUndo);
 	void restoreName(SimpleState *state, bool isUndo);
@@ -1650,9 +1653,9 @@ protected: // Start protected functions
 	void restoreRemoveMeshPatch(SimpleState *state, bool isUndo);
 	void restoreResTyp(SimpleState *state, bool isUndo);
 	void restoreResetMeshGrad(SimpleState *state, bool isUndo);
-	void restoreResize(SimpleState *state, bool isUndo);
+	void restoreResize(ScGeometryState *state, bool isUndo);
 	void restoreRightTextFrameDist(SimpleState *state, bool isUndo);
-	void restoreRotate(SimpleState *state, bool isUndo);
+	void restoreRotate(ScGeometryState *state, bool isUndo);
 	void restoreSetCharStyle(SimpleState *state, bool isUndo);
 	void restoreSetParagraphStyle(SimpleState *state, bool isUndo);
 	void restoreShade(SimpleState *state, bool isUndo);
@@ -1904,9 +1907,43 @@ private:	// Start private functions
 	 */
 	QString getImageEffectsModifier() const;
 
+	QRegion computeTextInteractionRegion(double xOffset, double yOffset) const;
+	bool textInteractionCacheValid() const;
+
 			// End private functions
 
 private:	// Start private variables
+	/**
+	 * @brief Last unshifted textInteractionRegion() result and the geometry it was computed from.
+	 * Checked against the current geometry on each call, so no setter has to invalidate it.
+	 */
+	struct TextInteractionCache
+	{
+		bool valid {false};
+		const PageItem* parent {nullptr};
+		double xPos {0.0};
+		double yPos {0.0};
+		double gXpos {0.0};
+		double gYpos {0.0};
+		double width {0.0};
+		double height {0.0};
+		double rotation {0.0};
+		TextFlowMode textFlowMode {TextFlowDisabled};
+		bool flippedH {false};
+		bool flippedV {false};
+		QString lineColor;
+		QString strokePattern;
+		int strokeGradientType {0};
+		double lineWidth {0.0};
+		Qt::PenCapStyle lineEnd {Qt::FlatCap};
+		Qt::PenJoinStyle lineJoin {Qt::MiterJoin};
+		QPolygon clip;
+		FPointArray poLine;
+		FPointArray contourLine;
+		FPointArray imageClip;
+		QRegion region;
+	};
+	mutable TextInteractionCache m_textInteractionCache;
 			// End private variables
 
 
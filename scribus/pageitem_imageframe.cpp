@@ -93,6 +93,21 @@ void PageItem_ImageFrame::DrawObj_Item(ScPainter *p, const QRectF& /*e*/)
 			p->drawLine(FPoint(0, m_height), FPoint(m_width, 0));
 		}
 	}
+	else if (!imageIsAvailable && m_Doc->imageLoader().isPending(this))
+	{
+		//Placeholder until the image is decoded in the background, frames being shown come first
+		m_Doc->imageLoader().prioritize(this);
+		if ((drawFrame()) && (m_Doc->guidesPrefs().framesShown))
+		{
+			p->setBrush(Qt::white);
+			p->setPen(Qt::gray, 1, Qt::DotLine, Qt::FlatCap, Qt::MiterJoin);
+			p->drawLine(FPoint(0, 0), FPoint(m_width, m_height));
+			p->drawLine(FPoint(0, m_height), FPoint(m_width, 0));
+			const QFont &font = QApplication::font();
+			p->setFont(PrefsManager::instance().appPrefs.fontPrefs.AvailFonts.findFont(font.family(), QFontInfo(font).styleName()), font.pointSizeF());
+			p->drawText(QRectF(0.0, 0.0, m_width, m_height), tr("Loading:") + " " + QFileInfo(Pfile).fileName());
+		}
+	}
 	else if ((!m_imageVisible) || (!imageIsAvailable))
 	{
 		//If we are missing our image, draw a red cross in the frame
@@ -235,6 +250,7 @@ void PageItem_ImageFrame::clearContents()
 	imageIsAvailable = false;
 	Pfile.clear();
 	pixm = ScImage();
+	imagePoolUser.reset();
 
 	m_imageXScale = 1;
 	m_imageYScale = 1;
@@ -59,6 +59,7 @@ for which a new license (GPL+exception) is in place.
 #include "text/screenpainter.h"
 #include "text/textshaper.h"
 #include "text/shapedtext.h"
+#include "text/shapedtextcache.h"
 #include "text/shapedtextfeed.h"
 #include "textnote.h"
 #include "ui/guidemanager.h"
@@ -91,6 +92,26 @@ void PageItem_TextFrame::init()
 	connect(&itemText,SIGNAL(changed(int,int)), this, SLOT(slotInvalidateLayout(int,int)));
 }
 
+QRegion PageItem_TextFrame::calcLayoutRegion()
+{
+	QRegion region = calcAvailableRegion();
+	if (!imageFlippedH() && !imageFlippedV())
+		return region;
+
+	QTransform matrix;
+	if (imageFlippedH())
+	{
+		matrix.translate(m_width, 0);
+		matrix.scale(-1, 1);
+	}
+	if (imageFlippedV())
+	{
+		matrix.translate(0, m_height);
+		matrix.scale(1, -1);
+	}
+	return matrix.map(region);
+}
+
 QRegion PageItem_TextFrame::calcAvailableRegion()
 {
 	QRegion result(this->Clip);
@@ -98,16 +119,18 @@ QRegion PageItem_TextFrame::calcAvailableRegion()
 		return result;
 
 	bool invertible(false);
-	QTransform canvasToLocalMat;
+	QTransform localToCanvasMat;
 	if (isGroupChild())
-		canvasToLocalMat.translate(gXpos, gYpos);
+		localToCanvasMat.translate(gXpos, gYpos);
 	else
-		canvasToLocalMat.translate(m_xPos, m_yPos);
-	canvasToLocalMat.rotate(m_rotation);
-	canvasToLocalMat = canvasToLocalMat.inverted(&invertible);
+		localToCanvasMat.translate(m_xPos, m_yPos);
+	localToCanvasMat.rotate(m_rotation);
+	QTransform canvasToLocalMat = localToCanvasMat.inverted(&invertible);
 
 	if (!invertible)
 		return QRegion();
+	// only items whose text flow region intersects this frame can change the result
+	QRectF canvasRect = localToCanvasMat.mapRect(QRectF(result.boundingRect())).adjusted(-1, -1, 1, 1);
 
 	int layerLev = m_Doc->layerLevelFromID(m_layerID);
 	int docItemsCount = m_Doc->Items->count();
@@ -125,7 +148,10 @@ QRegion PageItem_TextFrame::calcAvailableRegion()
 		else
 			thisList = m_Doc->MasterItems;
 		int thisid = thisList.indexOf(this);
-		for (int i = 0; i < m_Doc->MasterItems.count(); ++i)
+		// textInteractionRegion() moves master items by -offset, move this frame by +offset instead
+		QRectF masterRect = canvasRect.translated(Mp->xOffset() - Dp->xOffset(), Mp->yOffset() - Dp->yOffset());
+		const QList<int> candidates = m_Doc->textFlowIndex(m_Doc->MasterItems).itemsIntersecting(masterRect);
+		for (int i : candidates)
 		{
 			docItem = m_Doc->MasterItems.at(i);
 			// #10642 : masterpage items interact only with items placed on same masterpage
@@ -177,7 +203,8 @@ QRegion PageItem_TextFrame::calcAvailableRegion()
 		else
 		{
 			thisid = m_Doc->Items->indexOf(this);
-			for (int i = 0; i < docItemsCount; ++i)
+			const QList<int> candidates = m_Doc->textFlowIndex(*m_Doc->Items).itemsIntersecting(canvasRect);
+			for (int i : candidates)
 			{
 				docItem = m_Doc->Items->at(i);
 				layerLevItem = m_Doc->layerLevelFromID(docItem->m_layerID);
@@ -1118,6 +1145,7 @@ bool PageItem_TextFrame::moveLinesFromPreviousFrame ()
 	for (int i = 0; i < pull; ++i)
 		prev->textLayout.removeLastLine();
 	firstChar = prev->m_maxChars = startingPos;
+	prev->m_layoutRecord.valid = false;
 	// keep the remaining incomplete lines flagged as such
 	// this ensures that if pulling one line won't be enough, the subsequent call to layout() will pull more
 	prev->incompleteLines -= pull;
@@ -1205,6 +1233,9 @@ void PageItem_TextFrame::layout()
 	}
 	if (invalid && m_backBox == nullptr)
 		firstChar = 0;
+	if (invalid && reuseLayoutRecord())
+		return;
+	m_layoutRecord.valid = false;
 
 //	qDebug() << QString("textframe(%1,%2): len=%3, start relayout at %4").arg(m_xPos).arg(m_yPos).arg(itemText.length()).arg(firstInFrame());
 	QPoint pt1, pt2;
@@ -1218,6 +1249,10 @@ void PageItem_TextFrame::layout()
 	bool goNoRoom = false;
 	bool goNextColumn = false;
 
+	// lines pulled by widow and orphan control make the layout depend on the previous frame
+	PageItem_TextFrame* prevFrame = dynamic_cast<PageItem_TextFrame*>(m_backBox);
+	bool reusableLayout = (prevFrame == nullptr) || (prevFrame->incompleteLines == 0);
+
 	TabControl tabs;
 	tabs.active    = false;     // RTab
 	tabs.status    = TabNONE;   // TabCode
@@ -1272,6 +1307,7 @@ void PageItem_TextFrame::layout()
 			next->firstChar = itLen;
 			next->m_maxChars = itLen;
 			next->textLayout.clear();
+			next->m_layoutRecord.valid = false;
 			next = dynamic_cast<PageItem_TextFrame*>(next->nextInChain());
 		}
 		// TODO layout() shouldn't delete any frame here, as it breaks any loop
@@ -1296,29 +1332,13 @@ void PageItem_TextFrame::layout()
 	if (itLen != 0)
 	{
 		// determine layout area
-		m_availableRegion = calcAvailableRegion();
+		m_availableRegion = calcLayoutRegion();
 		if (m_availableRegion.isEmpty())
 		{
 			m_maxChars = firstInFrame();
 			goto NoRoom;
 		}
 
-		if (imageFlippedH() || imageFlippedV())
-		{
-			QTransform matrix;
-			if (imageFlippedH())
-			{
-				matrix.translate(m_width, 0);
-				matrix.scale(-1, 1);
-			}
-			if (imageFlippedV())
-			{
-				matrix.translate(0, m_height);
-				matrix.scale(1, -1);
-			}
-			m_availableRegion = matrix.map(m_availableRegion);
-		}
-		
 		// update Bullet & number list if any.
 		if (itemText.hasTextMarks() || itemText.hasBulletOrNum() ||  itemText.marksCountChanged())
 		{
@@ -1327,8 +1347,9 @@ void PageItem_TextFrame::layout()
 		}
 
 		ITextContext* context = this;
+		ShapedTextCache::instance().preShape(itemText, firstInFrame());
 		//TextShaper textShaper(this, itemText, firstInFrame());
-		ShapedTextFeed shapedText(&itemText, firstInFrame(), context);
+		ShapedTextFeed shapedText(&itemText, firstInFrame(), context, &ShapedTextCache::instance());
 
 		QList<GlyphCluster> glyphClusters; // = textShaper.shape();
 		// std::sort(glyphClusters.begin(), glyphClusters.end(), logicalGlyphRunComp);
@@ -2905,16 +2926,8 @@ void PageItem_TextFrame::layout()
 		}
 		UndoManager::instance()->setUndoEnabled(true);
 	}
-	if (m_nextBox != nullptr)
-	{
-		PageItem_TextFrame * nextFrame = dynamic_cast<PageItem_TextFrame*>(m_nextBox);
-		while (nextFrame)
-		{
-			nextFrame->invalid   = true;
-			nextFrame->firstChar = m_maxChars;
-			nextFrame = dynamic_cast<PageItem_TextFrame*>(nextFrame->m_nextBox);
-		}
-	}
+	storeLayoutRecord(reusableLayout);
+	invalidateNextFrames();
 	itemText.blockSignals(false);
 //	qDebug("textframe: len=%d, done relayout", itemText.length());
 	return;
@@ -2957,6 +2970,7 @@ NoRoom:
 		}
 		UndoManager::instance()->setUndoEnabled(true);
 	}
+	storeLayoutRecord(reusableLayout);
 
 	PageItem_TextFrame * next = dynamic_cast<PageItem_TextFrame*>(m_nextBox);
 	if (next != nullptr)
@@ -2967,12 +2981,7 @@ NoRoom:
 			if (m_Doc->appMode == modeEdit)
 				next->itemText.setCursorPosition( qMax(nCP, signed(m_maxChars)) );
 		}
-		while (next)
-		{
-			next->invalid   = true;
-			next->firstChar = m_maxChars;
-			next = dynamic_cast<PageItem_TextFrame*>(next->m_nextBox);
-		}
+		invalidateNextFrames();
 	}
 //	qDebug("textframe: len=%d, done relayout (no room %d)", itemText.length(), MaxChars);
 	itemText.blockSignals(false);
@@ -2981,24 +2990,30 @@ NoRoom:
 void PageItem_TextFrame::invalidateLayout(bool wholeChain)
 {
 	//const bool wholeChain = true;
-	invalid = true;
+	invalidateLayout();
 	if (wholeChain)
 	{
 		PageItem *prevFrame = this->prevInChain();
 		while (prevFrame != nullptr)
 		{
-			prevFrame->invalid = true;
+			prevFrame->invalidateLayout();
 			prevFrame = prevFrame->prevInChain();
 		}
 		PageItem *nextFrame = this->nextInChain();
 		while (nextFrame != nullptr)
 		{
-			nextFrame->invalid = true;
+			nextFrame->invalidateLayout();
 			nextFrame = nextFrame->nextInChain();
 		}
 	}
 }
 
+void PageItem_TextFrame::invalidateLayout()
+{
+	invalid = true;
+	m_layoutRecord.valid = false;
+}
+
 void PageItem_TextFrame::invalidateLayout(int firstChar)
 {
 	int storyLen = itemText.length();
@@ -3020,14 +3035,116 @@ void PageItem_TextFrame::slotInvalidateLayout(int firstItem, int /*endItem*/)
 		firstInvalid = dynamic_cast<PageItem_TextFrame*>(firstInvalid->m_nextBox);
 	}
 
+	// frames whose text did not change are revalidated by reuseLayoutRecord()
 	PageItem_TextFrame* invalidFrame = firstInvalid;
 	while (invalidFrame)
 	{
+		if (!invalidFrame->invalid)
+			invalidFrame->m_layoutRecord.chainInvalidated = true;
 		invalidFrame->invalid = true;
 		invalidFrame = dynamic_cast<PageItem_TextFrame*>(invalidFrame->m_nextBox);
 	}
 }
 
+void PageItem_TextFrame::invalidateNextFrames()
+{
+	PageItem_TextFrame* nextFrame = dynamic_cast<PageItem_TextFrame*>(m_nextBox);
+	while (nextFrame)
+	{
+		if (!nextFrame->invalid)
+			nextFrame->m_layoutRecord.chainInvalidated = true;
+		nextFrame->invalid   = true;
+		nextFrame->firstChar = m_maxChars;
+		nextFrame = dynamic_cast<PageItem_TextFrame*>(nextFrame->m_nextBox);
+	}
+}
+
+void PageItem_TextFrame::storeLayoutRecord(bool reusable)
+{
+	LayoutRecord& record = m_layoutRecord;
+	record.valid = reusable;
+	record.chainInvalidated = false;
+	record.editSerial = itemText.editSerial();
+	record.firstChar = firstChar;
+	record.maxChars = m_maxChars;
+	record.dependFirst = qMax(firstChar - 1, 0);
+	int parSep = itemText.indexOf(SpecialChars::PARSEP, m_maxChars);
+	record.dependLast = (parSep < 0) ? itemText.length() : parSep;
+	record.ownPage = OwnPage;
+	record.pageCount = m_Doc->Pages->count();
+	record.paragraphStylesVersion = m_Doc->paragraphStyles().version();
+	record.charStylesVersion = m_Doc->charStyles().version();
+	record.width = m_width;
+	record.height = m_height;
+	record.lineCorr = (lineColor() != CommonStrings::None) ? m_lineWidth / 2.0 : 0.0;
+	record.textDistances = QMarginsF(m_textDistanceMargins.left(), m_textDistanceMargins.top(), m_textDistanceMargins.right(), m_textDistanceMargins.bottom());
+	record.columns = m_columns;
+	record.columnGap = m_columnGap;
+	record.verticalAlign = verticalAlign;
+	record.firstLineOffset = m_firstLineOffset;
+	record.region = m_availableRegion;
+}
+
+/**
+	Revalidates the frame without laying it out again if its text and all other
+	inputs of the last layout are unchanged, only moved by edits in previous frames.
+	Relayouting a chain then stops at the first frame which starts at the same text
+	position as before.
+ */
+bool PageItem_TextFrame::reuseLayoutRecord()
+{
+	const LayoutRecord& record = m_layoutRecord;
+	if (!record.valid || !record.chainInvalidated)
+		return false;
+	// notes, marks and list numbers are updated as a side effect of layout
+	if (!OnMasterPage.isEmpty() || isNoteFrame() || !m_notesFramesMap.isEmpty())
+		return false;
+	if (!m_Doc->notesList().isEmpty() || m_Doc->notesChanged())
+		return false;
+	if (itemText.hasTextMarks() || itemText.hasBulletOrNum() || itemText.marksCountChanged())
+		return false;
+	PageItem_TextFrame* prevFrame = dynamic_cast<PageItem_TextFrame*>(m_backBox);
+	if (prevFrame && prevFrame->incompleteLines != 0)
+		return false;
+
+	int dependFirst = record.dependFirst;
+	int dependLast = record.dependLast;
+	if (!itemText.mapRange(record.editSerial, dependFirst, dependLast))
+		return false;
+	int delta = dependFirst - record.dependFirst;
+	if (firstChar != record.firstChar + delta)
+		return false;
+
+	if (record.ownPage != OwnPage || record.pageCount != m_Doc->Pages->count())
+		return false;
+	if (record.paragraphStylesVersion != m_Doc->paragraphStyles().version() || record.charStylesVersion != m_Doc->charStyles().version())
+		return false;
+	double lineCorr = (lineColor() != CommonStrings::None) ? m_lineWidth / 2.0 : 0.0;
+	if (record.width != m_width || record.height != m_height || record.lineCorr != lineCorr)
+		return false;
+	QMarginsF textDistances(m_textDistanceMargins.left(), m_textDistanceMargins.top(), m_textDistanceMargins.right(), m_textDistanceMargins.bottom());
+	if (record.textDistances != textDistances || record.columns != m_columns || record.columnGap != m_columnGap)
+		return false;
+	if (record.verticalAlign != verticalAlign || record.firstLineOffset != m_firstLineOffset)
+		return false;
+	QRegion region = calcLayoutRegion();
+	if (region != record.region)
+		return false;
+
+	if (delta != 0)
+	{
+		textLayout.shiftChars(delta);
+		for (int i = 0; i < incompletePositions.count(); ++i)
+			incompletePositions[i] += delta;
+	}
+	m_availableRegion = region;
+	m_maxChars = record.maxChars + delta;
+	invalid = false;
+	storeLayoutRecord(true);
+	invalidateNextFrames();
+	return true;
+}
+
 bool PageItem_TextFrame::isValidChainFromBegin()
 {
 	if (invalid)
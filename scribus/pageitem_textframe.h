@@ -23,6 +23,7 @@ for which a new license (GPL+exception) is in place.
 #define PAGEITEMTEXTFRAME_H
 
 #include <QHash>
+#include <QMarginsF>
 #include <QRectF>
 #include <QString>
 #include <QKeyEvent>
@@ -74,7 +75,7 @@ public:
 	//for speed up updates when changed was only one frame from chain
 	virtual void invalidateLayout(bool wholeChain);
 	virtual void invalidateLayout(int firstChar);
-	using PageItem::invalidateLayout;
+	void invalidateLayout() override;
 	void layout() override;
 
 	//return true if all previous frames from chain are valid (including that one)
@@ -89,6 +90,8 @@ public:
 
 protected:
 	QRegion calcAvailableRegion();
+	// available region in the orientation used for layout
+	QRegion calcLayoutRegion();
 	QRegion m_availableRegion;
 	void DrawObj_Item(ScPainter *p, const QRectF& e) override;
 	void DrawObj_Post(ScPainter *p) override;
@@ -124,6 +127,39 @@ private:
 	QRectF m_origAnnotPos;
 	void updateBulletsNum();
 
+	// Inputs and result of the last layout. When text is only changed in previous
+	// frames of a chain, this frame gets revalidated by moving its boxes instead of
+	// laying it out again.
+	struct LayoutRecord
+	{
+		bool valid {false};
+		// set if the frame was only invalidated because a previous frame changed
+		bool chainInvalidated {false};
+		quint64 editSerial {0};
+		int firstChar {0};
+		int maxChars {0};
+		// chars the layout depends on: the char in front of the frame up to the end of its last paragraph
+		int dependFirst {0};
+		int dependLast {0};
+		int ownPage {-1};
+		int pageCount {0};
+		int paragraphStylesVersion {0};
+		int charStylesVersion {0};
+		double width {0.0};
+		double height {0.0};
+		double lineCorr {0.0};
+		QMarginsF textDistances;
+		int columns {1};
+		double columnGap {0.0};
+		int verticalAlign {0};
+		FirstLineOffsetPolicy firstLineOffset {FLOPRealGlyphHeight};
+		QRegion region;
+	};
+	LayoutRecord m_layoutRecord;
+	void storeLayoutRecord(bool reusable);
+	bool reuseLayoutRecord();
+	void invalidateNextFrames();
+
 private slots:
 	void slotInvalidateLayout(int firstItem, int endItem);
 
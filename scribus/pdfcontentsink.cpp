@@ -0,0 +1,177 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include "pdfcontentsink.h"
+#include "pdfwriter.h"
+#include "scstreamfilter_flate.h"
+
+namespace Pdf
+{
+
+	namespace
+	{
+		// the writing thread waits if compression falls behind by more chunks
+		const int maxQueuedChunks = 4;
+	}
+
+	struct ContentSink::Compressor
+	{
+		QMutex mutex;
+		QWaitCondition changed;
+		QList<QByteArray> queue;
+		bool running { false };
+		bool failed { false };
+
+		QByteArray output;
+		QBuffer buffer;
+		QDataStream stream;
+		ScFlateEncodeFilter filter;
+
+		Compressor() : filter(&stream)
+		{
+			buffer.setBuffer(&output);
+			buffer.open(QIODevice::WriteOnly);
+			stream.setDevice(&buffer);
+			failed = !filter.openFilter();
+		}
+
+		/// Compresses the queued chunks in order, only one thread drains at a time.
+		void drain()
+		{
+			QMutexLocker locker(&mutex);
+			while (!queue.isEmpty())
+			{
+				QByteArray chunk = queue.takeFirst();
+				changed.wakeAll();
+				locker.unlock();
+				bool written = filter.writeData(chunk.constData(), chunk.size());
+				locker.relock();
+				failed |= !written;
+			}
+			running = false;
+			changed.wakeAll();
+		}
+	};
+
+	ContentSink::ContentSink(int chunkSize) :
+		m_chunkSize(qMax(1024, chunkSize))
+	{
+	}
+
+	ContentSink::~ContentSink()
+	{
+		if (!m_compressor)
+			return;
+		// a running drain keeps the compressor alive, it only has to finish its chunks
+		QMutexLocker locker(&m_compressor->mutex);
+		m_compressor->queue.clear();
+	}
+
+	void ContentSink::begin(bool compress)
+	{
+		if (m_compressor)
+		{
+			QMutexLocker locker(&m_compressor->mutex);
+			m_compressor->queue.clear();
+		}
+		m_compressor.reset();
+		m_size = 0;
+		m_failed = false;
+		m_chunk = QByteArray();
+		if (compress)
+		{
+			m_compressor = std::make_shared<Compressor>();
+			m_chunk.reserve(m_chunkSize + 64);
+		}
+	}
+
+	void ContentSink::write(const QByteArray& bytes)
+	{
+		write(bytes.constData(), bytes.size());
+	}
+
+	void ContentSink::write(const char* data, int length)
+	{
+		m_size += length;
+		if (!m_compressor)
+		{
+			m_chunk.append(data, length);
+			return;
+		}
+		while (m_chunk.size() + length >= m_chunkSize)
+		{
+			int part = m_chunkSize - m_chunk.size();
+			m_chunk.append(data, part);
+			data += part;
+			length -= part;
+			queueChunk();
+		}
+		m_chunk.append(data, length);
+	}
+
+	void ContentSink::writeNumber(double v, int decimals)
+	{
+		int oldSize = m_chunk.size();
+		appendNumber(m_chunk, v, decimals);
+		m_size += m_chunk.size() - oldSize;
+		if (m_compressor && (m_chunk.size() >= m_chunkSize))
+			queueChunk();
+	}
+
+	QByteArray ContentSink::finish()
+	{
+		if (!m_compressor)
+		{
+			QByteArray result = m_chunk;
+			m_chunk = QByteArray();
+			m_size = 0;
+			return result;
+		}
+		if (!m_chunk.isEmpty())
+			queueChunk();
+		std::shared_ptr<Compressor> compressor = m_compressor;
+		m_compressor.reset();
+		m_chunk = QByteArray();
+		m_size = 0;
+
+		QMutexLocker locker(&compressor->mutex);
+		while (compressor->running)
+			compressor->changed.wait(&compressor->mutex);
+		locker.unlock();
+		m_failed = !compressor->filter.closeFilter() || compressor->failed;
+		compressor->buffer.close();
+		if (m_failed)
+			return QByteArray();
+		return compressor->output;
+	}
+
+	void ContentSink::queueChunk()
+	{
+		std::shared_ptr<Compressor> compressor = m_compressor;
+		QMutexLocker locker(&compressor->mutex);
+		while (compressor->queue.count() >= maxQueuedChunks)
+			compressor->changed.wait(&compressor->mutex);
+		compressor->queue.append(m_chunk);
+		m_chunk = QByteArray();
+		m_chunk.reserve(m_chunkSize + 64);
+		if (compressor->running)
+			return;
+		compressor->running = true;
+		locker.unlock();
+		if (!QThreadPool::globalInstance()->tryStart([compressor]() { compressor->drain(); }))
+			compressor->drain();
+	}
+
+}
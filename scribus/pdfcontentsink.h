@@ -0,0 +1,68 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef PDFCONTENTSINK_H
+#define PDFCONTENTSINK_H
+
+#include <memory>
+
+#include <QByteArray>
+
+#include "scribusapi.h"
+
+namespace Pdf
+{
+
+/**
+ * Collects the operators of a content stream.
+ *
+ * Without compression the sink is a plain growing buffer. With compression the operators
+ * go into a chunk of fixed size, each filled chunk is handed to a ScFlateEncodeFilter running
+ * on the global thread pool while the next chunk is written, so a page with a huge content
+ * stream only ever holds its compressed data and a few chunks instead of the whole
+ * uncompressed content and a compressed copy of it.
+ */
+class SCRIBUS_API ContentSink
+{
+public:
+	explicit ContentSink(int chunkSize = 64 * 1024);
+	~ContentSink();
+
+	/// Starts a new content stream, dropping what was written so far.
+	void begin(bool compress);
+	void write(const QByteArray& bytes);
+	void write(const char* data, int length);
+	/// Writes @a v as Pdf::appendNumber() does, straight into the current chunk.
+	void writeNumber(double v, int decimals = 5);
+	/**
+	 * Completes the content stream.
+	 * @return the content, Flate compressed when begin() asked for it, or an empty array if compressing failed
+	 */
+	QByteArray finish();
+	/// Tells if the last finish() failed to compress the content.
+	bool failed() const { return m_failed; }
+
+	bool compresses() const { return m_compressor != nullptr; }
+	/// Number of uncompressed bytes written since begin().
+	qint64 size() const { return m_size; }
+
+	ContentSink& operator<<(const QByteArray& bytes) { write(bytes); return *this; }
+
+private:
+	struct Compressor;
+
+	int m_chunkSize { 0 };
+	qint64 m_size { 0 };
+	bool m_failed { false };
+	QByteArray m_chunk;
+	std::shared_ptr<Compressor> m_compressor;
+
+	void queueChunk();
+};
+
+}
+
+#endif
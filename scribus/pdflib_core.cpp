@@ -53,8 +53,10 @@ for which a new license (GPL+exception) is in place.
 #include <QRect>
 #include <QRegularExpression>
 #include <QScopedPointer>
+#include <QSet>
 #include <QStack>
 #include <QString>
+#include <QStringList>
 #include <QTemporaryFile>
 #include <QTextCodec>
 #include <QUuid>
@@ -72,6 +74,7 @@ for which a new license (GPL+exception) is in place.
 #include "scfonts.h"
 #include "text/textlayoutpainter.h"
 #include "fonts/cff.h"
+#include "fonts/scfontsubsetcache.h"
 #include "fonts/sfnt.h"
 #include "scpage.h"
 #include "scpaths.h"
@@ -104,10 +107,16 @@ using namespace TableUtils;
 
 static inline QByteArray FToStr(double c)
 {
-	double v = c;
-	if (fabs(c) < 0.0000001)
-		v = 0.0;
-	return QByteArray::number(v, 'f', 5);
+	QByteArray result;
+	Pdf::appendNumber(result, c, 5);
+	return result;
+}
+
+static inline void appendCoordinates(QByteArray& out, double x, double y)
+{
+	Pdf::appendNumber(out, x, 5);
+	out += ' ';
+	Pdf::appendNumber(out, y, 5);
 }
 
 static inline QByteArray TransformToStr(const QTransform& tr)
@@ -527,6 +536,7 @@ PDFLibCore::PDFLibCore(ScribusDoc & docu, const PDFOptions& options)
 	: QObject(&docu),
 	doc(docu),
 	Options(options),
+	imagePrefetcher(PrefsManager::instance().appPrefs.imageCachePrefs.memoryPoolSizeMiB),
 	usingGUI(ScCore->usingGUI())
 {
 	Catalog.Outlines = 2;
@@ -617,6 +627,7 @@ bool PDFLibCore::doExport(const QString& fn, const std::vector<int> & pageNs, co
 			progressDialog->setProgress("EMP", 0);
 			progressDialog->setProgress("EP", 0);
 		}
+		prefetchImages(pageNs);
 		for (int ap = 0; ap < doc.MasterPages.count() && !abortExport; ++ap)
 		{
 			if (doc.MasterItems.count() != 0)
@@ -651,7 +662,9 @@ bool PDFLibCore::doExport(const QString& fn, const std::vector<int> & pageNs, co
 			QApplication::processEvents();
 			if (abortExport) break;
 
-			PDF_End_Page();
+			if (!PDF_End_Page())
+				error = abortExport = true;
+			if (abortExport) break;
 			pc_exportpages++;
 			if (usingGUI)
 			{
@@ -903,6 +916,13 @@ bool PDFLibCore::PDF_Begin_Doc(const QString& fn, SCFonts &AllFonts, const QMap<
 {
 	if (!writer.open(fn))
 		return false;
+	// linearizing renumbers the objects, the encryption keys depend on the object numbers
+	bool linearize = Options.linearize && !Options.Encrypt;
+	writer.setLinearize(linearize);
+	// strings in object streams would need the encryption of the object stream
+	bool useObjectStreams = Options.useObjectStreams && Options.Compress && !Options.Encrypt && Options.Version.supportsObjectStreams();
+	// linearized files are written without object streams, the dialog disables them too
+	writer.setUseObjectStreams(!linearize && useObjectStreams);
 	
 	inPattern = 0;
 	Bvie = vi;
@@ -1647,7 +1667,8 @@ PdfId PDFLibCore::PDF_EmbedFontObject(const QByteArray& font, const QByteArray&
 		PutDoc("/Subtype " + subtype);
 	if (Options.Compress)
 		PutDoc("/Filter /FlateDecode\n");
-	PutDoc(">>\nstream\n");
+	PutDoc(">>\n");
+	writer.beginStream();
 	EncodeArrayToStream(ttf, embeddedFontObject);
 	PutDoc("\nendstream");
 	writer.endObj(embeddedFontObject);
@@ -2076,15 +2097,21 @@ static void dumpCFF(QString name, cff::CFF font)
 
 PdfFont PDFLibCore::PDF_WriteTtfSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs)
 {
-	QByteArray font;
-	face.rawData(font);
-	/*dumpFont(face.psName() + ".ttf", font);*/
 	QList<ScFace::gid_type> glyphs = usedGlyphs.keys();
 	glyphs.removeAll(0);
 	glyphs.prepend(0);
 
 	QMap<uint, uint> glyphMap;
-	QByteArray subset = sfnt::subsetFace(font, glyphs, glyphMap);
+	QByteArray subset;
+	QByteArray cacheKey = PDF_FindCachedSubset(face, "ttf", glyphs, glyphMap, subset);
+	if (subset.isEmpty())
+	{
+		QByteArray font;
+		face.rawData(font);
+		/*dumpFont(face.psName() + ".ttf", font);*/
+		subset = sfnt::subsetFace(font, glyphs, glyphMap);
+		PDF_CacheSubset(cacheKey, glyphs, glyphMap, subset);
+	}
 
 	/*dumpFont(face.psName() + "subs.ttf", subset);*/
 	QByteArray baseFont   = sanitizeFontName(face.psName());
@@ -2112,16 +2139,22 @@ PdfFont PDFLibCore::PDF_WriteCffSubsetFont(const QByteArray& fontName, ScFace& f
 //	PDF_WriteFontDescriptor(fontName, face, fformat, 0);
 //	// END
 	
-	QByteArray font, data;
-	face.rawData(data);
-	font = sfnt::getTable(data, "CFF ");
-	/*dumpFont(face.psName() + ".cff", font);*/
 	QList<ScFace::gid_type> glyphs = usedGlyphs.keys();
 	glyphs.removeAll(0);
 	glyphs.prepend(0);
 
 	QMap<uint, uint> glyphMap;
-	QByteArray subset = cff::subsetFace(font, glyphs, glyphMap);
+	QByteArray subset;
+	QByteArray cacheKey = PDF_FindCachedSubset(face, "cff", glyphs, glyphMap, subset);
+	if (subset.isEmpty())
+	{
+		QByteArray font, data;
+		face.rawData(data);
+		font = sfnt::getTable(data, "CFF ");
+		/*dumpFont(face.psName() + ".cff", font);*/
+		subset = cff::subsetFace(font, glyphs, glyphMap);
+		PDF_CacheSubset(cacheKey, glyphs, glyphMap, subset);
+	}
 	if (subset.isEmpty())
 	{
 		PdfFont result = PDF_WriteType3Font(fontName, face, usedGlyphs);
@@ -2141,14 +2174,20 @@ PdfFont PDFLibCore::PDF_WriteCffSubsetFont(const QByteArray& fontName, ScFace& f
 
 PdfFont PDFLibCore::PDF_WriteOpenTypeSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs)
 {
-	QByteArray data;
-	face.rawData(data);
 	QList<ScFace::gid_type> glyphs = usedGlyphs.keys();
 	glyphs.removeAll(0);
 	glyphs.prepend(0);
 
 	QMap<uint, uint> glyphMap;
-	QByteArray subset = sfnt::subsetFaceWithHB(data, glyphs, face.faceIndex(), glyphMap);
+	QByteArray subset;
+	QByteArray cacheKey = PDF_FindCachedSubset(face, "hb", glyphs, glyphMap, subset);
+	if (subset.isEmpty())
+	{
+		QByteArray data;
+		face.rawData(data);
+		subset = sfnt::subsetFaceWithHB(data, glyphs, face.faceIndex(), glyphMap);
+		PDF_CacheSubset(cacheKey, glyphs, glyphMap, subset);
+	}
 	if (subset.isEmpty())
 	{
 		PdfFont result = PDF_WriteType3Font(fontName, face, usedGlyphs);
@@ -2180,6 +2219,33 @@ PdfFont PDFLibCore::PDF_WriteOpenTypeSubsetFont(const QByteArray& fontName, ScFa
 	return result;
 }
 
+QByteArray PDFLibCore::PDF_FindCachedSubset(ScFace& face, const QByteArray& method, QList<uint>& glyphs, QMap<uint, uint>& glyphMap, QByteArray& subset)
+{
+	ScFontSubsetCache& subsetCache = ScFontSubsetCache::instance();
+	if (!subsetCache.enabled())
+		return QByteArray();
+	QByteArray cacheKey = ScFontSubsetCache::key(subsetCache.faceHash(face), face.faceIndex(), glyphs, method);
+	ScFontSubsetCache::Subset cached;
+	if (subsetCache.find(cacheKey, cached))
+	{
+		subset = cached.data;
+		glyphs = cached.glyphs;
+		glyphMap = cached.glyphMap;
+	}
+	return cacheKey;
+}
+
+void PDFLibCore::PDF_CacheSubset(const QByteArray& cacheKey, const QList<uint>& glyphs, const QMap<uint, uint>& glyphMap, const QByteArray& subset)
+{
+	if (cacheKey.isEmpty() || subset.isEmpty())
+		return;
+	ScFontSubsetCache::Subset entry;
+	entry.data = subset;
+	entry.glyphs = glyphs;
+	entry.glyphMap = glyphMap;
+	ScFontSubsetCache::instance().insert(cacheKey, entry);
+}
+
 PdfId PDFLibCore::PDF_EmbedType1AsciiFontObject(const QByteArray& fon)
 {
 	QByteArray fon2;
@@ -2488,7 +2554,8 @@ void PDFLibCore::PDF_Begin_Colors()
 		}
 		PutDoc("/Length " + Pdf::toPdf(dataP.size() + 1) + "\n");
 		PutDoc("/N " + Pdf::toPdf(Options.SComp) + "\n");
-		PutDoc(">>\nstream\n");
+		PutDoc(">>\n");
+		writer.beginStream();
 		EncodeArrayToStream(dataP, iccProfileObject);
 		PutDoc("\nendstream");
 		writer.endObj(iccProfileObject);
@@ -2605,7 +2672,7 @@ bool PDFLibCore::PDF_TemplatePage(const ScPage* pag, bool)
 	ll.isPrintable = false;
 	ll.ID = 0;
 
-	Content.clear();
+	Content.begin(Options.Compress);
 
 	double bLeft, bRight, bBottom, bTop;
 	getBleeds(pag, bLeft, bRight, bBottom, bTop);
@@ -2623,7 +2690,7 @@ bool PDFLibCore::PDF_TemplatePage(const ScPage* pag, bool)
 			PutPage("/OC /" + OCGEntries[ll.Name].Name + " BDC\n");
 		for (int a = 0; a < PItems.count(); ++a)
 		{
-			Content.clear();
+			Content.begin(Options.Compress);
 			ite = PItems.at(a);
 			if (ite->m_layerID != ll.ID)
 				continue;
@@ -2664,7 +2731,8 @@ bool PDFLibCore::PDF_TemplatePage(const ScPage* pag, bool)
 				PutPage(putColor(ite->fillColor(), ite->fillShade(), true));
 			if (ite->lineColor() != CommonStrings::None)
 				PutPage(putColor(ite->lineColor(), ite->lineShade(), false));
-			Content += FToStr(fabs(ite->lineWidth())) + " w\n";
+			Content.writeNumber(fabs(ite->lineWidth()));
+			PutPage(" w\n");
 			if (ite->DashValues.count() != 0)
 			{
 				PutPage("[ ");
@@ -3265,12 +3333,16 @@ bool PDFLibCore::PDF_TemplatePage(const ScPage* pag, bool)
 			writer.write("/Resources ");
 			writer.write(dict);
 				
-			if (Options.Compress)
-				Content = CompressArray(Content);
-			PutDoc("/Length " + Pdf::toPdf(Content.length() + 1));
+			QByteArray content = Content.finish();
+			if (Content.failed())
+			{
+				PDF_Error( tr("Failed to compress the content of a page") );
+				return false;
+			}
+			PutDoc("/Length " + Pdf::toPdf(content.length() + 1));
 			if (Options.Compress)
 				PutDoc("\n/Filter /FlateDecode");
-			PutDoc(" >>\nstream\n" + EncStream(Content, templateObject) + "\nendstream");
+			PutDoc(" >>\nstream\n" + EncStream(content, templateObject) + "\nendstream");
 			writer.endObj(templateObject);
 				
 			int pIndex = doc.MasterPages.indexOf((ScPage* const) pag) + 1;
@@ -3290,7 +3362,7 @@ bool PDFLibCore::PDF_TemplatePage(const ScPage* pag, bool)
 void PDFLibCore::PDF_Begin_Page(const ScPage* pag, const QImage& thumb)
 {
 	ActPageP = pag;
-	Content.clear();
+	Content.begin(Options.Compress);
 	pageData.AObjects.clear();
 	pageData.radioButtonList.clear();
 	pageData.radioButtonGroups.clear();
@@ -3317,7 +3389,8 @@ void PDFLibCore::PDF_Begin_Page(const ScPage* pag, const QImage& thumb)
 		PutDoc("/Length " + Pdf::toPdf(array.size() + 1) + "\n");
 		if (Options.Compress && compDataAvail)
 			PutDoc("/Filter /FlateDecode\n");
-		PutDoc(">>\nstream\n");
+		PutDoc(">>\n");
+		writer.beginStream();
 		EncodeArrayToStream(array, thumbnail);
 		PutDoc("\nendstream");
 		writer.endObj(thumbnail);
@@ -3325,7 +3398,7 @@ void PDFLibCore::PDF_Begin_Page(const ScPage* pag, const QImage& thumb)
 	}
 }
 
-void PDFLibCore::PDF_End_Page()
+bool PDFLibCore::PDF_End_Page()
 {
 	if (!pageData.radioButtonList.isEmpty())
 		PDF_RadioButtonGroups();
@@ -3519,7 +3592,20 @@ void PDFLibCore::PDF_End_Page()
 			PutPage("Q\n");
 		}
 	}
-	pageData.ObjNum = WritePDFStream(Content);
+	// the sink compressed the content on worker threads while the page was processed
+	QByteArray content = Content.finish();
+	if (Content.failed())
+	{
+		PDF_Error( tr("Failed to compress the content of a page") );
+		return false;
+	}
+	pageData.ObjNum = writer.newObject();
+	writer.startObj(pageData.ObjNum);
+	PutDoc("<< /Length " + Pdf::toPdf(content.length()));
+	if (Options.Compress)
+		PutDoc("\n/Filter /FlateDecode");
+	PutDoc(" >>");
+	writer.endObjectWithStream(Options.Encrypt, pageData.ObjNum, content);
 	int Gobj = 0;
 	if (Options.supportsTransparency())
 	{
@@ -3714,6 +3800,7 @@ void PDFLibCore::PDF_End_Page()
 	writer.endObj(pageObject);
 	PageTree.Kids.append(pageObject);
 	PageTree.KidsMap[ActPageP->pageNr()] = pageObject;
+	return true;
 }
 
 
@@ -3722,7 +3809,8 @@ void PDFLibCore::writeXObject(uint objNr, const QByteArray& dictionary, const QB
 	writer.startObj(objNr);
 	PutDoc("<<");
 	PutDoc(dictionary);
-	PutDoc(">>\nstream\n");
+	PutDoc(">>\n");
+	writer.beginStream();
 	EncodeArrayToStream(stream, objNr);
 	PutDoc("\nendstream");
 	writer.endObj(objNr);
@@ -4218,7 +4306,8 @@ QByteArray PDFLibCore::PDF_PutSoftShadow(PageItem* ite)
 	uint lengthObj = writer.newObject();
 	PutDoc("/Length " + Pdf::toPdf(lengthObj) + " 0 R\n");
 	PutDoc("/Filter /FlateDecode\n");
-	PutDoc(">>\nstream\n");
+	PutDoc(">>\n");
+	writer.beginStream();
 	int bytesWritten = WriteFlateImageToStream(img, maskObj, ColorSpaceGray, false);
 	PutDoc("\nendstream");
 	writer.endObj(maskObj);
@@ -5964,6 +6053,48 @@ QByteArray PDFLibCore::SetGradientColor(const QString& farbe, double Shade)
 	return tmp;
 }
 
+/// Same as SetGradientColor() for many colors, converting all of them with one transform call.
+QStringList PDFLibCore::SetGradientColors(const QStringList& colorNames, const QList<int>& shades)
+{
+	QStringList result;
+	result.reserve(colorNames.count());
+	QList<int> indexes;
+	QList<ScColor> colors;
+	QList<double> levels;
+	for (int i = 0; i < colorNames.count(); ++i)
+	{
+		const QString& colorName = colorNames.at(i);
+		if (Options.isGrayscale || (colorName == CommonStrings::None))
+		{
+			result.append(SetGradientColor(colorName, shades.value(i, 100)));
+			continue;
+		}
+		result.append(QString());
+		indexes.append(i);
+		colors.append(doc.PageColors[colorName]);
+		levels.append(shades.value(i, 100));
+	}
+	if (indexes.isEmpty())
+		return result;
+
+	bool useRGB = Options.UseRGB || (doc.HasCMS && Options.UseProfiles && (Options.SComp == 3));
+	if (useRGB)
+	{
+		QList<RGBColorF> rgb;
+		ScColorEngine::getShadeColorsRGB(colors, levels, &doc, rgb);
+		for (int i = 0; i < indexes.count(); ++i)
+			result[indexes.at(i)] = FToStr(rgb.at(i).r) + " " + FToStr(rgb.at(i).g) + " " + FToStr(rgb.at(i).b);
+	}
+	else
+	{
+		QList<CMYKColorF> cmyk;
+		ScColorEngine::getShadeColorsCMYK(colors, levels, &doc, cmyk);
+		for (int i = 0; i < indexes.count(); ++i)
+			result[indexes.at(i)] = FToStr(cmyk.at(i).c) + " " + FToStr(cmyk.at(i).m) + " " + FToStr(cmyk.at(i).y) + " " + FToStr(cmyk.at(i).k);
+	}
+	return result;
+}
+
 QByteArray PDFLibCore::SetClipPath(const PageItem *ite, bool poly) const
 {
 	QByteArray tmp;
@@ -5972,6 +6103,8 @@ QByteArray PDFLibCore::SetClipPath(const PageItem *ite, bool poly) const
 	bool first = true;
 	if (ite->PoLine.size() <= 3)
 		return tmp;
+	// about 50 bytes for a curve segment of 4 points
+	tmp.reserve(ite->PoLine.size() * 13);
 
 	for (int poi = 0; poi < ite->PoLine.size() - 3; poi += 4)
 	{
@@ -5985,7 +6118,8 @@ QByteArray PDFLibCore::SetClipPath(const PageItem *ite, bool poly) const
 			np = ite->PoLine.point(poi);
 			if (!first && poly && (np4 == firstP))
 				tmp += "h\n";
-			tmp += FToStr(np.x()) + " " + FToStr(-np.y()) + " m\n";
+			appendCoordinates(tmp, np.x(), -np.y());
+			tmp += " m\n";
 			nPath = false;
 			first = false;
 			firstP = np;
@@ -5996,12 +6130,18 @@ QByteArray PDFLibCore::SetClipPath(const PageItem *ite, bool poly) const
 		np2 = ite->PoLine.point(poi + 3);
 		np3 = ite->PoLine.point(poi + 2);
 		if ((np == np1) && (np2 == np3))
-			tmp += FToStr(np3.x()) + " " + FToStr(-np3.y()) + " l\n";
+		{
+			appendCoordinates(tmp, np3.x(), -np3.y());
+			tmp += " l\n";
+		}
 		else
 		{
-			tmp += FToStr(np1.x()) + " " + FToStr(-np1.y()) + " ";
-			tmp += FToStr(np2.x()) + " " + FToStr(-np2.y()) + " ";
-			tmp += FToStr(np3.x()) + " " + FToStr(-np3.y()) + " c\n";
+			appendCoordinates(tmp, np1.x(), -np1.y());
+			tmp += ' ';
+			appendCoordinates(tmp, np2.x(), -np2.y());
+			tmp += ' ';
+			appendCoordinates(tmp, np3.x(), -np3.y());
+			tmp += " c\n";
 		}
 		np4 = np3;
 	}
@@ -6016,6 +6156,7 @@ QByteArray PDFLibCore::SetClipPathArray(const FPointArray *ite, bool poly) const
 	bool first = true;
 	if (ite->size() <= 3)
 		return tmp;
+	tmp.reserve(ite->size() * 13);
 
 	for (int poi = 0; poi < ite->size() - 3; poi += 4)
 	{
@@ -6029,7 +6170,8 @@ QByteArray PDFLibCore::SetClipPathArray(const FPointArray *ite, bool poly) const
 			np = ite->point(poi);
 			if (!first && poly && (np4 == firstP))
 				tmp += "h\n";
-			tmp += FToStr(np.x()) + " " + FToStr(-np.y()) + " m\n";
+			appendCoordinates(tmp, np.x(), -np.y());
+			tmp += " m\n";
 			nPath = false;
 			first = false;
 			firstP = np;
@@ -6040,12 +6182,18 @@ QByteArray PDFLibCore::SetClipPathArray(const FPointArray *ite, bool poly) const
 		np2 = ite->point(poi + 3);
 		np3 = ite->point(poi + 2);
 		if ((np == np1) && (np2 == np3))
-			tmp += FToStr(np3.x()) + " " + FToStr(-np3.y()) + " l\n";
+		{
+			appendCoordinates(tmp, np3.x(), -np3.y());
+			tmp += " l\n";
+		}
 		else
 		{
-			tmp += FToStr(np1.x()) + " " + FToStr(-np1.y()) + " ";
-			tmp += FToStr(np2.x()) + " " + FToStr(-np2.y()) + " ";
-			tmp += FToStr(np3.x()) + " " + FToStr(-np3.y()) + " c\n";
+			appendCoordinates(tmp, np1.x(), -np1.y());
+			tmp += ' ';
+			appendCoordinates(tmp, np2.x(), -np2.y());
+			tmp += ' ';
+			appendCoordinates(tmp, np3.x(), -np3.y());
+			tmp += " c\n";
 		}
 		np4 = np3;
 	}
@@ -6071,7 +6219,8 @@ QByteArray PDFLibCore::SetClipPathImage(const PageItem *ite) const
 		if (nPath)
 		{
 			np = ite->imageClip.point(poi);
-			tmp += FToStr(np.x()) + " " + FToStr(-np.y()) + " m\n";
+			appendCoordinates(tmp, np.x(), -np.y());
+			tmp += " m\n";
 			nPath = false;
 		}
 		np = ite->imageClip.point(poi);
@@ -6079,12 +6228,18 @@ QByteArray PDFLibCore::SetClipPathImage(const PageItem *ite) const
 		np2 = ite->imageClip.point(poi + 3);
 		np3 = ite->imageClip.point(poi + 2);
 		if ((np == np1) && (np2 == np3))
-			tmp += FToStr(np3.x()) + " " + FToStr(-np3.y()) + " l\n";
+		{
+			appendCoordinates(tmp, np3.x(), -np3.y());
+			tmp += " l\n";
+		}
 		else
 		{
-			tmp += FToStr(np1.x()) + " " + FToStr(-np1.y()) + " ";
-			tmp += FToStr(np2.x()) + " " + FToStr(-np2.y()) + " ";
-			tmp += FToStr(np3.x()) + " " + FToStr(-np3.y()) + " c\n";
+			appendCoordinates(tmp, np1.x(), -np1.y());
+			tmp += ' ';
+			appendCoordinates(tmp, np2.x(), -np2.y());
+			tmp += ' ';
+			appendCoordinates(tmp, np3.x(), -np3.y());
+			tmp += " c\n";
 		}
 	}
 	return tmp;
@@ -6730,7 +6885,7 @@ quint16 PDFLibCore::encode16dVal(double val) const
 	return m;
 }
 
-void PDFLibCore::encodeColor(QDataStream &vs, const QString& colName, int colShade, const QStringList &spotColorSet, bool spotMode)
+void PDFLibCore::encodeColor(QDataStream &vs, const QString& colName, int colShade, const QString& colValue, const QStringList &spotColorSet, bool spotMode)
 {
 	if (spotMode)
 	{
@@ -6747,7 +6902,7 @@ void PDFLibCore::encodeColor(QDataStream &vs, const QString& colName, int colSha
 		}
 		else
 		{
-			QList<QByteArray> gcol = SetGradientColor(colName, colShade).split(' ');
+			QStringList gcol = colValue.split(' ');
 			for (int gcs = 0; gcs < gcol.count(); gcs++)
 			{
 				vs << encode16dVal(gcol[gcs].toDouble());
@@ -6760,7 +6915,7 @@ void PDFLibCore::encodeColor(QDataStream &vs, const QString& colName, int colSha
 	}
 	else
 	{
-		QList<QByteArray> gcol = SetGradientColor(colName, colShade).split(' ');
+		QStringList gcol = colValue.split(' ');
 		for (int gcs = 0; gcs < gcol.count(); gcs++)
 		{
 			vs << encode16dVal(gcol[gcs].toDouble());
@@ -6806,9 +6961,9 @@ bool PDFLibCore::PDF_MeshGradientFill(QByteArray& output, const PageItem *c)
 				if (!spotColorSet.contains(mp1.colorName))
 					spotColorSet.append(mp1.colorName);
 			}
-			Gcolors.append(SetGradientColor(mp1.colorName, mp1.shade));
 		}
 	}
+	Gcolors = SetGradientColors(colorNames, colorShades);
 	QByteArray TRes;
 	if (Options.supportsTransparency() && transparencyFound)
 	{
@@ -6973,10 +7128,10 @@ bool PDFLibCore::PDF_MeshGradientFill(QByteArray& output, const PageItem *c)
 			vs << encode32dVal(mp1.controlColor.x()) << encode32dVal(-mp1.controlColor.y());
 			vs << encode32dVal(mp2.controlColor.x()) << encode32dVal(-mp2.controlColor.y());
 			vs << encode32dVal(mp3.controlColor.x()) << encode32dVal(-mp3.controlColor.y());
-			encodeColor(vs, colorNames[colInd4], colorShades[colInd4], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[colInd1], colorShades[colInd1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[colInd2], colorShades[colInd2], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[colInd3], colorShades[colInd3], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[colInd4], colorShades[colInd4], Gcolors[colInd4], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[colInd1], colorShades[colInd1], Gcolors[colInd1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[colInd2], colorShades[colInd2], Gcolors[colInd2], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[colInd3], colorShades[colInd3], Gcolors[colInd3], spotColorSet, spotMode);
 		}
 	}
 	PutDoc("/Decode [-40000 40000 -40000 40000 " + entx + "]\n");
@@ -7099,7 +7254,6 @@ bool PDFLibCore::PDF_PatchMeshGradientFill(QByteArray& output, const PageItem *c
 			if (!spotColorSet.contains(mp1.colorName))
 				spotColorSet.append(mp1.colorName);
 		}
-		Gcolors.append(SetGradientColor(mp1.colorName, mp1.shade));
 		MeshPoint mp2 = patch.TR;
 		colorNames.append(mp2.colorName);
 		colorShades.append(mp2.shade);
@@ -7111,7 +7265,6 @@ bool PDFLibCore::PDF_PatchMeshGradientFill(QByteArray& output, const PageItem *c
 			if (!spotColorSet.contains(mp2.colorName))
 				spotColorSet.append(mp2.colorName);
 		}
-		Gcolors.append(SetGradientColor(mp2.colorName, mp2.shade));
 		MeshPoint mp3 = patch.BR;
 		colorNames.append(mp3.colorName);
 		colorShades.append(mp3.shade);
@@ -7123,7 +7276,6 @@ bool PDFLibCore::PDF_PatchMeshGradientFill(QByteArray& output, const PageItem *c
 			if (!spotColorSet.contains(mp3.colorName))
 				spotColorSet.append(mp3.colorName);
 		}
-		Gcolors.append(SetGradientColor(mp3.colorName, mp3.shade));
 		MeshPoint mp4 = patch.BL;
 		colorNames.append(mp4.colorName);
 		colorShades.append(mp4.shade);
@@ -7135,8 +7287,8 @@ bool PDFLibCore::PDF_PatchMeshGradientFill(QByteArray& output, const PageItem *c
 			if (!spotColorSet.contains(mp4.colorName))
 				spotColorSet.append(mp4.colorName);
 		}
-		Gcolors.append(SetGradientColor(mp4.colorName, mp4.shade));
 	}
+	Gcolors = SetGradientColors(colorNames, colorShades);
 	QByteArray TRes("");
 	if (Options.supportsTransparency() && transparencyFound)
 	{
@@ -7297,10 +7449,10 @@ bool PDFLibCore::PDF_PatchMeshGradientFill(QByteArray& output, const PageItem *c
 		vs << encode32dVal(mp1.controlColor.x()) << encode32dVal(-mp1.controlColor.y());
 		vs << encode32dVal(mp2.controlColor.x()) << encode32dVal(-mp2.controlColor.y());
 		vs << encode32dVal(mp3.controlColor.x()) << encode32dVal(-mp3.controlColor.y());
-		encodeColor(vs, colorNames[colInd4], colorShades[colInd4], spotColorSet, spotMode);
-		encodeColor(vs, colorNames[colInd1], colorShades[colInd1], spotColorSet, spotMode);
-		encodeColor(vs, colorNames[colInd2], colorShades[colInd2], spotColorSet, spotMode);
-		encodeColor(vs, colorNames[colInd3], colorShades[colInd3], spotColorSet, spotMode);
+		encodeColor(vs, colorNames[colInd4], colorShades[colInd4], Gcolors[colInd4], spotColorSet, spotMode);
+		encodeColor(vs, colorNames[colInd1], colorShades[colInd1], Gcolors[colInd1], spotColorSet, spotMode);
+		encodeColor(vs, colorNames[colInd2], colorShades[colInd2], Gcolors[colInd2], spotColorSet, spotMode);
+		encodeColor(vs, colorNames[colInd3], colorShades[colInd3], Gcolors[colInd3], spotColorSet, spotMode);
 	}
 	PutDoc("/Decode [-40000 40000 -40000 40000 " + entx + "]\n");
 	QByteArray dat;
@@ -7425,7 +7577,6 @@ bool PDFLibCore::PDF_DiamondGradientFill(QByteArray& output, const PageItem *c)
 				if (!spotColorSet.contains(cstops.at(cst)->name))
 					spotColorSet.append(cstops.at(cst)->name);
 			}
-			Gcolors.append(SetGradientColor(cstops.at(cst)->name, cstops.at(cst)->shade));
 		}
 		StopVec.append(actualStop);
 		colorNames.append(cstops.at(cst)->name);
@@ -7438,8 +7589,8 @@ bool PDFLibCore::PDF_DiamondGradientFill(QByteArray& output, const PageItem *c)
 			if (!spotColorSet.contains(cstops.at(cst)->name))
 				spotColorSet.append(cstops.at(cst)->name);
 		}
-		Gcolors.append(SetGradientColor(cstops.at(cst)->name, cstops.at(cst)->shade));
 	}
+	Gcolors = SetGradientColors(colorNames, colorShades);
 	QPointF cP(c->GrControl5.x(), -c->GrControl5.y());
 	QLineF edge1(cP, QPointF(c->GrControl1.x(), -c->GrControl1.y()));
 	QLineF edge2(cP, QPointF(c->GrControl2.x(), -c->GrControl2.y()));
@@ -7663,37 +7814,37 @@ bool PDFLibCore::PDF_DiamondGradientFill(QByteArray& output, const PageItem *c)
 			vs << encode32dVal(e1.x2()) << encode32dVal(e1.y2()) << encode32dVal(e1.x2()) << encode32dVal(e1.y2()) << encode32dVal(e2.x2()) << encode32dVal(e2.y2());
 			vs << encode32dVal(e2.x2()) << encode32dVal(e2.y2()) << encode32dVal(e2.x2()) << encode32dVal(e2.y2()) << encode32dVal(cP.x()) << encode32dVal(cP.y());
 			vs << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y());
-			encodeColor(vs, colorNames[0], colorShades[0], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[1], colorShades[1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[1], colorShades[1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[0], colorShades[0], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[0], colorShades[0], Gcolors[0], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[1], colorShades[1], Gcolors[1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[1], colorShades[1], Gcolors[1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[0], colorShades[0], Gcolors[0], spotColorSet, spotMode);
 			vs << flg;
 			vs << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y());
 			vs << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(e2.x2()) << encode32dVal(e2.y2());
 			vs << encode32dVal(e2.x2()) << encode32dVal(e2.y2()) << encode32dVal(e2.x2()) << encode32dVal(e2.y2()) << encode32dVal(e3.x2()) << encode32dVal(e3.y2());
 			vs << encode32dVal(e3.x2()) << encode32dVal(e3.y2()) << encode32dVal(e3.x2()) << encode32dVal(e3.y2()) << encode32dVal(cP.x()) << encode32dVal(cP.y());
-			encodeColor(vs, colorNames[0], colorShades[0], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[0], colorShades[0], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[1], colorShades[1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[1], colorShades[1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[0], colorShades[0], Gcolors[0], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[0], colorShades[0], Gcolors[0], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[1], colorShades[1], Gcolors[1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[1], colorShades[1], Gcolors[1], spotColorSet, spotMode);
 			vs << flg;
 			vs << encode32dVal(e4.x2()) << encode32dVal(e4.y2()) << encode32dVal(e4.x2()) << encode32dVal(e4.y2()) << encode32dVal(cP.x()) << encode32dVal(cP.y());
 			vs << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y());
 			vs << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(e3.x2()) << encode32dVal(e3.y2());
 			vs << encode32dVal(e3.x2()) << encode32dVal(e3.y2()) << encode32dVal(e3.x2()) << encode32dVal(e3.y2()) << encode32dVal(e4.x2()) << encode32dVal(e4.y2());
-			encodeColor(vs, colorNames[1], colorShades[1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[0], colorShades[0], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[0], colorShades[0], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[1], colorShades[1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[1], colorShades[1], Gcolors[1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[0], colorShades[0], Gcolors[0], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[0], colorShades[0], Gcolors[0], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[1], colorShades[1], Gcolors[1], spotColorSet, spotMode);
 			vs << flg;
 			vs << encode32dVal(e4.x2()) << encode32dVal(e4.y2()) << encode32dVal(e4.x2()) << encode32dVal(e4.y2()) << encode32dVal(e1.x2()) << encode32dVal(e1.y2());
 			vs << encode32dVal(e1.x2()) << encode32dVal(e1.y2()) << encode32dVal(e1.x2()) << encode32dVal(e1.y2()) << encode32dVal(cP.x()) << encode32dVal(cP.y());
 			vs << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y());
 			vs << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(cP.x()) << encode32dVal(cP.y()) << encode32dVal(e4.x2()) << encode32dVal(e4.y2());
-			encodeColor(vs, colorNames[1], colorShades[1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[1], colorShades[1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[0], colorShades[0], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[0], colorShades[0], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[1], colorShades[1], Gcolors[1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[1], colorShades[1], Gcolors[1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[0], colorShades[0], Gcolors[0], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[0], colorShades[0], Gcolors[0], spotColorSet, spotMode);
 		}
 		else
 		{
@@ -7702,37 +7853,37 @@ bool PDFLibCore::PDF_DiamondGradientFill(QByteArray& output, const PageItem *c)
 			vs << encode32dVal(e1.x2()) << encode32dVal(e1.y2()) << encode32dVal(e1.x2()) << encode32dVal(e1.y2()) << encode32dVal(e2.x2()) << encode32dVal(e2.y2());
 			vs << encode32dVal(e2.x2()) << encode32dVal(e2.y2()) << encode32dVal(e2.x2()) << encode32dVal(e2.y2()) << encode32dVal(e2s.x2()) << encode32dVal(e2s.y2());
 			vs << encode32dVal(e2s.x2()) << encode32dVal(e2s.y2()) << encode32dVal(e2s.x2()) << encode32dVal(e2s.y2()) << encode32dVal(e1s.x2()) << encode32dVal(e1s.y2());
-			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset], colorShades[offset], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset], colorShades[offset], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], Gcolors[offset-1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset], colorShades[offset], Gcolors[offset], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset], colorShades[offset], Gcolors[offset], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], Gcolors[offset-1], spotColorSet, spotMode);
 			vs << flg;
 			vs << encode32dVal(e3s.x2()) << encode32dVal(e3s.y2()) << encode32dVal(e3s.x2()) << encode32dVal(e3s.y2()) << encode32dVal(e2s.x2()) << encode32dVal(e2s.y2());
 			vs << encode32dVal(e2s.x2()) << encode32dVal(e2s.y2()) << encode32dVal(e2s.x2()) << encode32dVal(e2s.y2()) << encode32dVal(e2.x2()) << encode32dVal(e2.y2());
 			vs << encode32dVal(e2.x2()) << encode32dVal(e2.y2()) << encode32dVal(e2.x2()) << encode32dVal(e2.y2()) << encode32dVal(e3.x2()) << encode32dVal(e3.y2());
 			vs << encode32dVal(e3.x2()) << encode32dVal(e3.y2()) << encode32dVal(e3.x2()) << encode32dVal(e3.y2()) << encode32dVal(e3s.x2()) << encode32dVal(e3s.y2());
-			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset], colorShades[offset], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset], colorShades[offset], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], Gcolors[offset-1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], Gcolors[offset-1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset], colorShades[offset], Gcolors[offset], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset], colorShades[offset], Gcolors[offset], spotColorSet, spotMode);
 			vs << flg;
 			vs << encode32dVal(e4.x2()) << encode32dVal(e4.y2()) << encode32dVal(e4.x2()) << encode32dVal(e4.y2()) << encode32dVal(e4s.x2()) << encode32dVal(e4s.y2());
 			vs << encode32dVal(e4s.x2()) << encode32dVal(e4s.y2()) << encode32dVal(e4s.x2()) << encode32dVal(e4s.y2()) << encode32dVal(e3s.x2()) << encode32dVal(e3s.y2());
 			vs << encode32dVal(e3s.x2()) << encode32dVal(e3s.y2()) << encode32dVal(e3s.x2()) << encode32dVal(e3s.y2()) << encode32dVal(e3.x2()) << encode32dVal(e3.y2());
 			vs << encode32dVal(e3.x2()) << encode32dVal(e3.y2()) << encode32dVal(e3.x2()) << encode32dVal(e3.y2()) << encode32dVal(e4.x2()) << encode32dVal(e4.y2());
-			encodeColor(vs, colorNames[offset], colorShades[offset], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset], colorShades[offset], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset], colorShades[offset], Gcolors[offset], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], Gcolors[offset-1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], Gcolors[offset-1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset], colorShades[offset], Gcolors[offset], spotColorSet, spotMode);
 			vs << flg;
 			vs << encode32dVal(e4.x2()) << encode32dVal(e4.y2()) << encode32dVal(e4.x2()) << encode32dVal(e4.y2()) << encode32dVal(e1.x2()) << encode32dVal(e1.y2());
 			vs << encode32dVal(e1.x2()) << encode32dVal(e1.y2()) << encode32dVal(e1.x2()) << encode32dVal(e1.y2()) << encode32dVal(e1s.x2()) << encode32dVal(e1s.y2());
 			vs << encode32dVal(e1s.x2()) << encode32dVal(e1s.y2()) << encode32dVal(e1s.x2()) << encode32dVal(e1s.y2()) << encode32dVal(e4s.x2()) << encode32dVal(e4s.y2());
 			vs << encode32dVal(e4s.x2()) << encode32dVal(e4s.y2()) << encode32dVal(e4s.x2()) << encode32dVal(e4s.y2()) << encode32dVal(e4.x2()) << encode32dVal(e4.y2());
-			encodeColor(vs, colorNames[offset], colorShades[offset], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset], colorShades[offset], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], spotColorSet, spotMode);
-			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset], colorShades[offset], Gcolors[offset], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset], colorShades[offset], Gcolors[offset], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], Gcolors[offset-1], spotColorSet, spotMode);
+			encodeColor(vs, colorNames[offset-1], colorShades[offset-1], Gcolors[offset-1], spotColorSet, spotMode);
 		}
 	}
 	PutDoc("/Decode [-40000 40000 -40000 40000 " + entx + "]\n");
@@ -7861,8 +8012,8 @@ bool PDFLibCore::PDF_TensorGradientFill(QByteArray& output, const PageItem *c)
 			if (!spotColorSet.contains(colorNames.at(cst)))
 				spotColorSet.append(colorNames.at(cst));
 		}
-		Gcolors.append(SetGradientColor(colorNames.at(cst), colorShades[cst]));
 	}
+	Gcolors = SetGradientColors(colorNames, colorShades);
 	QByteArray TRes("");
 	if (Options.supportsTransparency() && transparencyFound)
 	{
@@ -8685,7 +8836,8 @@ bool PDFLibCore::PDF_3DAnnotation(PageItem *ite, uint)
 		}
 	}
 	PutDoc("/Length " + Pdf::toPdf(dataP.size() + 1) + "\n");
-	PutDoc(">>\nstream\n");
+	PutDoc(">>\n");
+	writer.beginStream();
 	EncodeArrayToStream(dataP, appearanceObj);
 	PutDoc("\nendstream");
 	writer.endObj(appearanceObj);
@@ -9929,7 +10081,8 @@ bool PDFLibCore::PDF_EmbeddedPDF(PageItem* c, const QString& fn, double sx, doub
 				PutDoc("\n/DecodeParms ");
 				copyPoDoFoDirect(nextObj, referencedObjects, importedObjects);
 			}
-			PutDoc("\n>>\nstream\n");
+			PutDoc("\n>>\n");
+			writer.beginStream();
 			{
 				QByteArray buffer = QByteArray::fromRawData(mbuffer, mlen);
 				EncodeArrayToStream(buffer, xObj);
@@ -10056,7 +10209,8 @@ bool PDFLibCore::PDF_EmbeddedPDF(PageItem* c, const QString& fn, double sx, doub
 			mbuffer = strBuffer.c_str();
 
 			PutDoc("\n/Length " + Pdf::toPdf(static_cast<qlonglong>(mlen)));
-			PutDoc("\n>>\nstream\n");
+			PutDoc("\n>>\n");
+			writer.beginStream();
 			{
 				QByteArray buffer = QByteArray::fromRawData(mbuffer, mlen);
 				EncodeArrayToStream(buffer, xObj);
@@ -10199,7 +10353,8 @@ bool PDFLibCore::PDF_EmbeddedPDF(PageItem* c, const QString& fn, double sx, doub
 				PutDoc("\n/DecodeParms ");
 				copyPoDoFoDirect(nextObj, referencedObjects, importedObjects);
 			}
-			PutDoc("\n>>\nstream\n");
+			PutDoc("\n>>\n");
+			writer.beginStream();
 			{
 				QByteArray buffer = QByteArray::fromRawData(mbuffer, mlen);
 				EncodeArrayToStream(buffer, xObj);
@@ -10325,7 +10480,8 @@ bool PDFLibCore::PDF_EmbeddedPDF(PageItem* c, const QString& fn, double sx, doub
 			mlen = outMemStream.GetLength();
 			mbuffer = outMemStream.TakeBuffer();
 			PutDoc("\n/Length " + Pdf::toPdf(static_cast<qlonglong>(mlen)));
-			PutDoc("\n>>\nstream\n");
+			PutDoc("\n>>\n");
+			writer.beginStream();
 			{
 				QByteArray buffer = QByteArray::fromRawData(mbuffer, mlen);
 				EncodeArrayToStream(buffer, xObj);
@@ -10510,7 +10666,8 @@ void PDFLibCore::copyPoDoFoObject(const PoDoFo::PdfObject* obj, PdfId scObjID, Q
 		size_t mlen = strBuff.size();
 		if (mbuffer[mlen - 1] == '\n')
 			--mlen;
-		PutDoc("\nstream\n");
+		PutDoc("\n");
+		writer.beginStream();
 		{
 			QByteArray buffer = QByteArray::fromRawData(mbuffer, mlen);
 			EncodeArrayToStream(buffer, scObjID);
@@ -10545,7 +10702,8 @@ void PDFLibCore::copyPoDoFoObject(const PoDoFo::PdfObject* obj, PdfId scObjID, Q
 		mbuffer = oStream.TakeBuffer();
 		if (mbuffer[mlen - 1] == '\n')
 			--mlen;
-		PutDoc("\nstream\n");
+		PutDoc("\n");
+		writer.beginStream();
 		{
 			QByteArray buffer = QByteArray::fromRawData(mbuffer, mlen);
 			EncodeArrayToStream(buffer, scObjID);
@@ -10583,6 +10741,139 @@ static ColorSpaceEnum getOutputType(const bool gray, const bool cmyk)
  * Add the image item to this.output
  * Returns false if the image can't be read or if it can't be added to this.output
 */
+void PDFLibCore::prefetchImages(const std::vector<int>& pageNs)
+{
+	// master pages are exported first, then the pages in the given order
+	QSet<QString> masterNames;
+	for (uint a = 0; a < pageNs.size(); ++a)
+		masterNames.insert(doc.DocPages.at(pageNs[a] - 1)->masterPageName());
+	QList<PageItem*> items;
+	for (int i = 0; i < doc.MasterItems.count(); ++i)
+	{
+		PageItem* item = doc.MasterItems.at(i);
+		if ((item->OwnPage >= 0) && (item->OwnPage < doc.MasterPages.count()) && masterNames.contains(doc.MasterPages.at(item->OwnPage)->pageName()))
+			items.append(item);
+	}
+	for (uint a = 0; a < pageNs.size(); ++a)
+	{
+		for (int i = 0; i < doc.DocItems.count(); ++i)
+		{
+			if (doc.DocItems.at(i)->OwnPage == pageNs[a] - 1)
+				items.append(doc.DocItems.at(i));
+		}
+	}
+
+	for (int i = 0; i < items.count(); ++i)
+	{
+		PageItem* item = items.at(i);
+		if (item->isGroup())
+		{
+			items.append(item->groupItemList);
+			continue;
+		}
+		if (!item->isImageFrame() || !item->imageIsAvailable || item->Pfile.isEmpty() || !item->printEnabled())
+			continue;
+		QString key = rasterImageKey(item, item->Pfile, item->imageXScale(), item->imageYScale(), item->ImageProfile, item->UseEmbedded, item->ImageIntent);
+		if (!key.isEmpty() && !imagePrefetcher.addUser(key, item))
+			imagePrefetcher.add(key, item, rasterImageDecoder(item, item->Pfile, item->imageXScale(), item->imageYScale(), item->ImageProfile, item->UseEmbedded, item->ImageIntent));
+	}
+	imagePrefetcher.start();
+}
+
+QString PDFLibCore::rasterImageKey(const PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const
+{
+	// only images going through the raster branch of PDF_Image() and loaded without requests
+	if (item->isLatexFrame() || item->pixm.imgInfo.isRequest || !item->pixm.imgInfo.RequestProps.isEmpty())
+		return QString();
+	QFileInfo fi(fn);
+	QString ext = fi.suffix().toLower();
+	if (ext.isEmpty())
+		ext = getImageType(fn);
+	if (extensionIndicatesPDF(ext) || (extensionIndicatesEPSorPS(ext) && (item->pixm.imgInfo.type != ImageType7)))
+		return QString();
+
+	QStringList keyParts;
+	keyParts << fn
+			 << QString::number(item->pixm.imgInfo.actualPageNumber)
+			 << QString::number(static_cast<int>(item->pixm.imgInfo.type == ImageType7))
+			 << QString::number(sx, 'g', 17)
+			 << QString::number(sy, 'g', 17)
+			 << QString::number(item->imageXScale(), 'g', 17)
+			 << QString::number(item->imageYScale(), 'g', 17)
+			 << (item->effectsInUse.isEmpty() ? QString() : item->getImageEffectsModifier())
+			 << Profil
+			 << QString::number(static_cast<int>(Embedded))
+			 << QString::number(static_cast<int>(Intent));
+	return keyParts.join(QChar('\n'));
+}
+
+ScImagePrefetcher::Decoder PDFLibCore::rasterImageDecoder(PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const
+{
+	// Options and doc may change while a prefetch worker runs the decoder, so it captures values only
+	CMSettings cms(item->doc(), Profil, Intent);
+	cms.setUseEmbeddedProfile(Embedded);
+	ScImage::RequestType requestType = ScImage::CMYKData;
+	if (Options.UseRGB)
+		requestType = ScImage::RGBData;
+	else if ((doc.HasCMS) && (Options.UseProfiles2))
+		requestType = ScImage::RawData;
+	else if (Options.isGrayscale)
+		requestType = ScImage::RGBData;
+	bool downsample = (Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / item->imageXScale(), 72.0 / item->imageYScale())));
+	double picRes = Options.PicRes;
+	ScImage::ScaleFilter scaleFilter = static_cast<ScImage::ScaleFilter>(qBound(0, Options.downsampleFilter, static_cast<int>(ScImage::LanczosFilter)));
+	int resolution = Options.Resolution;
+	bool pdfVer14 = Options.supportsTransparency();
+	bool cmykEffects = !((Options.UseRGB) || (Options.isGrayscale));
+	bool useProfiles = Options.UseProfiles2;
+	int page = item->pixm.imgInfo.actualPageNumber;
+	QMap<int, ImageLoadRequest> requestProps = item->pixm.imgInfo.RequestProps;
+	bool isRequest = item->pixm.imgInfo.isRequest;
+	bool loadMask = (item->pixm.imgInfo.type != ImageType7);
+	ScImageEffectList effects = item->effectsInUse;
+	ColorList colors;
+	if (!effects.isEmpty())
+		colors = doc.PageColors;
+
+	return [=](ScImagePrefetcher::DecodedImage& decoded) mutable
+	{
+		ScImage& img = decoded.image;
+		img.imgInfo.valid = false;
+		img.imgInfo.clipPath.clear();
+		img.imgInfo.PDSpathData.clear();
+		img.imgInfo.layerInfo.clear();
+		img.imgInfo.RequestProps = requestProps;
+		img.imgInfo.isRequest = isRequest;
+		decoded.loaded = img.loadPicture(fn, page, cms, requestType, 72, &decoded.realCMYK);
+		if (!decoded.loaded)
+			return;
+		if (downsample)
+		{
+			double a2 = (72.0 / sx) / picRes;
+			double a1 = (72.0 / sy) / picRes;
+			double ax = img.width() / a2;
+			double ay = img.height() / a1;
+			// #10510 : do not use scaled() here, may cause display problem
+			// with acrobat reader if image contains some transparency
+			img.scaleImage(qRound(ax), qRound(ay), scaleFilter);
+		}
+		if (loadMask)
+		{
+			ScImage img2;
+			img2.imgInfo.clipPath.clear();
+			img2.imgInfo.PDSpathData.clear();
+			img2.imgInfo.layerInfo.clear();
+			img2.imgInfo.RequestProps = requestProps;
+			img2.imgInfo.isRequest = isRequest;
+			decoded.maskLoaded = img2.getAlpha(fn, page, decoded.mask, true, pdfVer14, resolution, img.width(), img.height());
+			if (!decoded.maskLoaded)
+				return;
+		}
+		bool imgE = cmykEffects && !((useProfiles) && (img.imgInfo.colorspace != ColorSpaceCMYK));
+		img.applyEffect(effects, colors, imgE);
+	};
+}
+
 bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double sy, double x, double y, bool fromAN, const QString& Profil, bool Embedded, eRenderIntent Intent, QByteArray* output)
 {
 	QFileInfo fi(fn);
@@ -10667,6 +10958,8 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 		// no embedded PDF:
 		if (!imageLoaded)
 		{
+			ScImagePrefetcher::DecodedImage rasterImage;
+			bool rasterDecoded = false;
 			if ((extensionIndicatesPDF(ext) || extensionIndicatesEPSorPS(ext)) && (item->pixm.imgInfo.type != ImageType7))
 			{
 				ImInfo.isBitmapFromGS = true;
@@ -10759,45 +11052,24 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 			// not PS/PDF
 			else
 			{
-				img.imgInfo.valid = false;
-				img.imgInfo.clipPath.clear();
-				img.imgInfo.PDSpathData.clear();
-				img.imgInfo.layerInfo.clear();
-				img.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
-				img.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
-				CMSettings cms(item->doc(), Profil, Intent);
-				cms.setUseEmbeddedProfile(Embedded);
-				if (Options.UseRGB)
-					imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72, &realCMYK);
-				else
-				{
-					if ((doc.HasCMS) && (Options.UseProfiles2))
-						imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RawData, 72, &realCMYK);
-					else
-					{
-						if (Options.isGrayscale)
-							imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::RGBData, 72, &realCMYK);
-						else
-							imageLoaded = img.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, 72, &realCMYK);
-					}
-				}
+				// loaded, downsampled and with effects applied, usually by a worker thread ahead of the export
+				QString rasterKey = rasterImageKey(item, fn, sx, sy, Profil, Embedded, Intent);
+				if (rasterKey.isEmpty() || !imagePrefetcher.take(rasterKey, item, rasterImage))
+					rasterImageDecoder(item, fn, sx, sy, Profil, Embedded, Intent)(rasterImage);
+				rasterDecoded = true;
+				imageLoaded = rasterImage.loaded;
 				if (!imageLoaded)
 				{
 					PDF_Error_ImageLoadFailure(fn);
 					return false;
 				}
+				img = rasterImage.image;
+				realCMYK = rasterImage.realCMYK;
 				if ((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / item->imageXScale(), 72.0 / item->imageYScale()))))
 				{
 					double afl = Options.PicRes;
 					double a2 = (72.0 / sx) / afl;
 					double a1 = (72.0 / sy) / afl;
-					origWidth = img.width();
-					origHeight = img.height();
-					double ax = img.width() / a2;
-					double ay = img.height() / a1;
-					// #10510 : do not use scaled() here, may cause display problem 
-					// with acrobat reader if image contains some transparency
-					img.scaleImage(qRound(ax), qRound(ay));
 					ImInfo.sxa = sx * a2;
 					ImInfo.sya = sy * a1;
 				}
@@ -10874,7 +11146,8 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 						}
 						PutDoc("/Length " + Pdf::toPdf(dataP.size() + 1) + "\n");
 						PutDoc("/N " + Pdf::toPdf(components) + "\n");
-						PutDoc(">>\nstream\n");
+						PutDoc(">>\n");
+						writer.beginStream();
 						EncodeArrayToStream(dataP, embeddedProfile);
 						PutDoc("\nendstream");
 						writer.endObj(embeddedProfile);
@@ -10920,7 +11193,8 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 								}
 								PutDoc("/Length " + Pdf::toPdf(dataP.size() + 1) + "\n");
 								PutDoc("/N " + Pdf::toPdf(components) + "\n");
-								PutDoc(">>\nstream\n");
+								PutDoc(">>\n");
+								writer.beginStream();
 								EncodeArrayToStream(dataP, embeddedProfile);
 								PutDoc("\nendstream");
 								writer.endObj(embeddedProfile);
@@ -10954,7 +11228,13 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 			{
 				bool gotAlpha = false;
 				bool pdfVer14 = Options.supportsTransparency();
-				gotAlpha = img2.getAlpha(fn, item->pixm.imgInfo.actualPageNumber, im2, true, pdfVer14, afl, img.width(), img.height());
+				if (rasterDecoded)
+				{
+					im2 = rasterImage.mask;
+					gotAlpha = rasterImage.maskLoaded;
+				}
+				else
+					gotAlpha = img2.getAlpha(fn, item->pixm.imgInfo.actualPageNumber, im2, true, pdfVer14, afl, img.width(), img.height());
 				if (!gotAlpha)
 				{
 					PDF_Error_MaskLoadFailure(fn);
@@ -10969,7 +11249,8 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 				imgE = !((Options.UseProfiles2) && (img.imgInfo.colorspace != ColorSpaceCMYK));
 			origWidth = img.width();
 			origHeight = img.height();
-			img.applyEffect(item->effectsInUse, item->doc()->PageColors, imgE);
+			if (!rasterDecoded)
+				img.applyEffect(item->effectsInUse, item->doc()->PageColors, imgE);
 			if (!((Options.RecalcPic) && (Options.PicRes < (qMax(72.0 / item->imageXScale(), 72.0 / item->imageYScale())))))
 			{
 				ImInfo.sxa = sx * (1.0 / ImInfo.reso);
@@ -11008,7 +11289,8 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 				}
 				if ((Options.CompressMethod != PDFOptions::Compression_None) && compAlphaAvail)
 					PutDoc("/Filter /FlateDecode\n");
-				PutDoc(">>\nstream\n");
+				PutDoc(">>\n");
+				writer.beginStream();
 				EncodeArrayToStream(im2, maskObj);
 				PutDoc("\nendstream");
 				writer.endObj(maskObj);
@@ -11146,7 +11428,8 @@ bool PDFLibCore::PDF_Image(PageItem* item, const QString& fn, double sx, double
 				else
 					PutDoc("/Mask " + Pdf::toPdf(maskObj) + " 0 R\n");
 			}
-			PutDoc(">>\nstream\n");
+			PutDoc(">>\n");
+			writer.beginStream();
 			if (cm == PDFOptions::Compression_JPEG) // Fixme: should not do this with monochrome images?
 			{
 				int quality = item->OverrideCompressionQuality ? item->CompressionQualityIndex : Options.Quality;
@@ -11645,7 +11928,8 @@ bool PDFLibCore::PDF_End_OutputProfile(const QString& profilePath)
 	}
 	PutDoc("/Length " + Pdf::toPdf(dataP.size() + 1) + "\n");
 	PutDoc("/N " + Pdf::toPdf(components) + "\n");
-	PutDoc(">>\nstream\n");
+	PutDoc(">>\n");
+	writer.beginStream();
 	PutDoc(dataP);
 	PutDoc("\nendstream");
 	writer.endObj(profileObj);
@@ -11682,7 +11966,8 @@ void PDFLibCore::PDF_End_Metadata()
 		PutDoc("/Length " + Pdf::toPdf(xmpPacket.size() + 1) + "\n");
 		PutDoc("/Type /Metadata\n");
 		PutDoc("/Subtype /XML\n");
-		PutDoc(">>\nstream\n");
+		PutDoc(">>\n");
+		writer.beginStream();
 		PutDoc(xmpPacket);
 		PutDoc("\nendstream");
 		writer.endObj(writer.MetaDataObj);
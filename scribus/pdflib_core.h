@@ -30,7 +30,6 @@ class PDFOptions;
 class PrefsContext;
 class MultiProgressDialog;
 class ScLayer;
-class ScText;
 
 #include "pdfoptions.h"
 #include "pdfstructs.h"
@@ -42,7 +41,9 @@ class ScText;
 #include <podofo/podofo.h>
 #endif
 
+#include "pdfcontentsink.h"
 #include "pdfwriter.h"
+#include "scimageprefetcher.h"
 
 class PdfPainter;
 
@@ -150,6 +151,9 @@ private:
 	PdfFont PDF_WriteTtfSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs);
 	PdfFont PDF_WriteCffSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs);
 	PdfFont PDF_WriteOpenTypeSubsetFont(const QByteArray& fontName, ScFace& face, const QMap<uint, QString>& usedGlyphs);
+	/// Fills glyphs, glyphMap and subset from the font subset cache, returns the key for PDF_CacheSubset() or an empty key if the cache is off.
+	QByteArray PDF_FindCachedSubset(ScFace& face, const QByteArray& method, QList<uint>& glyphs, QMap<uint, uint>& glyphMap, QByteArray& subset);
+	void PDF_CacheSubset(const QByteArray& cacheKey, const QList<uint>& glyphs, const QMap<uint, uint>& glyphMap, const QByteArray& subset);
 	PdfFont PDF_EncodeSimpleFont(const QByteArray& fontname, ScFace& face,  const QByteArray& baseFont, const QByteArray& subtype, bool isEmbedded, PdfId fontDes, const QMap<uint, QString>& usedGlyphs);
 	PdfFont PDF_EncodeCidFont(const QByteArray& fontname, ScFace& face, const QByteArray& baseFont, PdfId fontDes, const QMap<uint, QString>& usedGlyphs, const QMap<uint, uint>& glyphmap);
 	PdfFont PDF_EncodeFormFont(const QByteArray& fontname, const ScFace& face,  const QByteArray& baseFont, const QByteArray& subtype, PdfId fontDes);
@@ -162,7 +166,7 @@ private:
 	void PDF_Begin_Layers();
 	
 	void PDF_Begin_Page(const ScPage* pag, const QImage& thumb);
-	void PDF_End_Page();
+	bool PDF_End_Page();
 	bool PDF_TemplatePage(const ScPage* pag, bool clip = false);
 	bool PDF_ProcessPage(const ScPage* pag, uint PNr, bool clip = false);
 	bool PDF_ProcessMasterElements(const ScLayer& layer, const ScPage* page, uint PNr);
@@ -216,6 +220,7 @@ private:
 	QByteArray SetColor(const QString& farbe, double Shade) const;
 	QByteArray SetColor(const ScColor& farbe, double Shade) const;
 	QByteArray SetGradientColor(const QString& farbe, double Shade);
+	QStringList SetGradientColors(const QStringList& colorNames, const QList<int>& shades);
 	QByteArray putColor(const QString& color, double Shade, bool fill);
 	QByteArray putColorUncached(const QString& color, int Shade, bool fill);
     QByteArray Write_FormXObject(QByteArray &data, const PageItem *controlItem = 0);
@@ -232,7 +237,7 @@ private:
 //	void PutDoc(const char* in) { outStream.writeRawData(in, strlen(in)); }
 //	void PutDoc(const std::string & in) { outStream.writeRawData(in.c_str(), in.length()); }
 
-	void       PutPage(const QByteArray & in) { Content += in; }
+	void       PutPage(const QByteArray & in) { Content.write(in); }
 //	uint       newObject() { return ObjCounter++; }
 	uint       WritePDFStream(const QByteArray& cc);
 	uint       WritePDFStream(const QByteArray& cc, PdfId objId);
@@ -265,6 +270,9 @@ private:
 	void    PDF_xForm(PdfId objNr, double w, double h, const QByteArray& im);
 	bool    PDF_Image(PageItem* c, const QString& fn, double sx, double sy, double x, double y, bool fromAN = false, const QString& Profil = "", bool Embedded = false, eRenderIntent Intent = Intent_Relative_Colorimetric, QByteArray* output = nullptr);
 	bool    PDF_EmbeddedPDF(PageItem* c, const QString& fn, double sx, double sy, double x, double y, ShIm& imgInfo, bool &fatalError);
+	void    prefetchImages(const std::vector<int>& pageNs);
+	QString rasterImageKey(const PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const;
+	ScImagePrefetcher::Decoder rasterImageDecoder(PageItem* item, const QString& fn, double sx, double sy, const QString& Profil, bool Embedded, eRenderIntent Intent) const;
 #if HAVE_PODOFO
 	void copyPoDoFoObject(const PoDoFo::PdfObject* obj, PdfId scObjID, QMap<PoDoFo::PdfReference, uint>& importedObjects);
 	void copyPoDoFoDirect(const PoDoFo::PdfObject* obj, QList<PoDoFo::PdfReference>& referencedObjects, QMap<PoDoFo::PdfReference, uint>& importedObjects);
@@ -272,7 +280,7 @@ private:
 
 	quint32 encode32dVal(double val) const;
 	quint16 encode16dVal(double val) const;
-	void    encodeColor(QDataStream &vs, const QString& colName, int colShade, const QStringList &spotColorSet, bool spotMode);
+	void    encodeColor(QDataStream &vs, const QString& colName, int colShade, const QString& colValue, const QStringList &spotColorSet, bool spotMode);
 
 	QByteArray drawArrow(PageItem *ite, QTransform &arrowTrans, int arrowIndex);
 	QByteArray createBorderAppearance(PageItem *ite);
@@ -289,7 +297,7 @@ private:
 	Pdf::Writer writer;
 	QString baseDir;
 	
-	QByteArray Content;
+	Pdf::ContentSink Content;
 	QString ErrorMessage;
 	ScribusDoc & doc;
 	const ScPage * ActPageP { nullptr };
@@ -297,6 +305,8 @@ private:
 	BookmarkView* Bvie { nullptr };
 	//int Dokument;
 	SharedImgRsrc SharedImages;
+	/// raster images of the exported pages decoded ahead on worker threads
+	ScImagePrefetcher imagePrefetcher;
 	QList<PdfDest> NamedDest;
 	QList<PdfId> CalcFields;
 	Pdf::ResourceMap Patterns;
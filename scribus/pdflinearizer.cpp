@@ -0,0 +1,637 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+#include <cstring>
+
+#include <QFile>
+#include <QSaveFile>
+#include <QSet>
+
+#include "pdflinearizer.h"
+#include "pdfwriter.h"
+#include "util.h"
+
+namespace Pdf
+{
+
+	namespace
+	{
+		// the hint tables store offsets and lengths in 32 bits, the fixed width numbers below have 10 digits
+		const qint64 maxFileSize = 0xF0000000LL;
+
+		struct Token
+		{
+			enum Type { Regular, Name, String, Open, Close };
+			Type type;
+			qint64 pos;
+			qint64 length;
+		};
+
+		/**
+		 Splits [begin, end) of @a data into tokens. Stops at the stream keyword and returns its
+		 position in @a streamPos, @a end if there is none.
+		 */
+		QList<Token> tokenize(const char* data, qint64 begin, qint64 end, qint64& streamPos)
+		{
+			QList<Token> tokens;
+			streamPos = end;
+			qint64 pos = begin;
+			while (pos < end)
+			{
+				char c = data[pos];
+				qint64 start = pos;
+				if (isWhiteSpace(c))
+				{
+					++pos;
+					continue;
+				}
+				if (c == '%')
+				{
+					while ((pos < end) && (data[pos] != '\n') && (data[pos] != '\r'))
+						++pos;
+					continue;
+				}
+				if (c == '(')
+				{
+					int depth = 0;
+					while (pos < end)
+					{
+						char s = data[pos++];
+						if (s == '\\')
+							++pos;
+						else if (s == '(')
+							++depth;
+						else if ((s == ')') && (--depth == 0))
+							break;
+					}
+					tokens.append({ Token::String, start, qMin(pos, end) - start });
+				}
+				else if ((c == '<') && (pos + 1 < end) && (data[pos + 1] == '<'))
+				{
+					pos += 2;
+					tokens.append({ Token::Open, start, 2 });
+				}
+				else if ((c == '>') && (pos + 1 < end) && (data[pos + 1] == '>'))
+				{
+					pos += 2;
+					tokens.append({ Token::Close, start, 2 });
+				}
+				else if (c == '<')
+				{
+					while ((pos < end) && (data[pos] != '>'))
+						++pos;
+					pos = qMin(pos + 1, end);
+					tokens.append({ Token::String, start, pos - start });
+				}
+				else if ((c == '[') || (c == '{'))
+				{
+					++pos;
+					tokens.append({ Token::Open, start, 1 });
+				}
+				else if ((c == ']') || (c == '}'))
+				{
+					++pos;
+					tokens.append({ Token::Close, start, 1 });
+				}
+				else if (c == '/')
+				{
+					++pos;
+					while ((pos < end) && isRegular(data[pos]))
+						++pos;
+					tokens.append({ Token::Name, start, pos - start });
+				}
+				else
+				{
+					++pos;
+					while ((pos < end) && isRegular(data[pos]))
+						++pos;
+					if ((pos - start == 6) && (memcmp(data + start, "stream", 6) == 0))
+					{
+						streamPos = start;
+						break;
+					}
+					tokens.append({ Token::Regular, start, pos - start });
+				}
+			}
+			return tokens;
+		}
+
+		bool isToken(const char* data, const Token& token, const char* text)
+		{
+			qint64 length = static_cast<qint64>(strlen(text));
+			return (token.length == length) && (memcmp(data + token.pos, text, length) == 0);
+		}
+
+		bool isNumber(const char* data, const Token& token)
+		{
+			if (token.type != Token::Regular)
+				return false;
+			for (qint64 i = 0; i < token.length; ++i)
+			{
+				if ((data[token.pos + i] < '0') || (data[token.pos + i] > '9'))
+					return false;
+			}
+			return true;
+		}
+
+		PdfId toNumber(const char* data, const Token& token)
+		{
+			return QByteArray(data + token.pos, token.length).toUInt();
+		}
+
+		/// Returns the index of the token following @a key in the outermost dictionary or -1.
+		int dictValue(const char* data, const QList<Token>& tokens, const char* key)
+		{
+			int depth = 0;
+			for (int i = 0; i + 1 < tokens.count(); ++i)
+			{
+				const Token& token = tokens.at(i);
+				if (token.type == Token::Open)
+					++depth;
+				else if (token.type == Token::Close)
+					--depth;
+				else if ((depth == 1) && (token.type == Token::Name) && isToken(data, token, key))
+					return i + 1;
+			}
+			return -1;
+		}
+
+		int bitsFor(quint64 value)
+		{
+			int bits = 0;
+			for (; value > 0; value >>= 1)
+				++bits;
+			return bits;
+		}
+
+		/// Writes the bit fields of the hint tables, most significant bit first.
+		class BitWriter
+		{
+		public:
+			void write(quint64 value, int bits)
+			{
+				for (int i = bits - 1; i >= 0; --i)
+				{
+					m_byte = (m_byte << 1) | ((value >> i) & 1);
+					if (++m_bits == 8)
+					{
+						m_data.append(static_cast<char>(m_byte));
+						m_byte = 0;
+						m_bits = 0;
+					}
+				}
+			}
+
+			/// Pads the current byte with zero bits, each item of the tables starts at a byte boundary.
+			void flush()
+			{
+				if (m_bits > 0)
+					write(0, 8 - m_bits);
+			}
+
+			const QByteArray& data() const { return m_data; }
+
+		private:
+			QByteArray m_data;
+			uint m_byte { 0 };
+			int m_bits { 0 };
+		};
+
+		QByteArray padded(qint64 value)
+		{
+			return QByteArray::number(value).rightJustified(10, ' ');
+		}
+
+		QByteArray xrefEntry(qint64 offset)
+		{
+			return QByteArray::number(offset).rightJustified(10, '0') + " 00000 n \n";
+		}
+
+		QByteArray objectHeader(PdfId id)
+		{
+			return QByteArray::number(id) + " 0 obj";
+		}
+
+		const QByteArray objectEnd("\nendobj\n");
+	}
+
+	Linearizer::Linearizer(const QList<qint64>& xref, qint64 startXRef, PdfId catalogObj, PdfId infoObj, PdfId pagesObj, const QByteArray& fileId) :
+		m_xref(xref),
+		m_startXRef(startXRef),
+		m_catalogObj(catalogObj),
+		m_infoObj(infoObj),
+		m_pagesObj(pagesObj),
+		m_fileId(fileId)
+	{
+	}
+
+	bool Linearizer::linearize(const QString& fileName)
+	{
+		QFile input(fileName);
+		if (!input.open(QIODevice::ReadOnly))
+			return false;
+		m_size = input.size();
+		if ((m_size <= 0) || (m_size >= maxFileSize) || (m_startXRef <= 0) || (m_startXRef > m_size))
+			return false;
+		uchar* map = input.map(0, m_size);
+		if (!map)
+			return false;
+		m_data = reinterpret_cast<const char*>(map);
+
+		QSaveFile output(fileName);
+		bool result = readObjects();
+		if (result)
+			result = readPageTree(m_index.value(m_pagesObj, -1), 0) && !m_pages.isEmpty();
+		if (result)
+		{
+			assignParts();
+			renumber();
+			result = output.open(QIODevice::WriteOnly) && write(output);
+		}
+		// the input has to be released before the output replaces it
+		input.unmap(map);
+		input.close();
+		m_data = nullptr;
+		return result && output.commit();
+	}
+
+	bool Linearizer::readObjects()
+	{
+		for (int id = 1; id < m_xref.count(); ++id)
+		{
+			if (m_xref.at(id) <= 0)
+				continue;
+			Object object;
+			object.id = id;
+			object.offset = m_xref.at(id);
+			m_objects.append(object);
+		}
+		if (m_objects.isEmpty())
+			return false;
+		std::sort(m_objects.begin(), m_objects.end(), [](const Object& a, const Object& b) { return a.offset < b.offset; });
+
+		for (int i = 0; i < m_objects.count(); ++i)
+		{
+			Object& object = m_objects[i];
+			// objects follow each other, the last one is followed by the cross-reference table
+			qint64 end = (i + 1 < m_objects.count()) ? m_objects.at(i + 1).offset : m_startXRef;
+			QByteArray header = objectHeader(object.id);
+			if ((end - object.offset <= header.size()) || (memcmp(m_data + object.offset, header.constData(), header.size()) != 0))
+				return false;
+			object.bodyStart = object.offset + header.size();
+			qint64 endObj = QByteArray::fromRawData(m_data + object.bodyStart, end - object.bodyStart).lastIndexOf("endobj");
+			if (endObj < 0)
+				return false;
+			object.bodyEnd = object.bodyStart + endObj;
+			while ((object.bodyEnd > object.bodyStart) && isWhiteSpace(m_data[object.bodyEnd - 1]))
+				--object.bodyEnd;
+
+			QList<Token> tokens = tokenize(m_data, object.bodyStart, object.bodyEnd, object.headEnd);
+			for (int t = 2; t < tokens.count(); ++t)
+			{
+				if (isToken(m_data, tokens.at(t), "R") && isNumber(m_data, tokens.at(t - 1)) && isNumber(m_data, tokens.at(t - 2)))
+				{
+					const Token& number = tokens.at(t - 2);
+					object.refs.append({ toNumber(m_data, number), number.pos, number.length });
+				}
+			}
+			m_index.insert(object.id, i);
+		}
+		m_catalog = m_index.value(m_catalogObj, -1);
+		m_info = m_index.value(m_infoObj, -1);
+		return (m_catalog >= 0);
+	}
+
+	bool Linearizer::readPageTree(int index, int depth)
+	{
+		if ((index < 0) || (depth > 64) || (m_objects.at(index).kind != Object::Other))
+			return false;
+		Object& node = m_objects[index];
+		qint64 streamPos;
+		QList<Token> tokens = tokenize(m_data, node.bodyStart, node.headEnd, streamPos);
+		int type = dictValue(m_data, tokens, "/Type");
+		if (type < 0)
+			return false;
+		if (isToken(m_data, tokens.at(type), "/Page"))
+		{
+			node.kind = Object::Page;
+			m_pages.append(index);
+			return true;
+		}
+		if (!isToken(m_data, tokens.at(type), "/Pages"))
+			return false;
+		node.kind = Object::PageTreeNode;
+
+		int kids = dictValue(m_data, tokens, "/Kids");
+		if ((kids < 0) || !isToken(m_data, tokens.at(kids), "["))
+			return false;
+		int t = kids + 1;
+		for (; (t + 2 < tokens.count()) && isNumber(m_data, tokens.at(t)); t += 3)
+		{
+			if (!isToken(m_data, tokens.at(t + 2), "R"))
+				return false;
+			if (!readPageTree(m_index.value(toNumber(m_data, tokens.at(t)), -1), depth + 1))
+				return false;
+		}
+		return (t < tokens.count()) && isToken(m_data, tokens.at(t), "]");
+	}
+
+	void Linearizer::assignParts()
+	{
+		// collect what each page uses, without following links to the document structure or other pages
+		m_pageObjects.resize(m_pages.count());
+		for (int p = 0; p < m_pages.count(); ++p)
+		{
+			QList<int>& used = m_pageObjects[p];
+			QSet<int> seen;
+			used.append(m_pages.at(p));
+			seen.insert(m_pages.at(p));
+			m_objects[m_pages.at(p)].firstUser = p;
+			m_objects[m_pages.at(p)].users = 1;
+			for (int u = 0; u < used.count(); ++u)
+			{
+				const QList<Reference> refs = m_objects.at(used.at(u)).refs;
+				for (const Reference& ref : refs)
+				{
+					int target = m_index.value(ref.id, -1);
+					if ((target < 0) || (target == m_catalog) || (target == m_info) || seen.contains(target))
+						continue;
+					if (m_objects.at(target).kind != Object::Other)
+						continue;
+					seen.insert(target);
+					used.append(target);
+					Object& object = m_objects[target];
+					if (object.users++ == 0)
+						object.firstUser = p;
+				}
+			}
+		}
+
+		// the first page section holds everything the first page uses, each other page section
+		// the page and the objects only it uses
+		m_sections.resize(m_pages.count());
+		for (int p = 0; p < m_pages.count(); ++p)
+			m_sections[p].append(m_pages.at(p));
+		for (int i = 0; i < m_objects.count(); ++i)
+		{
+			const Object& object = m_objects.at(i);
+			if ((i == m_catalog) || (object.kind == Object::Page))
+				continue;
+			if (object.users == 0)
+				m_other.append(i);
+			else if ((object.firstUser == 0) || (object.users == 1))
+				m_sections[object.firstUser].append(i);
+			else
+				m_shared.append(i);
+		}
+	}
+
+	void Linearizer::renumber()
+	{
+		// the main cross-reference section comes first in number order, the first page section last
+		for (int p = 1; p < m_sections.count(); ++p)
+			m_mainOrder += m_sections.at(p);
+		m_mainOrder += m_shared;
+		m_mainOrder += m_other;
+		PdfId next = 1;
+		for (int index : std::as_const(m_mainOrder))
+			m_objects[index].newId = next++;
+		m_mainCount = next;
+		m_linearizationObj = next++;
+		m_objects[m_catalog].newId = next++;
+		m_hintObj = next++;
+		for (int index : std::as_const(m_sections.first()))
+			m_objects[index].newId = next++;
+		m_objectCount = next;
+
+		for (Object& object : m_objects)
+		{
+			QByteArray head;
+			qint64 pos = object.bodyStart;
+			for (const Reference& ref : std::as_const(object.refs))
+			{
+				head.append(m_data + pos, ref.pos - pos);
+				// references to objects not in the file refer to the free object 0, which is null
+				int target = m_index.value(ref.id, -1);
+				head += QByteArray::number((target < 0) ? 0 : m_objects.at(target).newId);
+				pos = ref.pos + ref.length;
+			}
+			head.append(m_data + pos, object.headEnd - pos);
+			object.newHead = head;
+			object.newLength = objectHeader(object.newId).size() + head.size() + (object.bodyEnd - object.headEnd) + objectEnd.size();
+		}
+	}
+
+	bool Linearizer::write(QIODevice& output)
+	{
+		QByteArray header(m_data, m_objects.first().offset);
+		qint64 linearizationOffset = header.size();
+		qint64 pos = linearizationOffset + linearizationDict(0, 0, 0, 0, 0).size() + firstPageXRef(0, 0, 0).size();
+		m_objects[m_catalog].newOffset = pos;
+		pos += m_objects.at(m_catalog).newLength;
+
+		// the hint tables give offsets as if the hint stream was not in the file
+		qint64 hintOffset = pos;
+		const QList<int>& firstPage = m_sections.first();
+		for (int index : firstPage)
+		{
+			m_objects[index].newOffset = pos;
+			pos += m_objects.at(index).newLength;
+		}
+		qint64 firstPageEnd = pos;
+		for (int index : std::as_const(m_mainOrder))
+		{
+			m_objects[index].newOffset = pos;
+			pos += m_objects.at(index).newLength;
+		}
+		QByteArray hint = hintStream();
+		qint64 hintLength = hint.size();
+		for (int index : firstPage)
+			m_objects[index].newOffset += hintLength;
+		for (int index : std::as_const(m_mainOrder))
+			m_objects[index].newOffset += hintLength;
+		firstPageEnd += hintLength;
+
+		qint64 mainXRefOffset = pos + hintLength;
+		QByteArray linearization = linearizationDict(0, 0, 0, 0, 0);
+		QByteArray mainXRefSection = mainXRef(linearizationOffset + linearization.size());
+		qint64 mainXRefEntries = mainXRefOffset + QByteArray("xref\n0 " + QByteArray::number(m_mainCount)).size();
+		qint64 fileLength = mainXRefOffset + mainXRefSection.size();
+		linearization = linearizationDict(fileLength, hintOffset, hintLength, firstPageEnd, mainXRefEntries);
+		QByteArray firstPageXRefSection = firstPageXRef(linearizationOffset, hintOffset, mainXRefOffset);
+		if (linearizationOffset + linearization.size() + firstPageXRefSection.size() != m_objects.at(m_catalog).newOffset)
+			return false;
+
+		output.write(header);
+		output.write(linearization);
+		output.write(firstPageXRefSection);
+		writeObject(output, m_objects.at(m_catalog));
+		output.write(hint);
+		for (int index : firstPage)
+			writeObject(output, m_objects.at(index));
+		for (int index : std::as_const(m_mainOrder))
+			writeObject(output, m_objects.at(index));
+		output.write(mainXRefSection);
+		return (output.pos() == fileLength);
+	}
+
+	void Linearizer::writeObject(QIODevice& output, const Object& object) const
+	{
+		output.write(objectHeader(object.newId));
+		output.write(object.newHead);
+		output.write(m_data + object.headEnd, object.bodyEnd - object.headEnd);
+		output.write(objectEnd);
+	}
+
+	QByteArray Linearizer::hintTables(int& sharedTableOffset) const
+	{
+		// shared object entries, the objects of the first page section come first
+		const QList<int>& firstPage = m_sections.first();
+		QList<int> entries = firstPage + m_shared;
+		QHash<int, int> sharedIds;
+		for (int i = 0; i < entries.count(); ++i)
+			sharedIds.insert(entries.at(i), i);
+
+		int pageCount = m_sections.count();
+		QList<qint64> objectCounts(pageCount, 0);
+		QList<qint64> pageLengths(pageCount, 0);
+		QList<QList<int> > sharedObjects(pageCount);
+		int maxShared = 0;
+		for (int p = 0; p < pageCount; ++p)
+		{
+			objectCounts[p] = m_sections.at(p).count();
+			for (int index : m_sections.at(p))
+				pageLengths[p] += m_objects.at(index).newLength;
+			for (int index : m_pageObjects.at(p))
+			{
+				if ((m_objects.at(index).users > 1) && sharedIds.contains(index))
+					sharedObjects[p].append(sharedIds.value(index));
+			}
+			maxShared = qMax(maxShared, static_cast<int>(sharedObjects.at(p).count()));
+		}
+		qint64 minObjects = *std::min_element(objectCounts.cbegin(), objectCounts.cend());
+		qint64 minLength = *std::min_element(pageLengths.cbegin(), pageLengths.cend());
+		int objectBits = bitsFor(*std::max_element(objectCounts.cbegin(), objectCounts.cend()) - minObjects);
+		int lengthBits = bitsFor(*std::max_element(pageLengths.cbegin(), pageLengths.cend()) - minLength);
+		int sharedBits = bitsFor(maxShared);
+		int idBits = bitsFor(entries.count() - 1);
+
+		// page offset hint table, F.4.1, content streams are reported as spanning the whole page
+		BitWriter bits;
+		bits.write(minObjects, 32);
+		bits.write(m_objects.at(firstPage.first()).newOffset, 32);
+		bits.write(objectBits, 16);
+		bits.write(minLength, 32);
+		bits.write(lengthBits, 16);
+		bits.write(0, 32);
+		bits.write(0, 16);
+		bits.write(minLength, 32);
+		bits.write(lengthBits, 16);
+		bits.write(sharedBits, 16);
+		bits.write(idBits, 16);
+		bits.write(0, 16);
+		bits.write(1, 16);
+		for (int p = 0; p < pageCount; ++p)
+			bits.write(objectCounts.at(p) - minObjects, objectBits);
+		bits.flush();
+		for (int p = 0; p < pageCount; ++p)
+			bits.write(pageLengths.at(p) - minLength, lengthBits);
+		bits.flush();
+		for (int p = 0; p < pageCount; ++p)
+			bits.write(sharedObjects.at(p).count(), sharedBits);
+		bits.flush();
+		for (int p = 0; p < pageCount; ++p)
+		{
+			for (int id : sharedObjects.at(p))
+				bits.write(id, idBits);
+		}
+		bits.flush();
+		for (int p = 0; p < pageCount; ++p)
+			bits.write(pageLengths.at(p) - minLength, lengthBits);
+		bits.flush();
+		sharedTableOffset = bits.data().size();
+
+		// shared object hint table, F.4.2, one object per group
+		QList<qint64> groupLengths;
+		for (int index : std::as_const(entries))
+			groupLengths.append(m_objects.at(index).newLength);
+		qint64 minGroupLength = *std::min_element(groupLengths.cbegin(), groupLengths.cend());
+		int groupBits = bitsFor(*std::max_element(groupLengths.cbegin(), groupLengths.cend()) - minGroupLength);
+		bits.write(m_shared.isEmpty() ? 0 : m_objects.at(m_shared.first()).newId, 32);
+		bits.write(m_shared.isEmpty() ? 0 : m_objects.at(m_shared.first()).newOffset, 32);
+		bits.write(firstPage.count(), 32);
+		bits.write(entries.count(), 32);
+		bits.write(0, 16);
+		bits.write(minGroupLength, 32);
+		bits.write(groupBits, 16);
+		for (qint64 length : std::as_const(groupLengths))
+			bits.write(length - minGroupLength, groupBits);
+		bits.flush();
+		for (int i = 0; i < groupLengths.count(); ++i)
+			bits.write(0, 1);
+		bits.flush();
+		return bits.data();
+	}
+
+	QByteArray Linearizer::hintStream() const
+	{
+		int sharedTableOffset = 0;
+		QByteArray tables = hintTables(sharedTableOffset);
+		QByteArray data = CompressArray(tables);
+		bool compressed = !data.isEmpty();
+		if (!compressed)
+			data = tables;
+		QByteArray result = objectHeader(m_hintObj) + "\n<< /S " + QByteArray::number(sharedTableOffset) + " /Length " + QByteArray::number(data.size());
+		if (compressed)
+			result += " /Filter /FlateDecode";
+		result += " >>\nstream\n" + data + "\nendstream" + objectEnd;
+		return result;
+	}
+
+	QByteArray Linearizer::linearizationDict(qint64 fileLength, qint64 hintOffset, qint64 hintLength, qint64 firstPageEnd, qint64 mainXRefEntries) const
+	{
+		// fixed width numbers, the size of the dictionary is needed before the values are known
+		QByteArray result = objectHeader(m_linearizationObj) + "\n<< /Linearized 1 /L " + padded(fileLength);
+		result += " /H [ " + padded(hintOffset) + " " + padded(hintLength) + " ]";
+		result += " /O " + QByteArray::number(m_objects.at(m_pages.first()).newId);
+		result += " /E " + padded(firstPageEnd);
+		result += " /N " + QByteArray::number(m_pages.count());
+		result += " /T " + padded(mainXRefEntries) + " >>" + objectEnd;
+		return result;
+	}
+
+	QByteArray Linearizer::firstPageXRef(qint64 linearizationOffset, qint64 hintOffset, qint64 mainXRef) const
+	{
+		QByteArray result = "xref\n" + QByteArray::number(m_mainCount) + " " + QByteArray::number(m_objectCount - m_mainCount) + "\n";
+		result += xrefEntry(linearizationOffset);
+		result += xrefEntry(m_objects.at(m_catalog).newOffset);
+		result += xrefEntry(hintOffset);
+		for (int index : m_sections.first())
+			result += xrefEntry(m_objects.at(index).newOffset);
+		result += "trailer\n<< /Size " + QByteArray::number(m_objectCount) + " /Prev " + padded(mainXRef);
+		result += " /Root " + QByteArray::number(m_objects.at(m_catalog).newId) + " 0 R";
+		if (m_info >= 0)
+			result += " /Info " + QByteArray::number(m_objects.at(m_info).newId) + " 0 R";
+		if (!m_fileId.isEmpty())
+			result += " /ID [" + toHexString(m_fileId) + toHexString(m_fileId) + "]";
+		result += " >>\nstartxref\n0\n%%EOF\n";
+		return result;
+	}
+
+	QByteArray Linearizer::mainXRef(qint64 firstPageXRef) const
+	{
+		QByteArray result = "xref\n0 " + QByteArray::number(m_mainCount) + "\n";
+		result += "0000000000 65535 f \n";
+		for (int index : m_mainOrder)
+			result += xrefEntry(m_objects.at(index).newOffset);
+		result += "trailer\n<< /Size " + QByteArray::number(m_mainCount) + " >>\nstartxref\n";
+		result += QByteArray::number(firstPageXRef) + "\n%%EOF\n";
+		return result;
+	}
+
+}
@@ -0,0 +1,121 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef PDFLINEARIZER_H
+#define PDFLINEARIZER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QList>
+#include <QString>
+
+#include "pdfstructs.h"
+
+namespace Pdf
+{
+
+/**
+ * Rewrites a PDF file written by Pdf::Writer as a linearized file, cf. PDF32000-2008, Annex F.
+ *
+ * This is a post-pass over the object table of the writer, the export itself stays as it is.
+ * The objects are read from the finished file and written again in the linearized order:
+ * the linearization dictionary and the first-page cross-reference section, the catalog,
+ * the primary hint stream and everything the first page needs, then the other pages with
+ * their own objects, the objects shared by several pages and all remaining objects, followed
+ * by the main cross-reference section. Objects are renumbered accordingly, so the file must
+ * not be encrypted and must use a classic cross-reference table.
+ */
+class Linearizer
+{
+public:
+	/**
+	 * @param xref offsets of the objects in the file, indexed by object number, 0 for unused numbers
+	 * @param startXRef offset of the cross-reference table, which follows the last object
+	 */
+	Linearizer(const QList<qint64>& xref, qint64 startXRef, PdfId catalogObj, PdfId infoObj, PdfId pagesObj, const QByteArray& fileId);
+
+	/**
+	 * Linearizes @a fileName in place.
+	 * @return false if the file is left as it was, because of an unexpected structure or an I/O error
+	 */
+	bool linearize(const QString& fileName);
+
+private:
+	struct Reference
+	{
+		PdfId id { 0 };
+		qint64 pos { 0 };    ///< position of the object number in the input
+		qint64 length { 0 };
+	};
+
+	struct Object
+	{
+		enum Kind { Other, Page, PageTreeNode };
+
+		PdfId id { 0 };
+		qint64 offset { 0 };
+		/// the body is [bodyStart, bodyEnd), the stream keyword and data start at headEnd
+		qint64 bodyStart { 0 };
+		qint64 headEnd { 0 };
+		qint64 bodyEnd { 0 };
+		QList<Reference> refs;
+		Kind kind { Other };
+		/// first page using the object and the number of pages using it
+		int firstUser { -1 };
+		int users { 0 };
+
+		PdfId newId { 0 };
+		QByteArray newHead;
+		qint64 newLength { 0 };
+		qint64 newOffset { 0 };
+	};
+
+	QList<qint64> m_xref;
+	qint64 m_startXRef { 0 };
+	PdfId m_catalogObj { 0 };
+	PdfId m_infoObj { 0 };
+	PdfId m_pagesObj { 0 };
+	QByteArray m_fileId;
+
+	const char* m_data { nullptr };
+	qint64 m_size { 0 };
+	QList<Object> m_objects;
+	QHash<PdfId, int> m_index;
+	int m_catalog { -1 };
+	int m_info { -1 };
+	/// page objects in page order and all objects each page uses
+	QList<int> m_pages;
+	QList<QList<int> > m_pageObjects;
+
+	/// the parts of Annex F.3, section 0 is the first page
+	QList<QList<int> > m_sections;
+	QList<int> m_shared;
+	QList<int> m_other;
+	/// objects of the main cross-reference section in file and number order
+	QList<int> m_mainOrder;
+	PdfId m_mainCount { 0 };
+	PdfId m_linearizationObj { 0 };
+	PdfId m_hintObj { 0 };
+	PdfId m_objectCount { 0 };
+
+	bool readObjects();
+	bool readPageTree(int index, int depth);
+	void assignParts();
+	void renumber();
+	bool write(QIODevice& output);
+	void writeObject(QIODevice& output, const Object& object) const;
+
+	QByteArray hintTables(int& sharedTableOffset) const;
+	QByteArray hintStream() const;
+	QByteArray linearizationDict(qint64 fileLength, qint64 hintOffset, qint64 hintLength, qint64 firstPageEnd, qint64 mainXRefEntries) const;
+	QByteArray firstPageXRef(qint64 linearizationOffset, qint64 hintOffset, qint64 mainXRef) const;
+	QByteArray mainXRef(qint64 firstPageXRef) const;
+};
+
+}
+
+#endif
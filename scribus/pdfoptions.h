@@ -104,11 +104,14 @@ public:
 	bool Articles { false };
 	bool useLayers { false };
 	bool Compress { true };
+	bool useObjectStreams { true }; //!< Pack small objects into object streams and write a cross-reference stream for PDF 1.5 and later
+	bool linearize { false }; //!< Write a linearized (Fast Web View) file, so viewers can show the first page before the whole file is loaded
 	PDFCompression CompressMethod { Compression_Auto };
 	int  Quality { 0 };
 	bool RecalcPic { false };
 	bool Bookmarks { false };
 	int  PicRes { 300 };
+	int  downsampleFilter { 0 }; //!< ScImage::ScaleFilter used when images are downsampled to PicRes
 	bool embedPDF { false };
 	PDFVersion Version { PDFVersion::PDF_14 };
 	int  Resolution { 300 };
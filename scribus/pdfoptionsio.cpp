@@ -102,11 +102,14 @@ void PDFOptionsIO::buildSettings()
 	addElem(m_root, "articles", m_opts->Articles);
 	addElem(m_root, "useLayers", m_opts->useLayers);
 	addElem(m_root, "compress", m_opts->Compress);
+	addElem(m_root, "useObjectStreams", m_opts->useObjectStreams);
+	addElem(m_root, "linearize", m_opts->linearize);
 	addElem(m_root, "compressMethod", m_opts->CompressMethod);
 	addElem(m_root, "quality", m_opts->Quality);
 	addElem(m_root, "recalcPic", m_opts->RecalcPic);
 	addElem(m_root, "bookmarks", m_opts->Bookmarks);
 	addElem(m_root, "picRes", m_opts->PicRes);
+	addElem(m_root, "downsampleFilter", m_opts->downsampleFilter);
 	addElem(m_root, "embedPDF", m_opts->embedPDF);
 	QString pdfVersString;
 	switch (m_opts->Version)
@@ -345,6 +348,10 @@ bool PDFOptionsIO::readSettings()
 		return false;
 	if (!readElem(m_root, "compress", &m_opts->Compress))
 		return false;
+	if (!readElem(m_root, "useObjectStreams", &m_opts->useObjectStreams))
+		m_opts->useObjectStreams = true;
+	if (!readElem(m_root, "linearize", &m_opts->linearize))
+		m_opts->linearize = false;
 	if (!readElem(m_root, "compressMethod", (int*) &m_opts->CompressMethod))
 		return false;
 	if (!readElem(m_root, "quality", &m_opts->Quality))
@@ -355,6 +362,8 @@ bool PDFOptionsIO::readSettings()
 		return false;
 	if (!readElem(m_root, "picRes", &m_opts->PicRes))
 		return false;
+	if (!readElem(m_root, "downsampleFilter", &m_opts->downsampleFilter))
+		m_opts->downsampleFilter = 0;
 	if (!readElem(m_root, "embedPDF", &m_opts->embedPDF))
 		m_opts->embedPDF = false;
 	if (!readPDFVersion())
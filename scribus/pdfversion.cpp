@@ -38,6 +38,17 @@ bool PDFVersion::supportsEmbeddedOpenTypeFonts() const
 	return false;
 }
 
+bool PDFVersion::supportsObjectStreams() const
+{
+	if (m_version == PDF_15)
+		return true;
+	if (m_version == PDF_16)
+		return true;
+	if (m_version == PDF_X4)
+		return true;
+	return false;
+}
+
 bool PDFVersion::supportsOCGs() const
 {
 	if (m_version == PDF_15)
@@ -45,6 +45,7 @@ public:
 
 	bool supports128BitsEncryption() const;
 	bool supportsEmbeddedOpenTypeFonts() const;
+	bool supportsObjectStreams() const;
 	bool supportsOCGs() const;
 	bool supportsPDF15PresentationEffects() const;
 	bool supportsTransparency() const;
@@ -5,8 +5,12 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <cmath>
+
 #include <QCryptographicHash>
+#include <QDebug>
 
+#include "pdflinearizer.h"
 #include "pdfwriter.h"
 #include "rc4.h"
 #include "scstreamfilter_rc4.h"
@@ -338,7 +342,48 @@ namespace Pdf
 
 	QByteArray toPdf(double v)
 	{
-		return QByteArray::number(v, 'f');
+		QByteArray result;
+		appendNumber(result, v, 6);
+		return result;
+	}
+
+	void appendNumber(QByteArray& out, double v, int decimals)
+	{
+		static const double scales[] = { 1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8 };
+		decimals = qBound(0, decimals, 8);
+		double scaled = std::round(v * scales[decimals]);
+		if (!(std::fabs(scaled) < 9.0e15))
+		{
+			// NaN, infinite or beyond the range of the fixed point digits
+			out += QByteArray::number(v, 'f', decimals);
+			return;
+		}
+		quint64 digits = static_cast<quint64>(std::fabs(scaled));
+		int fraction = decimals;
+		while ((fraction > 0) && (digits % 10 == 0))
+		{
+			digits /= 10;
+			--fraction;
+		}
+		char buffer[32];
+		char* end = buffer + sizeof(buffer);
+		char* p = end;
+		for (int i = 0; i < fraction; ++i)
+		{
+			*--p = static_cast<char>('0' + digits % 10);
+			digits /= 10;
+		}
+		if (fraction > 0)
+			*--p = '.';
+		do
+		{
+			*--p = static_cast<char>('0' + digits % 10);
+			digits /= 10;
+		} while (digits > 0);
+		// values rounded to zero are written without sign, scaled is -0.0 then
+		if (scaled < 0)
+			*--p = '-';
+		out.append(p, end - p);
 	}
 	
 	QByteArray toObjRef(PdfId id)
@@ -503,8 +548,18 @@ namespace Pdf
 		return true;
 	}
 	
+	QDataStream& Writer::getOutStream()
+	{
+		// raw stream data, the object cannot go into an object stream
+		if (m_bufferingObject)
+			unbufferObject();
+		return m_outStream;
+	}
+
 	ScStreamFilter* Writer::openStreamFilter(bool encrypted, PdfId objId)
 	{
+		if (m_bufferingObject)
+			unbufferObject();
 		if (encrypted)
 		{
 			QByteArray step1 = ComputeRC4Key(objId);
@@ -523,6 +578,13 @@ namespace Pdf
 			if (m_Spool.exists())
 				m_Spool.remove();
 		}
+		else if (m_linearize && !m_useObjectStreams && (EncryptObj == 0))
+		{
+			// the file stays as written if it cannot be linearized
+			Linearizer linearizer(m_XRef, m_startXRef, CatalogObj, InfoObj, PagesObj, m_FileID);
+			if (!linearizer.linearize(m_Spool.fileName()))
+				qDebug() << "PDF export: could not linearize" << m_Spool.fileName();
+		}
 		return result;
 	}
 	
@@ -730,8 +792,15 @@ namespace Pdf
 	
 	void Writer::writeXrefAndTrailer()
 	{
+		if (m_useObjectStreams)
+		{
+			writeObjectStream();
+			writeXrefStream();
+			return;
+		}
 		QByteArray tmp;
 		uint StX = bytesWritten();
+		m_startXRef = StX;
 		write("xref\n");
 		write("0 "+Pdf::toPdf(m_ObjCounter)+"\n");
 		//write("0000000000 65535 f \n");
@@ -845,9 +914,16 @@ namespace Pdf
 	{
 		assert( m_CurrentObj == 0);
 		m_CurrentObj = id;
-		while (static_cast<uint>(m_XRef.length()) <= id)
-			m_XRef.append(0);
-		m_XRef[id] = bytesWritten();
+		if (m_useObjectStreams)
+		{
+			m_objectDevice = m_outStream.device();
+			m_objectBuffer.setData(QByteArray());
+			m_objectBuffer.open(QIODevice::WriteOnly);
+			m_outStream.setDevice(&m_objectBuffer);
+			m_bufferingObject = true;
+			return;
+		}
+		setObjectOffset(id);
 		write(toPdf(id));
 		write(" 0 obj\n");
 	}
@@ -856,13 +932,157 @@ namespace Pdf
 	{
 		assert( m_CurrentObj == id);
 		m_CurrentObj = 0;
+		if (m_bufferingObject)
+		{
+			m_bufferingObject = false;
+			m_objectBuffer.close();
+			m_outStream.setDevice(m_objectDevice);
+			addToObjectStream(id, m_objectBuffer.data());
+			return;
+		}
 		write("\nendobj\n");
 	}
+
+	void Writer::setObjectOffset(PdfId id)
+	{
+		while (static_cast<uint>(m_XRef.length()) <= id)
+			m_XRef.append(0);
+		m_XRef[id] = m_Spool.pos();
+	}
+
+	void Writer::unbufferObject()
+	{
+		m_bufferingObject = false;
+		m_objectBuffer.close();
+		m_outStream.setDevice(m_objectDevice);
+		setObjectOffset(m_CurrentObj);
+		write(toPdf(m_CurrentObj));
+		write(" 0 obj\n");
+		write(m_objectBuffer.data());
+	}
+
+	void Writer::addToObjectStream(PdfId id, const QByteArray& body)
+	{
+		if (m_objStmObjects.isEmpty())
+			m_objStmObj = newObject();
+		m_compressedXRef.insert(id, qMakePair(m_objStmObj, static_cast<int>(m_objStmObjects.count())));
+		m_objStmObjects.append(qMakePair(id, body));
+		m_objStmBytes += body.size();
+		// small streams keep random access cheap for readers
+		if ((m_objStmObjects.count() >= 200) || (m_objStmBytes >= 256 * 1024))
+			writeObjectStream();
+	}
+
+	void Writer::writeObjectStream()
+	{
+		if (m_objStmObjects.isEmpty())
+			return;
+		QByteArray offsets;
+		QByteArray objects;
+		for (const auto& object : std::as_const(m_objStmObjects))
+		{
+			offsets += toPdf(object.first) + " " + toPdf(static_cast<qlonglong>(objects.size())) + " ";
+			objects += object.second;
+			objects += "\n";
+		}
+		offsets += "\n";
+		QByteArray data = CompressArray(offsets + objects);
+		bool compressed = !data.isEmpty();
+		if (!compressed)
+			data = offsets + objects;
+
+		setObjectOffset(m_objStmObj);
+		write(toPdf(m_objStmObj));
+		write(" 0 obj\n");
+		write("<< /Type /ObjStm /N " + toPdf(static_cast<int>(m_objStmObjects.count())) + " /First " + toPdf(static_cast<qlonglong>(offsets.size())));
+		write(" /Length " + toPdf(static_cast<qlonglong>(data.size())));
+		if (compressed)
+			write(" /Filter /FlateDecode");
+		write(" >>\nstream\n");
+		write(data);
+		write("\nendstream\nendobj\n");
+
+		m_objStmObjects.clear();
+		m_objStmBytes = 0;
+		m_objStmObj = 0;
+	}
+
+	void Writer::writeXrefStream()
+	{
+		PdfId xrefObj = newObject();
+		while (static_cast<uint>(m_XRef.length()) < m_ObjCounter)
+			m_XRef.append(0);
+		qint64 startXRef = m_Spool.pos();
+		m_XRef[xrefObj] = startXRef;
+
+		// entries of type, offset or object stream, generation or index
+		int offsetBytes = (startXRef > 0xffffffffLL) ? 8 : 4;
+		QByteArray entries;
+		entries.reserve(m_XRef.count() * (offsetBytes + 3));
+		auto appendField = [&entries](quint64 value, int bytes)
+		{
+			for (int i = bytes - 1; i >= 0; --i)
+				entries += static_cast<char>((value >> (8 * i)) & 0xff);
+		};
+		for (int a = 0; a < m_XRef.count(); ++a)
+		{
+			auto compressed = m_compressedXRef.constFind(a);
+			if (compressed != m_compressedXRef.constEnd())
+			{
+				appendField(2, 1);
+				appendField(compressed->first, offsetBytes);
+				appendField(compressed->second, 2);
+			}
+			else if (m_XRef[a] > 0)
+			{
+				appendField(1, 1);
+				appendField(m_XRef[a], offsetBytes);
+				appendField(0, 2);
+			}
+			else
+			{
+				// unused object, mark as free-never-to-be-used-again
+				appendField(0, 1);
+				appendField(0, offsetBytes);
+				appendField(65535, 2);
+			}
+		}
+		QByteArray data = CompressArray(entries);
+		bool compressed = !data.isEmpty();
+		if (!compressed)
+			data = entries;
+
+		QByteArray IDs;
+		for (uint cl = 0; cl < 16; ++cl)
+			IDs += (m_FileID[cl]);
+		QByteArray IDbytes = Pdf::toHexString(IDs);
+		write(toPdf(xrefObj));
+		write(" 0 obj\n");
+		write("<< /Type /XRef /Size " + Pdf::toPdf(static_cast<qlonglong>(m_XRef.count())) + " /W [1 " + toPdf(offsetBytes) + " 2]\n");
+		write("/Root 1 0 R\n/Info 2 0 R\n/ID [" + IDbytes + IDbytes + "]\n");
+		write("/Length " + toPdf(static_cast<qlonglong>(data.size())));
+		if (compressed)
+			write(" /Filter /FlateDecode");
+		write(" >>\nstream\n");
+		write(data);
+		write("\nendstream\nendobj\n");
+		write("startxref\n");
+		write(Pdf::toPdf(startXRef) + "\n%%EOF\n");
+	}
 	
+	void Writer::beginStream()
+	{
+		assert( m_CurrentObj != 0);
+		if (m_bufferingObject)
+			unbufferObject();
+		write("stream\n");
+	}
+
 	void Writer::endObjectWithStream(bool encrypted, PdfId id, const QByteArray& streamContent)
 	{
 		assert( m_CurrentObj == id);
-		write("\nstream\n");
+		write("\n");
+		beginStream();
 		write(encrypted? encryptBytes(streamContent, id): streamContent);
 		write("\nendstream");
 		endObj(id);
@@ -9,11 +9,14 @@
 #ifndef Scribus_pdfwriter_h
 #define Scribus_pdfwriter_h
 
+#include <QBuffer>
 #include <QByteArray>
 #include <QDataStream>
 #include <QFile>
 #include <QDateTime>
 #include <QList>
+#include <QMap>
+#include <QPair>
 #include <QRect>
 #include <QString>
 
@@ -91,6 +94,13 @@ namespace Pdf
 	 Cf. PDF32000-2008, 7.3.3
 	 */
 	QByteArray toPdf(double v);
+
+	/**
+	 Appends @a v with at most @a decimals (0 to 8) digits after the decimal point and without
+	 trailing zeros to @a out. Formats in fixed point on the stack, without the temporary
+	 QByteArray and the exact conversion of QByteArray::number(). Cf. PDF32000-2008, 7.3.3
+	 */
+	void appendNumber(QByteArray& out, double v, int decimals);
 	
 	/**
 	 Cf. PDF32000-2008, 7.3.3
@@ -168,7 +178,7 @@ public:
 	
 	// file handling
 	bool open (const QString& filename);
-	QDataStream& getOutStream() { return m_outStream; }
+	QDataStream& getOutStream();
 	bool close(bool aborted);
 	qint64 bytesWritten() { return m_Spool.pos(); }
 	
@@ -179,6 +189,15 @@ public:
 	
 	QByteArray ComputeRC4Key(PdfId ObjNum);
 	
+	// object and cross-reference streams, PDF 1.5
+	void setUseObjectStreams(bool use) { m_useObjectStreams = use; }
+	bool useObjectStreams() const { return m_useObjectStreams; }
+
+	// linearized file (Fast Web View), written by close() from the classic xref table,
+	// so it cannot be combined with object streams or encryption
+	void setLinearize(bool linearize) { m_linearize = linearize; }
+	bool linearize() const { return m_linearize; }
+
 	// writing
 	void writeHeader(const PDFVersion& vers);
 	void writeXrefAndTrailer();
@@ -198,6 +217,8 @@ public:
 	}
 	
 	void endObj(PdfId id);
+	/// Writes the stream keyword of the current object, which keeps it out of object streams.
+	void beginStream();
 	void endObjectWithStream(bool encrypted, PdfId id, const QByteArray& streamContent);
 	ScStreamFilter* openStreamFilter(bool encrypted, PdfId objId);
 	
@@ -226,6 +247,23 @@ private:
 	QDataStream m_outStream;
 	
 	QList<qint64> m_XRef;
+	qint64 m_startXRef { 0 };
+	bool m_linearize { false };
+
+	/**
+	 With object streams, each object is held back from startObj() on. It is written
+	 as usual once beginStream() or raw stream output starts a stream in it, otherwise
+	 endObj() adds it to the object stream being collected.
+	 */
+	bool m_useObjectStreams { false };
+	bool m_bufferingObject { false };
+	QBuffer m_objectBuffer;
+	QIODevice* m_objectDevice { nullptr };
+	PdfId m_objStmObj { 0 };
+	QList<QPair<PdfId, QByteArray> > m_objStmObjects;
+	qint64 m_objStmBytes { 0 };
+	/// object number mapped to the object stream holding it and its index there
+	QMap<PdfId, QPair<PdfId, int> > m_compressedXRef;
 	
 	QByteArray m_KeyGen;
 	QByteArray m_OwnerKey;
@@ -237,6 +275,11 @@ private:
 	void CalcOwnerKey(const QByteArray& Owner, const QByteArray& User);
 	void CalcUserKey(const QByteArray& User, int Permission);
 	QByteArray FitKey(const QByteArray& pass);
+	void setObjectOffset(PdfId id);
+	void unbufferObject();
+	void addToObjectStream(PdfId id, const QByteArray& body);
+	void writeObjectStream();
+	void writeXrefStream();
 };
 
 }
@@ -30,7 +30,6 @@ class ScribusDoc;
 class ScribusMainWindow;
 class PageItem;
 class ScPage;
-class ScText;
 class ScZipHandler;
 
 struct XPSResourceInfo
@@ -3485,6 +3485,8 @@ bool Scribus150Format::readPDFOptions(ScribusDoc* doc, ScXmlStreamReader& reader
 	doc->pdfOptions().Articles   = attrs.valueAsBool("Articles");
 	doc->pdfOptions().Thumbnails = attrs.valueAsBool("Thumbnails");
 	doc->pdfOptions().Compress   = attrs.valueAsBool("Compress");
+	doc->pdfOptions().useObjectStreams = attrs.valueAsBool("UseObjectStreams", true);
+	doc->pdfOptions().linearize  = attrs.valueAsBool("Linearize", false);
 	doc->pdfOptions().CompressMethod = (PDFOptions::PDFCompression) attrs.valueAsInt("CMethod", 0);
 	doc->pdfOptions().Quality    = attrs.valueAsInt("Quality", 0);
 	doc->pdfOptions().RecalcPic  = attrs.valueAsBool("RecalcPic");
@@ -3498,6 +3500,7 @@ bool Scribus150Format::readPDFOptions(ScribusDoc* doc, ScXmlStreamReader& reader
 	doc->pdfOptions().doClip     = attrs.valueAsBool("Clip", false);
 	doc->pdfOptions().PresentMode = attrs.valueAsBool("PresentMode");
 	doc->pdfOptions().PicRes     = attrs.valueAsInt("PicRes");
+	doc->pdfOptions().downsampleFilter = attrs.valueAsInt("DownsampleFilter", 0);
 	// Fixme: check input pdf version
 	doc->pdfOptions().Version    = (PDFVersion::Version) attrs.valueAsInt("Version");
 	doc->pdfOptions().Resolution = attrs.valueAsInt("Resolution");
@@ -4574,6 +4577,8 @@ bool Scribus150Format::readObject(ScribusDoc* doc, ScXmlStreamReader& reader, co
 				cl.scale(newItem->imageXScale(), newItem->imageYScale());
 				newItem->imageClip.map(cl);
 			}
+			else if (doc->imageLoader().isPending(newItem))
+				newItem->pixm.imgInfo.usedPath = clipPath; // applied by PageItem::loadImage() once the image is decoded
 			if (layerFound)
 			{
 				newItem->pixm.imgInfo.isRequest = true;
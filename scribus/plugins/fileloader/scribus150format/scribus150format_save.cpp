@@ -1261,6 +1261,8 @@ void Scribus150Format::writePdfOptions(ScXmlStreamWriter & docu)
 	docu.writeAttribute("Articles", static_cast<int>(m_Doc->pdfOptions().Articles));
 	docu.writeAttribute("Bookmarks", static_cast<int>(m_Doc->pdfOptions().Bookmarks));
 	docu.writeAttribute("Compress", static_cast<int>(m_Doc->pdfOptions().Compress));
+	docu.writeAttribute("UseObjectStreams", static_cast<int>(m_Doc->pdfOptions().useObjectStreams));
+	docu.writeAttribute("Linearize", static_cast<int>(m_Doc->pdfOptions().linearize));
 	docu.writeAttribute("CMethod", m_Doc->pdfOptions().CompressMethod);
 	docu.writeAttribute("Quality", m_Doc->pdfOptions().Quality);
 	docu.writeAttribute("EmbedPDF", static_cast<int>(m_Doc->pdfOptions().embedPDF));
@@ -1279,6 +1281,7 @@ void Scribus150Format::writePdfOptions(ScXmlStreamWriter & docu)
 	docu.writeAttribute("UseProfiles2", static_cast<int>(m_Doc->pdfOptions().UseProfiles2));
 	docu.writeAttribute("Binding", m_Doc->pdfOptions().Binding);
 	docu.writeAttribute("PicRes", m_Doc->pdfOptions().PicRes);
+	docu.writeAttribute("DownsampleFilter", m_Doc->pdfOptions().downsampleFilter);
 	docu.writeAttribute("Resolution", m_Doc->pdfOptions().Resolution);
 	docu.writeAttribute("Version", m_Doc->pdfOptions().Version);
 	docu.writeAttribute("Intent", m_Doc->pdfOptions().Intent);
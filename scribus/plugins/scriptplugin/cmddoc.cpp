@@ -171,6 +171,21 @@ PyObject *scribus_setbaseline(PyObject* /* self */, PyObject* args)
 }
 
 
+PyObject *scribus_beginbatch(PyObject* /* self */)
+{
+	if (!checkHaveDocument())
+		return nullptr;
+	beginScriptBatch();
+	Py_RETURN_NONE;
+}
+
+PyObject *scribus_endbatch(PyObject* /* self */)
+{
+	// The document may have been closed during the batch
+	endScriptBatch();
+	Py_RETURN_NONE;
+}
+
 PyObject *scribus_closedoc(PyObject* /* self */)
 {
 	if (!checkHaveDocument())
@@ -197,6 +212,8 @@ PyObject *scribus_opendoc(PyObject* /* self */, PyObject* args)
 		PyErr_SetString(ScribusException, QObject::tr("Failed to open document: %1","python error").arg(Name).toLocal8Bit().constData());
 		return nullptr;
 	}
+	// scripts expect the images to be loaded
+	ScCore->primaryMainWindow()->doc->imageLoader().finish();
 	return PyBool_FromLong(static_cast<long>(true));
 //	Py_INCREF(Py_True); // compatibility: return true, not none, on success
 //	return Py_True;
@@ -493,11 +510,13 @@ void cmddocdocwarnings()
 {
 	QStringList s;
 	s << scribus_applymasterpage__doc__
+	  << scribus_beginbatch__doc__
 	  << scribus_closedoc__doc__
 	  << scribus_closemasterpage__doc__
 	  << scribus_createmasterpage__doc__
 	  << scribus_deletemasterpage__doc__
 	  << scribus_editmasterpage__doc__ 
+	  << scribus_endbatch__doc__
 	  << scribus_getdocname__doc__
 	  << scribus_getinfo__doc__
 	  << scribus_getmasterpage__doc__
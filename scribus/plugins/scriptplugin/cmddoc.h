@@ -111,6 +111,38 @@ May throw NoDocOpenError if there is no document to close\n\
 /** Closes active doc. No params */
 PyObject *scribus_closedoc(PyObject * /*self*/);
 
+/*! docstring */
+PyDoc_STRVAR(scribus_beginbatch__doc__,
+QT_TR_NOOP("beginBatch()\n\
+\n\
+Starts a batch of changes to the current document. Until the matching\n\
+endBatch() no undo steps are recorded, text frames are not laid out and\n\
+the user interface is not updated for each change. Batches may be nested.\n\
+\n\
+Prefer the batch() context manager, which always ends the batch:\n\
+\n\
+with scribus.batch():\n\
+    ...\n\
+\n\
+Functions reading the text layout, like textOverflows(), still lay out the\n\
+frames they need. The undo history is cleared when the batch ends, and\n\
+open batches are ended when the script finishes.\n\
+\n\
+May throw NoDocOpenError if there is no document open.\n\
+"));
+/** Starts a batch of changes to the active doc. No params */
+PyObject *scribus_beginbatch(PyObject * /*self*/);
+
+/*! docstring */
+PyDoc_STRVAR(scribus_endbatch__doc__,
+QT_TR_NOOP("endBatch()\n\
+\n\
+Ends a batch started by beginBatch(). When the outermost batch ends, the\n\
+changed text frames are laid out and the document is updated once.\n\
+"));
+/** Ends a batch of changes to the active doc. No params */
+PyObject *scribus_endbatch(PyObject * /*self*/);
+
 /*! docstring */
 PyDoc_STRVAR(scribus_havedoc__doc__,
 QT_TR_NOOP("haveDoc() -> int\n\
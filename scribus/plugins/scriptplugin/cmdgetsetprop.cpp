@@ -233,23 +233,9 @@ PyObject* scribus_getpropertynames(PyObject* /*self*/, PyObject* args, PyObject*
 }
 
 
-PyObject* scribus_getproperty(PyObject* /*self*/, PyObject* args, PyObject* kw)
+/// Look up a property and convert its value to a Python object, may return nullptr with an exception set
+static PyObject* getPropertyValue(QObject* obj, const char* propertyName)
 {
-	PyObject* objArg = nullptr;
-	char* propertyName = nullptr;
-	char* kwargs[] = {const_cast<char*>("object"),
-					  const_cast<char*>("property"),
-					  nullptr};
-	if (!PyArg_ParseTupleAndKeywords(args, kw, "Oes", kwargs,
-				&objArg, "ascii", &propertyName))
-		return nullptr;
-
-	// Get the QObject* the object argument refers to
-	QObject* obj = getQObjectFromPyArg(objArg);
-	if (!obj)
-		return nullptr;
-	objArg = nullptr; // no need to decref, it's borrowed
-
 	// Get the QMetaProperty for the property, so we can check
 	// if it's a set/enum and do name/value translation.
 	const QMetaObject* objmeta = obj->metaObject();
@@ -328,34 +314,36 @@ PyObject* scribus_getproperty(PyObject* /*self*/, PyObject* args, PyObject* kw)
 	return resultobj;
 }
 
-
-
-PyObject* scribus_setproperty(PyObject* /*self*/, PyObject* args, PyObject* kw)
+PyObject* scribus_getproperty(PyObject* /*self*/, PyObject* args, PyObject* kw)
 {
 	PyObject* objArg = nullptr;
 	char* propertyName = nullptr;
-	PyObject* objValue = nullptr;
 	char* kwargs[] = {const_cast<char*>("object"),
 					  const_cast<char*>("property"),
-					  const_cast<char*>("value"),
 					  nullptr};
-	if (!PyArg_ParseTupleAndKeywords(args, kw, "OesO", kwargs,
-				&objArg, "ascii", &propertyName, &objValue))
+	if (!PyArg_ParseTupleAndKeywords(args, kw, "Oes", kwargs,
+				&objArg, "ascii", &propertyName))
 		return nullptr;
 
-	// We're going to hang on to the value object for a while, so
-	// claim a reference to it.
-	Py_INCREF(objValue);
-
 	// Get the QObject* the object argument refers to
 	QObject* obj = getQObjectFromPyArg(objArg);
 	if (!obj)
 		return nullptr;
 	objArg = nullptr; // no need to decref, it's borrowed
 
+	return getPropertyValue(obj, propertyName);
+}
+
+/// Convert a Python object to the type of a property and set it, may return false with an exception set
+static bool setPropertyValue(QObject* obj, const char* propertyName, PyObject* objValue)
+{
 	const char* propertyTypeName = getpropertytype(obj, propertyName, true);
 	if (propertyTypeName == nullptr)
-		return nullptr;
+	{
+		PyErr_SetString(PyExc_ValueError,
+				QObject::tr("Property not found").toLocal8Bit().data());
+		return false;
+	}
 	QString propertyType = QString::fromLatin1(propertyTypeName);
 
 	// Did we know how to convert the value argument to the right type?
@@ -438,10 +426,9 @@ PyObject* scribus_setproperty(PyObject* /*self*/, PyObject* args, PyObject* kw)
 	// ... which I can't be stuffed supporting yet. FIXME.
 	else
 	{
-		Py_DECREF(objValue);
 		PyErr_SetString(PyExc_TypeError,
 				QObject::tr("Property type '%1' not supported").arg(propertyType).toLocal8Bit().constData());
-		return nullptr;
+		return false;
 	}
 
 	// If `matched' is false, we recognised the C type but weren't able to
@@ -450,27 +437,123 @@ PyObject* scribus_setproperty(PyObject* /*self*/, PyObject* args, PyObject* kw)
 	{
 		// Get a string representation of the object
 		PyObject* objRepr = PyObject_Repr(objValue);
-		Py_DECREF(objValue); // We're done with it now
 		if (!objRepr)
-			return nullptr;
+			return false;
 		// Extract the repr() string
 		QString reprString = PyUnicode_asQString(objRepr);
 		Py_DECREF(objRepr);
 
 		// And return an error
 		PyErr_SetString(PyExc_TypeError, QObject::tr("Couldn't convert '%1' to property type '%2'").arg(reprString, propertyType).toLocal8Bit().constData());
-		return nullptr;
+		return false;
 	}
 
 	// `success' is the return value of the setProperty() call
 	if (!success)
 	{
-		Py_DECREF(objValue);
 		PyErr_SetString(PyExc_ValueError, QObject::tr("Types matched, but setting property failed.").toLocal8Bit().constData());
+		return false;
+	}
+
+	return true;
+}
+
+PyObject* scribus_setproperty(PyObject* /*self*/, PyObject* args, PyObject* kw)
+{
+	PyObject* objArg = nullptr;
+	char* propertyName = nullptr;
+	PyObject* objValue = nullptr;
+	char* kwargs[] = {const_cast<char*>("object"),
+					  const_cast<char*>("property"),
+					  const_cast<char*>("value"),
+					  nullptr};
+	if (!PyArg_ParseTupleAndKeywords(args, kw, "OesO", kwargs,
+				&objArg, "ascii", &propertyName, &objValue))
+		return nullptr;
+
+	// Get the QObject* the object argument refers to
+	QObject* obj = getQObjectFromPyArg(objArg);
+	if (!obj)
+		return nullptr;
+	objArg = nullptr; // no need to decref, it's borrowed
+
+	if (!setPropertyValue(obj, propertyName, objValue))
+		return nullptr;
+	Py_RETURN_NONE;
+}
+
+PyObject* scribus_getproperties(PyObject* /*self*/, PyObject* args, PyObject* kw)
+{
+	PyObject* objList = nullptr;
+	char* propertyName = nullptr;
+	char* kwargs[] = {const_cast<char*>("objects"),
+					  const_cast<char*>("property"),
+					  nullptr};
+	if (!PyArg_ParseTupleAndKeywords(args, kw, "Oes", kwargs,
+				&objList, "ascii", &propertyName))
+		return nullptr;
+	if (!PyList_Check(objList) && !PyTuple_Check(objList))
+	{
+		PyErr_SetString(PyExc_TypeError, QObject::tr("Expected a list or tuple of objects").toLocal8Bit().constData());
+		return nullptr;
+	}
+
+	Py_ssize_t count = PySequence_Size(objList);
+	PyObject* resultList = PyList_New(count);
+	if (!resultList)
 		return nullptr;
+	for (Py_ssize_t i = 0; i < count; ++i)
+	{
+		// PySequence_Fast_GET_ITEM returns a borrowed reference
+		QObject* obj = getQObjectFromPyArg(PySequence_Fast_GET_ITEM(objList, i));
+		PyObject* value = obj ? getPropertyValue(obj, propertyName) : nullptr;
+		if (!value)
+		{
+			Py_DECREF(resultList);
+			return nullptr;
+		}
+		// PyList_SET_ITEM steals the reference to value
+		PyList_SET_ITEM(resultList, i, value);
 	}
+	return resultList;
+}
 
-	Py_DECREF(objValue);
+PyObject* scribus_setproperties(PyObject* /*self*/, PyObject* args, PyObject* kw)
+{
+	PyObject* objList = nullptr;
+	char* propertyName = nullptr;
+	PyObject* values = nullptr;
+	char* kwargs[] = {const_cast<char*>("objects"),
+					  const_cast<char*>("property"),
+					  const_cast<char*>("values"),
+					  nullptr};
+	if (!PyArg_ParseTupleAndKeywords(args, kw, "OesO", kwargs,
+				&objList, "ascii", &propertyName, &values))
+		return nullptr;
+	if (!PyList_Check(objList) && !PyTuple_Check(objList))
+	{
+		PyErr_SetString(PyExc_TypeError, QObject::tr("Expected a list or tuple of objects").toLocal8Bit().constData());
+		return nullptr;
+	}
+
+	// A value which is not a list or tuple is set on all objects
+	Py_ssize_t count = PySequence_Size(objList);
+	bool valueList = PyList_Check(values) || PyTuple_Check(values);
+	if (valueList && PySequence_Size(values) != count)
+	{
+		PyErr_SetString(PyExc_ValueError, QObject::tr("Lists of objects and values must have the same length").toLocal8Bit().constData());
+		return nullptr;
+	}
+
+	for (Py_ssize_t i = 0; i < count; ++i)
+	{
+		QObject* obj = getQObjectFromPyArg(PySequence_Fast_GET_ITEM(objList, i));
+		if (!obj)
+			return nullptr;
+		PyObject* value = valueList ? PySequence_Fast_GET_ITEM(values, i) : values;
+		if (!setPropertyValue(obj, propertyName, value))
+			return nullptr;
+	}
 	Py_RETURN_NONE;
 }
 
@@ -483,5 +566,7 @@ void cmdgetsetpropdocwarnings()
 	s << scribus_getproperty__doc__
 	  << scribus_getpropertynames__doc__
 	  << scribus_propertyctype__doc__
-	  << scribus_setproperty__doc__;
+	  << scribus_setproperty__doc__
+	  << scribus_getproperties__doc__
+	  << scribus_setproperties__doc__;
 }
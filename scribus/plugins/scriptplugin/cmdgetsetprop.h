@@ -166,6 +166,46 @@ See getProperty() for more information.\n\
 PyObject* scribus_setproperty(PyObject* /*self*/, PyObject* args, PyObject* kw);
 
 
+/**
+ * @brief Get a property of many objects in one call
+ *
+ * Looks up and converts each value like scribus_getproperty(), saving
+ * a Python call per object for scripts processing many items.
+ *
+ * @sa scribus_getproperty(), scribus_setproperties()
+ */
+PyDoc_STRVAR(scribus_getproperties__doc__,
+QT_TR_NOOP("getProperties(objects, property) -> list\n\
+\n\
+Return a list with the value of 'property' of each object in 'objects',\n\
+which must be a list or tuple of page item names or PyCObjects.\n\
+\n\
+See getProperty() for more information.\n\
+"));
+PyObject* scribus_getproperties(PyObject* /*self*/, PyObject* args, PyObject* kw);
+
+
+/**
+ * @brief Set a property of many objects in one call
+ *
+ * @sa scribus_setproperty(), scribus_getproperties()
+ */
+PyDoc_STRVAR(scribus_setproperties__doc__,
+QT_TR_NOOP("setProperties(objects, property, values)\n\
+\n\
+Set 'property' of each object in 'objects', a list or tuple of page item\n\
+names or PyCObjects. If 'values' is a list or tuple, it must have the same\n\
+length as 'objects' and each object gets the matching value, otherwise\n\
+'values' is set on all objects.\n\
+\n\
+Objects are processed in order and the first failure raises an exception,\n\
+leaving the objects before it changed.\n\
+\n\
+See setProperty() for more information.\n\
+"));
+PyObject* scribus_setproperties(PyObject* /*self*/, PyObject* args, PyObject* kw);
+
+
 /**
  * @brief Return a list of children of the passed object
  *
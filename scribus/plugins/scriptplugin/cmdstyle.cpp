@@ -153,8 +153,9 @@ PyObject *scribus_createparagraphstyle(PyObject* /* self */, PyObject* args, PyO
 	// PV - refresh the Style Manager window.
 	// I thought that this can work but it doesn't:
 	// ScCore->primaryMainWindow()->styleMgr()->reloadStyleView();
-	// So the brute force setDoc is called...
-	ScCore->primaryMainWindow()->styleMgr()->setDoc(ScCore->primaryMainWindow()->doc);
+	// So the brute force setDoc is called, once at the end of a batch
+	if (!ScCore->primaryMainWindow()->doc->inBatch())
+		ScCore->primaryMainWindow()->styleMgr()->setDoc(ScCore->primaryMainWindow()->doc);
 
 	Py_RETURN_NONE;
 }
@@ -305,8 +306,9 @@ PyObject *scribus_createcharstyle(PyObject* /* self */, PyObject* args, PyObject
 	// PV - refresh the Style Manager window.
 	// I thought that this can work but it doesn't:
 	// ScCore->primaryMainWindow()->styleMgr()->reloadStyleView();
-	// So the brute force setDoc is called...
-	ScCore->primaryMainWindow()->styleMgr()->setDoc(ScCore->primaryMainWindow()->doc);
+	// So the brute force setDoc is called, once at the end of a batch
+	if (!ScCore->primaryMainWindow()->doc->inBatch())
+		ScCore->primaryMainWindow()->styleMgr()->setDoc(ScCore->primaryMainWindow()->doc);
 
 	Py_RETURN_NONE;
 }
@@ -604,7 +604,11 @@ PyObject *scribus_layouttext(PyObject* /* self */, PyObject* args)
 		PyErr_SetString(WrongFrameTypeError, QObject::tr("Cannot layout text of a non-text frame.", "python error").toLocal8Bit().constData());
 		return nullptr;
 	}
-	item->layout();
+	// Batches lay out all invalid text frames when they end
+	if (ScCore->primaryMainWindow()->doc->inBatch())
+		item->invalidateLayout();
+	else
+		item->layout();
 
 	Py_RETURN_NONE;
 }
@@ -625,6 +629,12 @@ PyObject *scribus_layouttextchain(PyObject* /* self */, PyObject* args)
 		return nullptr;
 	}
 
+	if (ScCore->primaryMainWindow()->doc->inBatch())
+	{
+		item->invalidateLayout();
+		Py_RETURN_NONE;
+	}
+
 	if (item->isPathText())
 	{
 		item->layout();
@@ -8,12 +8,14 @@ for which a new license (GPL+exception) is in place.
 #include "cmdutil.h"
 #include "prefsmanager.h"
 #include "resourcecollection.h"
+#include "scguardedptr.h"
 #include "scpage.h"
 #include "scribuscore.h"
 #include "scribusdoc.h"
 #include "scribusview.h"
 #include "selection.h"
 #include "tableborder.h"
+#include "ui/stylemanager.h"
 #include "units.h"
 
 #include <QMap>
@@ -61,13 +63,7 @@ PageItem *GetItem(const QString& name)
 {
 	ScribusDoc* currentDoc = ScCore->primaryMainWindow()->doc;
 	if (!name.isEmpty())
-	{
-		for (int i = 0; i < currentDoc->Items->count(); ++i)
-		{
-			if (currentDoc->Items->at(i)->itemName() == name)
-				return currentDoc->Items->at(i);
-		}
-	}
+		return currentDoc->itemByName(name);
 	else
 	{
 		if (currentDoc->m_Selection->count() != 0)
@@ -117,12 +113,9 @@ PageItem* getPageItemByName(const QString& name)
 		return nullptr;
 	}
 
-	ScribusDoc* currentDoc = ScCore->primaryMainWindow()->doc;
-	for (int i = 0; i < currentDoc->Items->count(); ++i)
-	{
-		if (name == currentDoc->Items->at(i)->itemName())
-			return currentDoc->Items->at(i);
-	}
+	PageItem* item = ScCore->primaryMainWindow()->doc->itemByName(name);
+	if (item)
+		return item;
 
 	PyErr_SetString(NoValidObjectError, QString("Object not found").toLocal8Bit().constData());
 	return nullptr;
@@ -139,13 +132,7 @@ bool ItemExists(const QString& name)
 	if (name.length() == 0)
 		return false;
 
-	ScribusDoc* currentDoc = ScCore->primaryMainWindow()->doc;
-	for (int i = 0; i < currentDoc->Items->count(); ++i)
-	{
-		if (name == currentDoc->Items->at(i)->itemName())
-			return true;
-	}
-	return false;
+	return ScCore->primaryMainWindow()->doc->itemByName(name) != nullptr;
 }
 
 /*!
@@ -165,6 +152,40 @@ bool checkHaveDocument()
 	return false;
 }
 
+namespace
+{
+	/// documents of the batches started by scripts, the most recent one last
+	QList<ScGuardedPtr<ScribusDoc> > scriptBatchDocs;
+}
+
+void beginScriptBatch()
+{
+	ScribusDoc* doc = ScCore->primaryMainWindow()->doc;
+	doc->beginBatch();
+	scriptBatchDocs.append(doc->guardedPtr());
+}
+
+void endScriptBatch(bool allLevels)
+{
+	ScribusMainWindow* mainWin = ScCore->primaryMainWindow();
+	bool currentDocEnded = false;
+	while (!scriptBatchDocs.isEmpty())
+	{
+		ScribusDoc* doc = scriptBatchDocs.takeLast();
+		if (doc && doc->inBatch())
+		{
+			doc->endBatch();
+			if (mainWin->HaveDoc && (doc == mainWin->doc) && !doc->inBatch())
+				currentDocEnded = true;
+		}
+		if (!allLevels)
+			break;
+	}
+	// Style commands skip refreshing the style manager during a batch
+	if (currentDocEnded)
+		mainWin->styleMgr()->setDoc(mainWin->doc);
+}
+
 bool checkValidPageNumber(int page)
 {
 	const int numPages = ScCore->primaryMainWindow()->doc->Pages->count();
@@ -198,13 +219,8 @@ bool setSelectedItemsByName(const QStringList& itemNames)
 	// For each named item
 	for (auto it = itemNames.begin() ; it != itemNames.end() ; it++)
 	{
-		// Search for the named item
-		PageItem* item = nullptr;
-		for (int j = 0; j < currentDoc->Items->count(); j++)
-		{
-			if (*it == currentDoc->Items->at(j)->itemName())
-				item = currentDoc->Items->at(j);
-		}
+		// Search for the named item, the last one if several items share the name
+		PageItem* item = currentDoc->itemByName(*it, true);
 		if (!item)
 			return false;
 		// And select it
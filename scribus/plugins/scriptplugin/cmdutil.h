@@ -54,6 +54,21 @@ PageItem* getPageItemByName(const QString& name);
 // 2004-10-27 Craig Ringer see cmdutil.cpp for description
 bool checkHaveDocument();
 
+/*!
+ * Starts a batch of changes of the current document for beginBatch() and
+ * remembers the document, the script may switch to another one before the
+ * batch ends.
+ */
+void beginScriptBatch();
+
+/*!
+ * Ends the most recent batch started by beginScriptBatch(), or all of them if
+ * allLevels is true, in the documents they were started in, and refreshes the
+ * style manager once the current document has left its outermost batch.
+ * Batches of documents closed in the meantime are skipped.
+ */
+void endScriptBatch(bool allLevels = false);
+
 /*!
  * @brief Returns true if the page number is between 0 and the number of pages.
  *
@@ -113,6 +113,7 @@ typedef struct
 	int hideMenuBar;
 	int fitWindow;
 	PyObject *openAction;
+	int linearize; // bool - optimize for fast web view
 
 } PDFfile;
 
@@ -334,6 +335,7 @@ static PyObject * PDFfile_new(PyTypeObject *type, PyObject * /*args*/, PyObject
 			Py_DECREF(self);
 			return nullptr;
 		}
+		self->linearize = 0;
 	}
 	return (PyObject *) self;
 }
@@ -726,6 +728,7 @@ static int PDFfile_init(PDFfile *self, PyObject * /*args*/, PyObject * /*kwds*/)
 		PyErr_SetString(PyExc_SystemError, "Can not initialize 'openAction' attribute");
 		return -1;
 	}
+	self->linearize = pdfOptions.linearize; // bool
 
 	return 0;
 }
@@ -785,6 +788,7 @@ static PyMemberDef PDFfile_members[] = {
 	{const_cast<char*>("hideToolBar"), T_INT, offsetof(PDFfile, hideToolBar), 0, const_cast<char*>("Hide the viewer toolbar. The toolbar has usually selection and other editing capabilities.")},
 	{const_cast<char*>("hideMenuBar"), T_INT, offsetof(PDFfile, hideMenuBar), 0, const_cast<char*>("Hide the viewer menu bar, the PDF will display in a plain window.")},
 	{const_cast<char*>("fitWindow"), T_INT, offsetof(PDFfile, fitWindow), 0, const_cast<char*>("Fit the document page or pages to the available space in the viewer window.")},
+	{const_cast<char*>("linearize"), T_INT, offsetof(PDFfile, linearize), 0, const_cast<char*>("Linearize the PDF (Fast Web View), so viewers can show the first page before the whole file is loaded. Not available with encryption. Bool value")},
 	/** Deprecated members */
 	{const_cast<char*>("aprint"), T_INT, offsetof(PDFfile, allowPrinting), 0, const_cast<char*>("Deprecated. Use 'allowPrinting' instead.")},
 	{const_cast<char*>("achange"), T_INT, offsetof(PDFfile, allowChange), 0, const_cast<char*>("Deprecated. Use 'allowChange' instead.")},
@@ -1647,6 +1651,7 @@ static PyObject *PDFfile_save(PDFfile *self)
 	pdfOptions.hideMenuBar = self->hideMenuBar;
 	pdfOptions.fitWindow = self->fitWindow;
 	pdfOptions.openAction = PyUnicode_asQString(self->openAction);
+	pdfOptions.linearize = self->linearize;
 	pdfOptions.firstUse = false;
 
 	QString errorMessage;
@@ -365,6 +365,8 @@ void ScripterCore::slotRunScriptFile(const QString& fileName, QStringList argume
 		// Because 'result' may be nullptr, not a PyObject*, we must call PyXDECREF not Py_DECREF
 		Py_XDECREF(result);
 	} // end if m == nullptr
+	// A script may have failed or forgotten to end its batch
+	endScriptBatch(true);
 	if (!inMainInterpreter)
 	{
 		Py_EndInterpreter(state);
@@ -458,6 +460,7 @@ void ScripterCore::slotRunScript(const QString& Script)
 		// Because 'result' may be nullptr, not a PyObject*, we must call PyXDECREF not Py_DECREF
 			Py_XDECREF(result);
 	}
+	endScriptBatch(true);
 	ScCore->primaryMainWindow()->setScriptRunning(false);
 
 	enableMainWindowMenu();
@@ -285,6 +285,7 @@ PyMethodDef scribus_methods[] = {
 	// 2004/10/03 pv - aliases with common Python syntax - ClassName methodName
 	// 2004-11-06 cr - move aliasing to dynamically generated wrapper functions, sort methoddef
 	{const_cast<char*>("applyMasterPage"), scribus_applymasterpage, METH_VARARGS, tr(scribus_applymasterpage__doc__)},
+	{const_cast<char*>("beginBatch"), (PyCFunction)scribus_beginbatch, METH_NOARGS, tr(scribus_beginbatch__doc__)},
 	{const_cast<char*>("changeColor"), scribus_setcolor, METH_VARARGS, tr(scribus_setcolor__doc__)},
 	{const_cast<char*>("changeColorCMYK"), scribus_setcolorcmyk, METH_VARARGS, tr(scribus_setcolorcmyk__doc__)},
 	{const_cast<char*>("changeColorCMYKFloat"), scribus_setcolorcmykfloat, METH_VARARGS, tr(scribus_setcolorcmykfloat__doc__)},
@@ -327,6 +328,7 @@ PyMethodDef scribus_methods[] = {
 	{const_cast<char*>("deselectAll"), (PyCFunction)scribus_deselectall, METH_NOARGS, tr(scribus_deselectall__doc__)},
 	{const_cast<char*>("docChanged"), scribus_docchanged, METH_VARARGS, tr(scribus_docchanged__doc__)},
 	{const_cast<char*>("editMasterPage"), scribus_editmasterpage, METH_VARARGS, tr(scribus_editmasterpage__doc__)},
+	{const_cast<char*>("endBatch"), (PyCFunction)scribus_endbatch, METH_NOARGS, tr(scribus_endbatch__doc__)},
 	{const_cast<char*>("fileDialog"), (PyCFunction)scribus_filedialog, METH_VARARGS|METH_KEYWORDS, tr(scribus_filedialog__doc__)},
 	{const_cast<char*>("fileQuit"), scribus_filequit, METH_VARARGS, tr(scribus_filequit__doc__)},
 	{const_cast<char*>("flipObject"), scribus_flipobject, METH_VARARGS, tr(scribus_flipobject__doc__)},
@@ -601,7 +603,9 @@ PyMethodDef scribus_methods[] = {
 	// Property magic
 	{const_cast<char*>("getPropertyCType"), (PyCFunction)scribus_propertyctype, METH_VARARGS|METH_KEYWORDS, tr(scribus_propertyctype__doc__)},
 	{const_cast<char*>("getPropertyNames"), (PyCFunction)scribus_getpropertynames, METH_VARARGS|METH_KEYWORDS, tr(scribus_getpropertynames__doc__)},
+	{const_cast<char*>("getProperties"), (PyCFunction)scribus_getproperties, METH_VARARGS|METH_KEYWORDS, tr(scribus_getproperties__doc__)},
 	{const_cast<char*>("getProperty"), (PyCFunction)scribus_getproperty, METH_VARARGS|METH_KEYWORDS, tr(scribus_getproperty__doc__)},
+	{const_cast<char*>("setProperties"), (PyCFunction)scribus_setproperties, METH_VARARGS|METH_KEYWORDS, tr(scribus_setproperties__doc__)},
 	{const_cast<char*>("setProperty"), (PyCFunction)scribus_setproperty, METH_VARARGS|METH_KEYWORDS, tr(scribus_setproperty__doc__)},
 // 	{const_cast<char*>("getChildren"), (PyCFunction)scribus_getchildren, METH_VARARGS|METH_KEYWORDS, tr(scribus_getchildren__doc__)},
 // 	{const_cast<char*>("getChild"), (PyCFunction)scribus_getchild, METH_VARARGS|METH_KEYWORDS, tr(scribus_getchild__doc__)},
@@ -978,6 +982,27 @@ PyObject* PyInit_scribus(void)
 		return nullptr;
 	}
 	PyDict_SetItemString(d, "warnings", warningsModule);
+	// batch() context manager, ending the batch even if the block raises an exception
+	PyObject* batchResult = PyRun_String(
+		"import contextlib as _contextlib\n"
+		"@_contextlib.contextmanager\n"
+		"def batch():\n"
+		"    \"\"\"batch()\n\n"
+		"    Context manager running its block as a batch of changes to the current\n"
+		"    document, see beginBatch() and endBatch().\n"
+		"    \"\"\"\n"
+		"    beginBatch()\n"
+		"    try:\n"
+		"        yield\n"
+		"    finally:\n"
+		"        endBatch()\n",
+		Py_file_input, d, d);
+	if (batchResult == nullptr)
+	{
+		qDebug("Failed to create the batch() context manager.");
+		PyErr_Print();
+	}
+	Py_XDECREF(batchResult);
 	// Create the module-level docstring. This can be a proper unicode string, unlike
 	// the others, because we can just create a Unicode object and insert it in our
 	// module dictionary.
@@ -455,12 +455,15 @@ void PrefsManager::initDefaults()
 	appPrefs.pdfPrefs.Articles = false;
 	appPrefs.pdfPrefs.useLayers = false;
 	appPrefs.pdfPrefs.Compress = true;
+	appPrefs.pdfPrefs.useObjectStreams = true;
+	appPrefs.pdfPrefs.linearize = false;
 	appPrefs.pdfPrefs.CompressMethod = PDFOptions::Compression_Auto;
 	appPrefs.pdfPrefs.Quality = 0;
 	appPrefs.pdfPrefs.RecalcPic = false;
 	appPrefs.pdfPrefs.embedPDF  = false;
 	appPrefs.pdfPrefs.Bookmarks = false;
 	appPrefs.pdfPrefs.PicRes = 300;
+	appPrefs.pdfPrefs.downsampleFilter = 0;
 	appPrefs.pdfPrefs.Version = PDFVersion::PDF_14;
 	appPrefs.pdfPrefs.Resolution = 300;
 	appPrefs.pdfPrefs.Binding = 0;
@@ -518,6 +521,8 @@ void PrefsManager::initDefaults()
 	appPrefs.imageCachePrefs.maxCacheSizeMiB = 1000;
 	appPrefs.imageCachePrefs.maxCacheEntries = 1000;
 	appPrefs.imageCachePrefs.compressionLevel = 1;
+	appPrefs.imageCachePrefs.memoryPoolSizeMiB = 256;
+	appPrefs.imageCachePrefs.fontSubsetCacheSizeMiB = 64;
 	appPrefs.activePageSizes.clear();
 	appPrefs.activePageSizes << "A3" << "A4" << "A5" << "A6" << "Letter";
 
@@ -1796,6 +1801,8 @@ bool PrefsManager::writePref(const QString& filePath)
 	pdf.setAttribute("Articles", static_cast<int>(appPrefs.pdfPrefs.Articles));
 	pdf.setAttribute("Bookmarks", static_cast<int>(appPrefs.pdfPrefs.Bookmarks));
 	pdf.setAttribute("Compress", static_cast<int>(appPrefs.pdfPrefs.Compress));
+	pdf.setAttribute("UseObjectStreams", static_cast<int>(appPrefs.pdfPrefs.useObjectStreams));
+	pdf.setAttribute("Linearize", static_cast<int>(appPrefs.pdfPrefs.linearize));
 	pdf.setAttribute("CompressionMethod", appPrefs.pdfPrefs.CompressMethod);
 	pdf.setAttribute("Quality", appPrefs.pdfPrefs.Quality);
 	pdf.setAttribute("EmbedPDF", static_cast<int>(appPrefs.pdfPrefs.embedPDF));
@@ -1811,6 +1818,7 @@ bool PrefsManager::writePref(const QString& filePath)
 	pdf.setAttribute("UseProfiles2", static_cast<int>(appPrefs.pdfPrefs.UseProfiles2));
 	pdf.setAttribute("Binding", appPrefs.pdfPrefs.Binding);
 	pdf.setAttribute("PicRes", appPrefs.pdfPrefs.PicRes);
+	pdf.setAttribute("DownsampleFilter", appPrefs.pdfPrefs.downsampleFilter);
 	pdf.setAttribute("Resolution", appPrefs.pdfPrefs.Resolution);
 	pdf.setAttribute("Version", appPrefs.pdfPrefs.Version);
 	pdf.setAttribute("FontEmbedding", static_cast<int>(appPrefs.pdfPrefs.FontEmbedding));
@@ -1897,6 +1905,8 @@ bool PrefsManager::writePref(const QString& filePath)
 	icElem.setAttribute("MaximumCacheSizeMiB", appPrefs.imageCachePrefs.maxCacheSizeMiB);
 	icElem.setAttribute("MaximumCacheEntries", appPrefs.imageCachePrefs.maxCacheEntries);
 	icElem.setAttribute("CompressionLevel", appPrefs.imageCachePrefs.compressionLevel);
+	icElem.setAttribute("MemoryPoolSizeMiB", appPrefs.imageCachePrefs.memoryPoolSizeMiB);
+	icElem.setAttribute("FontSubsetCacheSizeMiB", appPrefs.imageCachePrefs.fontSubsetCacheSizeMiB);
 	elem.appendChild(icElem);
 	// active page sizes
 	QDomElement apsElem = docu.createElement("ActivePageSizes");
@@ -2579,6 +2589,8 @@ bool PrefsManager::readPref(const QString& filePath)
 			appPrefs.pdfPrefs.Articles = static_cast<bool>(dc.attribute("Articles").toInt());
 			appPrefs.pdfPrefs.Thumbnails = static_cast<bool>(dc.attribute("Thumbnails").toInt());
 			appPrefs.pdfPrefs.Compress = static_cast<bool>(dc.attribute("Compress").toInt());
+			appPrefs.pdfPrefs.useObjectStreams = static_cast<bool>(dc.attribute("UseObjectStreams", "1").toInt());
+			appPrefs.pdfPrefs.linearize = static_cast<bool>(dc.attribute("Linearize", "0").toInt());
 			appPrefs.pdfPrefs.CompressMethod = (PDFOptions::PDFCompression) dc.attribute("CompressMethod", "0").toInt();
 			appPrefs.pdfPrefs.Quality = dc.attribute("Quality", "0").toInt();
 			appPrefs.pdfPrefs.embedPDF  = dc.attribute("EmbedPDF", "0").toInt();
@@ -2590,6 +2602,7 @@ bool PrefsManager::readPref(const QString& filePath)
 			appPrefs.pdfPrefs.RotateDeg = dc.attribute("RotateDeg", "0").toInt();
 			appPrefs.pdfPrefs.PresentMode = static_cast<bool>(dc.attribute("PresentMode").toInt());
 			appPrefs.pdfPrefs.PicRes = dc.attribute("PicRes").toInt();
+			appPrefs.pdfPrefs.downsampleFilter = dc.attribute("DownsampleFilter", "0").toInt();
 			appPrefs.pdfPrefs.Version = (PDFVersion::Version) dc.attribute("Version").toInt();
 			appPrefs.pdfPrefs.Resolution = dc.attribute("Resolution").toInt();
 			appPrefs.pdfPrefs.Binding = dc.attribute("Binding").toInt();
@@ -2708,6 +2721,8 @@ bool PrefsManager::readPref(const QString& filePath)
 			appPrefs.imageCachePrefs.maxCacheSizeMiB = dc.attribute("MaximumCacheSizeMiB", "1000").toInt();
 			appPrefs.imageCachePrefs.maxCacheEntries = dc.attribute("MaximumCacheEntries", "1000").toInt();
 			appPrefs.imageCachePrefs.compressionLevel = dc.attribute("CompressionLevel", "1").toInt();
+			appPrefs.imageCachePrefs.memoryPoolSizeMiB = dc.attribute("MemoryPoolSizeMiB", "256").toInt();
+			appPrefs.imageCachePrefs.fontSubsetCacheSizeMiB = dc.attribute("FontSubsetCacheSizeMiB", "64").toInt();
 		}
 		// active page sizes
 		if (dc.tagName() == "ActivePageSizes")
@@ -465,6 +465,8 @@ struct ImageCachePrefs
 	int maxCacheSizeMiB;  //!< Maximum total size of image cache in MiB
 	int maxCacheEntries;  //!< Maximum number of cache entries
 	int compressionLevel; //!< Cache image compression level (see QImage)
+	int memoryPoolSizeMiB; //!< Maximum size of the decoded images shared by the frames of a document in MiB
+	int fontSubsetCacheSizeMiB; //!< Maximum total size of the font subset cache used by the PDF export in MiB, 0 disables it
 };
 
 struct ExperimentalFeaturePrefs
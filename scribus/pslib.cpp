@@ -34,6 +34,7 @@ for which a new license (GPL+exception) is in place.
 #include <QRegularExpression>
 #include <QBuffer>
 #include <QStack>
+#include <QStringList>
 
 #include "api/api_application.h"
 #include "cmsettings.h"
@@ -247,7 +248,8 @@ static QString sanitizeItemName(const QString& itemName)
 }
 
 PSLib::PSLib(ScribusDoc* doc, PrintOptions &options, OutputFormat outputFmt, ColorList *docColors)
-	: m_Doc(doc), m_outputFormat(outputFmt)
+	: m_Doc(doc), m_outputFormat(outputFmt),
+	m_imagePrefetcher(PrefsManager::instance().appPrefs.imageCachePrefs.memoryPoolSizeMiB)
 {
 	Options = options;
 	Creator = ScribusAPI::getVersionScribus();
@@ -1278,9 +1280,115 @@ bool PSLib::PS_ImageData(PageItem *item, const QString& fn, const QString& Name,
 	return true;
 }
 
+void PSLib::prefetchImages(const std::vector<int>& pageNs)
+{
+	// items in the order of the pages, each page showing its master page items first
+	QList<PageItem*> items;
+	for (size_t i = 0; i < pageNs.size(); ++i)
+	{
+		const ScPage* page = m_Doc->Pages->at(pageNs[i] - 1);
+		int masterIndex = m_Doc->MasterNames.value(page->masterPageName(), -1);
+		for (int j = 0; j < m_Doc->MasterItems.count(); ++j)
+		{
+			if ((masterIndex >= 0) && (m_Doc->MasterItems.at(j)->OwnPage == masterIndex))
+				items.append(m_Doc->MasterItems.at(j));
+		}
+		for (int j = 0; j < m_Doc->Items->count(); ++j)
+		{
+			if (m_Doc->Items->at(j)->OwnPage == pageNs[i] - 1)
+				items.append(m_Doc->Items->at(j));
+		}
+	}
+
+	for (int i = 0; i < items.count(); ++i)
+	{
+		PageItem* item = items.at(i);
+		if (item->isGroup())
+		{
+			items.append(item->groupItemList);
+			continue;
+		}
+		if (!item->isImageFrame() || !item->imageIsAvailable || item->Pfile.isEmpty() || !item->printEnabled())
+			continue;
+		QString key = imageKey(item, item->Pfile, item->ImageProfile, item->UseEmbedded);
+		if (!key.isEmpty() && !m_imagePrefetcher.addUser(key, item))
+			m_imagePrefetcher.add(key, item, imageDecoder(item, item->Pfile, item->ImageProfile, item->UseEmbedded));
+	}
+	m_imagePrefetcher.start();
+}
+
+QString PSLib::imageKey(const PageItem* item, const QString& fn, const QString& Prof, bool UseEmbedded) const
+{
+	// EPS files are copied to the output, render frames and images loaded with requests are left out
+	if (item->isLatexFrame() || item->pixm.imgInfo.isRequest || !item->pixm.imgInfo.RequestProps.isEmpty())
+		return QString();
+	QFileInfo fi(fn);
+	QString ext = fi.suffix().toLower();
+	if (ext.isEmpty())
+		ext = getImageType(fn);
+	if (extensionIndicatesEPS(ext) && (item->pixm.imgInfo.type != ImageType7))
+		return QString();
+
+	QStringList keyParts;
+	keyParts << fn
+			 << QString::number(item->pixm.imgInfo.actualPageNumber)
+			 << QString::number(static_cast<int>(item->pixm.imgInfo.type == ImageType7))
+			 << (item->effectsInUse.isEmpty() ? QString() : item->getImageEffectsModifier())
+			 << Prof
+			 << QString::number(static_cast<int>(UseEmbedded))
+			 << QString::number(static_cast<int>(item->ImageIntent));
+	return keyParts.join(QChar('\n'));
+}
+
+ScImagePrefetcher::Decoder PSLib::imageDecoder(PageItem* item, const QString& fn, const QString& Prof, bool UseEmbedded) const
+{
+	// colorsToUse is copied, the decoder must not touch PSLib once the next page is written
+	CMSettings cms(item->doc(), Prof, item->ImageIntent);
+	cms.allowColorManagement(true);
+	cms.setUseEmbeddedProfile(UseEmbedded);
+	int resolution = 300;
+	if (item->isLatexFrame())
+		resolution = item->asLatexFrame()->realDpi();
+	else if (item->pixm.imgInfo.type == ImageType7)
+		resolution = 72;
+	int page = item->pixm.imgInfo.actualPageNumber;
+	QMap<int, ImageLoadRequest> requestProps = item->pixm.imgInfo.RequestProps;
+	bool isRequest = item->pixm.imgInfo.isRequest;
+	bool loadMask = (item->pixm.imgInfo.type != ImageType7);
+	ScImageEffectList effects = item->effectsInUse;
+	ColorList colors;
+	if (!effects.isEmpty())
+		colors = colorsToUse;
+
+	return [=](ScImagePrefetcher::DecodedImage& decoded) mutable
+	{
+		bool dummy;
+		ScImage& image = decoded.image;
+		image.imgInfo.valid = false;
+		image.imgInfo.clipPath = "";
+		image.imgInfo.PDSpathData.clear();
+		image.imgInfo.layerInfo.clear();
+		image.imgInfo.RequestProps = requestProps;
+		image.imgInfo.isRequest = isRequest;
+		decoded.loaded = image.loadPicture(fn, page, cms, ScImage::CMYKData, resolution, &dummy);
+		if (!decoded.loaded)
+			return;
+		image.applyEffect(effects, colors, true);
+		if (loadMask)
+		{
+			ScImage img2;
+			img2.imgInfo.clipPath = "";
+			img2.imgInfo.PDSpathData.clear();
+			img2.imgInfo.layerInfo.clear();
+			img2.imgInfo.RequestProps = requestProps;
+			img2.imgInfo.isRequest = isRequest;
+			decoded.maskLoaded = img2.getAlpha(fn, page, decoded.mask, false, true, resolution);
+		}
+	};
+}
+
 bool PSLib::PS_image(PageItem *item, double x, double y, const QString& fn, double scalex, double scaley, const QString& Prof, bool UseEmbedded, const QString& Name)
 {
-	bool dummy;
 	QByteArray tmp;
 
 	QFileInfo fi(fn);
@@ -1323,28 +1431,17 @@ bool PSLib::PS_image(PageItem *item, double x, double y, const QString& fn, doub
 		return false;
 	}
 
-	ScImage image;
-	image.imgInfo.valid = false;
-	image.imgInfo.clipPath = "";
-	image.imgInfo.PDSpathData.clear();
-	image.imgInfo.layerInfo.clear();
-	image.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
-	image.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
-	CMSettings cms(item->doc(), Prof, item->ImageIntent);
-	cms.allowColorManagement(true);
-	cms.setUseEmbeddedProfile(UseEmbedded);
-	int resolution = 300;
-	if (item->isLatexFrame())
-		resolution = item->asLatexFrame()->realDpi();
-	else if (item->pixm.imgInfo.type == ImageType7)
-		resolution = 72;
-	//	int resolution = (item->pixm.imgInfo.type == ImageType7) ? 72 : 300;
-	if ( !image.loadPicture(fn, item->pixm.imgInfo.actualPageNumber, cms, ScImage::CMYKData, resolution, &dummy) )
+	// loaded with effects applied and its mask, usually by a worker thread ahead of the export
+	ScImagePrefetcher::DecodedImage decoded;
+	QString key = imageKey(item, fn, Prof, UseEmbedded);
+	if (key.isEmpty() || !m_imagePrefetcher.take(key, item, decoded))
+		imageDecoder(item, fn, Prof, UseEmbedded)(decoded);
+	if (!decoded.loaded)
 	{
 		PS_Error_ImageLoadFailure(fn);
 		return false;
 	}
-	image.applyEffect(item->effectsInUse, colorsToUse, true);
+	const ScImage& image = decoded.image;
 	int w = image.width();
 	int h = image.height();
 	PutStream(ToStr(x*scalex) + " " + ToStr(y*scaley) + " tr\n");
@@ -1359,21 +1456,11 @@ bool PSLib::PS_image(PageItem *item, double x, double y, const QString& fn, doub
 	//	PutStream(ToStr(x*scalex) + " " + ToStr(y*scaley) + " tr\n");
 	PutStream(ToStr(qRound(scalex*w)) + " " + ToStr(qRound(scaley*h)) + " sc\n");
 	PutStream(((!DoSep) && (!GraySc)) ? "/DeviceCMYK setcolorspace\n" : "/DeviceGray setcolorspace\n");
-	QByteArray maskArray;
-	ScImage img2;
-	img2.imgInfo.clipPath = "";
-	img2.imgInfo.PDSpathData.clear();
-	img2.imgInfo.layerInfo.clear();
-	img2.imgInfo.RequestProps = item->pixm.imgInfo.RequestProps;
-	img2.imgInfo.isRequest = item->pixm.imgInfo.isRequest;
-	if (item->pixm.imgInfo.type != ImageType7)
+	const QByteArray& maskArray = decoded.mask;
+	if (!decoded.maskLoaded)
 	{
-		bool alphaLoaded = img2.getAlpha(fn, item->pixm.imgInfo.actualPageNumber, maskArray, false, true, resolution);
-		if (!alphaLoaded)
-		{
-			PS_Error_MaskLoadFailure(fn);
-			return false;
-		}
+		PS_Error_MaskLoadFailure(fn);
+		return false;
 	}
 	if ((maskArray.size() > 0) && (item->pixm.imgInfo.type != ImageType7))
 	{
@@ -1704,6 +1791,8 @@ int PSLib::createPS(const QString& outputFileName)
 		errorOccured = !PS_begin_doc(0.0, 0.0, maxWidth, maxHeight, pageNs.size() * pagemult);
 	}
 
+	if (!errorOccured)
+		prefetchImages(pageNs);
 	sepac = 0;
 	uint aa = 0;
 	uint a;
@@ -2915,6 +3004,8 @@ void PSLib::HandleMeshGradient(PageItem* item)
 			}
 		}
 	}
+	QList<CMYKColorF> colorsCMYK;
+	SetColors(cols, colsSh, colorsCMYK);
 	for (int ac = 0; ac < cols.count(); ac++)
 	{
 		QString colorVal;
@@ -2933,7 +3024,7 @@ void PSLib::HandleMeshGradient(PageItem* item)
 			}
 			else
 			{
-				SetColor(cols.at(ac), colsSh.at(ac), &ch, &cs, &cv, &ck);
+				colorsCMYK.at(ac).getValues(ch, cs, cv, ck);
 				colorVal += hs.setNum(ch) + " " + ss.setNum(cs) + " " + vs.setNum(cv) + " " + ks.setNum(ck);
 				for (int sc = 0; sc < spotColorSet.count(); sc++)
 				{
@@ -2944,7 +3035,7 @@ void PSLib::HandleMeshGradient(PageItem* item)
 		}
 		else
 		{
-			SetColor(cols.at(ac), colsSh.at(ac), &ch, &cs, &cv, &ck);
+			colorsCMYK.at(ac).getValues(ch, cs, cv, ck);
 			if (GraySc)
 				colorVal += hs.setNum(1.0 - qMin(0.3 * ch + 0.59 * cs + 0.11 * cv + ck, 1.0));
 			else
@@ -3096,6 +3187,8 @@ void PSLib::HandlePatchMeshGradient(PageItem* item)
 				spotColorSet.append(mp4.colorName);
 		}
 	}
+	QList<CMYKColorF> colorsCMYK;
+	SetColors(cols, colsSh, colorsCMYK);
 	for (int ac = 0; ac < cols.count(); ac++)
 	{
 		QString colorVal;
@@ -3114,7 +3207,7 @@ void PSLib::HandlePatchMeshGradient(PageItem* item)
 			}
 			else
 			{
-				SetColor(cols.at(ac), colsSh.at(ac), &ch, &cs, &cv, &ck);
+				colorsCMYK.at(ac).getValues(ch, cs, cv, ck);
 				colorVal += hs.setNum(ch) + " " + ss.setNum(cs) + " " + vs.setNum(cv) + " " + ks.setNum(ck);
 				for (int sc = 0; sc < spotColorSet.count(); sc++)
 				{
@@ -3125,7 +3218,7 @@ void PSLib::HandlePatchMeshGradient(PageItem* item)
 		}
 		else
 		{
-			SetColor(cols.at(ac), colsSh.at(ac), &ch, &cs, &cv, &ck);
+			colorsCMYK.at(ac).getValues(ch, cs, cv, ck);
 			if (GraySc)
 				colorVal += hs.setNum(1.0 - qMin(0.3 * ch + 0.59 * cs + 0.11 * cv + ck, 1.0));
 			else
@@ -3273,6 +3366,8 @@ void PSLib::HandleDiamondGradient(PageItem* item)
 		}
 		qStopRampPoints.append(colorStops.at(cst)->rampPoint);
 	}
+	QList<CMYKColorF> colorsCMYK;
+	SetColors(cols, colsSh, colorsCMYK);
 	for (int ac = 0; ac < cols.count(); ac++)
 	{
 		QString colorVal;
@@ -3291,7 +3386,7 @@ void PSLib::HandleDiamondGradient(PageItem* item)
 			}
 			else
 			{
-				SetColor(cols.at(ac), colsSh.at(ac), &ch, &cs, &cv, &ck);
+				colorsCMYK.at(ac).getValues(ch, cs, cv, ck);
 				colorVal += hs.setNum(ch) + " " + ss.setNum(cs) + " " + vs.setNum(cv) + " " + ks.setNum(ck);
 				for (int sc = 0; sc < spotColorSet.count(); sc++)
 				{
@@ -3302,7 +3397,7 @@ void PSLib::HandleDiamondGradient(PageItem* item)
 		}
 		else
 		{
-			SetColor(cols.at(ac), colsSh.at(ac), &ch, &cs, &cv, &ck);
+			colorsCMYK.at(ac).getValues(ch, cs, cv, ck);
 			if (GraySc)
 				colorVal += hs.setNum(1.0 - qMin(0.3 * ch + 0.59 * cs + 0.11 * cv + ck, 1.0));
 			else
@@ -3512,6 +3607,8 @@ void PSLib::HandleTensorGradient(PageItem* item)
 	PutStream(ToStr(item->GrControl4.x()) + " " + ToStr(-item->GrControl4.y()) + "\n");
 	PutStream(ToStr(item->GrControl3.x()) + " " + ToStr(-item->GrControl3.y()) + "\n");
 	PutStream(ToStr(item->GrControl2.x()) + " " + ToStr(-item->GrControl2.y()) + "\n");
+	QList<CMYKColorF> colorsCMYK;
+	SetColors(cols, colsSh, colorsCMYK);
 	for (int ac = 0; ac < cols.count(); ac++)
 	{
 		if ((Options.useSpotColors) && ((spotColorSet.count() > 0) && (spotColorSet.count() < 28)) && (!GraySc))
@@ -3529,7 +3626,7 @@ void PSLib::HandleTensorGradient(PageItem* item)
 			}
 			else
 			{
-				SetColor(cols.at(ac), colsSh.at(ac), &ch, &cs, &cv, &ck);
+				colorsCMYK.at(ac).getValues(ch, cs, cv, ck);
 				GCol = hs.setNum(ch)  + " " + ss.setNum(cs) + " " + vs.setNum(cv) + " " + ks.setNum(ck);
 				PutStream(GCol);
 				for (int sc = 0; sc < spotColorSet.count(); sc++)
@@ -3541,7 +3638,7 @@ void PSLib::HandleTensorGradient(PageItem* item)
 		}
 		else
 		{
-			SetColor(cols.at(ac), colsSh.at(ac), &ch, &cs, &cv, &ck);
+			colorsCMYK.at(ac).getValues(ch, cs, cv, ck);
 			if (GraySc)
 				GCol = hs.setNum(1.0 - qMin(0.3 * ch + 0.59 * cs + 0.11 * cv + ck, 1.0));
 			else
@@ -4119,6 +4216,61 @@ void PSLib::SetColor(const ScColor& color, double shade, double *c, double *m, d
 	}
 }
 
+/// Same as SetColor() for many colors, with one call to the color transforms for all of them.
+void PSLib::SetColors(const QStringList& colors, const QList<int>& shades, QList<CMYKColorF>& cmyk)
+{
+	QList<ScColor> scColors;
+	scColors.reserve(colors.count());
+	for (const QString& color : colors)
+		scColors.append((color == CommonStrings::None) ? ScColor(0, 0, 0, 0) : m_Doc->PageColors[color]);
+	ScColorEngine::getCMYKValues(scColors, m_Doc, cmyk);
+
+	bool useTransform = m_Doc->HasCMS && ScCore->haveCMS() && solidTransform;
+	QList<unsigned short> inC;
+	if (useTransform)
+		inC.reserve(4 * colors.count());
+	for (int i = 0; i < colors.count(); ++i)
+	{
+		CMYKColorF& result = cmyk[i];
+		if (colors.at(i) == CommonStrings::None)
+		{
+			result = CMYKColorF();
+			if (useTransform)
+				inC << 0 << 0 << 0 << 0;
+			continue;
+		}
+		if ((Options.doGCR) && (!scColors.at(i).isRegistrationColor()))
+		{
+			ScColor tmp;
+			tmp.setColorF(result.c, result.m, result.y, result.k);
+			ScColorEngine::applyGCR(tmp, m_Doc);
+			tmp.getCMYK(&result.c, &result.m, &result.y, &result.k);
+		}
+		double shade = shades.value(i, 100) / 100.0;
+		result.c *= shade;
+		result.m *= shade;
+		result.y *= shade;
+		result.k *= shade;
+		if (useTransform)
+			inC << result.c * 65535.0 << result.m * 65535.0 << result.y * 65535.0 << result.k * 65535.0;
+	}
+	if (!useTransform || colors.isEmpty())
+		return;
+
+	QList<unsigned short> outC(inC.count());
+	solidTransform.apply(inC.data(), outC.data(), colors.count());
+	for (int i = 0; i < colors.count(); ++i)
+	{
+		if (colors.at(i) == CommonStrings::None)
+			continue;
+		CMYKColorF& result = cmyk[i];
+		result.c = outC.at(4 * i) / 65535.0;
+		result.m = outC.at(4 * i + 1) / 65535.0;
+		result.y = outC.at(4 * i + 2) / 65535.0;
+		result.k = outC.at(4 * i + 3) / 65535.0;
+	}
+}
+
 /**
  * @brief PSLib::setTextSt
  * @param ite   the text item to set
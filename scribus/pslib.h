@@ -35,6 +35,8 @@ for which a new license (GPL+exception) is in place.
 
 #include "scribusapi.h"
 #include "scribusstructs.h"
+#include "sccolorstructs.h"
+#include "scimageprefetcher.h"
 #include "colormgmt/sccolormgmtengine.h"
 #include "tableborder.h"
 
@@ -150,6 +152,7 @@ class SCRIBUS_API PSLib : public QObject
 		virtual void HandleGradientFillStroke(PageItem *item, bool stroke = true, bool forArrow = false);
 		virtual void SetColor(const QString& color, double shade, double *c, double *m, double *y, double *k);
 		virtual void SetColor(const ScColor& color, double shade, double *c, double *m, double *y, double *k);
+		virtual void SetColors(const QStringList& colors, const QList<int>& shades, QList<CMYKColorF>& cmyk);
 		virtual void setTextSt(PageItem* ite, uint a, ScPage* pg, bool master);
 
 	private:
@@ -166,12 +169,18 @@ class SCRIBUS_API PSLib : public QObject
 		void WriteASCII85Bytes(const QByteArray& array);
 		void WriteASCII85Bytes(const unsigned char* array, int length);
 
+		void prefetchImages(const std::vector<int>& pageNs);
+		QString imageKey(const PageItem* item, const QString& fn, const QString& Prof, bool UseEmbedded) const;
+		ScImagePrefetcher::Decoder imageDecoder(PageItem* item, const QString& fn, const QString& Prof, bool UseEmbedded) const;
+
 		void paintBorder(const TableBorder& border, const QPointF& start, const QPointF& end, const QPointF& startOffsetFactors, const QPointF& endOffsetFactors);
 		
 		ScribusDoc *m_Doc { nullptr };
 		ScPage*      m_currentPage { nullptr };
 		Optimization m_optimization { OptimizeCompat };
 		OutputFormat m_outputFormat { OutputPS };
+		/// images of the exported pages decoded ahead on worker threads
+		ScImagePrefetcher m_imagePrefetcher;
 
 		QString ToStr(double c) const;
 		QString IToStr(int c) const;
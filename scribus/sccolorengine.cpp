@@ -461,6 +461,120 @@ void ScColorEngine::getCMYKValues(const ScColor& color, const ScribusDoc* doc, C
 	}
 }
 
+void ScColorEngine::getRGBValues(const QList<ScColor>& colors, const ScribusDoc* doc, QList<RGBColorF>& rgb)
+{
+	rgb.resize(colors.count());
+	ScColorTransform transRGB = doc ? doc->stdTransRGB : ScCore->defaultCMYKToRGBTrans;
+	ScColorTransform transLab = doc ? doc->stdLabToRGBTrans : ScCore->defaultLabToRGBTrans;
+	bool cmsUse = ScCore->haveCMS() && transRGB;
+	QList<int> cmykIndexes;
+	QList<quint16> cmykIn;
+	QList<int> labIndexes;
+	QList<double> labIn;
+	for (int i = 0; i < colors.count(); ++i)
+	{
+		const ScColor& color = colors.at(i);
+		if (cmsUse && (color.m_Model == colorModelCMYK))
+		{
+			cmykIndexes.append(i);
+			for (int j = 0; j < 4; ++j)
+				cmykIn.append(qRound(color.m_values[j] * 65535));
+		}
+		else if (cmsUse && (color.m_Model == colorModelLab) && transLab)
+		{
+			labIndexes.append(i);
+			labIn << color.m_L_val << color.m_a_val << color.m_b_val;
+		}
+		else
+			getRGBValues(color, doc, rgb[i]);
+	}
+
+	QList<quint16> outC;
+	if (!cmykIndexes.isEmpty())
+	{
+		outC.resize(3 * cmykIndexes.count());
+		transRGB.apply(cmykIn.data(), outC.data(), cmykIndexes.count());
+		for (int i = 0; i < cmykIndexes.count(); ++i)
+		{
+			RGBColorF& result = rgb[cmykIndexes.at(i)];
+			result.r = outC.at(3 * i) / 65535.0;
+			result.g = outC.at(3 * i + 1) / 65535.0;
+			result.b = outC.at(3 * i + 2) / 65535.0;
+		}
+	}
+	if (!labIndexes.isEmpty())
+	{
+		outC.resize(3 * labIndexes.count());
+		transLab.apply(labIn.data(), outC.data(), labIndexes.count());
+		for (int i = 0; i < labIndexes.count(); ++i)
+		{
+			RGBColorF& result = rgb[labIndexes.at(i)];
+			result.r = outC.at(3 * i) / 65535.0;
+			result.g = outC.at(3 * i + 1) / 65535.0;
+			result.b = outC.at(3 * i + 2) / 65535.0;
+		}
+	}
+}
+
+void ScColorEngine::getCMYKValues(const QList<ScColor>& colors, const ScribusDoc* doc, QList<CMYKColorF>& cmyk)
+{
+	cmyk.resize(colors.count());
+	ScColorTransform transCMYK = doc ? doc->stdTransCMYK : ScCore->defaultRGBToCMYKTrans;
+	ScColorTransform transLab = doc ? doc->stdLabToCMYKTrans : ScCore->defaultLabToCMYKTrans;
+	bool cmsUse = ScCore->haveCMS() && transCMYK;
+	QList<int> rgbIndexes;
+	QList<quint16> rgbIn;
+	QList<int> labIndexes;
+	QList<double> labIn;
+	for (int i = 0; i < colors.count(); ++i)
+	{
+		const ScColor& color = colors.at(i);
+		// RGB greys go to CMYK greys without transform
+		bool rgbGrey = (color.m_values[0] == color.m_values[1]) && (color.m_values[1] == color.m_values[2]);
+		if (cmsUse && (color.m_Model == colorModelRGB) && !rgbGrey)
+		{
+			rgbIndexes.append(i);
+			for (int j = 0; j < 3; ++j)
+				rgbIn.append(qRound(color.m_values[j] * 65535.0));
+		}
+		else if ((color.m_Model == colorModelLab) && transLab)
+		{
+			labIndexes.append(i);
+			labIn << color.m_L_val << color.m_a_val << color.m_b_val;
+		}
+		else
+			getCMYKValues(color, doc, cmyk[i]);
+	}
+
+	QList<quint16> outC;
+	if (!rgbIndexes.isEmpty())
+	{
+		outC.resize(4 * rgbIndexes.count());
+		transCMYK.apply(rgbIn.data(), outC.data(), rgbIndexes.count());
+		for (int i = 0; i < rgbIndexes.count(); ++i)
+		{
+			CMYKColorF& result = cmyk[rgbIndexes.at(i)];
+			result.c = outC.at(4 * i) / 65535.0;
+			result.m = outC.at(4 * i + 1) / 65535.0;
+			result.y = outC.at(4 * i + 2) / 65535.0;
+			result.k = outC.at(4 * i + 3) / 65535.0;
+		}
+	}
+	if (!labIndexes.isEmpty())
+	{
+		outC.resize(4 * labIndexes.count());
+		transLab.apply(labIn.data(), outC.data(), labIndexes.count());
+		for (int i = 0; i < labIndexes.count(); ++i)
+		{
+			CMYKColorF& result = cmyk[labIndexes.at(i)];
+			result.c = outC.at(4 * i) / 65535.0;
+			result.m = outC.at(4 * i + 1) / 65535.0;
+			result.y = outC.at(4 * i + 2) / 65535.0;
+			result.k = outC.at(4 * i + 3) / 65535.0;
+		}
+	}
+}
+
 void ScColorEngine::getShadeColorCMYK(const ScColor& color, const ScribusDoc* doc, 
 										  CMYKColor& cmyk, double level)
 {
@@ -604,7 +718,177 @@ void ScColorEngine::getShadeColorRGB(const ScColor& color, const ScribusDoc* doc
 	}
 }
 
+void ScColorEngine::getShadeColorsRGB(const QList<ScColor>& colors, const QList<double>& levels, const ScribusDoc* doc, QList<RGBColorF>& rgb)
+{
+	rgb.resize(colors.count());
+	ScColorTransform transLab = doc ? doc->stdLabToRGBTrans : ScCore->defaultLabToRGBTrans;
+	QList<int> cmykIndexes;
+	QList<ScColor> cmykShades;
+	QList<int> labIndexes;
+	QList<double> labIn;
+	for (int i = 0; i < colors.count(); ++i)
+	{
+		const ScColor& color = colors.at(i);
+		double level = levels.value(i, 100.0);
+		if (color.m_Model == colorModelCMYK)
+		{
+			CMYKColorF cmyk;
+			getShadeColorCMYK(color, doc, cmyk, level);
+			ScColor tmpC;
+			tmpC.setColorF(cmyk.c, cmyk.m, cmyk.y, cmyk.k);
+			cmykIndexes.append(i);
+			cmykShades.append(tmpC);
+		}
+		else if ((color.m_Model == colorModelLab) && transLab)
+		{
+			labIndexes.append(i);
+			labIn << 100 - (100 - color.m_L_val) * (level / 100.0);
+			labIn << color.m_a_val * (level / 100.0);
+			labIn << color.m_b_val * (level / 100.0);
+		}
+		else
+			getShadeColorRGB(color, doc, rgb[i], level);
+	}
+
+	if (!cmykIndexes.isEmpty())
+	{
+		QList<RGBColorF> converted;
+		getRGBValues(cmykShades, doc, converted);
+		for (int i = 0; i < cmykIndexes.count(); ++i)
+			rgb[cmykIndexes.at(i)] = converted.at(i);
+	}
+	if (!labIndexes.isEmpty())
+	{
+		QList<quint16> outC(3 * labIndexes.count());
+		transLab.apply(labIn.data(), outC.data(), labIndexes.count());
+		for (int i = 0; i < labIndexes.count(); ++i)
+		{
+			RGBColorF& result = rgb[labIndexes.at(i)];
+			result.r = outC.at(3 * i) / 65535.0;
+			result.g = outC.at(3 * i + 1) / 65535.0;
+			result.b = outC.at(3 * i + 2) / 65535.0;
+		}
+	}
+}
+
+void ScColorEngine::getShadeColorsCMYK(const QList<ScColor>& colors, const QList<double>& levels, const ScribusDoc* doc, QList<CMYKColorF>& cmyk)
+{
+	cmyk.resize(colors.count());
+	// shading is done in the color model of each color, the conversions are batched by getCMYKValues()
+	QList<int> indexes;
+	QList<ScColor> shades;
+	for (int i = 0; i < colors.count(); ++i)
+	{
+		const ScColor& color = colors.at(i);
+		double level = levels.value(i, 100.0);
+		if (color.m_Model == colorModelRGB)
+		{
+			RGBColorF rgb;
+			getShadeColorRGB(color, doc, rgb, level);
+			ScColor tmpR;
+			tmpR.setRgbColorF(rgb.r, rgb.g, rgb.b);
+			indexes.append(i);
+			shades.append(tmpR);
+		}
+		else if (color.m_Model == colorModelLab)
+		{
+			ScColor tmpL;
+			tmpL.setLabColor(100 - (100 - color.m_L_val) * (level / 100.0), color.m_a_val * (level / 100.0), color.m_b_val * (level / 100.0));
+			indexes.append(i);
+			shades.append(tmpL);
+		}
+		else
+			getShadeColorCMYK(color, doc, cmyk[i], level);
+	}
+	if (indexes.isEmpty())
+		return;
+	QList<CMYKColorF> converted;
+	getCMYKValues(shades, doc, converted);
+	for (int i = 0; i < indexes.count(); ++i)
+		cmyk[indexes.at(i)] = converted.at(i);
+}
+
+ScDisplayColorCache::Key ScColorEngine::displayColorKey(ScDisplayColorCache::Conversion conversion, const ScColor& color, const ScribusDoc* doc, double level)
+{
+	ScDisplayColorCache::Key key {};
+	for (int i = 0; i < 4; ++i)
+		key.values[i] = color.m_values[i];
+	key.lab[0] = color.m_L_val;
+	key.lab[1] = color.m_a_val;
+	key.lab[2] = color.m_b_val;
+	key.level = level;
+	key.flags = static_cast<quint32>(conversion) | (static_cast<quint32>(color.m_Model) << 3);
+	if (color.m_Spot)
+		key.flags |= 1 << 6;
+	if (doc->HasCMS)
+		key.flags |= 1 << 7;
+	if (doc->SoftProofing)
+		key.flags |= 1 << 8;
+	if (doc->Gamut)
+		key.flags |= 1 << 9;
+	if (ScCore->haveCMS())
+		key.flags |= 1 << 10;
+	return key;
+}
+
 QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* doc)
+{
+	if (!doc)
+		return computeDisplayColor(color, doc);
+	ScDisplayColorCache& cache = doc->displayColorCache();
+	ScDisplayColorCache::Key key = displayColorKey(ScDisplayColorCache::DisplayColor, color, doc, 100.0);
+	QColor tmp;
+	if (cache.find(key, tmp))
+		return tmp;
+	tmp = computeDisplayColor(color, doc);
+	cache.insert(key, tmp);
+	return tmp;
+}
+
+QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* doc, double level)
+{
+	if (!doc)
+		return computeDisplayColor(color, doc, level);
+	ScDisplayColorCache& cache = doc->displayColorCache();
+	ScDisplayColorCache::Key key = displayColorKey(ScDisplayColorCache::DisplayShadeColor, color, doc, level);
+	QColor tmp;
+	if (cache.find(key, tmp))
+		return tmp;
+	tmp = computeDisplayColor(color, doc, level);
+	cache.insert(key, tmp);
+	return tmp;
+}
+
+QColor ScColorEngine::getColorProof(const ScColor& color, const ScribusDoc* doc, bool gamutCheck)
+{
+	if (!doc)
+		return computeColorProof(color, doc, gamutCheck);
+	ScDisplayColorCache& cache = doc->displayColorCache();
+	ScDisplayColorCache::Conversion conversion = gamutCheck ? ScDisplayColorCache::ColorProofGamutCheck : ScDisplayColorCache::ColorProof;
+	ScDisplayColorCache::Key key = displayColorKey(conversion, color, doc, 100.0);
+	QColor tmp;
+	if (cache.find(key, tmp))
+		return tmp;
+	tmp = computeColorProof(color, doc, gamutCheck);
+	cache.insert(key, tmp);
+	return tmp;
+}
+
+QColor ScColorEngine::getShadeColorProof(const ScColor& color, const ScribusDoc* doc, double level)
+{
+	if (!doc)
+		return computeShadeColorProof(color, doc, level);
+	ScDisplayColorCache& cache = doc->displayColorCache();
+	ScDisplayColorCache::Key key = displayColorKey(ScDisplayColorCache::ShadeColorProof, color, doc, level);
+	QColor tmp;
+	if (cache.find(key, tmp))
+		return tmp;
+	tmp = computeShadeColorProof(color, doc, level);
+	cache.insert(key, tmp);
+	return tmp;
+}
+
+QColor ScColorEngine::computeDisplayColor(const ScColor& color, const ScribusDoc* doc)
 {
 	QColor tmp;
 	if (color.getColorModel() == colorModelRGB)
@@ -686,7 +970,7 @@ QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* do
 	return tmp;
 }
 
-QColor ScColorEngine::getDisplayColor(const ScColor& color, const ScribusDoc* doc, double level)
+QColor ScColorEngine::computeDisplayColor(const ScColor& color, const ScribusDoc* doc, double level)
 {
 	QColor tmp;
 	if (color.getColorModel() == colorModelRGB)
@@ -739,7 +1023,7 @@ QColor ScColorEngine::getDisplayColorGC(const ScColor& color, const ScribusDoc*
 	return tmp;
 }
 
-QColor ScColorEngine::getColorProof(const ScColor& color, const ScribusDoc* doc, bool gamutCheck)
+QColor ScColorEngine::computeColorProof(const ScColor& color, const ScribusDoc* doc, bool gamutCheck)
 {
 	QColor tmp;
 	bool gamutChkEnabled = doc ? doc->Gamut : false;
@@ -777,7 +1061,7 @@ QColor ScColorEngine::getShadeColor(const ScColor& color, const ScribusDoc* doc,
 	return QColor(rgb.r, rgb.g, rgb.b);
 }
 
-QColor ScColorEngine::getShadeColorProof(const ScColor& color, const ScribusDoc* doc, double level)
+QColor ScColorEngine::computeShadeColorProof(const ScColor& color, const ScribusDoc* doc, double level)
 {
 	QColor tmp;
 	bool doGC = doc ? doc->Gamut : false;
@@ -24,9 +24,12 @@ for which a new license (GPL+exception) is in place.
 #ifndef SCCOLORENGINE_H
 #define SCCOLORENGINE_H
 
+#include <QList>
+
 #include "scribusapi.h"
 #include "sccolor.h"
 #include "sccolorstructs.h"
+#include "scdisplaycolorcache.h"
 class ScribusDoc;
 
 class SCRIBUS_API ScColorEngine
@@ -50,6 +53,14 @@ public:
 	/** \brief get CMYK values of a specified color */
 	static void getCMYKValues(const ScColor& color, const ScribusDoc* doc, CMYKColorF& cmyk);
 
+	/** \brief get RGB values of several colors.
+	* Colors needing the same color transform are converted with a single call to it. */
+	static void getRGBValues(const QList<ScColor>& colors, const ScribusDoc* doc, QList<RGBColorF>& rgb);
+
+	/** \brief get CMYK values of several colors.
+	* Colors needing the same color transform are converted with a single call to it. */
+	static void getCMYKValues(const QList<ScColor>& colors, const ScribusDoc* doc, QList<CMYKColorF>& cmyk);
+
 	/** \brief get RGB values of a specified shade */
 	static void getShadeColorRGB(const ScColor& color, const ScribusDoc* doc, RGBColor&, double level);
 
@@ -62,7 +73,14 @@ public:
 	/** \brief get CMYK values of a specified shade */
 	static void getShadeColorCMYK(const ScColor& color, const ScribusDoc* doc, CMYKColorF& cmyk, double level);
 
-	/** \brief Return a color converted to monitor color space. No soft-proofing is done. */
+	/** \brief get RGB values of several shades, as getShadeColorRGB() but with batched color transforms */
+	static void getShadeColorsRGB(const QList<ScColor>& colors, const QList<double>& levels, const ScribusDoc* doc, QList<RGBColorF>& rgb);
+
+	/** \brief get CMYK values of several shades, as getShadeColorCMYK() but with batched color transforms */
+	static void getShadeColorsCMYK(const QList<ScColor>& colors, const QList<double>& levels, const ScribusDoc* doc, QList<CMYKColorF>& cmyk);
+
+	/** \brief Return a color converted to monitor color space. No soft-proofing is done.
+	* Results are kept in the display color cache of the document. */
 	static QColor getDisplayColor(const ScColor& color, const ScribusDoc* doc);
 
 	/** \brief Return a color with the specified shade converted to monitor color space. 
@@ -122,6 +140,15 @@ public:
 
 	/** \brief Apply Gray-Component-Removal to an ScColor */
 	static void applyGCR(ScColor& color, const ScribusDoc* doc);
+
+private:
+	static ScDisplayColorCache::Key displayColorKey(ScDisplayColorCache::Conversion conversion, const ScColor& color, const ScribusDoc* doc, double level);
+
+	// uncached versions of the ScColor overloads of getDisplayColor(), getColorProof() and getShadeColorProof()
+	static QColor computeDisplayColor(const ScColor& color, const ScribusDoc* doc);
+	static QColor computeDisplayColor(const ScColor& color, const ScribusDoc* doc, double level);
+	static QColor computeColorProof(const ScColor& color, const ScribusDoc* doc, bool gamutCheck);
+	static QColor computeShadeColorProof(const ScColor& color, const ScribusDoc* doc, double level);
 };
 
 #endif
@@ -0,0 +1,90 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <cstring>
+
+#include <QMutexLocker>
+
+#include "scdisplaycolorcache.h"
+
+#if defined(DEBUG_SCDISPLAYCOLORCACHE)
+#define SC_DEBUG_FILE 1
+#else
+#define SC_DEBUG_FILE 0
+#endif
+#include "scdebug.h"
+
+bool ScDisplayColorCache::Key::operator==(const Key& other) const
+{
+	return std::memcmp(this, &other, sizeof(Key)) == 0;
+}
+
+size_t qHash(const ScDisplayColorCache::Key& key, size_t seed)
+{
+	return qHashBits(&key, sizeof(ScDisplayColorCache::Key), seed);
+}
+
+ScDisplayColorCache::ScDisplayColorCache(int maxColors) :
+	m_maxColors(qMax(1, maxColors))
+{
+}
+
+ScDisplayColorCache::~ScDisplayColorCache()
+{
+	reportStatistics();
+}
+
+bool ScDisplayColorCache::find(const Key& key, QColor& color)
+{
+	QMutexLocker locker(&m_mutex);
+	auto it = m_colors.constFind(key);
+	if (it == m_colors.constEnd())
+	{
+		++m_misses;
+		return false;
+	}
+	color = it.value();
+	++m_hits;
+	return true;
+}
+
+void ScDisplayColorCache::insert(const Key& key, const QColor& color)
+{
+	QMutexLocker locker(&m_mutex);
+	// colors used by a document are few, a full cache means most entries are outdated shades
+	if (m_colors.count() >= m_maxColors)
+		m_colors.clear();
+	m_colors.insert(key, color);
+}
+
+void ScDisplayColorCache::clear()
+{
+	QMutexLocker locker(&m_mutex);
+	reportStatistics();
+	m_colors.clear();
+	m_hits = 0;
+	m_misses = 0;
+}
+
+ScDisplayColorCache::Statistics ScDisplayColorCache::statistics() const
+{
+	QMutexLocker locker(&m_mutex);
+	Statistics stats;
+	stats.colors = m_colors.count();
+	stats.hits = m_hits;
+	stats.misses = m_misses;
+	return stats;
+}
+
+void ScDisplayColorCache::reportStatistics() const
+{
+	int lookups = m_hits + m_misses;
+	if (lookups == 0)
+		return;
+	scDebug() << "display color cache:" << m_colors.count() << "colors," << lookups << "lookups,"
+			  << qRound(100.0 * m_hits / lookups) << "% hits";
+}
@@ -0,0 +1,81 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCDISPLAYCOLORCACHE_H
+#define SCDISPLAYCOLORCACHE_H
+
+#include <QColor>
+#include <QHash>
+#include <QMutex>
+
+#include "scribusapi.h"
+
+/**
+ * The ScDisplayColorCache class remembers the screen colors ScColorEngine computed for a
+ * document, so that repainting items does not run a color transform for every fill, stroke,
+ * gradient stop and text color again.
+ *
+ * The key holds the color values rather than the color name, so editing a color can never
+ * return a stale result. It also holds the color management, soft proofing and gamut check
+ * switches of the document. The document clears the cache when it rebuilds its color
+ * transforms and when its colors are recalculated.
+ */
+class SCRIBUS_API ScDisplayColorCache
+{
+public:
+	/// The ScColorEngine function whose result is cached.
+	enum Conversion
+	{
+		DisplayColor = 0,
+		DisplayShadeColor,
+		ColorProof,
+		ColorProofGamutCheck,
+		ShadeColorProof
+	};
+
+	struct Key
+	{
+		double values[4];
+		double lab[3];
+		double level;
+		/// conversion, color model, spot color flag and color management state
+		quint32 flags;
+		quint32 padding;
+
+		bool operator==(const Key& other) const;
+	};
+
+	struct Statistics
+	{
+		int colors { 0 }; ///< number of cached colors
+		int hits { 0 };   ///< lookups answered from the cache
+		int misses { 0 }; ///< lookups which ran the conversion
+	};
+
+	/// Constructs an empty cache keeping at most @a maxColors colors.
+	explicit ScDisplayColorCache(int maxColors = 4096);
+	~ScDisplayColorCache();
+
+	bool find(const Key& key, QColor& color);
+	/// Adds @a color, the cache is emptied first when it is full.
+	void insert(const Key& key, const QColor& color);
+	void clear();
+
+	Statistics statistics() const;
+
+private:
+	mutable QMutex m_mutex;
+	QHash<Key, QColor> m_colors;
+	int m_maxColors { 0 };
+	int m_hits { 0 };
+	int m_misses { 0 };
+
+	void reportStatistics() const;
+};
+
+size_t qHash(const ScDisplayColorCache::Key& key, size_t seed = 0);
+
+#endif
@@ -16,8 +16,10 @@ for which a new license (GPL+exception) is in place.
 */
 
 #include <QApplication>
+#include <QAtomicInt>
 #include <QDir>
 #include <QDomDocument>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QFont>
@@ -25,6 +27,7 @@ for which a new license (GPL+exception) is in place.
 #include <QHash>
 #include <QMap>
 #include <QRawFont>
+#include <QSemaphore>
 #ifdef Q_OS_WIN32
 #include <QSet>
 #include <QSettings>
@@ -32,6 +35,8 @@ for which a new license (GPL+exception) is in place.
 #endif
 #include <QString>
 #include <QTextCodec>
+#include <QThread>
+#include <QThreadPool>
 
 #include <cstdlib>
 #include <utility>
@@ -198,9 +203,14 @@ void SCFonts::addScalableFonts(const QString &path, const QString& DocName)
 #ifdef Q_OS_MACOS
 			else if (ext.isEmpty() && DocName.isEmpty())
 			{
-				bool error = addScalableFont(pathfile, library, DocName);
-				if (error)
-					error = addScalableFont(pathfile + "/..namedfork/rsrc",library, DocName);
+				if (m_parallelScan)
+					queueFontFile(pathfile, DocName, true);
+				else
+				{
+					bool error = addScalableFont(pathfile, library, DocName);
+					if (error)
+						error = addScalableFont(pathfile + "/..namedfork/rsrc",library, DocName);
+				}
 			}
 #endif				
 		}
@@ -503,6 +513,17 @@ static QStringList getFontFeatures(const FT_Face face)
 	return fontFeatures;
 }
 
+static void getUnicodeRanges(const FT_Face face, quint32* unicodeRanges)
+{
+	const TT_OS2* os2 = static_cast<const TT_OS2*>(FT_Get_Sfnt_Table(face, FT_SFNT_OS2));
+	if (!os2 || os2->version == 0xFFFF)
+		return;
+	unicodeRanges[0] = os2->ulUnicodeRange1;
+	unicodeRanges[1] = os2->ulUnicodeRange2;
+	unicodeRanges[2] = os2->ulUnicodeRange3;
+	unicodeRanges[3] = os2->ulUnicodeRange4;
+}
+
 ScFace SCFonts::loadScalableFont(const QString &filename)
 {
 	ScFace t;
@@ -618,6 +639,8 @@ ScFace SCFonts::loadScalableFont(const QString &filename)
 				break;
 		}
 		t.m_m->hasGlyphNames = HasNames;
+		t.m_m->embeddingFlags = FT_Get_FSType_Flags(face);
+		getUnicodeRanges(face, t.m_m->unicodeRanges);
 		t.embedPs(true);
 		t.usable(true);
 		t.m_m->status = ScFace::UNKNOWN;
@@ -632,28 +655,22 @@ ScFace SCFonts::loadScalableFont(const QString &filename)
 
 static QString getFtError(int code)
 {
+	// filled once, fonts are checked on several threads
+	static const QHash<int, QString> ftErrors = []()
+	{
+		QHash<int, QString> errors;
 #undef FTERRORS_H_
-#define FT_ERRORDEF(e, v, s) ftErrors[e] = s;
-	static QHash<int, QString> ftErrors;
+#define FT_ERRORDEF(e, v, s) errors[e] = s;
 #include FT_ERRORS_H
 #undef FT_ERRORDEF
+		return errors;
+	}();
 
-	if (ftErrors.contains(code))
-		return ftErrors.value(code);
-	return QString();
+	return ftErrors.value(code);
 }
 
-// Load a single font into the library from the passed filename. Returns true on error.
-bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, const QString& DocName)
+QDateTime SCFonts::fontModificationTime(const QString& filename)
 {
-	static bool firstRun;
-	bool Subset = false;
-	char buf[128];
-	QString glyName;
-	ScFace::FontFormat format;
-	ScFace::FontType   type;
-	FT_Face         face = nullptr;
-	struct testCache foCache;
 	QFileInfo fic(filename);
 	QDateTime lastMod = fic.lastModified();
 	QTime lastModTime = lastMod.time();
@@ -662,61 +679,123 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 		lastModTime.setHMS(lastModTime.hour(), lastModTime.minute(), lastModTime.second());
 		lastMod.setTime(lastModTime);
 	}
-	foCache.isOK = false;
-	foCache.isChecked = true;
-	foCache.lastMod = lastMod;
+	return lastMod;
+}
+
+void SCFonts::initFontScan(FontFileScan& scan) const
+{
+	scan.lastMod = fontModificationTime(scan.filename);
+	auto known = m_checkedFonts.constFind(scan.filename);
+	scan.known = (known != m_checkedFonts.constEnd());
+	if (scan.known)
+		scan.knownCache = known.value();
+}
+
+// Load a single font into the library from the passed filename. Returns true on error.
+bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, const QString& DocName)
+{
+	static bool firstRun;
+	if (m_parallelScan)
+	{
+		queueFontFile(filename, DocName);
+		return false;
+	}
 	if (m_checkedFonts.count() == 0)
 	{
 		firstRun = true;
 		ScCore->setSplashStatus( QObject::tr("Creating Font Cache") );
 	}
+	FontFileScan scan;
+	scan.filename = filename;
+	scan.docName = DocName;
+	initFontScan(scan);
+	if (addFontFromCache(filename, scan.lastMod, DocName))
+		return false;
+	if (!scan.known)
+	{
+		if (!firstRun)
+			ScCore->setSplashStatus( QObject::tr("New Font found, checking...") );
+	}
+	else if (scan.knownCache.isOK && scan.knownCache.lastMod != scan.lastMod)
+		ScCore->setSplashStatus( QObject::tr("Modified Font found, checking...") );
+	scanFontFile(scan, library);
+	mergeFontScan(scan);
+	return scan.error;
+}
+
+bool SCFonts::addFontFromCache(const QString& filename, const QDateTime& lastMod, const QString& DocName)
+{
+	// unchanged fonts are created from the cache, FreeType opens them when they are used
+	auto cached = m_checkedFonts.find(filename);
+	if (cached == m_checkedFonts.end() || !cached->isOK || cached->lastMod != lastMod || cached->faces.isEmpty())
+		return false;
+	cached->isChecked = true;
+	QList<FaceInfo> faces(cached->faces);
+	addFaces(filename, faces, DocName);
+	return true;
+}
+
+void SCFonts::scanFontFile(FontFileScan& scan, FT_Library library)
+{
+	const QString& filename = scan.filename;
+	bool Subset = false;
+	char buf[128];
+	QString glyName;
+	ScFace::FontFormat format;
+	ScFace::FontType   type;
+	FT_Face         face = nullptr;
+	struct testCache foCache;
+	foCache.isOK = false;
+	foCache.isChecked = true;
+	foCache.lastMod = scan.lastMod;
+	scan.cache = foCache;
+	scan.error = true;
+
 	FT_Error error = FT_New_Face( library, QFile::encodeName(filename), 0, &face );
 	if (error || (face == nullptr))
 	{
 		if (face != nullptr)
 			FT_Done_Face(face);
-		m_checkedFonts.insert(filename, foCache);
-		addRejectedFont(filename, QObject::tr("Font is broken: \"%1\"").arg(getFtError(error)));
-		if (m_showFontInfo)
-			sDebug(QObject::tr("Font %1 is broken, discarding it. Error message: \"%2\"").arg(filename, getFtError(error)));
-		return true;
+		scan.rejectMessage = QObject::tr("Font is broken: \"%1\"").arg(getFtError(error));
+		scan.messages.append(QObject::tr("Font %1 is broken, discarding it. Error message: \"%2\"").arg(filename, getFtError(error)));
+		return;
 	}
 	if (face->family_name == nullptr)
 	{
-		addRejectedFont(filename, QObject::tr("Failed to load font: font family unspecified"));
-		if (m_showFontInfo)
-			sDebug(QObject::tr("Failed to load font %1 - font family unspecified").arg(filename));
+		scan.rejectMessage = QObject::tr("Failed to load font: font family unspecified");
+		scan.messages.append(QObject::tr("Failed to load font %1 - font family unspecified").arg(filename));
 		FT_Done_Face(face);
-		m_checkedFonts.insert(filename, foCache);
-		return true;
+		return;
 	}
 	getFontFormat(face, format, type);
 	if (format == ScFace::UNKNOWN_FORMAT) 
 	{
-		addRejectedFont(filename, QObject::tr("Failed to load font: font type unknown"));
-		if (m_showFontInfo)
-			sDebug(QObject::tr("Failed to load font %1 - font type unknown").arg(filename));
+		scan.rejectMessage = QObject::tr("Failed to load font: font type unknown");
+		scan.messages.append(QObject::tr("Failed to load font %1 - font type unknown").arg(filename));
 		FT_Done_Face(face);
-		m_checkedFonts.insert(filename, foCache);
-		return true;
+		return;
 	}
 	// Some fonts such as Noto ColorEmoji are in fact bitmap fonts
 	// and do not provide a valid value for units_per_EM
 	if (face->units_per_EM == 0)
 	{
-		addRejectedFont(filename, QObject::tr("Failed to load font: font is not scalable"));
-		if (m_showFontInfo)
-			sDebug(QObject::tr("Failed to load font %1 - font is not scalable").arg(filename));
+		scan.rejectMessage = QObject::tr("Failed to load font: font is not scalable");
+		scan.messages.append(QObject::tr("Failed to load font %1 - font is not scalable").arg(filename));
 		FT_Done_Face(face);
-		m_checkedFonts.insert(filename, foCache);
-		return true;
+		return;
 	}
 	bool HasNames = FT_HAS_GLYPH_NAMES(face);
 
-	if (!m_checkedFonts.contains(filename))
+	if (scan.known && !scan.knownCache.isOK)
+	{
+		scan.cache = scan.knownCache;
+		scan.cache.isChecked = true;
+		FT_Done_Face(face);
+		return;
+	}
+	// new and modified fonts get all their glyphs checked
+	if (!scan.known || scan.knownCache.lastMod != foCache.lastMod)
 	{
-		if (!firstRun)
-			ScCore->setSplashStatus( QObject::tr("New Font found, checking...") );
 		FT_UInt gindex = 0;
 		FT_ULong charcode = FT_Get_First_Char( face, &gindex );
 		while ( gindex != 0 )
@@ -724,17 +803,14 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 			error = FT_Load_Glyph(face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
 			if (error)
 			{
-				auto errorMessage = QObject::tr("Font %1 has broken glyph %2 (charcode U+%3). Error message: \"%4\"")
+				scan.rejectMessage = QObject::tr("Font %1 has broken glyph %2 (charcode U+%3). Error message: \"%4\"")
 							   .arg(filename)
 							   .arg(gindex)
 							   .arg(charcode, 4, 16, QChar('0'))
 							   .arg(getFtError(error));
-				addRejectedFont(filename, errorMessage);
-				if (m_showFontInfo)
-					sDebug(errorMessage);
+				scan.messages.append(scan.rejectMessage);
 				FT_Done_Face(face);
-				m_checkedFonts.insert(filename, foCache);
-				return true;
+				return;
 			}
 			FT_Get_Glyph_Name(face, gindex, buf, 128);
 			QString newName(buf);
@@ -747,66 +823,25 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 			charcode = FT_Get_Next_Char( face, charcode, &gindex );
 		}
 		foCache.isOK = true;
-		m_checkedFonts.insert(filename, foCache);
+		scan.cache = foCache;
 	}
 	else
 	{
-		auto& checkedFont = m_checkedFonts[filename];
-		if (!checkedFont.isOK)
-		{
-			checkedFont.isChecked = true;
-			FT_Done_Face(face);
-			return true;
-		}
-		if (checkedFont.lastMod != foCache.lastMod)
-		{
-			ScCore->setSplashStatus( QObject::tr("Modified Font found, checking...") );
-			FT_UInt gindex = 0;
-			FT_ULong charcode = FT_Get_First_Char( face, &gindex );
-			while ( gindex != 0 )
-			{
-				error = FT_Load_Glyph(face, gindex, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
-				if (error)
-				{
-					auto errorMessage = QObject::tr("Font %1 has broken glyph %2 (charcode U+%3). Error message: \"%4\"")
-								   .arg(filename)
-								   .arg(gindex)
-								   .arg(charcode, 4, 16, QChar('0'))
-								   .arg(getFtError(error));
-					addRejectedFont(filename, errorMessage);
-					if (m_showFontInfo)
-						sDebug(errorMessage);
-					FT_Done_Face(face);
-					m_checkedFonts.insert(filename, foCache);
-					return true;
-				}
-				FT_Get_Glyph_Name(face, gindex, buf, 128);
-				QString newName(buf);
-				if (newName == glyName)
-				{
-					HasNames = false;
-					Subset = true;
-				}
-				glyName = newName;
-				charcode = FT_Get_Next_Char( face, charcode, &gindex );
-			}
-			foCache.isOK = true;
-			checkedFont = foCache;
-		}
-		else
-		{
-			checkedFont.isOK = true;
-			checkedFont.isChecked = true;
-		}
+		scan.cache = scan.knownCache;
+		scan.cache.isOK = true;
+		scan.cache.isChecked = true;
 	}
+	scan.error = false;
 
 	// Warning: code below is also present in loadScalableFont, so if you do
 	// any modification here, think also about modifying code in loadScalableFont
 	int faceIndex = 0;
+	bool allFacesRead = false;
 	while (!error)
 	{
-		QString fam(getFamilyName(face));
-		QStringList features(getFontFeatures(face));
+		FaceInfo info;
+		info.family = getFamilyName(face);
+		info.features = getFontFeatures(face);
 		QString sty(face->style_name);
 		if ((sty == "Regular" && face->style_flags != 0) || sty.isEmpty())
 		{
@@ -828,102 +863,221 @@ bool SCFonts::addScalableFont(const QString& filename, FT_Library &library, cons
 					break;
 			}
 		}
-		QString fullName(fam);
+		info.style = sty;
+		info.fullName = info.family;
 		if (!sty.isEmpty())
-			fullName += " " + sty;
+			info.fullName += " " + sty;
 		const char* psName = FT_Get_Postscript_Name(face);
-		QString qpsName;
 		if (psName)
-			qpsName = QString(psName);
+			info.psName = QString(psName);
 		else
-			qpsName = fullName;
-		ScFace t;
-		if (contains(fullName))
-		{
-			t = (*this)[fullName];
-			if (t.psName() != qpsName)
-			{
-				QString alt = " (" + qpsName + ")";
-				fullName += alt;
-				sty += alt;
-			}
-		}
-		t = (*this)[fullName];
-		if (t.isNone())
-		{
-			switch (format) 
-			{
-				case ScFace::PFA:
-					t = ScFace(new ScFace_PFA(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					t.subset(Subset);
-					break;
-				case ScFace::PFB:
-					t = ScFace(new ScFace_PFB(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					t.subset(Subset);
-					break;
-				case ScFace::SFNT:
-					t = ScFace(new ScFace_ttf(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					getSubFontType(face, t.m_m->typeCode);
-					t.subset(Subset);
-					break;
-				case ScFace::TTCF:
-					t = ScFace(new ScFace_ttf(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					t.m_m->formatCode = ScFace::TTCF;
-					t.m_m->typeCode = ScFace::TTF;
-					getSubFontType(face, t.m_m->typeCode);
-					t.subset(Subset);
-					break;
-				case ScFace::TYPE42:
-					t = ScFace(new ScFace_ttf(fam, sty, "", fullName, qpsName, filename, faceIndex, features));
-					getSubFontType(face, t.m_m->typeCode);
-					t.subset(Subset);
-					break;
-				default:
-				/* catching any types not handled above to silence compiler */
-					break;
-			}
-			insert(fullName, t);
-			t.m_m->hasGlyphNames = HasNames;
-			t.embedPs(true);
-			t.usable(true);
-			t.m_m->status = ScFace::UNKNOWN;
-			if (face->num_glyphs > 2048)
-				t.subset(true);
-			t.m_m->forDocument = DocName;
-			//setBestEncoding(face); //AV
-			if (m_showFontInfo)
-				sDebug(QObject::tr("Font %1 loaded from %2(%3)").arg(t.psName(), filename).arg(faceIndex + 1));
+			info.psName = info.fullName;
+		info.faceIndex = faceIndex;
+		info.format = format;
+		info.type = (format == ScFace::TTCF) ? ScFace::TTF : ScFace::UNKNOWN_TYPE;
+		getSubFontType(face, info.type);
+		info.hasGlyphNames = HasNames;
+		info.glyphCount = face->num_glyphs;
+		info.embeddingFlags = FT_Get_FSType_Flags(face);
+		getUnicodeRanges(face, info.unicodeRanges);
+		info.subset = Subset || (face->num_glyphs > 2048);
+		scan.faces.append(info);
 
-/*
-//debug
-			QByteArray bb;
-			t->rawData(bb);
-			QFile dump(QString("/tmp/fonts/%1-%2").arg(fullName, psName));
-			dump.open(IO_WriteOnly);
-			QDataStream os(&dump);
-			os.writeRawBytes(bb.data(), bb.size());
-			dump.close();
-*/
-		}
-		else 
-		{
-			if (m_showFontInfo)
-				sDebug(QObject::tr("Font %1(%2) is duplicate of %3").arg(filename).arg(faceIndex + 1).arg(t.fontPath()));
-			// this is needed since eg. AppleSymbols will happily return a face for *any* face_index
-			if (faceIndex > 0) {
-				break;
-			}
-		}
 		if ((++faceIndex) >= face->num_faces)
+		{
+			allFacesRead = true;
 			break;
+		}
 		FT_Done_Face(face);
 		face = nullptr;
 		error = FT_New_Face(library, QFile::encodeName(filename), faceIndex, &face);
 	} //while
-	
+
+	// files with unreadable faces are read again next time
+	if (allFacesRead)
+		scan.cache.faces = scan.faces;
+	else
+		scan.cache.faces.clear();
 	if (face != nullptr)
 		FT_Done_Face(face);
-	return error && faceIndex == 0;
+}
+
+void SCFonts::mergeFontScan(const FontFileScan& scan)
+{
+	if (m_showFontInfo)
+	{
+		for (const QString& message : scan.messages)
+			sDebug(message);
+	}
+	if (!scan.rejectMessage.isEmpty())
+		addRejectedFont(scan.filename, scan.rejectMessage);
+	m_checkedFonts.insert(scan.filename, scan.cache);
+	addFaces(scan.filename, scan.faces, scan.docName);
+}
+
+void SCFonts::queueFontFile(const QString& filename, const QString& DocName, bool tryResourceFork)
+{
+	// fontconfig also lists the files found in the font directories
+	if (m_queuedFonts.contains(filename))
+		return;
+	m_queuedFonts.insert(filename);
+	FontFileScan scan;
+	scan.filename = filename;
+	scan.docName = DocName;
+	scan.tryResourceFork = tryResourceFork;
+	m_pendingFonts.append(scan);
+}
+
+void SCFonts::processPendingFonts()
+{
+	QElapsedTimer timer;
+	timer.start();
+	QList<FontFileScan> pending;
+	pending.swap(m_pendingFonts);
+	m_queuedFonts.clear();
+	if (pending.isEmpty())
+		return;
+	if (m_checkedFonts.count() == 0)
+		ScCore->setSplashStatus( QObject::tr("Creating Font Cache") );
+
+	// Unchanged fonts come from the cache. The others are checked on all cores,
+	// each thread with its own FreeType library.
+	QVector<FontFileScan*> toScan;
+	for (FontFileScan& scan : pending)
+	{
+		initFontScan(scan);
+		const testCache& known = scan.knownCache;
+		if (scan.known && known.isOK && known.lastMod == scan.lastMod && !known.faces.isEmpty())
+			continue;
+		scan.scanned = true;
+		toScan.append(&scan);
+	}
+
+	int threads = 1;
+	if (!toScan.isEmpty())
+	{
+		ScCore->setSplashStatus( QObject::tr("Checking new and modified fonts...") );
+		FontFileScan** scans = toScan.data();
+		const int count = toScan.count();
+		QAtomicInt nextScan(0);
+		auto scanFiles = [scans, count, &nextScan]()
+		{
+			FT_Library library = nullptr;
+			FT_Init_FreeType( &library );
+			for (int i = nextScan.fetchAndAddRelaxed(1); i < count; i = nextScan.fetchAndAddRelaxed(1))
+				scanFontFile(*scans[i], library);
+			FT_Done_FreeType(library);
+		};
+		QSemaphore finished;
+		int workers = 0;
+		for (int i = 1; i < qMin(QThread::idealThreadCount(), count); ++i)
+		{
+			bool started = QThreadPool::globalInstance()->tryStart([&scanFiles, &finished]()
+			{
+				scanFiles();
+				finished.release();
+			});
+			if (!started)
+				break;
+			++workers;
+		}
+		scanFiles();
+		finished.acquire(workers);
+		threads += workers;
+	}
+
+	// merged in the order the files were found, as if they had been checked one by one
+	FT_Library library = nullptr;
+	for (const FontFileScan& scan : std::as_const(pending))
+	{
+		if (!scan.scanned)
+		{
+			addFontFromCache(scan.filename, scan.lastMod, scan.docName);
+			continue;
+		}
+		mergeFontScan(scan);
+		if (scan.error && scan.tryResourceFork)
+		{
+			if (library == nullptr)
+				FT_Init_FreeType( &library );
+			addScalableFont(scan.filename + "/..namedfork/rsrc", library, scan.docName);
+		}
+	}
+	if (library != nullptr)
+		FT_Done_FreeType(library);
+
+	if (m_showFontInfo)
+		sDebug(QObject::tr("Checked %1 font files in %2 ms, %3 of them with FreeType on %4 threads")
+			   .arg(pending.count()).arg(timer.elapsed()).arg(toScan.count()).arg(threads));
+}
+
+bool SCFonts::addFace(const FaceInfo& info, const QString& filename, const QString& DocName)
+{
+	QString fullName(info.fullName);
+	QString sty(info.style);
+	ScFace t;
+	if (contains(fullName))
+	{
+		t = (*this)[fullName];
+		if (t.psName() != info.psName)
+		{
+			QString alt = " (" + info.psName + ")";
+			fullName += alt;
+			sty += alt;
+		}
+	}
+	t = (*this)[fullName];
+	if (!t.isNone())
+	{
+		if (m_showFontInfo)
+			sDebug(QObject::tr("Font %1(%2) is duplicate of %3").arg(filename).arg(info.faceIndex + 1).arg(t.fontPath()));
+		return false;
+	}
+
+	switch (info.format)
+	{
+		case ScFace::PFA:
+			t = ScFace(new ScFace_PFA(info.family, sty, "", fullName, info.psName, filename, info.faceIndex, info.features));
+			break;
+		case ScFace::PFB:
+			t = ScFace(new ScFace_PFB(info.family, sty, "", fullName, info.psName, filename, info.faceIndex, info.features));
+			break;
+		case ScFace::SFNT:
+		case ScFace::TYPE42:
+			t = ScFace(new ScFace_ttf(info.family, sty, "", fullName, info.psName, filename, info.faceIndex, info.features));
+			t.m_m->typeCode = info.type;
+			break;
+		case ScFace::TTCF:
+			t = ScFace(new ScFace_ttf(info.family, sty, "", fullName, info.psName, filename, info.faceIndex, info.features));
+			t.m_m->formatCode = ScFace::TTCF;
+			t.m_m->typeCode = info.type;
+			break;
+		default:
+		/* catching any types not handled above to silence compiler */
+			break;
+	}
+	insert(fullName, t);
+	t.m_m->hasGlyphNames = info.hasGlyphNames;
+	t.m_m->embeddingFlags = info.embeddingFlags;
+	for (int i = 0; i < 4; ++i)
+		t.m_m->unicodeRanges[i] = info.unicodeRanges[i];
+	t.subset(info.subset);
+	t.embedPs(true);
+	t.usable(true);
+	t.m_m->status = ScFace::UNKNOWN;
+	t.m_m->forDocument = DocName;
+	if (m_showFontInfo)
+		sDebug(QObject::tr("Font %1 loaded from %2(%3)").arg(t.psName(), filename).arg(info.faceIndex + 1));
+	return true;
+}
+
+void SCFonts::addFaces(const QString& filename, const QList<FaceInfo>& faces, const QString& DocName)
+{
+	for (const FaceInfo& info : faces)
+	{
+		if (!addFace(info, filename, DocName) && info.faceIndex > 0)
+			break;
+	}
 }
 
 void SCFonts::removeFont(const QString& name)
@@ -1246,6 +1400,33 @@ void SCFonts::readFontCache(const QString& pf)
 			foCache.isChecked = false;
 			foCache.isOK = static_cast<bool>(dc.attribute("Status", "1").toInt());
 			foCache.lastMod = QDateTime::fromString(dc.attribute("Modified"), Qt::ISODate);
+			foCache.faces.clear();
+			for (QDomElement fc = dc.firstChildElement("Face"); !fc.isNull(); fc = fc.nextSiblingElement("Face"))
+			{
+				FaceInfo info;
+				info.family = fc.attribute("Family");
+				info.style = fc.attribute("Style");
+				info.fullName = fc.attribute("FullName");
+				info.psName = fc.attribute("PSName");
+				info.faceIndex = fc.attribute("Index", "0").toInt();
+				info.format = static_cast<ScFace::FontFormat>(fc.attribute("Format", QString::number(ScFace::UNKNOWN_FORMAT)).toInt());
+				info.type = static_cast<ScFace::FontType>(fc.attribute("Type", QString::number(ScFace::UNKNOWN_TYPE)).toInt());
+				info.hasGlyphNames = static_cast<bool>(fc.attribute("GlyphNames", "0").toInt());
+				info.subset = static_cast<bool>(fc.attribute("Subset", "0").toInt());
+				info.glyphCount = fc.attribute("Glyphs", "0").toInt();
+				info.embeddingFlags = fc.attribute("Embedding", "0").toUShort();
+				QStringList ranges = fc.attribute("UnicodeRanges").split(',', Qt::SkipEmptyParts);
+				for (int i = 0; i < 4 && i < ranges.count(); ++i)
+					info.unicodeRanges[i] = ranges[i].toUInt(nullptr, 16);
+				info.features = fc.attribute("Features").split(',', Qt::SkipEmptyParts);
+				foCache.faces.append(info);
+				// faces cached before coverage and embedding flags were kept are read again
+				if (!fc.hasAttribute("UnicodeRanges"))
+				{
+					foCache.faces.clear();
+					break;
+				}
+			}
 			m_checkedFonts.insert(dc.attribute("File"), foCache);
 		}
 		DOC = DOC.nextSibling();
@@ -1279,6 +1460,27 @@ void SCFonts::writeFontCache(const QString& pf)
 		fosu.setAttribute("File", it.key());
 		fosu.setAttribute("Status", static_cast<int>(checkedFont.isOK));
 		fosu.setAttribute("Modified", checkedFont.lastMod.toString(Qt::ISODate));
+		for (const FaceInfo& info : checkedFont.faces)
+		{
+			QDomElement face = docu.createElement("Face");
+			face.setAttribute("Family", info.family);
+			face.setAttribute("Style", info.style);
+			face.setAttribute("FullName", info.fullName);
+			face.setAttribute("PSName", info.psName);
+			face.setAttribute("Index", info.faceIndex);
+			face.setAttribute("Format", static_cast<int>(info.format));
+			face.setAttribute("Type", static_cast<int>(info.type));
+			face.setAttribute("GlyphNames", static_cast<int>(info.hasGlyphNames));
+			face.setAttribute("Subset", static_cast<int>(info.subset));
+			face.setAttribute("Glyphs", info.glyphCount);
+			face.setAttribute("Embedding", info.embeddingFlags);
+			QStringList ranges;
+			for (quint32 range : info.unicodeRanges)
+				ranges.append(QString::number(range, 16));
+			face.setAttribute("UnicodeRanges", ranges.join(','));
+			face.setAttribute("Features", info.features.join(','));
+			fosu.appendChild(face);
+		}
 		elem.appendChild(fosu);
 	}
 
@@ -1298,6 +1500,8 @@ void SCFonts::getFonts(const QString& pf, bool showFontInfo)
 	m_showFontInfo = showFontInfo;
 	m_fontPaths.clear();
 	readFontCache(pf);
+	// the font files found below are checked together by processPendingFonts()
+	m_parallelScan = true;
 	ScCore->setSplashStatus( QObject::tr("Searching for Fonts") );
 	addUserPath(pf);
 
@@ -1334,6 +1538,8 @@ void SCFonts::getFonts(const QString& pf, bool showFontInfo)
 	for (fpi = m_fontPaths.begin() ; fpi != fpend; ++fpi) 
 		addScalableFonts(*fpi);
 #endif
+	m_parallelScan = false;
+	processPendingFonts();
 	updateFontMap();
 	writeFontCache(pf);
 }
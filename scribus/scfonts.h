@@ -14,6 +14,7 @@ for which a new license (GPL+exception) is in place.
 #include <QMap>
 #include <QVector>
 #include <QPair>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 
@@ -76,14 +77,73 @@ class SCRIBUS_API SCFonts : public QMap<QString,ScFace>
 #endif
 		QStringList m_fontPaths;
 
+		/// what the font cache keeps about a face, enough to create its ScFace without FreeType
+		struct FaceInfo
+		{
+			QString family;
+			QString style;
+			QString fullName;
+			QString psName;
+			int faceIndex { 0 };
+			ScFace::FontFormat format { ScFace::UNKNOWN_FORMAT };
+			ScFace::FontType type { ScFace::UNKNOWN_TYPE };
+			bool hasGlyphNames { false };
+			bool subset { false };
+			int glyphCount { 0 };
+			/// fsType of the OS/2 table
+			ushort embeddingFlags { 0 };
+			/// ulUnicodeRange1-4 of the OS/2 table
+			quint32 unicodeRanges[4] { 0, 0, 0, 0 };
+			QStringList features;
+		};
+
 		struct testCache
 		{
 			bool isOK;
 			bool isChecked;
 			QDateTime lastMod;
+			/// all faces of the file, empty if they have to be read with FreeType
+			QList<FaceInfo> faces;
 		};
 		QMap<QString, testCache> m_checkedFonts;
 
+		/// Creates and inserts the ScFace for info. Returns false if the face duplicates a known one.
+		bool addFace(const FaceInfo& info, const QString& filename, const QString& DocName);
+		void addFaces(const QString& filename, const QList<FaceInfo>& faces, const QString& DocName);
+		/// Adds the faces of an unchanged font file from the cache. Returns false if the file has to be checked.
+		bool addFontFromCache(const QString& filename, const QDateTime& lastMod, const QString& DocName);
+
+		/// a font file to check and what checking it found out
+		struct FontFileScan
+		{
+			QString filename;
+			QString docName;
+			bool tryResourceFork { false };
+			QDateTime lastMod;
+			bool known { false };
+			testCache knownCache {};
+			bool scanned { false };
+
+			bool error { false };
+			testCache cache {};
+			QList<FaceInfo> faces;
+			QString rejectMessage;
+			QStringList messages;
+		};
+		/// font files queued while m_parallelScan is set
+		QList<FontFileScan> m_pendingFonts;
+		QSet<QString> m_queuedFonts;
+		bool m_parallelScan { false };
+
+		static QDateTime fontModificationTime(const QString& filename);
+		void initFontScan(FontFileScan& scan) const;
+		/// Checks a font file with FreeType. Touches no members, so files can be checked on several threads.
+		static void scanFontFile(FontFileScan& scan, FT_Library library);
+		void mergeFontScan(const FontFileScan& scan);
+		void queueFontFile(const QString& filename, const QString& DocName, bool tryResourceFork = false);
+		/// Checks the queued font files on a thread pool and adds them in the order they were found.
+		void processPendingFonts();
+
 	protected:
 		bool m_showFontInfo { false };
 };
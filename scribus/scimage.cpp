@@ -5,11 +5,16 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <csetjmp>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include <QByteArray>
 #include <QFile>
@@ -34,6 +39,7 @@ for which a new license (GPL+exception) is in place.
 #include "util_color.h"
 #include "util_formats.h"
 #include "util_ghostscript.h"
+#include "util_parallel.h"
 
 #include "imagedataloaders/scimgdataloader_gimp.h"
 #ifdef GMAGICK_FOUND
@@ -58,6 +64,316 @@ for which a new license (GPL+exception) is in place.
 
 using namespace std;
 
+namespace
+{
+	// rows or columns handed to a thread at once by the image effects
+	const int effectRowChunk = 16;
+
+	/// Gray value the tone effects map through their tables, the alpha byte of CMYK images holds black.
+	inline int toneIndex(QRgb r, bool cmyk)
+	{
+		if (cmyk)
+			return qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
+		return 255 - qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
+	}
+
+	/// Adds @a bytes channel values of @a src times @a weight to the sums in @a acc.
+	void accumulateRow(float* acc, const uchar* src, int bytes, float weight)
+	{
+		int i = 0;
+#if defined(__SSE2__)
+		const __m128 w = _mm_set1_ps(weight);
+		const __m128i zero = _mm_setzero_si128();
+		for (; i + 16 <= bytes; i += 16)
+		{
+			__m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			__m128i lo = _mm_unpacklo_epi8(px, zero);
+			__m128i hi = _mm_unpackhi_epi8(px, zero);
+			_mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(w, _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)))));
+			_mm_storeu_ps(acc + i + 4, _mm_add_ps(_mm_loadu_ps(acc + i + 4), _mm_mul_ps(w, _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)))));
+			_mm_storeu_ps(acc + i + 8, _mm_add_ps(_mm_loadu_ps(acc + i + 8), _mm_mul_ps(w, _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)))));
+			_mm_storeu_ps(acc + i + 12, _mm_add_ps(_mm_loadu_ps(acc + i + 12), _mm_mul_ps(w, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)))));
+		}
+#endif
+		for (; i < bytes; ++i)
+			acc[i] += weight * src[i];
+	}
+
+	/**
+	 * Convolves a row of per channel sums horizontally and adds the source pixels times @a center.
+	 * @a padded holds the row with the border pixels repeated taps / 2 times on both sides.
+	 */
+	void convolveRow(const float* padded, const uchar* src, uchar* dest, int count, const float* weights, int taps, float center)
+	{
+		// rounds like the former convolution with 16 bit channels did
+		const float bias = 0.5f / 257.0f;
+#if defined(__SSE2__)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 c = _mm_set1_ps(center);
+		const __m128 b = _mm_set1_ps(bias);
+		for (int x = 0; x < count; ++x)
+		{
+			int px;
+			memcpy(&px, src + 4 * x, 4);
+			__m128i p = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(px), zero), zero);
+			__m128 sum = _mm_add_ps(b, _mm_mul_ps(c, _mm_cvtepi32_ps(p)));
+			const float* in = padded + 4 * x;
+			for (int j = 0; j < taps; ++j)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[j]), _mm_loadu_ps(in + 4 * j)));
+			// the packs saturate to 0..255
+			__m128i v = _mm_cvttps_epi32(sum);
+			v = _mm_packs_epi32(v, v);
+			v = _mm_packus_epi16(v, v);
+			px = _mm_cvtsi128_si32(v);
+			memcpy(dest + 4 * x, &px, 4);
+		}
+#else
+		for (int x = 0; x < count; ++x)
+		{
+			const float* in = padded + 4 * x;
+			for (int ch = 0; ch < 4; ++ch)
+			{
+				float sum = bias + center * src[4 * x + ch];
+				for (int j = 0; j < taps; ++j)
+					sum += weights[j] * in[4 * j + ch];
+				dest[4 * x + ch] = qBound(0, static_cast<int>(sum), 255);
+			}
+		}
+#endif
+	}
+
+	/// Source pixels and their weights for each pixel along one axis of a scaled image
+	struct ScaleContributions
+	{
+		QVector<int> first;
+		QVector<int> count;
+		QVector<int> offset;
+		QVector<float> weights;
+	};
+
+	double lanczos3(double t)
+	{
+		if (t == 0.0)
+			return 1.0;
+		if (qAbs(t) >= 3.0)
+			return 0.0;
+		double pt = M_PI * t;
+		return 3.0 * sin(pt) * sin(pt / 3.0) / (pt * pt);
+	}
+
+	/**
+	 * Weights of the source pixels for each of @a dstSize pixels. When shrinking the filters are
+	 * widened by the scale factor so that every source pixel contributes; the box filter then
+	 * averages the area covered by a destination pixel.
+	 */
+	ScaleContributions scaleContributions(int srcSize, int dstSize, ScImage::ScaleFilter filter)
+	{
+		ScaleContributions result;
+		result.first.resize(dstSize);
+		result.count.resize(dstSize);
+		result.offset.resize(dstSize);
+		const double scale = (double) srcSize / dstSize;
+		const double filterScale = qMax(1.0, scale);
+		double radius = 0.5;
+		if (filter == ScImage::BilinearFilter)
+			radius = 1.0;
+		else if (filter == ScImage::LanczosFilter)
+			radius = 3.0;
+		const double support = radius * filterScale;
+
+		QVector<double> weights;
+		for (int x = 0; x < dstSize; ++x)
+		{
+			double center = (x + 0.5) * scale;
+			int first = qMax(0, static_cast<int>(floor(center - support)));
+			int last = qMin(srcSize - 1, static_cast<int>(ceil(center + support)) - 1);
+			weights.clear();
+			double total = 0.0;
+			for (int i = first; i <= last; ++i)
+			{
+				double value;
+				if (filter == ScImage::BoxFilter)
+					value = qMax(0.0, qMin(i + 1.0, center + support) - qMax(static_cast<double>(i), center - support));
+				else if (filter == ScImage::BilinearFilter)
+					value = qMax(0.0, 1.0 - qAbs((i + 0.5 - center) / filterScale));
+				else
+					value = lanczos3((i + 0.5 - center) / filterScale);
+				weights.append(value);
+				total += value;
+			}
+			if (weights.isEmpty() || qAbs(total) < 1.0e-9)
+			{
+				first = qBound(0, static_cast<int>(center), srcSize - 1);
+				weights.fill(0.0, 1);
+				weights[0] = total = 1.0;
+			}
+			result.first[x] = first;
+			result.count[x] = weights.count();
+			result.offset[x] = result.weights.count();
+			for (double value : std::as_const(weights))
+				result.weights.append(value / total);
+		}
+		return result;
+	}
+
+	/// Resamples one row of per channel values horizontally.
+	void resampleRow(const float* row, uchar* dest, int dstWidth, int channels, const ScaleContributions& columns)
+	{
+		const float* weights = columns.weights.constData();
+#if defined(__SSE2__)
+		if (channels == 4)
+		{
+			for (int x = 0; x < dstWidth; ++x)
+			{
+				const float* w = weights + columns.offset[x];
+				const float* in = row + 4 * columns.first[x];
+				__m128 sum = _mm_setzero_ps();
+				for (int j = 0; j < columns.count[x]; ++j)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(w[j]), _mm_loadu_ps(in + 4 * j)));
+				// rounds half up like qRound(), negative sums end up 0 either way, the packs saturate to 0..255
+				__m128i v = _mm_cvttps_epi32(_mm_add_ps(sum, _mm_set1_ps(0.5f)));
+				v = _mm_packs_epi32(v, v);
+				v = _mm_packus_epi16(v, v);
+				int px = _mm_cvtsi128_si32(v);
+				memcpy(dest + 4 * x, &px, 4);
+			}
+			return;
+		}
+#endif
+		for (int x = 0; x < dstWidth; ++x)
+		{
+			const float* w = weights + columns.offset[x];
+			const float* in = row + channels * columns.first[x];
+			for (int ch = 0; ch < channels; ++ch)
+			{
+				float sum = 0.0f;
+				for (int j = 0; j < columns.count[x]; ++j)
+					sum += w[j] * in[channels * j + ch];
+				dest[channels * x + ch] = qBound(0, qRound(sum), 255);
+			}
+		}
+	}
+
+	/// Scales interleaved 8 bit channels, rows of the destination are spread over the thread pool.
+	void resampleImage(const uchar* srcBits, qsizetype srcBpl, int srcWidth, int srcHeight,
+					   uchar* dstBits, qsizetype dstBpl, int dstWidth, int dstHeight, int channels, ScImage::ScaleFilter filter)
+	{
+		const ScaleContributions columns = scaleContributions(srcWidth, dstWidth, filter);
+		const ScaleContributions rows = scaleContributions(srcHeight, dstHeight, filter);
+		parallelFor(dstHeight, effectRowChunk, [&](int firstRow, int lastRow)
+		{
+			QVector<float> row(srcWidth * channels);
+			for (int y = firstRow; y < lastRow; ++y)
+			{
+				std::fill(row.begin(), row.end(), 0.0f);
+				const float* weights = rows.weights.constData() + rows.offset[y];
+				for (int j = 0; j < rows.count[y]; ++j)
+					accumulateRow(row.data(), srcBits + (rows.first[y] + j) * srcBpl, srcWidth * channels, weights[j]);
+				resampleRow(row.constData(), dstBits + y * dstBpl, dstWidth, channels, columns);
+			}
+		});
+	}
+
+	/**
+	 * Stack blur of one line of @a count pixels, @a step pixels apart, in place.
+	 * Pixels are written once the stack holds them, later ones are still unchanged when read.
+	 */
+	void stackBlurLine(QRgb* pix, int count, int step, int radius, const int* dv, int* stack)
+	{
+		int div = radius + radius + 1;
+		int r1 = radius + 1;
+		int last = count - 1;
+		int rsum, gsum, bsum, asum;
+		int routsum, goutsum, boutsum, aoutsum;
+		int rinsum, ginsum, binsum, ainsum;
+		int* sir;
+		QRgb p;
+
+		rinsum = ginsum = binsum = ainsum
+			= routsum = goutsum = boutsum = aoutsum
+			= rsum = gsum = bsum = asum = 0;
+		for (int i = -radius; i <= radius; ++i)
+		{
+			p = pix[qMin(last, qMax(i, 0)) * step];
+			sir = stack + 4 * (i + radius);
+			sir[0] = qRed(p);
+			sir[1] = qGreen(p);
+			sir[2] = qBlue(p);
+			sir[3] = qAlpha(p);
+
+			int rbs = r1 - abs(i);
+			rsum += sir[0] * rbs;
+			gsum += sir[1] * rbs;
+			bsum += sir[2] * rbs;
+			asum += sir[3] * rbs;
+
+			if (i > 0)
+			{
+				rinsum += sir[0];
+				ginsum += sir[1];
+				binsum += sir[2];
+				ainsum += sir[3];
+			}
+			else
+			{
+				routsum += sir[0];
+				goutsum += sir[1];
+				boutsum += sir[2];
+				aoutsum += sir[3];
+			}
+		}
+
+		int stackpointer = radius;
+		for (int x = 0; x < count; ++x)
+		{
+			pix[x * step] = qRgba(dv[rsum], dv[gsum], dv[bsum], dv[asum]);
+
+			rsum -= routsum;
+			gsum -= goutsum;
+			bsum -= boutsum;
+			asum -= aoutsum;
+
+			int stackstart = stackpointer - radius + div;
+			sir = stack + 4 * (stackstart % div);
+
+			routsum -= sir[0];
+			goutsum -= sir[1];
+			boutsum -= sir[2];
+			aoutsum -= sir[3];
+
+			p = pix[qMin(x + r1, last) * step];
+
+			sir[0] = qRed(p);
+			sir[1] = qGreen(p);
+			sir[2] = qBlue(p);
+			sir[3] = qAlpha(p);
+
+			rinsum += sir[0];
+			ginsum += sir[1];
+			binsum += sir[2];
+			ainsum += sir[3];
+
+			rsum += rinsum;
+			gsum += ginsum;
+			bsum += binsum;
+			asum += ainsum;
+
+			stackpointer = (stackpointer + 1) % div;
+			sir = stack + 4 * stackpointer;
+
+			routsum += sir[0];
+			goutsum += sir[1];
+			boutsum += sir[2];
+			aoutsum += sir[3];
+
+			rinsum -= sir[0];
+			ginsum -= sir[1];
+			binsum -= sir[2];
+			ainsum -= sir[3];
+		}
+	}
+}
+
 ScImage::ScImage(const QImage & image) : QImage(image)
 {
 }
@@ -367,6 +683,7 @@ void ScImage::solarize(double factor, bool cmyk)
 }
 
 // Stack Blur Algorithm by Mario Klingemann <mario@quasimondo.com>
+// Rows and then columns are blurred in place, each line on its own, so both passes run in parallel.
 void ScImage::blur(int radius)
 {
 	if (radius < 1) {
@@ -376,313 +693,63 @@ void ScImage::blur(int radius)
 	QRgb *pix = (QRgb*) bits();
 	int w   = width();
 	int h   = height();
-	int wm  = w - 1;
-	int hm  = h - 1;
-	int wh  = w * h;
 	int div = radius + radius + 1;
 
-	int *r = new int[wh];
-	int *g = new int[wh];
-	int *b = new int[wh];
-	int *a = new int[wh];
-	int rsum, gsum, bsum, asum, x, y, i, yp, yi, yw;
-	QRgb p;
-	int *vmin = new int[qMax(w, h)];
-
 	int divsum = (div + 1) >> 1;
 	divsum *= divsum;
-	int *dv = new int[256*divsum];
-	for (i = 0; i < 256 * divsum; ++i) {
+	QVector<int> dvTable(256 * divsum);
+	int *dv = dvTable.data();
+	for (int i = 0; i < 256 * divsum; ++i) {
 		dv[i] = (i / divsum);
 	}
 
-	yw = yi = 0;
-
-	int **stack = new int*[div];
-	for (int i = 0; i < div; ++i) {
-		stack[i] = new int[4];
-	}
-
-	int stackpointer;
-	int stackstart;
-	int *sir;
-	int rbs;
-	int r1 = radius + 1;
-	int routsum, goutsum, boutsum, aoutsum;
-	int rinsum, ginsum, binsum, ainsum;
-
-	for (y = 0; y < h; ++y)
+	parallelFor(h, effectRowChunk, [&](int first, int last)
 	{
-		rinsum = ginsum = binsum = ainsum
-			= routsum = goutsum = boutsum = aoutsum
-			= rsum = gsum = bsum = asum = 0;
-		for (i = -radius; i <= radius; ++i)
-		{
-			p = pix[yi + qMin(wm, qMax(i, 0))];
-			sir = stack[i + radius];
-			sir[0] = qRed(p);
-			sir[1] = qGreen(p);
-			sir[2] = qBlue(p);
-			sir[3] = qAlpha(p);
-
-			rbs = r1 - abs(i);
-			rsum += sir[0] * rbs;
-			gsum += sir[1] * rbs;
-			bsum += sir[2] * rbs;
-			asum += sir[3] * rbs;
-
-			if (i > 0)
-			{
-				rinsum += sir[0];
-				ginsum += sir[1];
-				binsum += sir[2];
-				ainsum += sir[3];
-			}
-			else
-			{
-				routsum += sir[0];
-				goutsum += sir[1];
-				boutsum += sir[2];
-				aoutsum += sir[3];
-			}
-		}
-		stackpointer = radius;
-
-		for (x=0; x < w; ++x)
-		{
-			r[yi] = dv[rsum];
-			g[yi] = dv[gsum];
-			b[yi] = dv[bsum];
-			a[yi] = dv[asum];
-
-			rsum -= routsum;
-			gsum -= goutsum;
-			bsum -= boutsum;
-			asum -= aoutsum;
-
-			stackstart = stackpointer - radius + div;
-			sir = stack[stackstart % div];
-
-			routsum -= sir[0];
-			goutsum -= sir[1];
-			boutsum -= sir[2];
-			aoutsum -= sir[3];
-
-			if (y == 0)
-			{
-				vmin[x] = qMin(x + radius + 1, wm);
-			}
-			p = pix[yw + vmin[x]];
-
-			sir[0] = qRed(p);
-			sir[1] = qGreen(p);
-			sir[2] = qBlue(p);
-			sir[3] = qAlpha(p);
-
-			rinsum += sir[0];
-			ginsum += sir[1];
-			binsum += sir[2];
-			ainsum += sir[3];
-
-			rsum += rinsum;
-			gsum += ginsum;
-			bsum += binsum;
-			asum += ainsum;
-
-			stackpointer = (stackpointer+1)%div;
-			sir = stack[(stackpointer)%div];
-
-			routsum += sir[0];
-			goutsum += sir[1];
-			boutsum += sir[2];
-			aoutsum += sir[3];
-
-			rinsum -= sir[0];
-			ginsum -= sir[1];
-			binsum -= sir[2];
-			ainsum -= sir[3];
-
-			++yi;
-		}
-		yw += w;
-	}
-	for (x=0; x < w; ++x)
+		QVector<int> stack(4 * div);
+		for (int y = first; y < last; ++y)
+			stackBlurLine(pix + y * w, w, 1, radius, dv, stack.data());
+	});
+	parallelFor(w, effectRowChunk, [&](int first, int last)
 	{
-		rinsum = ginsum = binsum = ainsum
-			= routsum = goutsum = boutsum = aoutsum
-			= rsum = gsum = bsum = asum = 0;
-
-		yp =- radius * w;
-
-		for (i=-radius; i <= radius; ++i)
-		{
-			yi = qMax(0, yp) + x;
-
-			sir = stack[i + radius];
-
-			sir[0] = r[yi];
-			sir[1] = g[yi];
-			sir[2] = b[yi];
-			sir[3] = a[yi];
-
-			rbs = r1 - abs(i);
-
-			rsum += r[yi]*rbs;
-			gsum += g[yi]*rbs;
-			bsum += b[yi]*rbs;
-			asum += a[yi]*rbs;
-
-			if (i > 0)
-			{
-				rinsum += sir[0];
-				ginsum += sir[1];
-				binsum += sir[2];
-				ainsum += sir[3];
-			}
-			else
-			{
-				routsum += sir[0];
-				goutsum += sir[1];
-				boutsum += sir[2];
-				aoutsum += sir[3];
-			}
-
-			if (i < hm)
-			{
-				yp += w;
-			}
-		}
-
-		yi = x;
-		stackpointer = radius;
-
-		for (y=0; y < h; ++y)
-		{
-			pix[yi] = qRgba(dv[rsum], dv[gsum], dv[bsum], dv[asum]);
-
-			rsum -= routsum;
-			gsum -= goutsum;
-			bsum -= boutsum;
-			asum -= aoutsum;
-
-			stackstart = stackpointer-radius+div;
-			sir = stack[stackstart%div];
-
-			routsum -= sir[0];
-			goutsum -= sir[1];
-			boutsum -= sir[2];
-			aoutsum -= sir[3];
-
-			if (x==0)
-			{
-				vmin[y] = qMin(y + r1,hm)*w;
-			}
-			p = x + vmin[y];
-
-			sir[0] = r[p];
-			sir[1] = g[p];
-			sir[2] = b[p];
-			sir[3] = a[p];
-
-			rinsum += sir[0];
-			ginsum += sir[1];
-			binsum += sir[2];
-			ainsum += sir[3];
-
-			rsum += rinsum;
-			gsum += ginsum;
-			bsum += binsum;
-			asum += ainsum;
-
-			stackpointer = (stackpointer + 1) % div;
-			sir = stack[stackpointer];
-
-			routsum += sir[0];
-			goutsum += sir[1];
-			boutsum += sir[2];
-			aoutsum += sir[3];
-
-			rinsum -= sir[0];
-			ginsum -= sir[1];
-			binsum -= sir[2];
-			ainsum -= sir[3];
-
-			yi += w;
-		}
-	}
-	delete [] r;
-	delete [] g;
-	delete [] b;
-	delete [] a;
-	delete [] vmin;
-	delete [] dv;
-
-	for (int i = 0; i < div; ++i)
-	{
-		delete [] stack[i];
-	}
-	delete [] stack;
+		QVector<int> stack(4 * div);
+		for (int x = first; x < last; ++x)
+			stackBlurLine(pix + x, h, w, radius, dv, stack.data());
+	});
 }
 
-bool ScImage::convolveImage(QImage *dest, const unsigned int order, const double *kernel)
+void ScImage::convolveSeparable(QImage *dest, const QVector<float>& vWeights, const QVector<float>& hWeights, float center) const
 {
-	double red, green, blue, alpha;
-	const double *k;
-	unsigned int *q;
-	int x, y, mx, my, sx, sy;
-	long i;
-	int mcx, mcy;
-	long widthk = order;
-	if ((widthk % 2) == 0)
-		return false;
-	double *normal_kernel = (double *)malloc(widthk*widthk*sizeof(double));
-	if (!normal_kernel)
-		return false;
-	*dest = QImage(width(), height(), QImage::Format_ARGB32);
-	double normalize = 0.0;
-	for (i=0; i < (widthk * widthk); i++)
-		normalize += kernel[i];
-	if (fabs(normalize) <= 1.0e-12)
-		normalize = 1.0;
-	normalize = 1.0 / normalize;
-	for (i = 0; i < (widthk * widthk); i++)
-		normal_kernel[i] = normalize*kernel[i];
-	for (y = 0; y < dest->height(); ++y)
-	{
-		sy = y - (widthk / 2);
-		q = (unsigned int *) dest->scanLine(y);
-		for (x = 0; x < dest->width(); ++x)
+	const int w = width();
+	const int h = height();
+	const int taps = hWeights.count();
+	const int half = taps / 2;
+	*dest = QImage(w, h, QImage::Format_ARGB32);
+	const uchar* srcBits = constBits();
+	const qsizetype srcBpl = bytesPerLine();
+	uchar* destBits = dest->bits();
+	const qsizetype destBpl = dest->bytesPerLine();
+
+	parallelFor(h, effectRowChunk, [&](int first, int last)
+	{
+		// one row blurred vertically, with its border pixels repeated on both sides
+		QVector<float> padded(4 * (w + 2 * half));
+		float* row = padded.data() + 4 * half;
+		for (int y = first; y < last; ++y)
 		{
-			k = normal_kernel;
-			red = green = blue = alpha = 0;
-			sy = y - (widthk / 2);
-			for (mcy = 0; mcy < widthk; ++mcy, ++sy)
+			std::fill(row, row + 4 * w, 0.0f);
+			for (int j = 0; j < vWeights.count(); ++j)
 			{
-				my = sy < 0 ? 0 : sy > height() - 1 ? height() - 1 : sy;
-				sx = x + (-widthk / 2);
-				for (mcx=0; mcx < widthk; ++mcx, ++sx)
-				{
-					mx = sx < 0 ? 0 : sx > width()-1 ? width()-1 : sx;
-					int px = pixel(mx, my);
-					red += (*k)*(qRed(px) * 257);
-					green += (*k)*(qGreen(px) * 257);
-					blue += (*k)*(qBlue(px) * 257);
-					alpha += (*k)*(qAlpha(px) * 257);
-					++k;
-				}
+				int sy = qBound(0, y + j - vWeights.count() / 2, h - 1);
+				accumulateRow(row, srcBits + sy * srcBpl, 4 * w, vWeights.at(j));
 			}
-			red = red < 0 ? 0 : red > 65535 ? 65535 : red + 0.5;
-			green = green < 0 ? 0 : green > 65535 ? 65535 : green + 0.5;
-			blue = blue < 0 ? 0 : blue > 65535 ? 65535 : blue + 0.5;
-			alpha = alpha < 0 ? 0 : alpha > 65535 ? 65535 : alpha + 0.5;
-			*q++ = qRgba((unsigned char)(red / 257UL),
-			             (unsigned char)(green / 257UL),
-			             (unsigned char)(blue / 257UL),
-			             (unsigned char)(alpha / 257UL));
+			for (int i = 0; i < half; ++i)
+			{
+				std::copy(row, row + 4, padded.data() + 4 * i);
+				std::copy(row + 4 * (w - 1), row + 4 * w, row + 4 * (w + i));
+			}
+			convolveRow(padded.constData(), srcBits + y * srcBpl, destBits + y * destBpl, w, hWeights.constData(), taps, center);
 		}
-	}
-	free(normal_kernel);
-	return(true);
+	});
 }
 
 int ScImage::getOptimalKernelWidth(double radius, double sigma)
@@ -709,7 +776,6 @@ int ScImage::getOptimalKernelWidth(double radius, double sigma)
 
 void ScImage::sharpen(double radius, double sigma)
 {
-	long u, v;
 	if (sigma == 0.0)
 		return;
 
@@ -717,40 +783,28 @@ void ScImage::sharpen(double radius, double sigma)
 	if ((widthk <= 0) || (width() < widthk))
 		return;
 
-	double *kernel = (double *) malloc(widthk * widthk * sizeof(double));
-	if (!kernel)
-		return;
-
-	long i = 0;
-	double alpha;
-	double normalize = 0.0;
-	for (v= (-widthk / 2); v <= (widthk / 2); v++)
+	// The kernel is a 2D gaussian G whose center weight is replaced by -2 times its sum. Up to
+	// the normalization that is the source pixel times (1 + 2 s^2) minus the image blurred by
+	// the separable g x g, with g the 1D gaussian and s its sum.
+	QVector<float> gauss(widthk);
+	double sum = 0.0;
+	for (int u = -(widthk / 2); u <= (widthk / 2); u++)
 	{
-		for (u= (-widthk / 2); u <= (widthk / 2); u++)
-		{
-			alpha = exp(-((double) u * u + v * v) / (2.0 * sigma * sigma));
-			kernel[i] = alpha / (2.0 * 3.14159265358979323846264338327950288419716939937510 * sigma * sigma);
-			normalize += kernel[i];
-			i++;
-		}
+		double value = exp(-((double) u * u) / (2.0 * sigma * sigma));
+		gauss[u + widthk / 2] = value;
+		sum += value;
 	}
-	kernel[i / 2] = (-2.0) * normalize;
+	double normalize = sum * sum + 1.0;
+	QVector<float> hWeights(widthk);
+	for (int i = 0; i < widthk; ++i)
+		hWeights[i] = -gauss[i] / normalize;
+	float center = (2.0 * sum * sum + 1.0) / normalize;
 
 	QImage dest;
-	convolveImage(&dest, widthk, kernel);
-	free(kernel);
+	convolveSeparable(&dest, gauss, hWeights, center);
 
 	for (int yi = 0; yi < dest.height(); ++yi)
-	{
-		QRgb *s = (QRgb*) dest.scanLine(yi);
-		QRgb *d = (QRgb*) scanLine(yi);
-		for (int xi = 0; xi < dest.width(); ++xi)
-		{
-			(*d) = (*s);
-			s++;
-			d++;
-		}
-	}
+		memcpy(scanLine(yi), dest.constScanLine(yi), 4 * dest.width());
 }
 
 void ScImage::contrast(int contrastValue, bool cmyk)
@@ -791,49 +845,66 @@ void ScImage::doGraduate(FPointArray curve, bool cmyk, bool linear)
 
 void ScImage::applyCurve(const QVector<int>& curveTable, bool cmyk)
 {
-	int h = height();
-	int w = width();
-	QRgb *s;
-	QRgb r;
-	int c, m, y, k;
-	unsigned char *p;
-	for (int yi=0; yi < h; ++yi)
+	// one table per byte of a pixel, the alpha byte of RGB images stays as it is
+	uchar tables[4][256];
+	const int alphaByte = (QSysInfo::ByteOrder == QSysInfo::LittleEndian) ? 3 : 0;
+	for (int i = 0; i < 256; ++i)
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for (int xi=0; xi < w; ++xi)
+		uchar value = cmyk ? 255 - curveTable[255 - i] : curveTable[i];
+		for (int b = 0; b < 4; ++b)
+			tables[b][i] = value;
+		if (!cmyk)
+			tables[alphaByte][i] = i;
+	}
+
+	uchar* imageBits = bits();
+	const qsizetype bpl = bytesPerLine();
+	const int w = width();
+	parallelFor(height(), effectRowChunk, [&](int first, int last)
+	{
+		for (int yi = first; yi < last; ++yi)
 		{
-			r = *s;
+			uchar* p = imageBits + yi * bpl;
+			for (int xi = 0; xi < w; ++xi, p += 4)
+			{
+				p[0] = tables[0][p[0]];
+				p[1] = tables[1][p[1]];
+				p[2] = tables[2][p[2]];
+				p[3] = tables[3][p[3]];
+			}
+		}
+	});
+}
+
+void ScImage::applyToneTable(const QRgb* table, bool cmyk)
+{
+	uchar* imageBits = bits();
+	const qsizetype bpl = bytesPerLine();
+	const int w = width();
+	parallelFor(height(), effectRowChunk, [&](int first, int last)
+	{
+		for (int yi = first; yi < last; ++yi)
+		{
+			QRgb* s = (QRgb*)(imageBits + yi * bpl);
 			if (cmyk)
 			{
-				p = (unsigned char *) s;
-				p[0] = 255 - curveTable[255 - p[0]];
-				p[1] = 255 - curveTable[255 - p[1]];
-				p[2] = 255 - curveTable[255 - p[2]];
-				p[3] = 255 - curveTable[255 - p[3]];
+				for (int xi = 0; xi < w; ++xi, ++s)
+					*s = table[toneIndex(*s, true)];
 			}
 			else
 			{
-				c = curveTable[qRed(r)];
-				m = curveTable[qGreen(r)];
-				y = curveTable[qBlue(r)];
-				k = qAlpha(r);
-				*s = qRgba(c, m, y, k);
+				for (int xi = 0; xi < w; ++xi, ++s)
+					*s = (table[toneIndex(*s, false)] & RGB_MASK) | (*s & ~RGB_MASK);
 			}
-			s++;
 		}
-	}
+	});
 }
 
 void ScImage::colorize(ScribusDoc* doc, ScColor color, int shade, bool cmyk)
 {
-	int h = height();
-	int w = width();
 	int cc, cm, cy, ck;
 	int hu, sa, v;
-	ScColor tmp2;
 	QColor tmpR;
-	QRgb *s;
-	QRgb r;
 	double k;
 	int cc2, cm2, cy2, k2;
 	if (cmyk)
@@ -849,35 +920,30 @@ void ScImage::colorize(ScribusDoc* doc, ScColor color, int shade, bool cmyk)
 		ScColorEngine::getShadeColorRGB(color, doc, rgbCol, shade);
 		rgbCol.getValues(cc, cm, cy);
 	}
-	for (int yi = 0; yi < h; ++yi)
+	// the result only depends on the gray value of a pixel
+	QRgb table[256];
+	for (int i = 0; i < 256; ++i)
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
+		if (cmyk)
 		{
-			r = *s;
-			if (cmyk)
-			{
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255) / 255.0;
-				*s = qRgba(qMin(qRound(cc*k), 255), qMin(qRound(cm*k), 255), qMin(qRound(cy*k), 255), qMin(qRound(ck*k), 255));
-			}
-			else
-			{
-				k2 = 255 - qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-				tmpR.setRgb(cc, cm, cy);
-				tmpR.getHsv(&hu, &sa, &v);
-				tmpR.setHsv(hu, sa * k2 / 255, 255 - ((255 - v) * k2 / 255));
-				tmpR.getRgb(&cc2, &cm2, &cy2);
-				*s = qRgba(cc2, cm2, cy2, qAlpha(r));
-			}
-			s++;
+			k = i / 255.0;
+			table[i] = qRgba(qMin(qRound(cc*k), 255), qMin(qRound(cm*k), 255), qMin(qRound(cy*k), 255), qMin(qRound(ck*k), 255));
+		}
+		else
+		{
+			k2 = i;
+			tmpR.setRgb(cc, cm, cy);
+			tmpR.getHsv(&hu, &sa, &v);
+			tmpR.setHsv(hu, sa * k2 / 255, 255 - ((255 - v) * k2 / 255));
+			tmpR.getRgb(&cc2, &cm2, &cy2);
+			table[i] = qRgb(cc2, cm2, cy2);
 		}
 	}
+	applyToneTable(table, cmyk);
 }
 
 void ScImage::duotone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray curve1, bool lin1, ScColor color2, int shade2, FPointArray curve2, bool lin2, bool cmyk)
 {
-	int h = height();
-	int w = width();
 	int c, c1, m, m1, y, y1, k, k1;
 	int cn, c1n, mn, m1n, yn, y1n, kn, k1n;
 	uchar cb;
@@ -898,42 +964,34 @@ void ScImage::duotone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray c
 	{
 		curveTable2[x] = qMin(255, qMax(0, qRound(getCurveYValue(curve2, x / 255.0, lin2) * 255)));
 	}
-	for (int yi=0; yi < h; ++yi)
+	// the result only depends on the gray value of a pixel
+	QRgb table[256];
+	for (int i = 0; i < 256; ++i)
 	{
-		QRgb * s = (QRgb*)(scanLine( yi ));
-		for (int xi=0; xi < w; ++xi)
+		cb = i;
+		cn = qMin((c * curveTable1[(int)cb]) >> 8, 255);
+		mn = qMin((m * curveTable1[(int)cb]) >> 8, 255);
+		yn = qMin((y * curveTable1[(int)cb]) >> 8, 255);
+		kn = qMin((k * curveTable1[(int)cb]) >> 8, 255);
+		c1n = qMin((c1 * curveTable1[(int)cb]) >> 8, 255);
+		m1n = qMin((m1 * curveTable2[(int)cb]) >> 8, 255);
+		y1n = qMin((y1 * curveTable2[(int)cb]) >> 8, 255);
+		k1n = qMin((k1 * curveTable2[(int)cb]) >> 8, 255);
+		ScColor col = ScColor(qMin(cn + c1n, 255), qMin(mn + m1n, 255), qMin(yn + y1n, 255), qMin(kn + k1n, 255));
+		if (cmyk)
+			col.getCMYK(&cn, &mn, &yn, &kn);
+		else
 		{
-			QRgb r = *s;
-			if (cmyk)
-				cb = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
-			else
-				cb = 255 - qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-			cn = qMin((c * curveTable1[(int)cb]) >> 8, 255);
-			mn = qMin((m * curveTable1[(int)cb]) >> 8, 255);
-			yn = qMin((y * curveTable1[(int)cb]) >> 8, 255);
-			kn = qMin((k * curveTable1[(int)cb]) >> 8, 255);
-			c1n = qMin((c1 * curveTable1[(int)cb]) >> 8, 255);
-			m1n = qMin((m1 * curveTable2[(int)cb]) >> 8, 255);
-			y1n = qMin((y1 * curveTable2[(int)cb]) >> 8, 255);
-			k1n = qMin((k1 * curveTable2[(int)cb]) >> 8, 255);
-			ScColor col = ScColor(qMin(cn + c1n, 255), qMin(mn + m1n, 255), qMin(yn + y1n, 255), qMin(kn + k1n, 255));
-			if (cmyk)
-				col.getCMYK(&cn, &mn, &yn, &kn);
-			else
-			{
-				col.getRawRGBColor(&cn, &mn, &yn);
-				kn = qAlpha(r);
-			}
-			*s = qRgba(cn, mn, yn, kn);
-			s++;
+			col.getRawRGBColor(&cn, &mn, &yn);
+			kn = 255;
 		}
+		table[i] = qRgba(cn, mn, yn, kn);
 	}
+	applyToneTable(table, cmyk);
 }
 
 void ScImage::tritone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray curve1, bool lin1, ScColor color2, int shade2, FPointArray curve2, bool lin2, ScColor color3, int shade3, const FPointArray& curve3, bool lin3, bool cmyk)
 {
-	int h = height();
-	int w = width();
 	int c, c1, c2, m, m1, m2, y, y1, y2, k, k1, k2;
 	int cn, c1n, c2n, mn, m1n, m2n, yn, y1n, y2n, kn, k1n, k2n;
 	uchar cb;
@@ -962,46 +1020,38 @@ void ScImage::tritone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray c
 	{
 		curveTable3[x] = qMin(255, qMax(0, qRound(getCurveYValue(curve2, x / 255.0, lin3) * 255)));
 	}
-	for (int yi = 0; yi < h; ++yi)
+	// the result only depends on the gray value of a pixel
+	QRgb table[256];
+	for (int i = 0; i < 256; ++i)
 	{
-		QRgb * s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
+		cb = i;
+		cn = qMin((c * curveTable1[(int)cb]) >> 8, 255);
+		mn = qMin((m * curveTable1[(int)cb]) >> 8, 255);
+		yn = qMin((y * curveTable1[(int)cb]) >> 8, 255);
+		kn = qMin((k * curveTable1[(int)cb]) >> 8, 255);
+		c1n = qMin((c1 * curveTable2[(int)cb]) >> 8, 255);
+		m1n = qMin((m1 * curveTable2[(int)cb]) >> 8, 255);
+		y1n = qMin((y1 * curveTable2[(int)cb]) >> 8, 255);
+		k1n = qMin((k1 * curveTable2[(int)cb]) >> 8, 255);
+		c2n = qMin((c2 * curveTable3[(int)cb]) >> 8, 255);
+		m2n = qMin((m2 * curveTable3[(int)cb]) >> 8, 255);
+		y2n = qMin((y2 * curveTable3[(int)cb]) >> 8, 255);
+		k2n = qMin((k2 * curveTable3[(int)cb]) >> 8, 255);
+		ScColor col = ScColor(qMin(cn+c1n+c2n, 255), qMin(mn+m1n+m2n, 255), qMin(yn+y1n+y2n, 255), qMin(kn+k1n+k2n, 255));
+		if (cmyk)
+			col.getCMYK(&cn, &mn, &yn, &kn);
+		else
 		{
-			QRgb r = *s;
-			if (cmyk)
-				cb = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
-			else
-				cb = 255 - qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-			cn = qMin((c * curveTable1[(int)cb]) >> 8, 255);
-			mn = qMin((m * curveTable1[(int)cb]) >> 8, 255);
-			yn = qMin((y * curveTable1[(int)cb]) >> 8, 255);
-			kn = qMin((k * curveTable1[(int)cb]) >> 8, 255);
-			c1n = qMin((c1 * curveTable2[(int)cb]) >> 8, 255);
-			m1n = qMin((m1 * curveTable2[(int)cb]) >> 8, 255);
-			y1n = qMin((y1 * curveTable2[(int)cb]) >> 8, 255);
-			k1n = qMin((k1 * curveTable2[(int)cb]) >> 8, 255);
-			c2n = qMin((c2 * curveTable3[(int)cb]) >> 8, 255);
-			m2n = qMin((m2 * curveTable3[(int)cb]) >> 8, 255);
-			y2n = qMin((y2 * curveTable3[(int)cb]) >> 8, 255);
-			k2n = qMin((k2 * curveTable3[(int)cb]) >> 8, 255);
-			ScColor col = ScColor(qMin(cn+c1n+c2n, 255), qMin(mn+m1n+m2n, 255), qMin(yn+y1n+y2n, 255), qMin(kn+k1n+k2n, 255));
-			if (cmyk)
-				col.getCMYK(&cn, &mn, &yn, &kn);
-			else
-			{
-				col.getRawRGBColor(&cn, &mn, &yn);
-				kn = qAlpha(r);
-			}
-			*s = qRgba(cn, mn, yn, kn);
-			s++;
+			col.getRawRGBColor(&cn, &mn, &yn);
+			kn = 255;
 		}
+		table[i] = qRgba(cn, mn, yn, kn);
 	}
+	applyToneTable(table, cmyk);
 }
 
 void ScImage::quadtone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray curve1, bool lin1, ScColor color2, int shade2, FPointArray curve2, bool lin2, ScColor color3, int shade3, FPointArray curve3, bool lin3, ScColor color4, int shade4, FPointArray curve4, bool lin4, bool cmyk)
 {
-	int h = height();
-	int w = width();
 	int c, c1, c2, c3, m, m1, m2, m3, y, y1, y2, y3, k, k1, k2, k3;
 	int cn, c1n, c2n, c3n, mn, m1n, m2n, m3n, yn, y1n, y2n, y3n, kn, k1n, k2n, k3n;
 	uchar cb;
@@ -1038,103 +1088,86 @@ void ScImage::quadtone(ScribusDoc* doc, ScColor color1, int shade1, FPointArray
 	{
 		curveTable4[x] = qMin(255, qMax(0, qRound(getCurveYValue(curve4, x / 255.0, lin4) * 255)));
 	}
-	for (int yi=0; yi < h; ++yi)
+	// the result only depends on the gray value of a pixel
+	QRgb table[256];
+	for (int i = 0; i < 256; ++i)
 	{
-		QRgb * s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
+		cb = i;
+		cn = qMin((c * curveTable1[(int)cb]) >> 8, 255);
+		mn = qMin((m * curveTable1[(int)cb]) >> 8, 255);
+		yn = qMin((y * curveTable1[(int)cb]) >> 8, 255);
+		kn = qMin((k * curveTable1[(int)cb]) >> 8, 255);
+		c1n = qMin((c1 * curveTable2[(int)cb]) >> 8, 255);
+		m1n = qMin((m1 * curveTable2[(int)cb]) >> 8, 255);
+		y1n = qMin((y1 * curveTable2[(int)cb]) >> 8, 255);
+		k1n = qMin((k1 * curveTable2[(int)cb]) >> 8, 255);
+		c2n = qMin((c2 * curveTable3[(int)cb]) >> 8, 255);
+		m2n = qMin((m2 * curveTable3[(int)cb]) >> 8, 255);
+		y2n = qMin((y2 * curveTable3[(int)cb]) >> 8, 255);
+		k2n = qMin((k2 * curveTable3[(int)cb]) >> 8, 255);
+		c3n = qMin((c3 * curveTable4[(int)cb]) >> 8, 255);
+		m3n = qMin((m3 * curveTable4[(int)cb]) >> 8, 255);
+		y3n = qMin((y3 * curveTable4[(int)cb]) >> 8, 255);
+		k3n = qMin((k3 * curveTable4[(int)cb]) >> 8, 255);
+		ScColor col = ScColor(qMin(cn+c1n+c2n+c3n, 255), qMin(mn+m1n+m2n+m3n, 255), qMin(yn+y1n+y2n+y3n, 255), qMin(kn+k1n+k2n+k3n, 255));
+		if (cmyk)
+			col.getCMYK(&cn, &mn, &yn, &kn);
+		else
 		{
-			QRgb r = *s;
-			if (cmyk)
-				cb = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
-			else
-				cb = 255 - qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-			cn = qMin((c * curveTable1[(int)cb]) >> 8, 255);
-			mn = qMin((m * curveTable1[(int)cb]) >> 8, 255);
-			yn = qMin((y * curveTable1[(int)cb]) >> 8, 255);
-			kn = qMin((k * curveTable1[(int)cb]) >> 8, 255);
-			c1n = qMin((c1 * curveTable2[(int)cb]) >> 8, 255);
-			m1n = qMin((m1 * curveTable2[(int)cb]) >> 8, 255);
-			y1n = qMin((y1 * curveTable2[(int)cb]) >> 8, 255);
-			k1n = qMin((k1 * curveTable2[(int)cb]) >> 8, 255);
-			c2n = qMin((c2 * curveTable3[(int)cb]) >> 8, 255);
-			m2n = qMin((m2 * curveTable3[(int)cb]) >> 8, 255);
-			y2n = qMin((y2 * curveTable3[(int)cb]) >> 8, 255);
-			k2n = qMin((k2 * curveTable3[(int)cb]) >> 8, 255);
-			c3n = qMin((c3 * curveTable4[(int)cb]) >> 8, 255);
-			m3n = qMin((m3 * curveTable4[(int)cb]) >> 8, 255);
-			y3n = qMin((y3 * curveTable4[(int)cb]) >> 8, 255);
-			k3n = qMin((k3 * curveTable4[(int)cb]) >> 8, 255);
-			ScColor col = ScColor(qMin(cn+c1n+c2n+c3n, 255), qMin(mn+m1n+m2n+m3n, 255), qMin(yn+y1n+y2n+y3n, 255), qMin(kn+k1n+k2n+k3n, 255));
-			if (cmyk)
-				col.getCMYK(&cn, &mn, &yn, &kn);
-			else
-			{
-				col.getRawRGBColor(&cn, &mn, &yn);
-				kn = qAlpha(r);
-			}
-			*s = qRgba(cn, mn, yn, kn);
-			s++;
+			col.getRawRGBColor(&cn, &mn, &yn);
+			kn = 255;
 		}
+		table[i] = qRgba(cn, mn, yn, kn);
 	}
+	applyToneTable(table, cmyk);
 }
 
 void ScImage::invert(bool cmyk)
 {
-	int h = height();
-	int w = width();
-	unsigned char *p;
-	QRgb * s;
-	unsigned char c, m, y, k;
-	for (int yi = 0; yi < h; ++yi)
+	uchar* imageBits = bits();
+	const qsizetype bpl = bytesPerLine();
+	const int w = width();
+	parallelFor(height(), effectRowChunk, [&](int first, int last)
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
+		unsigned char c, m, y, k;
+		for (int yi = first; yi < last; ++yi)
 		{
 			if (cmyk)
 			{
-				p = (unsigned char *) s;
-				c = 255 - qMin(255, p[0] + p[3]);
-				m = 255 - qMin(255, p[1] + p[3]);
-				y = 255 - qMin(255, p[2] + p[3]);
-				k = qMin(qMin(c, m), y);
-				p[0] = c - k;
-				p[1] = m - k;
-				p[2] = y - k;
-				p[3] = k;
+				unsigned char *p = imageBits + yi * bpl;
+				for (int xi = 0; xi < w; ++xi, p += 4)
+				{
+					c = 255 - qMin(255, p[0] + p[3]);
+					m = 255 - qMin(255, p[1] + p[3]);
+					y = 255 - qMin(255, p[2] + p[3]);
+					k = qMin(qMin(c, m), y);
+					p[0] = c - k;
+					p[1] = m - k;
+					p[2] = y - k;
+					p[3] = k;
+				}
 			}
 			else
-				*s ^= 0x00ffffff;
-			s++;
+			{
+				QRgb *s = (QRgb*)(imageBits + yi * bpl);
+				for (int xi = 0; xi < w; ++xi, ++s)
+					*s ^= 0x00ffffff;
+			}
 		}
-	}
+	});
 }
 
 void ScImage::toGrayscale(bool cmyk)
 {
-	int h = height();
-	int w = width();
-	int k;
-	QRgb * s;
-	QRgb r;
-	for (int yi = 0; yi < h; ++yi)
+	QRgb table[256];
+	for (int i = 0; i < 256; ++i)
 	{
-		s = (QRgb*)(scanLine( yi ));
-		for (int xi = 0; xi < w; ++xi)
-		{
-			r = *s;
-			if (cmyk)
-			{
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
-				*s = qRgba(0, 0, 0, k);
-			}
-			else
-			{
-				k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
-				*s = qRgba(k, k, k, qAlpha(r));
-			}
-			s++;
-		}
+		if (cmyk)
+			table[i] = qRgba(0, 0, 0, i);
+		else
+			table[i] = qRgb(255 - i, 255 - i, 255 - i);
 	}
+	applyToneTable(table, cmyk);
 }
 
 void ScImage::swapRGBA()
@@ -1163,6 +1196,12 @@ bool ScImage::createLowRes(double scale)
 	int h = qRound(height() / scale);
 	if (w >= width() && h >= height())  // don't do unnecessary scaling
 		return false;
+	if (depth() == 32)
+	{
+		// QImage::scaled() premultiplies by the alpha byte, which holds black in CMYK images
+		scaleImage32bpp(w, h, BoxFilter);
+		return true;
+	}
 	QImage tmp = scaled(w, h, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
 	if (tmp.format() != QImage::Format_ARGB32)
 		tmp = tmp.convertToFormat(QImage::Format_ARGB32);
@@ -1529,258 +1568,27 @@ bool ScImage::writePSImageToFilter(ScStreamFilter* filter, const QByteArray& mas
 	return success;
 }
 
-void ScImage::scaleImage(int nwidth, int nheight)
+void ScImage::scaleImage(int nwidth, int nheight, ScaleFilter filter)
 {
 	int depth = this->depth();
 	if (depth == 32)
 	{
-		scaleImage32bpp(nwidth, nheight);
+		scaleImage32bpp(nwidth, nheight, filter);
 		return;
 	}
-	scaleImageGeneric(nwidth, nheight);
+	scaleImageGeneric(nwidth, nheight, filter);
 }
 
-void ScImage::scaleImage32bpp(int nwidth, int nheight)
+void ScImage::scaleImage32bpp(int nwidth, int nheight, ScaleFilter filter)
 {
+	// bytes are scaled independently, CMYK data is handled like RGBA
 	QImage dst(nwidth, nheight, QImage::Format_ARGB32);
-	QRgb* xelrow = nullptr;
-	QRgb* tempxelrow = nullptr;
-	QRgb* xP = nullptr;
-	QRgb* nxP = nullptr;
-	int rows, cols, rowsread, newrows, newcols;
-	int row, col, needtoreadrow;
-	const uchar maxval = 255;
-	double xscale, yscale;
-	long sxscale, syscale;
-	long fracrowtofill, fracrowleft;
-	long* as = nullptr;
-	long* rs = nullptr;
-	long* gs = nullptr;
-	long* bs = nullptr;
-	int rowswritten = 0;
-
-	int depth = this->depth();
-	if (depth != 32)
-	{
-		QImage::operator=(QImage::scaled(nwidth, nheight, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-		return;
-	}
-
-	cols = width();
-	rows = height();
-	newcols = dst.width();
-	newrows = dst.height();
-	long SCALE;
-	long HALFSCALE;
-	if (cols > 4096)
-	{
-		SCALE = 4096;
-		HALFSCALE = 2048;
-	}
-	else
-	{
-		int fac = 4096;
-		while ((cols * fac) > 4096)
-		{
-			fac /= 2;
-		}
-		SCALE = fac * cols;
-		HALFSCALE = fac * cols / 2;
-	}
-	xscale = (double) newcols / (double) cols;
-	yscale = (double) newrows / (double) rows;
-	sxscale = (long) (xscale * SCALE);
-	syscale = (long) (yscale * SCALE);
-	if ( newrows != rows )	/* shortcut Y scaling if possible */
-		tempxelrow = new QRgb[cols];
-	as = new long[cols];
-	rs = new long[cols];
-	gs = new long[cols];
-	bs = new long[cols];
-	rowsread = 0;
-	fracrowleft = syscale;
-	needtoreadrow = 1;
-	for (col = 0; col < cols; ++col)
-		rs[col] = gs[col] =  as[col] = bs[col] = HALFSCALE;
-	fracrowtofill = SCALE;
-	for (row = 0; row < newrows; ++row)
-	{
-		if ( newrows == rows )
-			tempxelrow = xelrow = (QRgb*) scanLine(rowsread++);
-		else
-		{
-			while ( fracrowleft < fracrowtofill )
-			{
-				if ( needtoreadrow && rowsread < rows )
-					xelrow = (QRgb*) scanLine(rowsread++);
-				for ( col = 0, xP = xelrow; col < cols; ++col, ++xP )
-				{
-					as[col] += fracrowleft * qAlpha( *xP );
-					rs[col] += fracrowleft * qRed( *xP );
-					gs[col] += fracrowleft * qGreen( *xP );
-					bs[col] += fracrowleft * qBlue( *xP );
-				}
-				fracrowtofill -= fracrowleft;
-				fracrowleft = syscale;
-				needtoreadrow = 1;
-			}
-			if (needtoreadrow && rowsread < rows)
-			{
-				xelrow = (QRgb*) scanLine(rowsread++);
-				needtoreadrow = 0;
-			}
-			long a = 0;
-			for (col = 0, xP = xelrow, nxP = tempxelrow; col < cols; ++col, ++xP, ++nxP)
-			{
-				long r, g, b;
-				a = as[col] + fracrowtofill * qAlpha( *xP );
-				r = rs[col] + fracrowtofill * qRed( *xP );
-				g = gs[col] + fracrowtofill * qGreen( *xP );
-				b = bs[col] + fracrowtofill * qBlue( *xP );
-				r /= SCALE;
-				if (r > maxval)
-					r = maxval;
-				g /= SCALE;
-				if (g > maxval)
-					g = maxval;
-				b /= SCALE;
-				if (b > maxval)
-					b = maxval;
-				a /= SCALE;
-				if (a > maxval)
-					a = maxval;
-				*nxP = qRgba((int) r, (int) g, (int) b , (int) a);
-				rs[col] = as[col] = gs[col] = bs[col] = HALFSCALE;
-			}
-			fracrowleft -= fracrowtofill;
-			if (fracrowleft == 0)
-			{
-				fracrowleft = syscale;
-				needtoreadrow = 1;
-			}
-			fracrowtofill = SCALE;
-		}
-		if (newcols == cols)
-			memcpy(dst.scanLine(rowswritten++), tempxelrow, newcols*4);
-		else
-		{
-			long a, r, g, b;
-			long fraccoltofill, fraccolleft = 0;
-			int needcol;
-			nxP = (QRgb*) dst.scanLine(rowswritten++);
-			QRgb *nxPEnd = nxP + newcols;
-			fraccoltofill = SCALE;
-			a = r = g = b = HALFSCALE;
-			needcol = 0;
-			for (col = 0, xP = tempxelrow; col < cols; ++col, ++xP)
-			{
-				fraccolleft = sxscale;
-				while (fraccolleft >= fraccoltofill)
-				{
-					if (needcol)
-					{
-						++nxP;
-						a = r = g = b = HALFSCALE;
-					}
-					a += fraccoltofill * qAlpha(*xP);
-					r += fraccoltofill * qRed(*xP);
-					g += fraccoltofill * qGreen(*xP);
-					b += fraccoltofill * qBlue(*xP);
-					r /= SCALE;
-					if (r > maxval)
-						r = maxval;
-					g /= SCALE;
-					if (g > maxval)
-						g = maxval;
-					b /= SCALE;
-					if (b > maxval)
-						b = maxval;
-					a /= SCALE;
-					if (a > maxval)
-						a = maxval;
-					*nxP = qRgba((int) r, (int) g, (int) b, (int) a);
-					fraccolleft -= fraccoltofill;
-					fraccoltofill = SCALE;
-					needcol = 1;
-				}
-				if (fraccolleft > 0)
-				{
-					if (needcol)
-					{
-						++nxP;
-						a = r = g = b = HALFSCALE;
-						needcol = 0;
-					}
-					a += fraccolleft * qAlpha(*xP);
-					r += fraccolleft * qRed(*xP);
-					g += fraccolleft * qGreen(*xP);
-					b += fraccolleft * qBlue(*xP);
-					fraccoltofill -= fraccolleft;
-				}
-			}
-			if (fraccoltofill > 0)
-			{
-				--xP;
-				a += fraccoltofill * qAlpha(*xP);
-				r += fraccoltofill * qRed(*xP);
-				g += fraccoltofill * qGreen(*xP);
-				b += fraccoltofill * qBlue(*xP);
-			}
-			if (nxP < nxPEnd)
-			{
-				r /= SCALE;
-				if (r > maxval)
-					r = maxval;
-				g /= SCALE;
-				if (g > maxval)
-					g = maxval;
-				b /= SCALE;
-				if (b > maxval)
-					b = maxval;
-				a /= SCALE;
-				if (a > maxval)
-					a = maxval;
-				*nxP = qRgba((int) r, (int) g, (int) b, (int) a);
-				while (++nxP != nxPEnd)
-					nxP[0] = nxP[-1];
-			}
-		}
-	}
-	if (newrows != rows && tempxelrow) // Robust, tempxelrow might be 0 1 day
-		delete [] tempxelrow;
-	delete [] as;
-	delete [] rs;
-	delete [] gs;
-	delete [] bs;
-	QImage::operator=(QImage(nwidth, nheight, QImage::Format_ARGB32));
-	for (int yi = 0; yi < dst.height(); ++yi)
-	{
-		QRgb *s = (QRgb*) dst.scanLine(yi);
-		QRgb *d = (QRgb*) scanLine(yi);
-		for (int xi = 0; xi < dst.width(); ++xi)
-		{
-			(*d) = (*s);
-			s++;
-			d++;
-		}
-	}
+	resampleImage(constBits(), bytesPerLine(), width(), height(), dst.bits(), dst.bytesPerLine(), nwidth, nheight, 4, filter);
+	QImage::operator=(dst);
 }
 
-void ScImage::scaleImageGeneric(int nwidth, int nheight)
+void ScImage::scaleImageGeneric(int nwidth, int nheight, ScaleFilter filter)
 {
-	unsigned char* xelrow = nullptr;
-	unsigned char* tempxelrow = nullptr;
-	unsigned char* xP;
-	unsigned char* nxP;
-	int rows, cols, rowsread, newrows, newcols;
-	int row, col, needtoreadrow;
-	const uchar maxval = 255;
-	double xscale, yscale;
-	long sxscale, syscale;
-	long fracrowtofill, fracrowleft;
-	long* ps;
-	int rowswritten = 0;
-
 	int depth = this->depth();
 	Format imgFormat = this->format();
 	bool execScaled = (depth == 1 || depth == 4 || depth == 16);
@@ -1794,162 +1602,10 @@ void ScImage::scaleImageGeneric(int nwidth, int nheight)
 		return;
 	}
 
-	QImage dst(nwidth, nheight, this->format());
-	int nChannels = this->depth() / 8;
-
-	cols = width();
-	rows = height();
-	newcols = dst.width();
-	newrows = dst.height();
-	long SCALE;
-	long HALFSCALE;
-	if (cols > 4096)
-	{
-		SCALE = 4096;
-		HALFSCALE = 2048;
-	}
-	else
-	{
-		int fac = 4096;
-		while ((cols * fac) > 4096)
-		{
-			fac /= 2;
-		}
-		SCALE = fac * cols;
-		HALFSCALE = fac * cols / 2;
-	}
-	xscale = (double) newcols / (double) cols;
-	yscale = (double) newrows / (double) rows;
-	sxscale = (long)(xscale * SCALE);
-	syscale = (long)(yscale * SCALE);
-	if (newrows != rows)	/* shortcut Y scaling if possible */
-		tempxelrow = new unsigned char[cols * nChannels];
-	ps = new long[cols];
-
-	for (int chIndex = 0; chIndex < nChannels; ++chIndex)
-	{
-		xelrow = nullptr;
-		rowsread = rowswritten = 0;
-		fracrowleft = syscale;
-		needtoreadrow = 1;
-		for (col = 0; col < cols; ++col)
-			ps[col] = HALFSCALE;
-		fracrowtofill = SCALE;
-		for (row = 0; row < newrows; ++row)
-		{
-			if (newrows == rows)
-				tempxelrow = xelrow = scanLine(rowsread++);
-			else
-			{
-				while (fracrowleft < fracrowtofill)
-				{
-					if (needtoreadrow && rowsread < rows)
-						xelrow = scanLine(rowsread++);
-					for (col = 0, xP = xelrow + chIndex; col < cols; ++col, xP += nChannels)
-						ps[col] += fracrowleft * (*xP);
-					fracrowtofill -= fracrowleft;
-					fracrowleft = syscale;
-					needtoreadrow = 1;
-				}
-				if (needtoreadrow && rowsread < rows)
-				{
-					xelrow = scanLine(rowsread++);
-					needtoreadrow = 0;
-				}
-				long p = 0;
-				xP  = xelrow + chIndex;
-				nxP = tempxelrow + chIndex;
-				for (col = 0; col < cols; ++col, xP += nChannels, nxP += nChannels)
-				{
-					p = ps[col] + fracrowtofill * (*xP);
-					p /= SCALE;
-					if (p > maxval)
-						p = maxval;
-					*nxP = (unsigned char) p;
-					ps[col] = HALFSCALE;
-				}
-				fracrowleft -= fracrowtofill;
-				if (fracrowleft == 0)
-				{
-					fracrowleft = syscale;
-					needtoreadrow = 1;
-				}
-				fracrowtofill = SCALE;
-			}
-			if (newcols == cols)
-			{
-				memcpy(dst.scanLine(rowswritten++), tempxelrow, newcols * nChannels);
-			}
-			else
-			{
-				long p;
-				long fraccoltofill, fraccolleft = 0;
-				int needcol;
-				nxP = dst.scanLine(rowswritten++) + chIndex;
-				unsigned char *nxPEnd = nxP + newcols * nChannels;
-				fraccoltofill = SCALE;
-				p = HALFSCALE;
-				needcol = 0;
-				for (col = 0, xP = tempxelrow + chIndex; col < cols; ++col, xP += nChannels)
-				{
-					fraccolleft = sxscale;
-					while (fraccolleft >= fraccoltofill)
-					{
-						if (needcol)
-						{
-							nxP += nChannels;
-							p = HALFSCALE;
-						}
-						p += fraccoltofill * (*xP);
-						p /= SCALE;
-						if (p > maxval)
-							p = maxval;
-						*nxP = (unsigned char) p;
-						fraccolleft -= fraccoltofill;
-						fraccoltofill = SCALE;
-						needcol = 1;
-					}
-					if (fraccolleft > 0)
-					{
-						if (needcol)
-						{
-							nxP += nChannels;
-							p = HALFSCALE;
-							needcol = 0;
-						}
-						p += fraccolleft * (*xP);
-						fraccoltofill -= fraccolleft;
-					}
-				}
-				if (fraccoltofill > 0)
-				{
-					xP -= nChannels;
-					p += fraccoltofill * (*xP);
-				}
-				if (nxP < nxPEnd)
-				{
-					p /= SCALE;
-					if (p > maxval)
-						p = maxval;
-					*nxP = (unsigned char) p;
-					while ((nxP += nChannels) != nxPEnd)
-						nxP[0] = nxP[-nChannels];
-				}
-			}
-		}
-	}
-	if (newrows != rows && tempxelrow)// Robust, tempxelrow might be 0 1 day
-		delete [] tempxelrow;
-	delete [] ps;
-
-	int scanWidth = dst.width() * nChannels;
-	QImage::operator=(QImage(nwidth, nheight, this->format()));
-	for (int yi = 0; yi < dst.height(); ++yi)
-	{
-		uchar *s = dst.scanLine(yi);
-		uchar *d = scanLine(yi);
-		memcpy(d, s, scanWidth);
-	}
+	QImage dst(nwidth, nheight, imgFormat);
+	int nChannels = depth / 8;
+	resampleImage(constBits(), bytesPerLine(), width(), height(), dst.bits(), dst.bytesPerLine(), nwidth, nheight, nChannels, filter);
+	QImage::operator=(dst);
 }
 
 bool ScImage::getAlpha(const QString& fn, int page, QByteArray& alpha, bool PDF, bool pdf14, int gsRes, int scaleXSize, int scaleYSize)
@@ -2536,12 +2192,27 @@ bool ScImage::loadPicture(const QString & fn, int page, const CMSettings& cmSett
 				// JG : this line overwrite image profile info and should not be needed here!!!!
 				// imgInfo = pDataLoader->imageInfoRecord();
 			}
+			// Transforming all pixels at once saves the per call overhead of the CMS, which
+			// dominates for the short rows of thumbnails and previews
+			bool grayInput = (inputProfFormat == Format_GRAY_8);
+			bool wholeImage = false;
+			if (!grayInput && (bytesPerLine() == width() * 4))
+			{
+				int inputBytes = inputCSpace.bytesPerChannel() * inputCSpace.numChannels();
+				int srcBytes = pDataLoader->useRawImage() ? pDataLoader->r_image.channels() : 4;
+				wholeImage = (inputBytes == srcBytes);
+			}
+			if (wholeImage)
+			{
+				uchar* src = pDataLoader->useRawImage() ? pDataLoader->r_image.bits() : bits();
+				inputCSpace.convert(outputCSpace, (eRenderIntent) 0, 0, src, bits(), width() * height(), &xform);
+			}
 			uchar* ptr2 = nullptr;
 			for (int i = 0; i < height(); i++)
 			{
 				uchar* ptr = scanLine(i);
 				ptr2 = pDataLoader->useRawImage() ? pDataLoader->r_image.scanLine(i) : nullptr;
-				if ((inputProfFormat == Format_GRAY_8) && (outputProfColorSpace != ColorSpace_Cmyk))
+				if (grayInput && (outputProfColorSpace != ColorSpace_Cmyk))
 				{
 					unsigned char* ucs = ptr2 ? (ptr2 + 1) : (ptr + 1);
 					unsigned char* uc = new unsigned char[width()];
@@ -2553,7 +2224,7 @@ bool ScImage::loadPicture(const QString & fn, int page, const CMSettings& cmSett
 					xform.apply(uc, ptr, width());
 					delete[] uc;
 				}
-				else if ((inputProfFormat == Format_GRAY_8) && (outputProfColorSpace == ColorSpace_Cmyk))
+				else if (grayInput && (outputProfColorSpace == ColorSpace_Cmyk))
 				{
 					unsigned char  value;
 					unsigned char* ucs = ptr2 ? ptr2 : ptr;
@@ -2566,7 +2237,7 @@ bool ScImage::loadPicture(const QString & fn, int page, const CMSettings& cmSett
 						ucs += 4;
 					}
 				}
-				else
+				else if (!wholeImage)
 				{
 					inputCSpace.convert(outputCSpace, (eRenderIntent) 0, 0, ptr2 ? ptr2 : ptr, ptr, width(), &xform);
 				}
@@ -85,8 +85,15 @@ public:
 	// Generate a low res image for user preview
 	bool createLowRes(double scale);
 
+	enum ScaleFilter
+	{
+		BoxFilter,
+		BilinearFilter,
+		LanczosFilter
+	};
+
 	// Scale this image in-place
-	void scaleImage(int width, int height);
+	void scaleImage(int width, int height, ScaleFilter filter = BoxFilter);
 
 	// Retrieve an embedded ICC profile from the file path `fn', storing it in `profile'.
 	// TODO: Bad API. Should probably be static member returning an ICCProfile (custom class) or something like that.
@@ -103,10 +110,10 @@ public:
 private:
 
 	// Scale image in-place : case of 32bpp image (RGBA, RGB32, CMYK)
-	void scaleImage32bpp(int width, int height);
+	void scaleImage32bpp(int width, int height, ScaleFilter filter);
 
 	// Scale image in-place : generic case
-	void scaleImageGeneric(int width, int height);
+	void scaleImageGeneric(int width, int height, ScaleFilter filter);
 
 	// Image effects
 	void solarize(double factor, bool cmyk);
@@ -122,9 +129,11 @@ private:
 	void toGrayscale(bool cmyk);
 	void doGraduate(FPointArray curve, bool cmyk, bool linear);
 	void swapRGBA();
-	bool convolveImage(QImage *dest, const unsigned int order, const double *kernel);
+	void convolveSeparable(QImage *dest, const QVector<float>& vWeights, const QVector<float>& hWeights, float center) const;
 	int  getOptimalKernelWidth(double radius, double sigma);
 	void applyCurve(const QVector<int>& curveTable, bool cmyk);
+	/// Replaces each pixel by the entry of @a table for its gray value, RGB images keep their alpha
+	void applyToneTable(const QRgb* table, bool cmyk);
 
 	void addProfileToCacheModifiers(ScImageCacheProxy & cache, const QString & prefix, const ScColorProfile & profile) const;
 };
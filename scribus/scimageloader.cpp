@@ -0,0 +1,251 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QMutexLocker>
+
+#include "scimageloader.h"
+#include "cmsettings.h"
+#include "filewatcher.h"
+#include "pageitem.h"
+#include "prefsmanager.h"
+#include "scribuscore.h"
+#include "scribusdoc.h"
+#include "scribusview.h"
+
+ScImageLoader::ScImageLoader(ScribusDoc* doc) :
+	m_doc(doc)
+{
+}
+
+ScImageLoader::~ScImageLoader()
+{
+	cancelAll();
+}
+
+void ScImageLoader::beginDeferring()
+{
+	m_deferring = true;
+}
+
+void ScImageLoader::defer(PageItem* item)
+{
+	// the file loaders load some images twice
+	if (m_deferredItems.value(item) == item)
+		return;
+	m_deferredItems.insert(item, item);
+	m_deferred.append(item);
+}
+
+void ScImageLoader::endDeferring()
+{
+	if (!m_deferring)
+		return;
+	m_deferring = false;
+	const QList<JobPtr> jobs = createJobs();
+	m_deferred.clear();
+	m_deferredItems.clear();
+	{
+		QMutexLocker locker(&m_queueMutex);
+		m_queue.append(jobs);
+	}
+	// each task decodes the job first in the queue at the time it runs
+	for (int i = 0; i < jobs.count(); ++i)
+		m_threadPool.start([this]() { decodeNext(); });
+}
+
+bool ScImageLoader::isPending(const PageItem* item) const
+{
+	return pendingJob(item) || (m_deferredItems.value(item) == item);
+}
+
+void ScImageLoader::prioritize(const PageItem* item)
+{
+	JobPtr job = pendingJob(item);
+	if (!job)
+		return;
+	QMutexLocker locker(&m_queueMutex);
+	int index = m_queue.indexOf(job);
+	if (index > 0)
+		m_queue.move(index, 0);
+}
+
+void ScImageLoader::finish()
+{
+	endDeferring();
+	m_threadPool.waitForDone();
+	// apply the decoded images waiting in the event queue
+	QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+}
+
+void ScImageLoader::cancelAll()
+{
+	m_deferring = false;
+	m_deferred.clear();
+	m_deferredItems.clear();
+	for (const Pending& pending : std::as_const(m_pending))
+		pending.job->cancelled.storeRelaxed(1);
+	m_pending.clear();
+	{
+		QMutexLocker locker(&m_queueMutex);
+		m_queue.clear();
+	}
+	m_threadPool.clear();
+	m_threadPool.waitForDone();
+}
+
+bool ScImageLoader::takeDecodedImage(const PageItem* item, ScImage& image) const
+{
+	if (!m_appliedJob || m_appliedItem != item)
+		return false;
+	// assignment shares the pixel data with the frames using the same file
+	image = m_appliedJob->image;
+	return true;
+}
+
+QList<ScImageLoader::JobPtr> ScImageLoader::createJobs()
+{
+	// frames on the visible part of the document first, then frames on master pages, then by page
+	QRectF visibleRect;
+	if (m_doc->view() != nullptr)
+		visibleRect = m_doc->view()->visibleCanvasRect();
+	QList<PageItem*> items;
+	for (const QPointer<PageItem>& item : std::as_const(m_deferred))
+	{
+		if (!item.isNull() && item->isImageFrame() && !item->Pfile.isEmpty())
+			items.append(item.data());
+	}
+	auto rank = [&visibleRect](const PageItem* item)
+	{
+		if (visibleRect.intersects(item->getVisualBoundingRect()))
+			return 0;
+		return item->OnMasterPage.isEmpty() ? 2 : 1;
+	};
+	std::stable_sort(items.begin(), items.end(), [&rank](const PageItem* item1, const PageItem* item2)
+	{
+		int rank1 = rank(item1);
+		int rank2 = rank(item2);
+		if (rank1 != rank2)
+			return rank1 < rank2;
+		return item1->OwnPage < item2->OwnPage;
+	});
+
+	QList<JobPtr> jobs;
+	QHash<QString, JobPtr> sharedJobs;
+	int gsRes = PrefsManager::instance().gsResolution();
+	for (PageItem* item : std::as_const(items))
+	{
+		// layer requests are specific to their frame
+		QString key;
+		if (!item->pixm.imgInfo.isRequest)
+		{
+			key = QStringList({ QFileInfo(item->Pfile).absoluteFilePath(),
+								QString::number(item->pixm.imgInfo.actualPageNumber),
+								item->ImageProfile,
+								QString::number(static_cast<int>(item->ImageIntent)),
+								QString::number(static_cast<int>(item->UseEmbedded)) }).join(QChar('\n'));
+		}
+		JobPtr job = key.isEmpty() ? JobPtr() : sharedJobs.value(key);
+		if (!job)
+		{
+			job = JobPtr::create();
+			job->filename = item->Pfile;
+			job->image.imgInfo = item->pixm.imgInfo;
+			job->profile = item->ImageProfile;
+			job->intent = item->ImageIntent;
+			job->useEmbedded = item->UseEmbedded;
+			job->gsRes = gsRes;
+			jobs.append(job);
+			if (!key.isEmpty())
+				sharedJobs.insert(key, job);
+		}
+		job->items.append(item);
+		job->imageProfiles.append(item->ImageProfile);
+		job->embeddedProfiles.append(item->EmbeddedProfile);
+		job->useEmbeddedProfiles.append(item->UseEmbedded);
+		m_pending.insert(item, { item, job });
+	}
+	return jobs;
+}
+
+ScImageLoader::JobPtr ScImageLoader::pendingJob(const PageItem* item) const
+{
+	auto it = m_pending.constFind(item);
+	if (it == m_pending.constEnd() || it->item != item)
+		return JobPtr();
+	return it->job;
+}
+
+void ScImageLoader::decodeNext()
+{
+	JobPtr job;
+	{
+		QMutexLocker locker(&m_queueMutex);
+		if (m_queue.isEmpty())
+			return;
+		job = m_queue.takeFirst();
+	}
+	decode(job);
+}
+
+void ScImageLoader::decode(const JobPtr& job)
+{
+	if (job->cancelled.loadRelaxed())
+		return;
+	// runs on a worker thread, the document is only read
+	CMSettings cms(m_doc, job->profile, job->intent);
+	cms.setUseEmbeddedProfile(job->useEmbedded);
+	cms.allowSoftProofing(true);
+	bool dummy;
+	job->loaded = job->image.loadPicture(job->filename, job->image.imgInfo.actualPageNumber, cms, ScImage::RGBData, job->gsRes, &dummy, false);
+	QMetaObject::invokeMethod(this, [this, job]() { apply(job); }, Qt::QueuedConnection);
+}
+
+void ScImageLoader::apply(const JobPtr& job)
+{
+	m_appliedJob = job;
+	for (int i = 0; i < job->items.count(); ++i)
+	{
+		PageItem* item = job->items.at(i).data();
+		if (item == nullptr || pendingJob(item) != job)
+			continue;
+		m_pending.remove(item);
+		if (job->loaded)
+		{
+			m_appliedItem = item;
+			item->loadImage(item->Pfile, true);
+			m_appliedItem = nullptr;
+			// as the file loaders do after ScribusDoc::loadPict()
+			item->ImageProfile = job->imageProfiles.at(i);
+			item->EmbeddedProfile = job->embeddedProfiles.at(i);
+			item->UseEmbedded = job->useEmbeddedProfiles.at(i);
+			// as ScribusDoc::RecalcPictures() does for documents with color management
+			if (m_doc->HasCMS && item->imageIsAvailable)
+			{
+				bool isCMYK = (item->pixm.imgInfo.colorspace == ColorSpaceCMYK);
+				const ProfilesL& profiles = isCMYK ? ScCore->InputProfilesCMYK : ScCore->InputProfiles;
+				if (!profiles.contains(item->ImageProfile))
+				{
+					item->ImageProfile = isCMYK ? m_doc->cmsSettings().DefaultImageCMYKProfile : m_doc->cmsSettings().DefaultImageRGBProfile;
+					item->loadImage(item->Pfile, true);
+				}
+			}
+		}
+		if (m_doc->hasGUI())
+		{
+			if (item->imageIsAvailable)
+				ScCore->fileWatcher->addFile(item->Pfile);
+			else
+				ScCore->fileWatcher->addDir(QFileInfo(item->Pfile).absolutePath());
+		}
+		item->update();
+	}
+	m_appliedJob.reset();
+}
@@ -0,0 +1,111 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCIMAGELOADER_H
+#define SCIMAGELOADER_H
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+
+#include "scribusapi.h"
+#include "scimage.h"
+#include "colormgmt/sccolormgmtstructs.h"
+
+class PageItem;
+class ScribusDoc;
+
+/**
+ * The ScImageLoader class decodes the images of a document being opened on a thread pool.
+ *
+ * While deferring, ScribusDoc::loadPict() only registers image frames here, they are drawn
+ * as placeholders. endDeferring() decodes their files in the background, frames on the
+ * visible part of the document first, with ScImage::loadPicture() and therefore the usual
+ * image data loaders. Each decoded image is handed to PageItem::loadImage() on the GUI
+ * thread, which does the frame specific work as for a synchronously loaded image, and
+ * only the frame is redrawn. Frames sharing a file and its settings share one decoding.
+ * Drawing the placeholder of a frame moves its image ahead of the ones not started yet.
+ */
+class SCRIBUS_API ScImageLoader : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit ScImageLoader(ScribusDoc* doc);
+	~ScImageLoader() override;
+
+	/// Starts registering image frames instead of loading their images.
+	void beginDeferring();
+	bool isDeferring() const { return m_deferring; }
+	/// Registers @a item, its image is decoded after endDeferring().
+	void defer(PageItem* item);
+	/// Stops deferring and starts decoding the images of the registered frames.
+	void endDeferring();
+
+	/// Returns true if the image of @a item is registered or being decoded.
+	bool isPending(const PageItem* item) const;
+	/// Decodes the image of @a item next, unless its decoding started already.
+	void prioritize(const PageItem* item);
+	/// Waits for all images and applies them, used before the document is saved or output.
+	void finish();
+	/// Drops all pending images and waits for the running decodings.
+	void cancelAll();
+
+	/// Used by PageItem::loadImage() to take over the image decoded for @a item.
+	bool takeDecodedImage(const PageItem* item, ScImage& image) const;
+
+private:
+	struct Job
+	{
+		QString filename;
+		ScImage image;
+		QString profile;
+		eRenderIntent intent { Intent_Perceptual };
+		bool useEmbedded { false };
+		int gsRes { 72 };
+		bool loaded { false };
+		QAtomicInt cancelled;
+		QList<QPointer<PageItem> > items;
+		/// item properties which loadImage() would overwrite
+		QList<QString> imageProfiles;
+		QList<QString> embeddedProfiles;
+		QList<bool> useEmbeddedProfiles;
+	};
+	typedef QSharedPointer<Job> JobPtr;
+
+	/// the guard tells a frame from a later one created at the address of a deleted frame
+	struct Pending
+	{
+		QPointer<PageItem> item;
+		JobPtr job;
+	};
+
+	ScribusDoc* m_doc { nullptr };
+	bool m_deferring { false };
+	QList<QPointer<PageItem> > m_deferred;
+	QHash<const PageItem*, QPointer<PageItem> > m_deferredItems;
+	QHash<const PageItem*, Pending> m_pending;
+	JobPtr m_appliedJob;
+	const PageItem* m_appliedItem { nullptr };
+	QThreadPool m_threadPool;
+	/// jobs not started yet, the next one first
+	QList<JobPtr> m_queue;
+	QMutex m_queueMutex;
+
+	QList<JobPtr> createJobs();
+	JobPtr pendingJob(const PageItem* item) const;
+	void decodeNext();
+	void decode(const JobPtr& job);
+	void apply(const JobPtr& job);
+};
+
+#endif
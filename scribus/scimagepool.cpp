@@ -0,0 +1,80 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include "scimagepool.h"
+
+ScImagePool::ScImagePool(int maxSizeMiB) :
+	m_images(qMax(1, maxSizeMiB) * 1024)
+{
+}
+
+void ScImagePool::setMaxSizeMiB(int maxSizeMiB)
+{
+	m_images.setMaxCost(qMax(1, maxSizeMiB) * 1024);
+}
+
+bool ScImagePool::find(const QString& key, ScImage& image, int& origWidth, int& origHeight, UserToken& user)
+{
+	Entry* entry = m_images.object(key);
+	if (entry == nullptr)
+	{
+		++m_misses;
+		return false;
+	}
+	// assignment shares the pixel data, the copy constructor would copy it
+	image = entry->image;
+	origWidth = entry->origWidth;
+	origHeight = entry->origHeight;
+	user = entry->users;
+	++m_hits;
+	return true;
+}
+
+void ScImagePool::insert(const QString& key, const ScImage& image, int origWidth, int origHeight, UserToken& user)
+{
+	auto* entry = new Entry;
+	entry->image = image;
+	// the embedded clipping path in use belongs to the frame
+	entry->image.imgInfo.usedPath.clear();
+	entry->origWidth = origWidth;
+	entry->origHeight = origHeight;
+	user = entry->users;
+	// the cost is the size of the pixel data in KB
+	int cost = static_cast<int>(qMax<qint64>(1, imageBytes(image) / 1024));
+	m_images.insert(key, entry, cost);
+}
+
+void ScImagePool::clear()
+{
+	m_images.clear();
+}
+
+ScImagePool::Statistics ScImagePool::statistics() const
+{
+	Statistics stats;
+	stats.hits = m_hits;
+	stats.misses = m_misses;
+	const QList<QString> keys = m_images.keys();
+	for (const QString& key : keys)
+	{
+		const Entry* entry = m_images.object(key);
+		qint64 bytes = imageBytes(entry->image);
+		++stats.images;
+		stats.bytes += bytes;
+		// one reference is the entry's own
+		long users = entry->users.use_count() - 1;
+		if (users > 1)
+			stats.savedBytes += (users - 1) * bytes;
+	}
+	return stats;
+}
+
+qint64 ScImagePool::imageBytes(const ScImage& image)
+{
+	// ScImage stores 32 bit pixels
+	return static_cast<qint64>(image.width()) * image.height() * 4;
+}
@@ -0,0 +1,80 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCIMAGEPOOL_H
+#define SCIMAGEPOOL_H
+
+#include <QCache>
+#include <QString>
+#include <memory>
+
+#include "scribusapi.h"
+#include "scimage.h"
+
+/**
+ * The ScImagePool class keeps the decoded images of a document, so that frames showing
+ * the same image with the same settings load it once and share its pixel data.
+ *
+ * The key describes everything the decoded image depends on: the file and its modification
+ * time, the page, the preview resolution, the image effects and the color management
+ * settings. Images are shared through the implicit sharing of QImage, a frame modifying
+ * its image gets its own copy. The least recently used images are dropped from the pool
+ * when it grows beyond its size, frames still showing them keep their copy.
+ *
+ * Each frame showing a pooled image holds a UserToken of it and drops the token when it
+ * loads another image or goes away, the pool counts the users by their tokens.
+ */
+class SCRIBUS_API ScImagePool
+{
+public:
+	struct Statistics
+	{
+		int images { 0 };       ///< number of images in the pool
+		qint64 bytes { 0 };     ///< pixel data held by the pool
+		int hits { 0 };         ///< loads answered from the pool
+		int misses { 0 };       ///< loads which decoded the image file
+		qint64 savedBytes { 0 }; ///< pixel data the frames would hold without the pool
+	};
+
+	using UserToken = std::shared_ptr<const int>;
+
+	/// Constructs an empty pool holding at most @a maxSizeMiB of pixel data.
+	explicit ScImagePool(int maxSizeMiB = 256);
+
+	void setMaxSizeMiB(int maxSizeMiB);
+	int maxSizeMiB() const { return m_images.maxCost() / 1024; }
+
+	/**
+	 * Looks up the image for @a key.
+	 * @return true if found, @a image then shares the pooled image data and
+	 * @a origWidth and @a origHeight are the size of the image in the file and
+	 * @a user counts the caller as a user of the image
+	 */
+	bool find(const QString& key, ScImage& image, int& origWidth, int& origHeight, UserToken& user);
+	/// Adds @a image for @a key, @a user counts the caller as its first user.
+	void insert(const QString& key, const ScImage& image, int origWidth, int origHeight, UserToken& user);
+	void clear();
+
+	Statistics statistics() const;
+
+private:
+	struct Entry
+	{
+		ScImage image;
+		int origWidth { 0 };
+		int origHeight { 0 };
+		/// shared with the tokens of the users
+		UserToken users { std::make_shared<const int>(0) };
+	};
+
+	QCache<QString, Entry> m_images;
+	int m_hits { 0 };
+	int m_misses { 0 };
+
+	static qint64 imageBytes(const ScImage& image);
+};
+
+#endif
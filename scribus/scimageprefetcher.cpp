@@ -0,0 +1,149 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QMutexLocker>
+
+#include "scimageprefetcher.h"
+
+ScImagePrefetcher::ScImagePrefetcher(int maxSizeMiB) :
+	m_maxBytes(static_cast<qint64>(qMax(1, maxSizeMiB)) * 1024 * 1024)
+{
+}
+
+ScImagePrefetcher::~ScImagePrefetcher()
+{
+	{
+		QMutexLocker locker(&m_mutex);
+		m_cancelled = true;
+		m_changed.wakeAll();
+	}
+	m_threadPool.waitForDone();
+}
+
+void ScImagePrefetcher::add(const QString& key, const void* user, const Decoder& decoder)
+{
+	if (addUser(key, user))
+		return;
+	QMutexLocker locker(&m_mutex);
+	JobPtr job = std::make_shared<Job>();
+	job->key = key;
+	job->decoder = decoder;
+	job->users = 1;
+	m_jobs.append(job);
+	m_jobsByKey.insert(key, job);
+	m_jobsByUser.insert(user, job);
+}
+
+bool ScImagePrefetcher::addUser(const QString& key, const void* user)
+{
+	QMutexLocker locker(&m_mutex);
+	JobPtr job = m_jobsByKey.value(key);
+	if (!job)
+		return false;
+	// master page items are added once for each page showing them
+	if (m_jobsByUser.value(user) != job)
+	{
+		m_jobsByUser.insert(user, job);
+		++job->users;
+	}
+	return true;
+}
+
+void ScImagePrefetcher::start()
+{
+	QMutexLocker locker(&m_mutex);
+	int workers = qMin(m_threadPool.maxThreadCount(), m_jobs.count() - m_nextJob);
+	for (int i = 0; i < workers; ++i)
+		m_threadPool.start([this]() { work(); });
+}
+
+bool ScImagePrefetcher::take(const QString& key, const void* user, DecodedImage& result)
+{
+	QMutexLocker locker(&m_mutex);
+	JobPtr userJob = m_jobsByUser.take(user);
+	if (userJob && (--userJob->users == 0) && (userJob->key != key))
+		drop(userJob);
+
+	JobPtr job = m_jobsByKey.value(key);
+	if (!job || (job->state == Job::Taken))
+		return false;
+	if (job->state == Job::Queued)
+	{
+		job->state = Job::Running;
+		locker.unlock();
+		job->decoder(job->decoded);
+		locker.relock();
+		job->state = Job::Done;
+	}
+	while (job->state == Job::Running)
+		m_changed.wait(&m_mutex);
+
+	result = job->decoded;
+	job->decoded = DecodedImage();
+	job->decoder = nullptr;
+	job->state = Job::Taken;
+	m_bytesInUse -= job->bytes;
+	m_changed.wakeAll();
+	return true;
+}
+
+void ScImagePrefetcher::work()
+{
+	QMutexLocker locker(&m_mutex);
+	while (!m_cancelled)
+	{
+		while ((m_nextJob < m_jobs.count()) && (m_jobs.at(m_nextJob)->state != Job::Queued))
+			++m_nextJob;
+		if (m_nextJob >= m_jobs.count())
+			return;
+		// a single image larger than the budget is still decoded ahead
+		if ((m_bytesInUse > 0) && (m_bytesInUse >= m_maxBytes))
+		{
+			m_changed.wait(&m_mutex);
+			continue;
+		}
+		JobPtr job = m_jobs.at(m_nextJob++);
+		job->state = Job::Running;
+		locker.unlock();
+		job->decoder(job->decoded);
+		qint64 bytes = imageBytes(job->decoded);
+		locker.relock();
+		if (job->state == Job::Taken)
+		{
+			// dropped while decoding
+			job->decoded = DecodedImage();
+			job->decoder = nullptr;
+			continue;
+		}
+		job->bytes = bytes;
+		job->state = Job::Done;
+		m_bytesInUse += bytes;
+		m_changed.wakeAll();
+	}
+}
+
+void ScImagePrefetcher::drop(const JobPtr& job)
+{
+	m_jobsByKey.remove(job->key);
+	if (job->state == Job::Taken)
+		return;
+	// a running decoder still uses both, the worker drops them when done
+	if (job->state != Job::Running)
+	{
+		job->decoded = DecodedImage();
+		job->decoder = nullptr;
+	}
+	if (job->state == Job::Done)
+		m_bytesInUse -= job->bytes;
+	job->state = Job::Taken;
+	m_changed.wakeAll();
+}
+
+qint64 ScImagePrefetcher::imageBytes(const DecodedImage& decoded)
+{
+	return static_cast<qint64>(decoded.image.width()) * decoded.image.height() * 4 + decoded.mask.size();
+}
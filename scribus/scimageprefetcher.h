@@ -0,0 +1,101 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef SCIMAGEPREFETCHER_H
+#define SCIMAGEPREFETCHER_H
+
+#include <functional>
+#include <memory>
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+#include "scribusapi.h"
+#include "scimage.h"
+
+/**
+ * The ScImagePrefetcher class decodes the images of an export on a thread pool ahead of the exporter.
+ *
+ * The exporter adds a decoder for each distinct image in the order it will need them, the key
+ * describes everything the decoded image depends on. Workers run the decoders in that order,
+ * as long as the decoded images not yet taken stay within the memory budget. take() hands
+ * an image to the exporter, waiting for its worker if needed. An image no worker took up yet
+ * is decoded by the calling thread, so the exporter never waits for the budget.
+ *
+ * Each image is added for its users, usually the frames showing it. When a user asks for
+ * another key than it was added with, e.g. because the export scales it differently, its
+ * image is dropped at once if no other user is left waiting for it.
+ */
+class SCRIBUS_API ScImagePrefetcher
+{
+public:
+	struct DecodedImage
+	{
+		bool loaded { false };
+		bool maskLoaded { true };
+		bool realCMYK { false };
+		ScImage image;
+		QByteArray mask;
+	};
+	/// Decodes an image, called on a worker thread, so it must only use data it owns.
+	using Decoder = std::function<void(DecodedImage&)>;
+
+	/// Constructs a prefetcher holding at most @a maxSizeMiB of decoded images not yet taken.
+	explicit ScImagePrefetcher(int maxSizeMiB = 256);
+	/// Cancels the images not yet decoded and waits for the running decoders.
+	~ScImagePrefetcher();
+
+	/// Adds the image decoded by @a decoder under @a key for @a user.
+	void add(const QString& key, const void* user, const Decoder& decoder);
+	/**
+	 * Adds @a user to the image added under @a key already.
+	 * @return false if the key is not known yet
+	 */
+	bool addUser(const QString& key, const void* user);
+	/// Starts decoding the added images.
+	void start();
+	/**
+	 * Hands the image decoded for @a key over to @a result.
+	 * @return false for unknown keys and images taken or dropped already
+	 */
+	bool take(const QString& key, const void* user, DecodedImage& result);
+
+private:
+	struct Job
+	{
+		enum State { Queued, Running, Done, Taken };
+		QString key;
+		Decoder decoder;
+		DecodedImage decoded;
+		State state { Queued };
+		qint64 bytes { 0 };
+		int users { 0 };
+	};
+	using JobPtr = std::shared_ptr<Job>;
+
+	mutable QMutex m_mutex;
+	QWaitCondition m_changed;
+	QList<JobPtr> m_jobs;
+	QHash<QString, JobPtr> m_jobsByKey;
+	QHash<const void*, JobPtr> m_jobsByUser;
+	int m_nextJob { 0 };
+	qint64 m_bytesInUse { 0 };
+	qint64 m_maxBytes { 0 };
+	bool m_cancelled { false };
+	QThreadPool m_threadPool;
+
+	void work();
+	/// drops the image of a job nobody will take any longer, called with the mutex locked
+	void drop(const JobPtr& job);
+	static qint64 imageBytes(const DecodedImage& decoded);
+};
+
+#endif
@@ -561,6 +561,11 @@ QString ScPaths::imageCacheDir()
 	return applicationDataDir() + "cache/img/";
 }
 
+QString ScPaths::fontSubsetCacheDir()
+{
+	return applicationDataDir() + "cache/fontsubsets/";
+}
+
 QString ScPaths::pluginDataDir(bool createIfNotExists)
 {
 	QDir useFilesDirectory(applicationDataDir() + "plugins/");
@@ -87,6 +87,8 @@ public:
 	static QString userTemplateDir(bool createIfNotExists);
 	/** @brief Return path to image cache dir*/
 	static QString imageCacheDir();
+	/** @brief Return path to the cache of font subsets embedded in PDF files*/
+	static QString fontSubsetCacheDir();
 	/** @brief Return path to plugin data dir*/
 	static QString pluginDataDir(bool createIfNotExists);
 	/** @brief Return path to user documents*/
@@ -101,6 +101,7 @@ for which a new license (GPL+exception) is in place.
 #include "documentchecker.h"
 #include "fileloader.h"
 #include "filewatcher.h"
+#include "fonts/scfontsubsetcache.h"
 #include "fpoint.h"
 #include "fpointarray.h"
 #include "gtgettext.h"
@@ -3416,6 +3417,9 @@ bool ScribusMainWindow::loadDoc(const QString& fileName)
 		doc->SoftProofing = false;
 		doc->Gamut = false;
 		setScriptRunning(true);
+		// images of native documents are decoded in the background once the document is shown
+		if (ScCore->usingGUI() && (testResult == FORMATID_SLA150IMPORT))
+			doc->imageLoader().beginDeferring();
 		bool loadSuccess = fileLoader->loadFile(doc);
 		//Do the font replacement check from here, when we have a GUI. TODO do this also somehow without the GUI
 		//This also gives the user the opportunity to cancel the load when finding there's a replacement required.
@@ -3698,6 +3702,7 @@ bool ScribusMainWindow::loadDoc(const QString& fileName)
 		scrActions["viewToggleCMS"]->setChecked(doc->HasCMS);
 		view->zoom();
 		view->GotoPage(0);
+		doc->imageLoader().endDeferring();
 		connect(mdiArea, SIGNAL(subWindowActivated(QMdiSubWindow*)), this, SLOT(newActWin(QMdiSubWindow*)));
 		connect(ScCore->fileWatcher, SIGNAL(fileChanged(QString)), doc, SLOT(updatePict(QString)));
 		connect(ScCore->fileWatcher, SIGNAL(fileDeleted(QString)), doc, SLOT(removePict(QString)));
@@ -4125,6 +4130,7 @@ bool ScribusMainWindow::slotFileSaveAs()
 
 bool ScribusMainWindow::DoFileSave(const QString& fileName, QString* savedFileName)
 {
+	doc->imageLoader().finish();
 	ScCore->fileWatcher->forceScan();
 	ScCore->fileWatcher->stop();
 	doc->reorganiseFonts();
@@ -4249,6 +4255,7 @@ bool ScribusMainWindow::DoFileClose()
 
 void ScribusMainWindow::slotFilePrint()
 {
+	doc->imageLoader().finish();
 	if (doc->checkerProfiles()[doc->curCheckProfile()].autoCheck)
 	{
 		if (scanDocument())
@@ -6581,6 +6588,13 @@ void ScribusMainWindow::slotPrefsOrg()
 	icm.setMaxCacheSizeMiB(newPrefs.imageCachePrefs.maxCacheSizeMiB);
 	icm.setMaxCacheEntries(newPrefs.imageCachePrefs.maxCacheEntries);
 	icm.setCompressionLevel(newPrefs.imageCachePrefs.compressionLevel);
+	ScFontSubsetCache::instance().setMaxCacheSizeMiB(newPrefs.imageCachePrefs.fontSubsetCacheSizeMiB);
+	for (QMdiSubWindow* window : mdiArea->subWindowList())
+	{
+		ScribusWin* scw = dynamic_cast<ScribusWin *>(window->widget());
+		if (scw)
+			scw->doc()->imagePool().setMaxSizeMiB(newPrefs.imageCachePrefs.memoryPoolSizeMiB);
+	}
 
 	m_prefsManager.savePrefs();
 	m_mainWindowStatusLabel->setText( tr("Ready"));
@@ -6689,6 +6703,7 @@ int ScribusMainWindow::ShowSubs()
 
 void ScribusMainWindow::printPreview()
 {
+	doc->imageLoader().finish();
 	const CheckerPrefs& checkerProfile = doc->checkerProfiles()[doc->curCheckProfile()];
 	if (checkerProfile.autoCheck)
 	{
@@ -7038,6 +7053,7 @@ void ScribusMainWindow::reallySaveAsEps()
 bool ScribusMainWindow::getPDFDriver(const QString &filename, const std::vector<int> & pageNumbers,
 									 const QMap<int, QImage>& thumbs, QString& error, bool* cancelled)
 {
+	doc->imageLoader().finish();
 	ScCore->fileWatcher->forceScan();
 	ScCore->fileWatcher->stop();
 	PDFlib pdflib(*doc);
@@ -7052,6 +7068,7 @@ bool ScribusMainWindow::getPDFDriver(const QString &filename, const std::vector<
 
 void ScribusMainWindow::SaveAsPDF()
 {
+	doc->imageLoader().finish();
 	if (doc->checkerProfiles()[doc->curCheckProfile()].autoCheck)
 	{
 		if (scanDocument())
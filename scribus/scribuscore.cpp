@@ -31,6 +31,7 @@ for which a new license (GPL+exception) is in place.
 #include <QScreen>
 
 #include "colormgmt/sccolormgmtenginefactory.h"
+#include "fonts/scfontsubsetcache.h"
 #include "commonstrings.h"
 #include "filewatcher.h"
 #include "iconmanager.h"
@@ -228,6 +229,7 @@ int ScribusCore::initScribusCore(bool showSplash, bool showFontInfo, bool showPr
 	icm.setMaxCacheEntries(m_prefsManager.appPrefs.imageCachePrefs.maxCacheEntries);
 	icm.setCompressionLevel(m_prefsManager.appPrefs.imageCachePrefs.compressionLevel);
 	icm.initialize();
+	ScFontSubsetCache::instance().setMaxCacheSizeMiB(m_prefsManager.appPrefs.imageCachePrefs.fontSubsetCacheSizeMiB);
 	return 0;
 }
 
@@ -154,6 +154,11 @@ public:
 	{
 		QRectF pagebox(pg->xOffset(), pg->yOffset(), pg->width(), pg->height());
 		doc->invalidateRegion(pagebox);
+		if (doc->inBatch())
+		{
+			m_docChangeNeeded = true;
+			return;
+		}
 		doc->regionsChanged()->update(pagebox);
 		if (m_updateEnabled <= 0)
 		{
@@ -166,6 +171,13 @@ public:
 	void changed(PageItem* it, bool doLayout) override
 	{
 		it->invalidateLayout();
+		doc->itemBoundsChanged(it);
+		// layout and regions are updated once at the end of the batch
+		if (doc->inBatch())
+		{
+			m_docChangeNeeded = true;
+			return;
+		}
 		if (doLayout)
 			it->layout();
 		double x, y, w, h;
@@ -290,6 +302,7 @@ void ScribusDoc::init()
 
 	PrefsManager& prefsManager = PrefsManager::instance();
 	m_docPrefsData.colorPrefs.DCMSset = prefsManager.appPrefs.colorPrefs.DCMSset;
+	m_imagePool.setMaxSizeMiB(prefsManager.appPrefs.imageCachePrefs.memoryPoolSizeMiB);
 
 	Print_Options.firstUse = true;
 	PrinterUtil::getDefaultPrintOptions(Print_Options, m_docPrefsData.docSetupPrefs.bleeds);
@@ -466,6 +479,11 @@ void ScribusDoc::init()
 ScribusDoc::~ScribusDoc()
 {
 	m_guardedObject.nullify();
+	// the image loader threads read the document
+	m_imageLoader.cancelAll();
+	// undo is disabled application wide during a batch
+	if (m_batchLevel > 0)
+		m_undoManager->setUndoEnabled(true);
 	CloseCMSProfiles();
 	ScCore->fileWatcher->stop();
 	ScCore->fileWatcher->removeFile(m_documentFileName);
@@ -818,6 +836,7 @@ void ScribusDoc::SetDefaultCMSParams()
 	stdLabToScreenTrans   = ScCore->defaultLabToScreenTrans;
 	stdProofLab           = ScCore->defaultLabToRGBTrans;
 	stdProofLabGC         = ScCore->defaultLabToRGBTrans;
+	m_displayColorCache.clear();
 }
 
 bool ScribusDoc::OpenCMSProfiles(ProfilesL InPo, ProfilesL InPoCMYK, ProfilesL  /*MoPo*/, ProfilesL PrPo)
@@ -930,6 +949,7 @@ bool ScribusDoc::OpenCMSProfiles(ProfilesL InPo, ProfilesL InPoCMYK, ProfilesL
 	stdLabToRGBTrans  = colorEngine.createTransform(ScCore->defaultLabProfile, Format_Lab_Dbl, DocInputRGBProf, Format_RGB_16, Intent_Absolute_Colorimetric, dcmsFlags);
 	stdLabToCMYKTrans = colorEngine.createTransform(ScCore->defaultLabProfile, Format_Lab_Dbl, DocInputCMYKProf, Format_CMYK_16, Intent_Absolute_Colorimetric, dcmsFlags);
 	stdLabToScreenTrans = colorEngine.createTransform(ScCore->defaultLabProfile, Format_Lab_Dbl, DocDisplayProf, Format_RGB_16, Intent_Absolute_Colorimetric, dcmsFlags);
+	m_displayColorCache.clear();
 
 	bool success = (stdTransRGBMon   && stdTransCMYKMon   && stdProofImg    && stdProofImgCMYK &&
 					stdTransImg      && stdTransRGB       && stdTransCMYK   && stdProof        &&
@@ -2862,6 +2882,8 @@ bool ScribusDoc::deleteLayer(int layerID, bool deleteItems)
 
 	//Now delete the layer
 	Layers.removeLayerByID(layerID);
+	m_docItemsVisualIndexes.remove(layerID);
+	m_masterItemsVisualIndexes.remove(layerID);
 
 	if (activeTransaction)
 	{
@@ -4928,6 +4950,8 @@ void ScribusDoc::recalculateColorItem(PageItem *item)
 
 void ScribusDoc::recalculateColors()
 {
+	m_displayColorCache.clear();
+
 	// #12658, #13889 : disable undo temporarily, there is nothing to cancel here
 	m_undoManager->setUndoEnabled(false);
 
@@ -5296,7 +5320,10 @@ int ScribusDoc::itemAdd(const PageItem::ItemType itemType, const PageItem::ItemF
 		newItem->OwnPage = -1;
 	}
 	
+	bool nameIndexed = itemNameIndexRelease();
 	Items->append(newItem);
+	if (nameIndexed)
+		itemNameIndexAdd(newItem, Items->count() - 1);
 
 	if (UndoManager::undoEnabled())
 	{
@@ -5613,6 +5640,89 @@ PageItem* ScribusDoc::getItemFromName(const QString& name) const
 	return nullptr;
 }
 
+PageItem* ScribusDoc::itemByName(const QString& name, bool lastMatch) const
+{
+	if (!itemNameIndexValid())
+		rebuildItemNameIndex();
+	auto it = m_itemNameIndex.names.constFind(name);
+	if (it == m_itemNameIndex.names.constEnd())
+		return nullptr;
+	// renamed items are appended to the entries of their new name, which are therefore not sorted
+	const ItemNameIndex::Entry* found = nullptr;
+	for (const ItemNameIndex::Entry& entry : it.value())
+	{
+		if (!found || (lastMatch ? entry.position > found->position : entry.position < found->position))
+			found = &entry;
+	}
+	return found ? found->item : nullptr;
+}
+
+void ScribusDoc::itemNameChanged(PageItem* item, const QString& oldName)
+{
+	if (!itemNameIndexValid())
+		return;
+	ItemNameIndex& index = m_itemNameIndex;
+	auto it = index.names.find(oldName);
+	if (it == index.names.end())
+		return;
+	QList<ItemNameIndex::Entry>& entries = it.value();
+	for (int i = 0; i < entries.count(); ++i)
+	{
+		if (entries.at(i).item != item)
+			continue;
+		ItemNameIndex::Entry entry = entries.takeAt(i);
+		if (entries.isEmpty())
+			index.names.erase(it);
+		index.names[item->itemName()].append(entry);
+		return;
+	}
+}
+
+bool ScribusDoc::itemNameIndexValid() const
+{
+	// the item lists are edited directly in many places, any such edit detaches the list from the
+	// copy kept by the index, even if it leaves the number of items unchanged
+	const ItemNameIndex& index = m_itemNameIndex;
+	if ((index.items != Items) || (index.itemsData.count() != Items->count()))
+		return false;
+	return Items->isEmpty() || (index.itemsData.constData() == Items->constData());
+}
+
+void ScribusDoc::rebuildItemNameIndex() const
+{
+	ItemNameIndex& index = m_itemNameIndex;
+	index.items = Items;
+	index.itemsData = *Items;
+	index.names.clear();
+	index.names.reserve(Items->count());
+	index.groups.clear();
+	for (int i = 0; i < Items->count(); ++i)
+	{
+		PageItem* item = Items->at(i);
+		index.names[item->itemName()].append({ item, i });
+		if (item->isGroup())
+			index.groups.append(item);
+	}
+}
+
+bool ScribusDoc::itemNameIndexRelease()
+{
+	// lets the index stop sharing the list, so that adding an item does not copy the whole list
+	bool valid = itemNameIndexValid();
+	m_itemNameIndex.itemsData = QList<PageItem*>();
+	return valid;
+}
+
+void ScribusDoc::itemNameIndexAdd(PageItem* item, int position)
+{
+	// only for an index that was valid before itemNameIndexRelease() and the item was added
+	ItemNameIndex& index = m_itemNameIndex;
+	index.itemsData = *Items;
+	index.names[item->itemName()].append({ item, position });
+	if (item->isGroup())
+		index.groups.append(item);
+}
+
 void ScribusDoc::rebuildItemLists()
 {
 	// #5826 Rebuild items list in case layer order as been changed
@@ -5655,6 +5765,12 @@ void ScribusDoc::setUsesAutomaticTextFrames(bool atf)
 
 bool ScribusDoc::loadPict(const QString& fn, PageItem *pageItem, bool reload, bool showMsg)
 {
+	if (m_imageLoader.isDeferring() && pageItem->isImageFrame())
+	{
+		// decoded in the background once the document is loaded
+		m_imageLoader.defer(pageItem);
+		return true;
+	}
 	if (!reload)
 	{
 		if (pageItem->imageIsAvailable)
@@ -6474,14 +6590,13 @@ int ScribusDoc::currentPageNumber()
 
 bool ScribusDoc::itemNameExists(const QString& checkItemName) const
 {
+	// Root elements of the doc are looked up in the name index, which also remembers the groups
+	if (itemByName(checkItemName))
+		return true;
 	std::vector<PageItem*> groups;
 	groups.reserve(32);
-
-	// Process root elements of the doc and remember groups
-	for (PageItem* item: *Items)
+	for (PageItem* item : std::as_const(m_itemNameIndex.groups))
 	{
-		if (item->itemName() == checkItemName)
-			return true;
 		if (item->isGroup())
 			groups.push_back(item);
 	}
@@ -9794,6 +9909,7 @@ void ScribusDoc::MirrorPolyH(PageItem* currItem)
 		ma.translate(qRound(tp.x()), 0);
 		ma.scale(-1, 1);
 		currItem->ContourLine.map(ma);
+		itemBoundsChanged(currItem);
 		regionsChanged()->update(QRectF());
 		changed();
 		return;
@@ -9837,6 +9953,7 @@ void ScribusDoc::MirrorPolyV(PageItem* currItem)
 		ma.translate(0, qRound(tp.y()));
 		ma.scale(1, -1);
 		currItem->ContourLine.map(ma);
+		itemBoundsChanged(currItem);
 		regionsChanged()->update(QRectF());
 		changed();
 		return;
@@ -10139,6 +10256,8 @@ void ScribusDoc::updatePictDir(const QString& name)
 //CB Same as updatePict apart from the name checking, this should be able to be removed
 void ScribusDoc::recalcPicturesRes(int recalcFlags)
 {
+	// the document colors used by image effects are not part of the pool keys
+	m_imagePool.clear();
 	int imageCount = 0;
 	int progress = 0;
 	PageItemIterator itemIt;
@@ -10366,6 +10485,7 @@ void ScribusDoc::removePict(const QString& name)
 		{
 			currItem->imageIsAvailable = false;
 			currItem->pixm = ScImage();
+			currItem->imagePoolUser.reset();
 			updated = true;
 		}
 	}
@@ -10390,6 +10510,7 @@ void ScribusDoc::removePict(const QString& name)
 				{
 					currItem->imageIsAvailable = false;
 					currItem->pixm = ScImage();
+					currItem->imagePoolUser.reset();
 					updated = true;
 				}
 			}
@@ -13101,6 +13222,32 @@ void ScribusDoc::endUpdate()
 	m_docUpdater->endUpdate();
 }
 
+void ScribusDoc::beginBatch()
+{
+	if (m_batchLevel++ > 0)
+		return;
+	m_batchClearsUndo = UndoManager::undoEnabled();
+	m_undoManager->setUndoEnabled(false);
+	m_docUpdater->beginUpdate();
+}
+
+void ScribusDoc::endBatch()
+{
+	if (m_batchLevel <= 0 || --m_batchLevel > 0)
+		return;
+	// Frames of a chain are laid out by the first invalid frame
+	for (PageItemIterator it(this, PageItemIterator::IterateInDocNoPatterns); *it; ++it)
+	{
+		if (it->isTextFrame() && it->invalid)
+			it->layout();
+	}
+	m_undoManager->setUndoEnabled(true);
+	if (m_batchClearsUndo)
+		m_undoManager->clearStack();
+	m_regionsChanged.update(QRectF());
+	m_docUpdater->endUpdate();
+}
+
 void ScribusDoc::itemSelection_SwapLeft()
 {
 	if (!startAlign(2))
@@ -13447,6 +13594,33 @@ void ScribusDoc::invalidateRegion(QRectF region)
 	// for now hope that frameitems get invalidated by their parents layout() method.
 }
 
+const ItemSpatialIndex& ScribusDoc::textFlowIndex(const QList<PageItem*>& items)
+{
+	ItemSpatialIndex& index = (&items == &MasterItems) ? m_masterItemsTextFlowIndex : m_docItemsTextFlowIndex;
+	index.update(items);
+	return index;
+}
+
+const ItemSpatialIndex& ScribusDoc::visualIndex(const QList<PageItem*>& items, int layerID)
+{
+	QHash<int, ItemSpatialIndex>& indexes = (&items == &MasterItems) ? m_masterItemsVisualIndexes : m_docItemsVisualIndexes;
+	auto index = indexes.find(layerID);
+	if (index == indexes.end())
+		index = indexes.emplace(layerID, ItemSpatialIndex::VisualBounds, layerID);
+	index->update(items);
+	return *index;
+}
+
+void ScribusDoc::itemBoundsChanged(const PageItem* item)
+{
+	m_docItemsTextFlowIndex.itemChanged(item);
+	m_masterItemsTextFlowIndex.itemChanged(item);
+	for (auto it = m_docItemsVisualIndexes.begin(); it != m_docItemsVisualIndexes.end(); ++it)
+		it->itemChanged(item);
+	for (auto it = m_masterItemsVisualIndexes.begin(); it != m_masterItemsVisualIndexes.end(); ++it)
+		it->itemChanged(item);
+}
+
 
 ScPage* ScribusDoc::currentPage()
 {
@@ -40,6 +40,10 @@ for which a new license (GPL+exception) is in place.
 
 #include "appmodes.h"
 #include "gtgettext.h" //CB For the ImportSetup struct and itemadduserframe
+#include "itemspatialindex.h"
+#include "scimageloader.h"
+#include "scimagepool.h"
+#include "scdisplaycolorcache.h"
 #include "scribusapi.h"
 #include "colormgmt/sccolormgmtengine.h"
 #include "documentinformation.h"
@@ -132,6 +136,25 @@ public:
 	void invalidateAll();
 	void invalidateLayer(int layerID);
 	void invalidateRegion(QRectF region);
+	/**
+	 * @brief Spatial index of the regions text flows around for an item list
+	 * @param items either DocItems or MasterItems
+	 */
+	const ItemSpatialIndex& textFlowIndex(const QList<PageItem*>& items);
+	/**
+	 * @brief Spatial index of the visual bounds of the items of one layer of an item list, used by the canvas
+	 * @param items either DocItems or MasterItems
+	 * @param layerID the layer whose items are indexed
+	 */
+	const ItemSpatialIndex& visualIndex(const QList<PageItem*>& items, int layerID);
+	/// Tells the spatial indexes that the position, size, shape or text flow of @a item changed
+	void itemBoundsChanged(const PageItem* item);
+	/// Decoded images shared by the image frames of the document
+	ScImagePool& imagePool() { return m_imagePool; }
+	/// Screen colors computed by ScColorEngine for this document
+	ScDisplayColorCache& displayColorCache() const { return m_displayColorCache; }
+	/// Background decoding of the images of a document being opened
+	ScImageLoader& imageLoader() { return m_imageLoader; }
 
 	MarginStruct* scratch() { return &m_docPrefsData.displayPrefs.scratch; }
 	MarginStruct* bleeds() { return &m_docPrefsData.docSetupPrefs.bleeds; }
@@ -876,6 +899,21 @@ public:
 	 */
 	PageItem* getItemFromName(const QString& name) const;
 
+	/**
+	 * @brief Return the first item of the current item list named @a name, without looking into groups
+	 *
+	 * Uses an index of the item names which is updated when items are added or renamed, so lookups
+	 * by scripts neither scan the list for names that exist nor for names that do not. The index
+	 * shares the data of the item list, any other edit of the list detaches the list from it and
+	 * the index is rebuilt by the next lookup.
+	 * @param lastMatch return the last item named @a name instead of the first one
+	 */
+	PageItem* itemByName(const QString& name, bool lastMatch = false) const;
+	/**
+	 * @brief Update the item name index after @a item was renamed from @a oldName
+	 */
+	void itemNameChanged(PageItem* item, const QString& oldName);
+
 	/**
 	 * @brief Rebuild item lists taking into account layer order.
 	 * Utility function used in various places, basically handles keeping items numbered in the way
@@ -1279,6 +1317,23 @@ public:
 	void beginUpdate();
 	void endUpdate();
 
+	/**
+	 * @brief Start a batch of changes, e.g. by a script generating a whole document
+	 *
+	 * Until the matching endBatch() no undo states are recorded, changed items are only
+	 * invalidated instead of being laid out and having their region updated, and docChanged()
+	 * is emitted once at the end. Batches may be nested.
+	 */
+	void beginBatch();
+	/**
+	 * @brief End a batch, lay out the invalid text frames once and update the whole document
+	 *
+	 * The undo history is cleared if undo was enabled when the batch started, as it may
+	 * refer to items changed or deleted without undo states.
+	 */
+	void endBatch();
+	bool inBatch() const { return m_batchLevel > 0; }
+
 	int addToInlineFrames(PageItem *item);
 	void removeInlineFrame(int fIndex);
 	void checkItemForFrames(PageItem *it, int fIndex);
@@ -1316,6 +1371,33 @@ protected:
 	QString m_currentEditedSymbol;
 	int m_currentEditedIFrame {0};
 	QString m_documentFileName;
+	ItemSpatialIndex m_docItemsTextFlowIndex {ItemSpatialIndex::TextFlowBounds};
+	ItemSpatialIndex m_masterItemsTextFlowIndex {ItemSpatialIndex::TextFlowBounds};
+	QHash<int, ItemSpatialIndex> m_docItemsVisualIndexes;
+	QHash<int, ItemSpatialIndex> m_masterItemsVisualIndexes;
+	ScImagePool m_imagePool;
+	mutable ScDisplayColorCache m_displayColorCache;
+	struct ItemNameIndex
+	{
+		struct Entry
+		{
+			PageItem* item {nullptr};
+			int position {-1};
+		};
+		const QList<PageItem*>* items {nullptr};
+		// shares the data of *items, edits of the list detach it so they cannot go unnoticed
+		QList<PageItem*> itemsData;
+		QHash<QString, QList<Entry>> names;
+		QList<PageItem*> groups;
+	};
+	mutable ItemNameIndex m_itemNameIndex;
+	int m_batchLevel {0};
+	bool m_batchClearsUndo {false};
+	bool itemNameIndexValid() const;
+	void rebuildItemNameIndex() const;
+	bool itemNameIndexRelease();
+	void itemNameIndexAdd(PageItem* item, int position);
+	ScImageLoader m_imageLoader {this};
 
 public: // Public attributes
 	bool is12doc {false}; //public for now, it will be removed later
@@ -341,6 +341,7 @@ void ScribusView::togglePreview(bool inPreview)
 
 void ScribusView::changed(QRectF re, bool)
 {
+	m_canvas->invalidateTiles(re);
 	double scale = m_canvas->scale();
 	int newCanvasWidth  = qRound((m_doc->maxCanvasCoordinate.x() - m_doc->minCanvasCoordinate.x()) * scale);
 	int newCanvasHeight = qRound((m_doc->maxCanvasCoordinate.y() - m_doc->minCanvasCoordinate.y()) * scale);
@@ -1374,6 +1375,7 @@ void ScribusView::TransformPoly(int mode, int rot, double scaling)
 		}
 		currItem->ContourLine.map(ma);
 		currItem->ContourLine.translate(qRound((tp.x() + tp2.x()) / 2.0), qRound((tp.y() + tp2.y()) / 2.0));
+		m_doc->itemBoundsChanged(currItem);
 		updateContents();
 		currItem->FrameOnly = true;
 		m_doc->regionsChanged()->update(QRect());
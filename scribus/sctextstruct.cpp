@@ -5,7 +5,6 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
-#include <QList>
 #include "sctextstruct.h"
 #include "pageitem.h"
 #include "scribusdoc.h"
@@ -19,53 +18,3 @@ PageItem* InlineFrame::getPageItem(const ScribusDoc* doc) const
 }
 
 
-ScText::~ScText() 
-{
-	delete parstyle;
-	parstyle = nullptr;
-	mark = nullptr;
-}
-
-bool ScText::hasObject(const ScribusDoc *doc) const
-{
-	if (this->ch == SpecialChars::OBJECT)
-		return ((embedded > 0) && (doc->FrameItems.contains(embedded)));
-	return false;
-}
-
-bool ScText::hasMark(const Mark* mrk) const
-{
-	if (this->ch == SpecialChars::OBJECT)
-	{
-		if (mrk == nullptr)
-			return mark != nullptr;
-		return mark == mrk;
-	}
-	return false;
-}
-
-QList<PageItem*> ScText::getGroupedItems(const ScribusDoc *doc) const
-{
-	QList<PageItem*> result;
-	if ((embedded > 0) && (doc->FrameItems.contains(embedded)))
-	{
-		PageItem* dItem = doc->FrameItems[embedded];
-		result.append(dItem);
-		if (dItem->isGroup())
-			result = dItem->getAllChildren();
-	}
-	return result;
-}
-
-PageItem* ScText::getItem(const ScribusDoc *doc) const
-{
-	if ((embedded > 0) && (doc->FrameItems.contains(embedded)))
-		return doc->FrameItems[embedded];
-	return nullptr;
-}
-
-void ScText::setNewMark(Mark *mrk)
-{
-	if (!mrk->isUnique())
-		mark = mrk;
-}
@@ -104,13 +104,12 @@ public:
 	virtual void update(const StyleContext* b = nullptr);
 	
 	/**
-		Checks if this BaseStyle needs an update
+		Checks if this BaseStyle needs an update. Every attribute getter calls this,
+		so only the version check is inlined.
 	 */
 	inline void validate() const {
-		if (m_context && m_contextversion != m_context->version()) {
-			const_cast<BaseStyle*>(this)->update(m_context);
-			assert( m_context->checkConsistency() );
-		}
+		if (Q_UNLIKELY(m_context && m_contextversion != m_context->version()))
+			revalidate();
 	}
 
 	QString shortcut() const { return m_shortcut; }
@@ -151,6 +150,10 @@ public:
 			setParent("");
 		m_contextversion = -1;
 	}
+
+private:
+	/// the slow path of validate(): updates all inherited attributes from the context
+	void revalidate() const;
 };
 
 #endif
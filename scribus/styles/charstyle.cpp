@@ -240,9 +240,11 @@ void CharStyle::update(const StyleContext* context)
 	BaseStyle::update(context);
 	const CharStyle * oth = dynamic_cast<const CharStyle*> ( parentStyle() );
 	if (oth) {
+		// validate the parent once instead of in every getter
+		oth->validate();
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT, attr_BREAKSHAPING) \
 		if (inh_##attr_NAME) \
-			m_##attr_NAME = oth->attr_GETTER();
+			m_##attr_NAME = oth->m_##attr_NAME;
 #include "charstyle.attrdefs.cxx"
 #undef ATTRDEF
 	}
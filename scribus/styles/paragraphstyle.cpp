@@ -153,9 +153,11 @@ void ParagraphStyle::update(const StyleContext* context)
 	const auto * oth = reinterpret_cast<const ParagraphStyle*> ( parentStyle() );
 //	qDebug() << QString("ParagraphStyle::update(%1) parent=%2").arg((unsigned long int)context).arg((unsigned long int)oth);
 	if (oth){
+		// validate the parent once instead of in every getter
+		oth->validate();
 #define ATTRDEF(attr_TYPE, attr_GETTER, attr_NAME, attr_DEFAULT) \
 		if (inh_##attr_NAME) \
-			m_##attr_NAME = oth->attr_GETTER();
+			m_##attr_NAME = oth->m_##attr_NAME;
 #include "paragraphstyle.attrdefs.cxx"
 #undef ATTRDEF
 	}
@@ -60,6 +60,12 @@ void BaseStyle::update(const StyleContext* b)
 		m_contextversion = m_context->version(); 
 }
 
+void BaseStyle::revalidate() const
+{
+	const_cast<BaseStyle*>(this)->update(m_context);
+	assert( m_context->checkConsistency() );
+}
+
 QString BaseStyle::baseName() const
 {
 	if (m_name.isEmpty())
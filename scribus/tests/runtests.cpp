@@ -2,7 +2,14 @@
 #include <QTest>
 //#include "testGlyphStore.h"
 //#include "testIndex.h"
+#include "testFontSubsetCache.h"
+#include "testImageEffects.h"
+#include "testPdfContentSink.h"
+#include "testPdfWriter.h"
+#include "testShapedTextCache.h"
 #include "testStoryText.h"
+#include "testStyleGetters.h"
+#include "testUndoStack.h"
 #include "runtests.h"
 
 int RunTests::runTests(int argc, char ** argv)
@@ -10,6 +17,13 @@ int RunTests::runTests(int argc, char ** argv)
 	QList<QObject *> testObjects;
 //	testObjects << new TestGlyphStore();
 	testObjects << new TestStoryText();
+	testObjects << new TestStyleGetters();
+	testObjects << new TestPdfWriter();
+	testObjects << new TestPdfContentSink();
+	testObjects << new TestFontSubsetCache();
+	testObjects << new TestImageEffects();
+	testObjects << new TestUndoStack();
+	testObjects << new TestShapedTextCache();
 //	testObjects << new TestIndex();
 	int failed = 0;
 	for (int i = 0; i < testObjects.count(); ++i)
@@ -0,0 +1,126 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QTemporaryDir>
+
+#include "testFontSubsetCache.h"
+#include "fonts/scfontsubsetcache.h"
+
+namespace
+{
+	ScFontSubsetCache::Subset makeSubset(int size, char fill)
+	{
+		ScFontSubsetCache::Subset subset;
+		subset.data = QByteArray(size, fill);
+		subset.glyphs << 0 << 3 << 17 << 42;
+		subset.glyphMap.insert(3, 1);
+		subset.glyphMap.insert(17, 2);
+		subset.glyphMap.insert(42, 3);
+		return subset;
+	}
+}
+
+void TestFontSubsetCache::keys()
+{
+	QList<uint> glyphs { 0, 3, 17 };
+	QByteArray key = ScFontSubsetCache::key("fonthash", 0, glyphs, "ttf");
+	QCOMPARE(key, ScFontSubsetCache::key("fonthash", 0, glyphs, "ttf"));
+	QVERIFY(key != ScFontSubsetCache::key("otherhash", 0, glyphs, "ttf"));
+	QVERIFY(key != ScFontSubsetCache::key("fonthash", 1, glyphs, "ttf"));
+	QVERIFY(key != ScFontSubsetCache::key("fonthash", 0, glyphs, "cff"));
+	QVERIFY(key != ScFontSubsetCache::key("fonthash", 0, QList<uint> { 0, 3, 18 }, "ttf"));
+	QVERIFY(ScFontSubsetCache::key(QByteArray(), 0, glyphs, "ttf").isEmpty());
+}
+
+void TestFontSubsetCache::roundTrip()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	ScFontSubsetCache cache(dir.path());
+	cache.setMaxCacheSizeMiB(1);
+
+	QByteArray key = ScFontSubsetCache::key("fonthash", 0, QList<uint> { 0, 3, 17, 42 }, "ttf");
+	ScFontSubsetCache::Subset found;
+	QVERIFY(!cache.find(key, found));
+
+	ScFontSubsetCache::Subset subset = makeSubset(1000, 'a');
+	cache.insert(key, subset);
+	QCOMPARE(cache.entryCount(), 1);
+	QVERIFY(cache.find(key, found));
+	QCOMPARE(found.data, subset.data);
+	QCOMPARE(found.glyphs, subset.glyphs);
+	QCOMPARE(found.glyphMap, subset.glyphMap);
+
+	// a second instance, as another Scribus process would, sees the entry
+	ScFontSubsetCache other(dir.path());
+	other.setMaxCacheSizeMiB(1);
+	QCOMPARE(other.entryCount(), 1);
+	QVERIFY(other.find(key, found));
+	QCOMPARE(found.data, subset.data);
+}
+
+void TestFontSubsetCache::disabled()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	ScFontSubsetCache cache(dir.path());
+	QVERIFY(!cache.enabled());
+
+	QByteArray key = ScFontSubsetCache::key("fonthash", 0, QList<uint> { 0, 1 }, "ttf");
+	cache.insert(key, makeSubset(100, 'b'));
+	QCOMPARE(cache.entryCount(), 0);
+	ScFontSubsetCache::Subset found;
+	QVERIFY(!cache.find(key, found));
+}
+
+void TestFontSubsetCache::eviction()
+{
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	ScFontSubsetCache cache(dir.path());
+	cache.setMaxCacheSizeMiB(1);
+	cache.setMaxCacheEntries(3);
+
+	QList<QByteArray> keys;
+	for (int i = 0; i < 4; ++i)
+		keys.append(ScFontSubsetCache::key("fonthash", 0, QList<uint> { 0, uint(i + 1) }, "ttf"));
+	for (int i = 0; i < 3; ++i)
+		cache.insert(keys.at(i), makeSubset(100, 'c'));
+	QCOMPARE(cache.entryCount(), 3);
+
+	// the first entry was used last, the second one is the oldest
+	QDateTime past = QDateTime::currentDateTime().addSecs(-3600);
+	const int ages[3] = { 0, 120, 60 };
+	QDirIterator it(dir.path(), QStringList() << "*.subset", QDir::Files, QDirIterator::Subdirectories);
+	while (it.hasNext())
+	{
+		QString path = it.next();
+		for (int i = 0; i < 3; ++i)
+		{
+			if (!path.endsWith(QString::fromLatin1(keys.at(i).mid(2)) + ".subset"))
+				continue;
+			QFile file(path);
+			QVERIFY(file.open(QIODevice::ReadWrite));
+			QVERIFY(file.setFileTime(past.addSecs(-ages[i]), QFileDevice::FileModificationTime));
+		}
+	}
+
+	cache.insert(keys.at(3), makeSubset(100, 'd'));
+	QCOMPARE(cache.entryCount(), 3);
+	ScFontSubsetCache::Subset found;
+	QVERIFY(cache.find(keys.at(0), found));
+	QVERIFY(!cache.find(keys.at(1), found));
+	QVERIFY(cache.find(keys.at(2), found));
+	QVERIFY(cache.find(keys.at(3), found));
+	QCOMPARE(found.data, QByteArray(100, 'd'));
+
+	// the size limit evicts as well, an entry larger than the whole cache does not stay
+	cache.setMaxCacheEntries(100);
+	cache.insert(keys.at(1), makeSubset(1024 * 1024, 'e'));
+	QCOMPARE(cache.entryCount(), 0);
+	QCOMPARE(cache.totalSize(), qint64(0));
+}
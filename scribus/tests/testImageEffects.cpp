@@ -0,0 +1,264 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <cmath>
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include "testImageEffects.h"
+#include "sccolor.h"
+#include "scimage.h"
+#include "scimagestructs.h"
+
+namespace
+{
+	QImage randomImage(int width, int height, quint32 seed)
+	{
+		QImage image(width, height, QImage::Format_ARGB32);
+		QRandomGenerator random(seed);
+		for (int y = 0; y < height; ++y)
+		{
+			QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+			for (int x = 0; x < width; ++x)
+				line[x] = random.generate();
+		}
+		return image;
+	}
+
+	ScImageEffectList effectList(int code, const QString& parameters = QString())
+	{
+		ImageEffect effect;
+		effect.effectCode = code;
+		effect.effectParameters = parameters;
+		ScImageEffectList list;
+		list.append(effect);
+		return list;
+	}
+
+	/// The sharpen as it was done before, a 2D kernel applied with 16 bit channels.
+	QImage referenceSharpen(const QImage& image, int widthk, double sigma)
+	{
+		const int half = widthk / 2;
+		QList<double> kernel;
+		double normalize = 0.0;
+		for (int v = -half; v <= half; ++v)
+		{
+			for (int u = -half; u <= half; ++u)
+			{
+				double value = exp(-((double) u * u + v * v) / (2.0 * sigma * sigma)) / (2.0 * M_PI * sigma * sigma);
+				kernel.append(value);
+				normalize += value;
+			}
+		}
+		kernel[kernel.count() / 2] = -2.0 * normalize;
+		double sum = 0.0;
+		for (double value : std::as_const(kernel))
+			sum += value;
+
+		QImage result(image.size(), QImage::Format_ARGB32);
+		for (int y = 0; y < image.height(); ++y)
+		{
+			for (int x = 0; x < image.width(); ++x)
+			{
+				double channels[4] = { 0.0, 0.0, 0.0, 0.0 };
+				int k = 0;
+				for (int my = -half; my <= half; ++my)
+				{
+					for (int mx = -half; mx <= half; ++mx, ++k)
+					{
+						QRgb p = image.pixel(qBound(0, x + mx, image.width() - 1), qBound(0, y + my, image.height() - 1));
+						double weight = kernel.at(k) / sum;
+						channels[0] += weight * qRed(p) * 257;
+						channels[1] += weight * qGreen(p) * 257;
+						channels[2] += weight * qBlue(p) * 257;
+						channels[3] += weight * qAlpha(p) * 257;
+					}
+				}
+				int values[4];
+				for (int c = 0; c < 4; ++c)
+				{
+					double value = channels[c] < 0 ? 0 : channels[c] > 65535 ? 65535 : channels[c] + 0.5;
+					values[c] = (unsigned char) (value / 257UL);
+				}
+				result.setPixel(x, y, qRgba(values[0], values[1], values[2], values[3]));
+			}
+		}
+		return result;
+	}
+}
+
+void TestImageEffects::sharpenMatchesConvolution()
+{
+	QImage source = randomImage(83, 57, 4711);
+	ScImage image(source);
+	ColorList colors;
+	// a radius of 2 gives a 5 x 5 kernel
+	image.applyEffect(effectList(ImageEffect::EF_SHARPEN, "2 1.3"), colors, false);
+	// the separable filter sums in another order in float, a few channels round the other way
+	QImage result = image.qImage();
+	QImage expected = referenceSharpen(source, 5, 1.3);
+	for (int y = 0; y < source.height(); ++y)
+	{
+		for (int x = 0; x < source.width(); ++x)
+		{
+			QRgb r = result.pixel(x, y);
+			QRgb e = expected.pixel(x, y);
+			QVERIFY(qAbs(qRed(r) - qRed(e)) <= 1);
+			QVERIFY(qAbs(qGreen(r) - qGreen(e)) <= 1);
+			QVERIFY(qAbs(qBlue(r) - qBlue(e)) <= 1);
+			QVERIFY(qAbs(qAlpha(r) - qAlpha(e)) <= 1);
+		}
+	}
+}
+
+void TestImageEffects::grayscaleAndInvert()
+{
+	QImage source = randomImage(67, 31, 42);
+	ColorList colors;
+
+	ScImage gray(source);
+	gray.applyEffect(effectList(ImageEffect::EF_GRAYSCALE), colors, false);
+	ScImage grayCMYK(source);
+	grayCMYK.applyEffect(effectList(ImageEffect::EF_GRAYSCALE), colors, true);
+	for (int y = 0; y < source.height(); ++y)
+	{
+		for (int x = 0; x < source.width(); ++x)
+		{
+			QRgb r = source.pixel(x, y);
+			int k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r)), 255);
+			QCOMPARE(gray.qImage().pixel(x, y), qRgba(k, k, k, qAlpha(r)));
+			k = qMin(qRound(0.3 * qRed(r) + 0.59 * qGreen(r) + 0.11 * qBlue(r) + qAlpha(r)), 255);
+			QCOMPARE(grayCMYK.qImage().pixel(x, y), qRgba(0, 0, 0, k));
+		}
+	}
+
+	ScImage inverted(source);
+	inverted.applyEffect(effectList(ImageEffect::EF_INVERT), colors, false);
+	inverted.applyEffect(effectList(ImageEffect::EF_INVERT), colors, false);
+	QCOMPARE(inverted.qImage(), source);
+}
+
+void TestImageEffects::effectsBenchmark()
+{
+	if (qEnvironmentVariableIsEmpty("SCRIBUS_TEST_BENCHMARKS"))
+		QSKIP("set SCRIBUS_TEST_BENCHMARKS to time the image effects");
+	const QImage source = randomImage(6000, 4000, 1234);
+	ColorList colors;
+	colors.insert("Tone1", ScColor(200, 40, 0, 20));
+	colors.insert("Tone2", ScColor(0, 0, 0, 255));
+	const QString curve("2 0 0 1 1 0 ");
+
+	QList<QPair<QString, ScImageEffectList>> effects;
+	effects.append({ "invert", effectList(ImageEffect::EF_INVERT) });
+	effects.append({ "grayscale", effectList(ImageEffect::EF_GRAYSCALE) });
+	effects.append({ "colorize", effectList(ImageEffect::EF_COLORIZE, "Tone1\n80") });
+	effects.append({ "brightness", effectList(ImageEffect::EF_BRIGHTNESS, "20") });
+	effects.append({ "contrast", effectList(ImageEffect::EF_CONTRAST, "30") });
+	effects.append({ "sharpen", effectList(ImageEffect::EF_SHARPEN, "0 1") });
+	effects.append({ "blur", effectList(ImageEffect::EF_BLUR, "5 1") });
+	effects.append({ "solarize", effectList(ImageEffect::EF_SOLARIZE, "128") });
+	effects.append({ "duotone", effectList(ImageEffect::EF_DUOTONE, "Tone1\nTone2\n100 100 " + curve + curve) });
+	effects.append({ "curves", effectList(ImageEffect::EF_GRADUATE, "3 0 0 0.5 0.7 1 1 0") });
+
+	QElapsedTimer timer;
+	for (const auto& effect : std::as_const(effects))
+	{
+		for (bool cmyk : { false, true })
+		{
+			ScImage image(source);
+			timer.start();
+			image.applyEffect(effect.second, colors, cmyk);
+			qint64 elapsed = timer.elapsed();
+			qDebug() << "image effects," << effect.first << (cmyk ? "CMYK:" : "RGB:") << elapsed << "ms for" << source.width() << "x" << source.height();
+			QCOMPARE(image.width(), source.width());
+		}
+	}
+}
+
+void TestImageEffects::scaling_data()
+{
+	QTest::addColumn<int>("filter");
+	QTest::addColumn<int>("width");
+	QTest::addColumn<int>("height");
+
+	QTest::newRow("box down") << int(ScImage::BoxFilter) << 17 << 13;
+	QTest::newRow("box up") << int(ScImage::BoxFilter) << 150 << 101;
+	QTest::newRow("bilinear down") << int(ScImage::BilinearFilter) << 17 << 13;
+	QTest::newRow("bilinear up") << int(ScImage::BilinearFilter) << 150 << 101;
+	QTest::newRow("lanczos down") << int(ScImage::LanczosFilter) << 17 << 13;
+	QTest::newRow("lanczos up") << int(ScImage::LanczosFilter) << 150 << 101;
+}
+
+void TestImageEffects::scaling()
+{
+	QFETCH(int, filter);
+	QFETCH(int, width);
+	QFETCH(int, height);
+
+	// a flat image stays flat whatever the filter and direction
+	QImage flat(64, 48, QImage::Format_ARGB32);
+	flat.fill(qRgba(10, 200, 30, 255));
+	ScImage image(flat);
+	image.scaleImage(width, height, static_cast<ScImage::ScaleFilter>(filter));
+	QCOMPARE(image.width(), width);
+	QCOMPARE(image.height(), height);
+	QImage expected(width, height, QImage::Format_ARGB32);
+	expected.fill(qRgba(10, 200, 30, 255));
+	QCOMPARE(image.qImage(), expected);
+
+	if (filter != ScImage::BoxFilter)
+		return;
+	// halving with the box filter averages 2 x 2 blocks
+	QImage source = randomImage(64, 48, 99);
+	ScImage half(source);
+	half.scaleImage(32, 24);
+	for (int y = 0; y < 24; ++y)
+	{
+		for (int x = 0; x < 32; ++x)
+		{
+			int sum = 0;
+			for (int dy = 0; dy < 2; ++dy)
+			{
+				for (int dx = 0; dx < 2; ++dx)
+					sum += qGreen(source.pixel(2 * x + dx, 2 * y + dy));
+			}
+			QCOMPARE(qGreen(half.qImage().pixel(x, y)), qRound(sum / 4.0));
+		}
+	}
+}
+
+void TestImageEffects::scalingBenchmark()
+{
+	if (qEnvironmentVariableIsEmpty("SCRIBUS_TEST_BENCHMARKS"))
+		QSKIP("set SCRIBUS_TEST_BENCHMARKS to time the scaling filters");
+	const QImage source = randomImage(6000, 4000, 5678);
+	QElapsedTimer timer;
+
+	timer.start();
+	QImage smooth = source.scaled(1500, 1000, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+	qDebug() << "image scaling, QImage::scaled:" << timer.elapsed() << "ms from" << source.width() << "x" << source.height() << "to" << smooth.width() << "x" << smooth.height();
+
+	const QList<QPair<QString, ScImage::ScaleFilter>> filters = {
+		{ "box", ScImage::BoxFilter },
+		{ "bilinear", ScImage::BilinearFilter },
+		{ "lanczos", ScImage::LanczosFilter }
+	};
+	for (const auto& filter : filters)
+	{
+		ScImage image(source);
+		timer.start();
+		image.scaleImage(1500, 1000, filter.second);
+		qDebug() << "image scaling," << filter.first << "filter:" << timer.elapsed() << "ms";
+		QCOMPARE(image.width(), 1500);
+	}
+
+	ScImage preview(source);
+	timer.start();
+	QVERIFY(preview.createLowRes(4.0));
+	qDebug() << "image scaling, low resolution preview:" << timer.elapsed() << "ms";
+}
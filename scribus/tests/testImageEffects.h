@@ -0,0 +1,28 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QtTest/QtTest>
+
+/**
+ * Checks the separable sharpen against the former 2D convolution and the table driven
+ * tone effects against their per pixel formulas. If SCRIBUS_TEST_BENCHMARKS is set,
+ * each effect of ScImage::applyEffect() is timed on a 24 megapixel synthetic image.
+ * The scaling filters of ScImage::scaleImage() are checked and timed the same way.
+ */
+class TestImageEffects: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void sharpenMatchesConvolution();
+	void grayscaleAndInvert();
+	void effectsBenchmark();
+	void scaling_data();
+	void scaling();
+	void scalingBenchmark();
+};
@@ -0,0 +1,163 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include "testPdfContentSink.h"
+#include "pdfcontentsink.h"
+#include "pdfwriter.h"
+#include "util.h"
+
+namespace
+{
+	const int pathCount = 100000;
+	const int segmentsPerPath = 8;
+
+	/// Undoes the Flate compression of a content stream, qUncompress() grows its buffer as needed.
+	QByteArray inflate(const QByteArray& data)
+	{
+		QByteArray sizeHint(4, '\0');
+		sizeHint[1] = 0x10;
+		return qUncompress(sizeHint + data);
+	}
+}
+
+void TestPdfContentSink::numberFormat_data()
+{
+	QTest::addColumn<double>("value");
+	QTest::addColumn<int>("decimals");
+	QTest::addColumn<QByteArray>("expected");
+
+	QTest::newRow("zero") << 0.0 << 5 << QByteArray("0");
+	QTest::newRow("negative zero") << -0.0 << 5 << QByteArray("0");
+	QTest::newRow("below precision") << -0.0000001 << 5 << QByteArray("0");
+	QTest::newRow("integer") << 100.0 << 5 << QByteArray("100");
+	QTest::newRow("half") << 12.5 << 5 << QByteArray("12.5");
+	QTest::newRow("negative fraction") << -0.25 << 5 << QByteArray("-0.25");
+	QTest::newRow("rounded") << 3.3333333 << 5 << QByteArray("3.33333");
+	QTest::newRow("rounded up") << 0.999999 << 5 << QByteArray("1");
+	QTest::newRow("all digits") << -1234.56789 << 5 << QByteArray("-1234.56789");
+	QTest::newRow("no decimals") << 2.6 << 0 << QByteArray("3");
+	QTest::newRow("six decimals") << 0.1234564 << 6 << QByteArray("0.123456");
+	QTest::newRow("large") << 123456789.125 << 3 << QByteArray("123456789.125");
+}
+
+void TestPdfContentSink::numberFormat()
+{
+	QFETCH(double, value);
+	QFETCH(int, decimals);
+	QFETCH(QByteArray, expected);
+
+	QByteArray result("x ");
+	Pdf::appendNumber(result, value, decimals);
+	QCOMPARE(result, "x " + expected);
+}
+
+void TestPdfContentSink::compressedRoundTrip()
+{
+	// small chunks, so the content passes through many of them and the queue fills up
+	Pdf::ContentSink plain;
+	Pdf::ContentSink compressed(1024);
+	plain.begin(false);
+	compressed.begin(true);
+	QVERIFY(compressed.compresses());
+	QRandomGenerator random(4711);
+	for (int i = 0; i < 20000; ++i)
+	{
+		double v = random.bounded(10000.0) - 5000.0;
+		QByteArray op = (i % 7 == 0) ? QByteArray(" l\n") : QByteArray(" ");
+		plain.writeNumber(v);
+		plain.write(op);
+		compressed.writeNumber(v);
+		compressed << op;
+	}
+	QCOMPARE(compressed.size(), plain.size());
+	QByteArray expected = plain.finish();
+	QByteArray data = compressed.finish();
+	QVERIFY(data.size() < expected.size());
+	QCOMPARE(inflate(data), expected);
+
+	// a sink is reused for the next page
+	compressed.begin(true);
+	compressed.write("q\nQ\n");
+	QCOMPARE(inflate(compressed.finish()), QByteArray("q\nQ\n"));
+}
+
+void TestPdfContentSink::mapPageBenchmark()
+{
+	if (qEnvironmentVariableIsEmpty("SCRIBUS_TEST_BENCHMARKS"))
+		QSKIP("set SCRIBUS_TEST_BENCHMARKS to time the map page");
+	QList<double> coordinates;
+	QRandomGenerator random(42);
+	for (int i = 0; i < pathCount * (segmentsPerPath * 6 + 2); ++i)
+		coordinates.append(random.bounded(600.0) + random.bounded(1000) / 1000.0);
+
+	// before: one QByteArray built with operator+ and QByteArray::number(), compressed at the end
+	QElapsedTimer timer;
+	timer.start();
+	QByteArray content;
+	int c = 0;
+	for (int path = 0; path < pathCount; ++path)
+	{
+		content += QByteArray::number(coordinates.at(c), 'f', 5) + " " + QByteArray::number(coordinates.at(c + 1), 'f', 5) + " m\n";
+		c += 2;
+		for (int segment = 0; segment < segmentsPerPath; ++segment, c += 6)
+		{
+			content += QByteArray::number(coordinates.at(c), 'f', 5) + " " + QByteArray::number(coordinates.at(c + 1), 'f', 5) + " ";
+			content += QByteArray::number(coordinates.at(c + 2), 'f', 5) + " " + QByteArray::number(coordinates.at(c + 3), 'f', 5) + " ";
+			content += QByteArray::number(coordinates.at(c + 4), 'f', 5) + " " + QByteArray::number(coordinates.at(c + 5), 'f', 5) + " c\n";
+		}
+		content += "h\nS\n";
+	}
+	QByteArray before = CompressArray(content);
+	qint64 beforeTime = timer.restart();
+	QVERIFY(!before.isEmpty());
+
+	// after: numbers formatted straight into the chunks of the sink, compressed while writing
+	Pdf::ContentSink sink;
+	sink.begin(true);
+	c = 0;
+	for (int path = 0; path < pathCount; ++path)
+	{
+		sink.writeNumber(coordinates.at(c));
+		sink.write(" ", 1);
+		sink.writeNumber(coordinates.at(c + 1));
+		sink.write(" m\n", 3);
+		c += 2;
+		for (int segment = 0; segment < segmentsPerPath; ++segment)
+		{
+			for (int i = 0; i < 6; ++i, ++c)
+			{
+				sink.writeNumber(coordinates.at(c));
+				sink.write(" ", 1);
+			}
+			sink.write("c\n", 2);
+		}
+		sink.write("h\nS\n", 4);
+	}
+	qint64 uncompressedSize = sink.size();
+	QByteArray after = sink.finish();
+	qint64 afterTime = timer.elapsed();
+
+	qDebug() << "map page, before:" << content.size() << "bytes of content," << before.size() << "compressed," << beforeTime << "ms";
+	qDebug() << "map page, after:" << uncompressedSize << "bytes of content," << after.size() << "compressed," << afterTime << "ms";
+
+	// same drawing, the shorter numbers only drop trailing zeros
+	QByteArray afterContent = inflate(after);
+	QCOMPARE(afterContent.size(), uncompressedSize);
+	QList<QByteArray> beforeTokens = content.simplified().split(' ');
+	QList<QByteArray> afterTokens = afterContent.simplified().split(' ');
+	QCOMPARE(afterTokens.count(), beforeTokens.count());
+	for (int i = 0; i < beforeTokens.count(); i += 997)
+	{
+		if (beforeTokens.at(i).at(0) > '9')
+			QCOMPARE(afterTokens.at(i), beforeTokens.at(i));
+		else
+			QVERIFY(qAbs(afterTokens.at(i).toDouble() - beforeTokens.at(i).toDouble()) < 0.00001);
+	}
+}
@@ -0,0 +1,26 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QtTest/QtTest>
+
+/**
+ * Checks the number formatter and the content sink of the PDF export. If
+ * SCRIBUS_TEST_BENCHMARKS is set, a map-heavy page, 100000 curved paths, written the old
+ * way with QByteArray::number() into one QByteArray compressed at the end is compared
+ * against writing it through the sink.
+ */
+class TestPdfContentSink: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void numberFormat_data();
+	void numberFormat();
+	void compressedRoundTrip();
+	void mapPageBenchmark();
+};
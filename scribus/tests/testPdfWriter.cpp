@@ -0,0 +1,292 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+#include "testPdfWriter.h"
+#include "pdfwriter.h"
+#include "util.h"
+
+namespace
+{
+	const int pageCount = 2000;
+
+	QByteArray readFile(const QString& fileName)
+	{
+		QFile file(fileName);
+		if (!file.open(QIODevice::ReadOnly))
+			return QByteArray();
+		return file.readAll();
+	}
+
+	/// Returns the offset following the last startxref keyword or -1.
+	qint64 startXref(const QByteArray& pdf)
+	{
+		int pos = pdf.lastIndexOf("startxref\n");
+		if (pos < 0)
+			return -1;
+		int end = pdf.indexOf('\n', pos + 10);
+		return pdf.mid(pos + 10, end - pos - 10).toLongLong();
+	}
+
+	/// Returns the decompressed data of the stream object starting at @a offset.
+	QByteArray streamData(const QByteArray& pdf, qint64 offset, QByteArray& dictionary)
+	{
+		int start = pdf.indexOf(">>\nstream\n", offset);
+		if (start < 0)
+			return QByteArray();
+		dictionary = pdf.mid(offset, start - offset);
+		QRegularExpressionMatch length = QRegularExpression("/Length (\\d+)").match(QString::fromLatin1(dictionary));
+		if (!length.hasMatch())
+			return QByteArray();
+		QByteArray data = pdf.mid(start + 10, length.captured(1).toInt());
+		if (!dictionary.contains("/FlateDecode"))
+			return data;
+		// qUncompress() expects the uncompressed size in front, it grows its buffer if the hint is too small
+		QByteArray sizeHint(4, '\0');
+		sizeHint[1] = 0x10;
+		return qUncompress(sizeHint + data);
+	}
+}
+
+void TestPdfWriter::initTestCase()
+{
+	QVERIFY(m_dir.isValid());
+}
+
+qint64 TestPdfWriter::writeDocument(const QString& fileName, bool objectStreams, bool linearize)
+{
+	Pdf::Writer writer;
+	if (!writer.open(fileName))
+		return -1;
+	writer.setUseObjectStreams(objectStreams);
+	writer.setLinearize(linearize);
+	writer.setFileId("TestPdfWriter");
+	writer.writeHeader(PDFVersion::PDF_15);
+
+	writer.startObj(writer.CatalogObj);
+	writer.write("<<\n/Type /Catalog\n/Pages " + Pdf::toObjRef(writer.PagesObj) + "\n>>");
+	writer.endObj(writer.CatalogObj);
+	writer.startObj(writer.InfoObj);
+	writer.write("<<\n/Creator (TestPdfWriter)\n/Producer (Scribus PDF Library)\n>>");
+	writer.endObj(writer.InfoObj);
+
+	PdfId font = writer.newObject();
+	writer.startObj(font);
+	writer.write("<<\n/Type /Font\n/Subtype /Type1\n/BaseFont /Helvetica\n>>");
+	writer.endObj(font);
+
+	QByteArray kids;
+	for (int i = 0; i < pageCount; ++i)
+	{
+		QByteArray content = "q\n1 0 0 1 0 0 cm\nBT\n/F1 12 Tf\n72 770 Td\n(Page " + Pdf::toPdf(i + 1) + ") Tj\nET\n";
+		for (int j = 0; j < 20; ++j)
+			content += Pdf::toPdf(72 + j * 20) + " " + Pdf::toPdf(100 + (i + j) % 600) + " 20 20 re f\n";
+		content += "Q\n";
+		QByteArray data = CompressArray(content);
+		PdfId contents = writer.newObject();
+		writer.startObj(contents);
+		writer.write("<< /Length " + Pdf::toPdf(static_cast<qlonglong>(data.length())) + "\n/Filter /FlateDecode >>");
+		writer.endObjectWithStream(false, contents, data);
+
+		PdfId gState = writer.newObject();
+		writer.startObj(gState);
+		writer.write("<< /Type /ExtGState\n/CA 1\n/ca 0.5\n/SMask /None\n/AIS false\n/OPM 1\n/BM /Normal\n>>");
+		writer.endObj(gState);
+
+		PdfId page = writer.newObject();
+		writer.startObj(page);
+		writer.write("<<\n/Type /Page\n/Parent " + Pdf::toObjRef(writer.PagesObj) + "\n");
+		writer.write("/MediaBox [0 0 595.276 841.89]\n/TrimBox [0 0 595.276 841.89]\n/Rotate 0\n");
+		writer.write("/Contents " + Pdf::toObjRef(contents) + "\n");
+		writer.write("/Resources << /Font << /F1 " + Pdf::toObjRef(font) + " >> /ExtGState << /GS1 " + Pdf::toObjRef(gState) + " >> >>\n");
+		writer.write(">>");
+		writer.endObj(page);
+		kids += Pdf::toObjRef(page) + " ";
+	}
+
+	writer.startObj(writer.PagesObj);
+	writer.write("<<\n/Type /Pages\n/Kids [" + kids + "]\n/Count " + Pdf::toPdf(pageCount) + "\n>>");
+	writer.endObj(writer.PagesObj);
+
+	writer.writeXrefAndTrailer();
+	if (!writer.close(false))
+		return -1;
+	return QFileInfo(fileName).size();
+}
+
+bool TestPdfWriter::checkXrefStream(const QByteArray& pdf, int& compressedObjects)
+{
+	compressedObjects = 0;
+	qint64 xrefOffset = startXref(pdf);
+	if (xrefOffset <= 0)
+		return false;
+	QByteArray dictionary;
+	QByteArray entries = streamData(pdf, xrefOffset, dictionary);
+	QRegularExpressionMatch layout = QRegularExpression("/Type /XRef /Size (\\d+) /W \\[1 (\\d) 2\\]").match(QString::fromLatin1(dictionary));
+	if (!layout.hasMatch())
+		return false;
+	int size = layout.captured(1).toInt();
+	int offsetBytes = layout.captured(2).toInt();
+	int entryBytes = 1 + offsetBytes + 2;
+	if (entries.size() != size * entryBytes)
+		return false;
+
+	auto field = [&entries](int pos, int bytes)
+	{
+		quint64 value = 0;
+		for (int i = 0; i < bytes; ++i)
+			value = (value << 8) | static_cast<uchar>(entries.at(pos + i));
+		return value;
+	};
+	QHash<quint64, QList<QByteArray> > objectStreams;
+	for (int id = 0; id < size; ++id)
+	{
+		int pos = id * entryBytes;
+		int type = static_cast<int>(field(pos, 1));
+		quint64 second = field(pos + 1, offsetBytes);
+		quint64 third = field(pos + 1 + offsetBytes, 2);
+		if (type == 1)
+		{
+			if (!pdf.mid(static_cast<int>(second)).startsWith(Pdf::toPdf(id) + " 0 obj\n"))
+				return false;
+		}
+		else if (type == 2)
+		{
+			if (!objectStreams.contains(second))
+			{
+				int streamPos = static_cast<int>(field(static_cast<int>(second) * entryBytes + 1, offsetBytes));
+				QByteArray streamDictionary;
+				QByteArray objects = streamData(pdf, streamPos, streamDictionary);
+				if (!streamDictionary.contains("/Type /ObjStm"))
+					return false;
+				objectStreams.insert(second, objects.left(objects.indexOf('\n')).split(' '));
+			}
+			const QList<QByteArray>& header = objectStreams[second];
+			if ((static_cast<int>(third) * 2 >= header.count()) || (header.at(static_cast<int>(third) * 2).toInt() != id))
+				return false;
+			++compressedObjects;
+		}
+	}
+	return true;
+}
+
+void TestPdfWriter::classicXref()
+{
+	QString fileName = m_dir.filePath("classic.pdf");
+	QVERIFY(writeDocument(fileName, false) > 0);
+	QByteArray pdf = readFile(fileName);
+	QVERIFY(!pdf.contains("/ObjStm"));
+
+	qint64 xrefOffset = startXref(pdf);
+	QVERIFY(pdf.mid(xrefOffset).startsWith("xref\n0 "));
+	QCOMPARE(checkXrefTable(pdf, xrefOffset), 4 + pageCount * 3);
+}
+
+int TestPdfWriter::checkXrefTable(const QByteArray& pdf, qint64 offset)
+{
+	if (!pdf.mid(offset).startsWith("xref\n"))
+		return -1;
+	int pos = pdf.indexOf('\n', offset + 5) + 1;
+	QList<QByteArray> subsection = pdf.mid(offset + 5, pos - offset - 6).split(' ');
+	if (subsection.count() != 2)
+		return -1;
+	int id = subsection.at(0).toInt();
+	int inUse = 0;
+	while (pdf.mid(pos, 7) != "trailer")
+	{
+		QByteArray entry = pdf.mid(pos, 20);
+		if (entry.endsWith(" n \n"))
+		{
+			qint64 objectOffset = entry.left(10).toLongLong();
+			if (!pdf.mid(objectOffset).startsWith(Pdf::toPdf(id) + " 0 obj"))
+				return -1;
+			++inUse;
+		}
+		else if (!entry.endsWith(" f \n"))
+			return -1;
+		pos += 20;
+		++id;
+	}
+	return (id == subsection.at(0).toInt() + subsection.at(1).toInt()) ? inUse : -1;
+}
+
+void TestPdfWriter::objectStreams()
+{
+	QString fileName = m_dir.filePath("objstm.pdf");
+	QVERIFY(writeDocument(fileName, true) > 0);
+	QByteArray pdf = readFile(fileName);
+	QVERIFY(pdf.contains("/Type /ObjStm"));
+	QVERIFY(!pdf.contains("\ntrailer\n"));
+
+	int compressedObjects = 0;
+	QVERIFY(checkXrefStream(pdf, compressedObjects));
+	// catalog, info, font, pages and two dictionaries per page, content streams stay top level
+	QCOMPARE(compressedObjects, 4 + pageCount * 2);
+}
+
+void TestPdfWriter::compareSizeAndTime()
+{
+	if (qEnvironmentVariableIsEmpty("SCRIBUS_TEST_BENCHMARKS"))
+		QSKIP("set SCRIBUS_TEST_BENCHMARKS to compare the cross-reference formats");
+	QElapsedTimer timer;
+	timer.start();
+	qint64 classicSize = writeDocument(m_dir.filePath("classic-compare.pdf"), false);
+	qint64 classicTime = timer.restart();
+	qint64 objStmSize = writeDocument(m_dir.filePath("objstm-compare.pdf"), true);
+	qint64 objStmTime = timer.elapsed();
+	QVERIFY(classicSize > 0);
+	QVERIFY(objStmSize > 0);
+
+	qDebug() << "classic xref:" << classicSize << "bytes in" << classicTime << "ms,"
+			 << "object streams:" << objStmSize << "bytes in" << objStmTime << "ms,"
+			 << QString("%1% smaller").arg(100.0 * (classicSize - objStmSize) / classicSize, 0, 'f', 1);
+	QVERIFY(objStmSize < classicSize);
+}
+
+void TestPdfWriter::linearized()
+{
+	QString fileName = m_dir.filePath("linearized.pdf");
+	qint64 size = writeDocument(fileName, false, true);
+	QVERIFY(size > 0);
+	QByteArray pdf = readFile(fileName);
+
+	// the linearization dictionary is the first object
+	int first = pdf.indexOf(" 0 obj");
+	QVERIFY(first > 0);
+	QVERIFY(first < 1024);
+	int dictEnd = pdf.indexOf(">>", first);
+	QString dictionary = QString::fromLatin1(pdf.mid(first, dictEnd - first));
+	QRegularExpressionMatch values = QRegularExpression("/Linearized 1 /L +(\\d+) /H \\[ +(\\d+) +(\\d+) \\] /O (\\d+) /E +(\\d+) /N (\\d+) /T +(\\d+)").match(dictionary);
+	QVERIFY2(values.hasMatch(), qPrintable(dictionary));
+	QCOMPARE(values.captured(1).toLongLong(), size);
+	QCOMPARE(values.captured(6).toInt(), pageCount);
+	qint64 hintOffset = values.captured(2).toLongLong();
+	QVERIFY(pdf.mid(hintOffset + values.captured(3).toLongLong() - 7, 7) == "endobj\n");
+	QVERIFY(pdf.mid(hintOffset).contains("/S "));
+	QByteArray firstPage = "\n" + values.captured(4).toLatin1() + " 0 obj";
+	qint64 firstPageOffset = pdf.indexOf(firstPage) + 1;
+	QVERIFY(pdf.mid(firstPageOffset, 60).contains("/Type /Page\n"));
+	QVERIFY(firstPageOffset < values.captured(5).toLongLong());
+
+	// the first page cross-reference section comes right after the dictionary, the file ends
+	// with the main section, whose entries start at /T
+	qint64 firstPageXref = startXref(pdf);
+	QCOMPARE(firstPageXref, static_cast<qint64>(pdf.indexOf("xref\n", first)));
+	int firstPageObjects = checkXrefTable(pdf, firstPageXref);
+	QVERIFY(firstPageObjects > 0);
+	qint64 mainXref = pdf.lastIndexOf("xref\n0 ");
+	QCOMPARE(static_cast<qint64>(pdf.indexOf('\n', mainXref + 5)), values.captured(7).toLongLong());
+	QVERIFY(pdf.mid(firstPageXref, mainXref - firstPageXref).contains("/Prev " + QByteArray::number(mainXref).rightJustified(10, ' ')));
+	int mainObjects = checkXrefTable(pdf, mainXref);
+	QVERIFY(mainObjects > 0);
+	// all objects and the linearization dictionary and hint stream
+	QCOMPARE(firstPageObjects + mainObjects, 4 + pageCount * 3 + 2);
+}
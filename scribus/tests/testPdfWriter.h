@@ -0,0 +1,37 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+/**
+ * Writes a PDF shaped like a long export, 2000 pages with their content streams
+ * and small dictionaries, once with a classic xref table and once with object
+ * streams and a cross-reference stream, and checks that the cross-reference data
+ * points to the objects. The linearized variant is checked for its linearization
+ * dictionary and both cross-reference sections. If SCRIBUS_TEST_BENCHMARKS is set,
+ * size and time of both cross-reference formats are compared.
+ */
+class TestPdfWriter: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void initTestCase();
+	void classicXref();
+	void objectStreams();
+	void compareSizeAndTime();
+	void linearized();
+
+private:
+	QTemporaryDir m_dir;
+
+	static qint64 writeDocument(const QString& fileName, bool objectStreams, bool linearize = false);
+	static int checkXrefTable(const QByteArray& pdf, qint64 offset);
+	static bool checkXrefStream(const QByteArray& pdf, int& compressedObjects);
+};
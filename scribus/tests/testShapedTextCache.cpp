@@ -0,0 +1,110 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "testShapedTextCache.h"
+#include "text/shapedtext.h"
+#include "text/shapedtextcache.h"
+#include "text/specialchars.h"
+#include "text/storytext.h"
+
+namespace
+{
+	void putBlock(ShapedTextCache& cache, const StoryText& story, int fromChar, int toChar)
+	{
+		cache.put(story, fromChar, toChar, ShapedText(&story, fromChar, toChar));
+	}
+}
+
+void TestShapedTextCache::hitsAndMisses()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo Welt"));
+	ShapedTextCache cache;
+
+	QVERIFY(!cache.get(story, 0, story.length(), nullptr).isValid());
+	QCOMPARE(cache.hits(), 0);
+	QCOMPARE(cache.misses(), 1);
+
+	putBlock(cache, story, 0, story.length());
+	QCOMPARE(cache.count(), 1);
+	ShapedText shaped = cache.get(story, 0, story.length(), nullptr);
+	QVERIFY(shaped.isValid());
+	QCOMPARE(shaped.firstChar(), 0);
+	QCOMPARE(shaped.lastChar(), story.length());
+	QCOMPARE(cache.hits(), 1);
+	QCOMPARE(cache.misses(), 1);
+
+	// other chars of the same story are a different block
+	QVERIFY(!cache.get(story, 0, 5, nullptr).isValid());
+	QCOMPARE(cache.hits(), 1);
+	QCOMPARE(cache.misses(), 2);
+
+	cache.resetCounters();
+	QCOMPARE(cache.hits(), 0);
+	QCOMPARE(cache.misses(), 0);
+	QCOMPARE(cache.count(), 1);
+}
+
+void TestShapedTextCache::sharedByContent()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo") + SpecialChars::PARSEP + QString("Welt"));
+	ShapedTextCache cache;
+	putBlock(cache, story, 6, 10);
+
+	// text in front of a block does not invalidate it
+	story.insertChars(2, QString("xyz"));
+	QVERIFY(cache.get(story, 9, 13, nullptr).isValid());
+
+	// identical blocks share an entry
+	StoryText other;
+	other.insertChars(0, QString("Tschüss") + SpecialChars::PARSEP + QString("Welt"));
+	QVERIFY(cache.get(other, 8, 12, nullptr).isValid());
+	QCOMPARE(cache.hits(), 2);
+	QCOMPARE(cache.misses(), 0);
+	QCOMPARE(cache.count(), 1);
+}
+
+void TestShapedTextCache::invalidation()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo Welt"));
+	ShapedTextCache cache;
+	putBlock(cache, story, 0, story.length());
+
+	story.replaceChar(0, QChar('B'));
+	QVERIFY(!cache.get(story, 0, story.length(), nullptr).isValid());
+	story.replaceChar(0, QChar('H'));
+	QVERIFY(cache.get(story, 0, story.length(), nullptr).isValid());
+
+	CharStyle cs;
+	cs.setFontSize(240);
+	story.applyCharStyle(6, 4, cs);
+	QVERIFY(!cache.get(story, 0, story.length(), nullptr).isValid());
+	putBlock(cache, story, 0, story.length());
+	QCOMPARE(cache.count(), 2);
+
+	cache.clear();
+	QCOMPARE(cache.count(), 0);
+	QVERIFY(!cache.get(story, 0, story.length(), nullptr).isValid());
+	QCOMPARE(cache.hits(), 1);
+	QCOMPARE(cache.misses(), 3);
+}
+
+void TestShapedTextCache::uncacheable()
+{
+	StoryText story;
+	story.insertChars(0, QString("Hallo Welt"));
+	ShapedTextCache cache;
+
+	ShapedText needsFrame(&story, 0, story.length());
+	needsFrame.needsContext(true);
+	cache.put(story, 0, story.length(), needsFrame);
+	cache.put(story, 0, story.length(), ShapedText::Invalid);
+	putBlock(cache, story, 5, 5);
+	QCOMPARE(cache.count(), 0);
+}
@@ -0,0 +1,23 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QtTest/QtTest>
+
+/**
+ * Checks the hit and miss counters of the shaped text cache and which changes invalidate its entries.
+ */
+class TestShapedTextCache: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void hitsAndMisses();
+	void sharedByContent();
+	void invalidation();
+	void uncacheable();
+};
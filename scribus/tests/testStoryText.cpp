@@ -127,3 +127,83 @@ void TestStoryText::removeCharStyle()
 	QCOMPARE(story.startOfRun(2), 5  + 26 + 1);
 	QCOMPARE(story.endOfRun(2), 11 + 26);
 }
+
+void TestStoryText::splitAndMergeRuns()
+{
+	StoryText story;
+	story.insertChars(0, QString("abcdefghij"));
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(3, 3, cs);
+	QCOMPARE(story.nrOfRuns(), 3u);
+	QCOMPARE(story.endOfRun(0), 3);
+	QCOMPARE(story.endOfRun(1), 6);
+	QCOMPARE(story.endOfRun(2), 10);
+	story.applyCharStyle(6, 4, cs);
+	QCOMPARE(story.nrOfRuns(), 2u);
+	QCOMPARE(story.startOfRun(1), 3);
+	QCOMPARE(story.endOfRun(1), 10);
+	story.applyCharStyle(0, 3, cs);
+	QCOMPARE(story.nrOfRuns(), 1u);
+	QCOMPARE(story.charStyle(0).fontSize(), 10.0);
+}
+
+void TestStoryText::insertAtRunBoundaries()
+{
+	StoryText story;
+	story.insertChars(0, QString("abcdefghij"));
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(3, 3, cs);
+	// unstyled chars join the unstyled run before the boundary
+	story.insertChars(3, QString("XY"));
+	QCOMPARE(story.text(0, story.length()), QString("abcXYdefghij"));
+	QCOMPARE(story.nrOfRuns(), 3u);
+	QCOMPARE(story.endOfRun(0), 5);
+	QCOMPARE(story.endOfRun(1), 8);
+	QCOMPARE(story.charStyle(5).fontSize(), 10.0);
+	// and split a styled run
+	story.insertChars(6, QString("Z"));
+	QCOMPARE(story.text(0, story.length()), QString("abcXYdZefghij"));
+	QCOMPARE(story.nrOfRuns(), 5u);
+	QCOMPARE(story.startOfRun(2), 6);
+	QCOMPARE(story.endOfRun(2), 7);
+	QCOMPARE(story.charStyle(7).fontSize(), 10.0);
+	story.removeChars(6, 1);
+	QCOMPARE(story.nrOfRuns(), 3u);
+	QCOMPARE(story.endOfRun(1), 8);
+}
+
+void TestStoryText::removeAcrossRuns()
+{
+	StoryText story;
+	story.insertChars(0, QString("abcdefghij"));
+	CharStyle cs;
+	cs.setFontSize(10);
+	story.applyCharStyle(3, 3, cs);
+	story.removeChars(2, 2);
+	QCOMPARE(story.text(0, story.length()), QString("abefghij"));
+	QCOMPARE(story.nrOfRuns(), 3u);
+	QCOMPARE(story.endOfRun(0), 2);
+	QCOMPARE(story.endOfRun(1), 4);
+	QCOMPARE(story.endOfRun(2), 8);
+	// removing the styled run joins its neighbours
+	story.removeChars(1, 4);
+	QCOMPARE(story.text(0, story.length()), QString("ahij"));
+	QCOMPARE(story.nrOfRuns(), 1u);
+}
+
+void TestStoryText::layoutFlags()
+{
+	StoryText story;
+	story.insertChars(0, QString("abc"));
+	story.setFlag(1, ScLayout_LineBoundary);
+	story.setFlag(1, ScLayout_CJKLatinSpace);
+	QVERIFY(story.hasFlag(1, ScLayout_LineBoundary));
+	QVERIFY(!story.hasFlag(0, ScLayout_LineBoundary));
+	story.clearFlag(1, ScLayout_LineBoundary);
+	QCOMPARE(story.flags(1), ScLayout_CJKLatinSpace);
+	story.insertChars(0, QString("X"));
+	QVERIFY(story.hasFlag(2, ScLayout_CJKLatinSpace));
+	QCOMPARE(story.flags(1), ScLayout_None);
+}
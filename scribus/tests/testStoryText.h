@@ -27,4 +27,8 @@ private slots:
 	void removePars();
 	void applyCharStyle();
 	void removeCharStyle();
+	void splitAndMergeRuns();
+	void insertAtRunBoundaries();
+	void removeAcrossRuns();
+	void layoutFlags();
 };
@@ -0,0 +1,93 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "testStyleGetters.h"
+
+void TestStyleGetters::initTestCase()
+{
+	// 2000 paragraphs of 100 chars, every third word set in a different size
+	QString paragraph;
+	for (int i = 0; i < 10; ++i)
+		paragraph += QString("word%1 abc ").arg(i % 10);
+	paragraph += SpecialChars::PARSEP;
+
+	m_story = new StoryText();
+	QString text;
+	for (int i = 0; i < 2000; ++i)
+		text += paragraph;
+	m_story->insertChars(0, text);
+
+	CharStyle small;
+	small.setFontSize(80);
+	CharStyle large;
+	large.setFontSize(140);
+	large.setScaleH(900);
+	for (int pos = 0; pos + 6 < m_story->length(); pos += 33)
+		m_story->applyCharStyle(pos, 6, (pos / 33) % 2 ? small : large);
+	QVERIFY(m_story->nrOfRuns() > 4000u);
+}
+
+void TestStyleGetters::cleanupTestCase()
+{
+	delete m_story;
+	m_story = nullptr;
+}
+
+double TestStyleGetters::readCharStyles() const
+{
+	double sum = 0.0;
+	const int len = m_story->length();
+	for (int i = 0; i < len; ++i)
+	{
+		const CharStyle& style = m_story->charStyle(i);
+		sum += style.fontSize() + style.scaleH() + style.scaleV() + style.baselineOffset()
+			+ style.tracking() + style.fillShade() + style.wordTracking() + static_cast<int>(style.effects());
+	}
+	return sum;
+}
+
+void TestStyleGetters::charStyleGetters()
+{
+	if (qEnvironmentVariableIsEmpty("SCRIBUS_TEST_BENCHMARKS"))
+		QSKIP("set SCRIBUS_TEST_BENCHMARKS to time the style getters");
+	double sum = 0.0;
+	QBENCHMARK {
+		sum = readCharStyles();
+	}
+	QVERIFY(sum > 0.0);
+}
+
+void TestStyleGetters::paragraphStyleGetters()
+{
+	if (qEnvironmentVariableIsEmpty("SCRIBUS_TEST_BENCHMARKS"))
+		QSKIP("set SCRIBUS_TEST_BENCHMARKS to time the style getters");
+	double sum = 0.0;
+	QBENCHMARK {
+		sum = 0.0;
+		const int len = m_story->length();
+		for (int i = 0; i < len; ++i)
+		{
+			const ParagraphStyle& style = m_story->paragraphStyle(i);
+			sum += style.lineSpacing() + style.leftMargin() + style.rightMargin() + style.firstIndent()
+				+ style.gapBefore() + style.gapAfter() + style.minWordTracking() + static_cast<int>(style.alignment());
+		}
+	}
+	QVERIFY(sum > 0.0);
+}
+
+void TestStyleGetters::gettersAfterInvalidate()
+{
+	if (qEnvironmentVariableIsEmpty("SCRIBUS_TEST_BENCHMARKS"))
+		QSKIP("set SCRIBUS_TEST_BENCHMARKS to time the style getters");
+	// every paragraph re-resolves its char styles once, then reads them validated
+	double sum = 0.0;
+	QBENCHMARK {
+		m_story->invalidateAll();
+		sum = readCharStyles();
+	}
+	QVERIFY(sum > 0.0);
+}
@@ -0,0 +1,33 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QtTest/QtTest>
+
+#include "text/storytext.h"
+
+/**
+ * Measures the cost of style attribute getters on a large story, as used in
+ * layout loops, if SCRIBUS_TEST_BENCHMARKS is set. Run before and after changes
+ * to style resolution to compare.
+ */
+class TestStyleGetters: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void initTestCase();
+	void cleanupTestCase();
+	void charStyleGetters();
+	void paragraphStyleGetters();
+	void gettersAfterInvalidate();
+
+private:
+	StoryText* m_story { nullptr };
+
+	double readCharStyles() const;
+};
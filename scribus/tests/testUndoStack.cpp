@@ -0,0 +1,160 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include "testUndoStack.h"
+#include "undoobject.h"
+#include "undostate.h"
+#include "undostack.h"
+#include "undomanager.h"
+
+namespace
+{
+	SimpleState* textState(int length)
+	{
+		auto* state = new SimpleState("Insert Text");
+		state->set("INSERT_TEXT");
+		state->set("TEXT_STR", QString(length, 'x'));
+		return state;
+	}
+
+	/// Stores values in the state it restores, as the restore code of PageItem does.
+	class StoringObject : public UndoObject
+	{
+	public:
+		void restore(UndoState* state, bool isUndo) override
+		{
+			auto* ss = dynamic_cast<SimpleState*>(state);
+			if (ss)
+				ss->set("TEXT_STR", QString(isUndo ? 20000 : 10, 'x'));
+		}
+	};
+}
+
+void TestUndoStack::simpleState()
+{
+	SimpleState state("Test");
+	QVERIFY(!state.contains("OLD"));
+	QCOMPARE(state.getDouble("OLD", 2.5), 2.5);
+	QCOMPARE(state.get("NAME", "default"), QString("default"));
+
+	state.set("TYPE");
+	state.set("OLD", 1.5);
+	state.set("NEW", 3);
+	state.set("NAME", QString("first"));
+	QVERIFY(state.contains("TYPE"));
+	QCOMPARE(state.getDouble("OLD"), 1.5);
+	QCOMPARE(state.getInt("NEW"), 3);
+	QCOMPARE(state.get("NAME"), QString("first"));
+
+	// setting a key again replaces its value
+	qint64 usage = state.memoryUsage();
+	state.set("NAME", QString("second"));
+	QCOMPARE(state.get("NAME"), QString("second"));
+	state.set("NAME", QString(1000, 'x'));
+	QVERIFY(state.memoryUsage() >= usage + 1000 * qint64(sizeof(QChar)));
+}
+
+void TestUndoStack::geometryState()
+{
+	ScGeometryState state(ScGeometryState::Resize, "Resize");
+	QCOMPARE(state.action(), ScGeometryState::Resize);
+	QCOMPARE(state.oldGeometry().width, 0.0);
+	state.oldGeometry().width = 10.0;
+	state.newGeometry().width = 20.0;
+	QCOMPARE(state.oldGeometry().width, 10.0);
+	QCOMPARE(state.newGeometry().width, 20.0);
+
+	SimpleState simple("Resize");
+	simple.set("ITEM_RESIZE");
+	const char* keys[] = { "OLD_WIDTH", "NEW_WIDTH", "OLD_HEIGHT", "NEW_HEIGHT", "OLD_RXPOS", "OLD_RYPOS", "NEW_RXPOS", "NEW_RYPOS", "OLD_RROT", "NEW_RROT" };
+	for (const char* key : keys)
+		simple.set(key, 1.0);
+	QVERIFY(state.memoryUsage() < simple.memoryUsage());
+}
+
+void TestUndoStack::stepLimit()
+{
+	UndoStack stack(3);
+	int popped = 0;
+	for (int i = 0; i < 5; ++i)
+		popped += stack.action(new SimpleState("Test"));
+	QCOMPARE(popped, 2);
+	QCOMPARE(stack.undoItems(), 3u);
+
+	// redo actions are removed first
+	stack.undo(1, Um::GLOBAL_UNDO_MODE);
+	QCOMPARE(stack.redoItems(), 1u);
+	stack.setMaxSize(2);
+	QCOMPARE(stack.redoItems(), 0u);
+	QCOMPARE(stack.undoItems(), 2u);
+}
+
+void TestUndoStack::memoryLimit()
+{
+	UndoStack stack(0);
+	SimpleState* first = textState(10000);
+	qint64 stateUsage = first->memoryUsage();
+	stack.setMaxMemory(stateUsage * 3 + stateUsage / 2);
+
+	int popped = stack.action(first);
+	for (int i = 0; i < 9; ++i)
+		popped += stack.action(textState(10000));
+	QCOMPARE(stack.undoItems(), 3u);
+	QCOMPARE(popped, 7);
+	QVERIFY(stack.memoryUsage() <= stack.maxMemory());
+
+	// the newest action is kept even if it alone exceeds the limit
+	stack.action(textState(100000));
+	QCOMPARE(stack.undoItems(), 1u);
+	QCOMPARE(stack.redoItems(), 0u);
+
+	stack.clear();
+	QCOMPARE(stack.memoryUsage(), qint64(0));
+}
+
+void TestUndoStack::growingTopState()
+{
+	UndoStack stack(0);
+	SimpleState* state = textState(10);
+	stack.action(state);
+	qint64 usage = stack.memoryUsage();
+
+	// text states are extended while typing
+	state->set("TEXT_STR", QString(50000, 'x'));
+	stack.action(textState(10));
+	QVERIFY(stack.memoryUsage() >= usage + 49990 * qint64(sizeof(QChar)));
+
+	stack.setMaxMemory(stack.memoryUsage() - 1);
+	QCOMPARE(stack.undoItems(), 1u);
+	QCOMPARE(stack.memoryUsage(), usage);
+}
+
+void TestUndoStack::statesChangedByRestore()
+{
+	StoringObject object;
+	UndoStack stack(0);
+	SimpleState* first = textState(10);
+	SimpleState* second = textState(10);
+	first->setUndoObject(&object);
+	second->setUndoObject(&object);
+	stack.action(first);
+	stack.action(second);
+
+	stack.undo(2, Um::GLOBAL_UNDO_MODE);
+	QCOMPARE(stack.memoryUsage(), first->memoryUsage() + second->memoryUsage());
+	stack.redo(1, Um::GLOBAL_UNDO_MODE);
+	QCOMPARE(stack.memoryUsage(), first->memoryUsage() + second->memoryUsage());
+
+	// the remaining redo action is removed with the size it has now
+	SimpleState* third = textState(10);
+	stack.action(third);
+	QCOMPARE(stack.redoItems(), 0u);
+	QCOMPARE(stack.memoryUsage(), first->memoryUsage() + third->memoryUsage());
+
+	stack.clear();
+	QCOMPARE(stack.memoryUsage(), qint64(0));
+}
@@ -0,0 +1,25 @@
+/*
+ For general Scribus (>=1.3.2) copyright and licensing information please refer
+ to the COPYING file provided with the program. Following this notice may exist
+ a copyright and/or license notice that predates the release of Scribus 1.3.2
+ for which a new license (GPL+exception) is in place.
+ */
+
+#include <QtTest/QtTest>
+
+/**
+ * Checks the key-value storage of SimpleState and the step and memory limits of UndoStack.
+ */
+class TestUndoStack: public QObject
+{
+		Q_OBJECT
+
+private slots:
+
+	void simpleState();
+	void geometryState();
+	void stepLimit();
+	void memoryLimit();
+	void growingTopState();
+	void statesChangedByRestore();
+};
@@ -18,6 +18,17 @@
 
 using namespace icu;
 
+void Box::shiftChars(int delta)
+{
+	// empty group boxes keep their placeholder range
+	if (m_firstChar != INT_MAX)
+		m_firstChar += delta;
+	if (m_lastChar != INT_MIN)
+		m_lastChar += delta;
+	for (Box* box : m_boxes)
+		box->shiftChars(delta);
+}
+
 int GroupBox::pointToPosition(const QPointF& coord, const StoryText &story) const
 {
 	QPointF rel = coord - QPointF(m_x, m_y);
@@ -583,6 +594,12 @@ void GlyphBox::drawSelection(ScreenPainter *p, ITextContext *ctx) const
 	p->setStrokeWidth(sw);
 }
 
+void GlyphBox::shiftChars(int delta)
+{
+	Box::shiftChars(delta);
+	m_glyphRun.shiftChars(delta);
+}
+
 void GlyphBox::render(TextLayoutPainter *p) const
 {
 	// This is a very hot method and can be easily called tens of thousands of times per second,
@@ -96,6 +96,8 @@ public:
 	int firstChar() const { return m_firstChar == INT_MAX ? 0 : m_firstChar; }
 	/// The last character within the box.
 	int lastChar() const { return m_lastChar == INT_MIN ? 0 : m_lastChar; }
+	/// Moves the character range of the box and its children by delta.
+	virtual void shiftChars(int delta);
 
 	/// Sets the transformation matrix to applied to the box.
 	void setMatrix(const QTransform& x) { m_matrix = x; }
@@ -256,6 +258,8 @@ public:
 
 	GlyphCluster glyphRun() const { return m_glyphRun; }
 
+	void shiftChars(int delta) override;
+
 	const CharStyle& style() const { return m_glyphRun.style(); }
 
 protected:
@@ -56,6 +56,11 @@ const CharStyle& GlyphCluster::style() const
 	return *m_style;
 }
 
+void GlyphCluster::setStyle(const CharStyle* style)
+{
+	m_style = style;
+}
+
 bool GlyphCluster::hasFlag(LayoutFlags f) const
 {
 	return (m_flags & f) == f;
@@ -104,6 +109,12 @@ int GlyphCluster::lastChar() const
 	return m_lastChar;
 }
 
+void GlyphCluster::shiftChars(int delta)
+{
+	m_firstChar += delta;
+	m_lastChar += delta;
+}
+
 int GlyphCluster::visualIndex() const
 {
 	return m_visualIndex;
@@ -14,6 +14,7 @@ public:
 	void append(GlyphLayout&);
 
 	const CharStyle& style()  const;
+	void setStyle(const CharStyle* style);
 	bool hasFlag(LayoutFlags f) const ;
 	void setFlag(LayoutFlags f);
 	void clearFlag(LayoutFlags f);
@@ -24,6 +25,7 @@ public:
 
 	int firstChar() const;
 	int lastChar() const;
+	void shiftChars(int delta);
 	int visualIndex() const;
 
 	double width() const;
@@ -5,19 +5,32 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <algorithm>
 #include <cassert>  //added to make Fedora-5 happy
 
 //#include <QDebug>
 
 #include "fpoint.h"
+#include "marks.h"
 #include "scfonts.h"
 
 #include "scribusdoc.h"
 #include "sctext_shared.h"
+#include "text/specialchars.h"
 #include "util.h"
 
+namespace
+{
+	/// serials are shared by all stories, so that a serial never matches a copy
+	quint64 nextEditSerial = 1;
+
+	/// number of changes kept for mapRange()
+	const int maxRecordedEdits = 256;
+}
+
 ScText_Shared::ScText_Shared(const StyleContext* pstyles) :
-	pstyleContext(nullptr)
+	pstyleContext(nullptr),
+	m_editSerial(nextEditSerial++)
 {
 	pstyleContext.setDefaultStyle( & defaultStyle );
 	defaultStyle.setContext( pstyles );
@@ -26,44 +39,40 @@ ScText_Shared::ScText_Shared(const StyleContext* pstyles) :
 //		defaultStyle.charStyle().setContext( cstyles );
 //		qDebug() << QString("ScText_Shared() %1 %2 %3 %4").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&defaultStyle)).arg(reinterpret_cast<uint>(pstyles)).arg(reinterpret_cast<uint>(cstyles));
 }
-		
+
 
 ScText_Shared::ScText_Shared(const ScText_Shared& other) :
-	defaultStyle(other.defaultStyle), 
+	defaultStyle(other.defaultStyle),
 	pstyleContext(other.pstyleContext),
 	cursorPosition(other.cursorPosition),
 	selFirst(other.selFirst), selLast(other.selLast),
 	marksCount(other.marksCount), marksCountChanged(other.marksCountChanged),
-	trailingStyle(other.trailingStyle)
+	trailingStyle(other.trailingStyle),
+	m_editSerial(nextEditSerial++)
 {
 	pstyleContext.setDefaultStyle( &defaultStyle );
 	trailingStyle.setContext( &pstyleContext );
 	orphanedCharStyle.setContext( defaultStyle.charStyle().context() );
 
-	QListIterator<ScText*> it( other );
-	ScText* elem;
-	while ( it.hasNext() )
-	{
-		elem = it.next();
-		ScText* elem2 = new ScText(*elem);
-		append(elem2);
-		if (elem2->parstyle)
-		{
-			elem2->parstyle->setContext( & pstyleContext);
-//				elem2->parstyle->charStyle().setContext( defaultStyle.charStyleContext() );
-			replaceCharStyleContextInParagraph(count() - 1, elem2->parstyle->charStyleContext());
-		}
-	}
+	copyRuns(other);
 	len = count();
-	replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext() );
 //		qDebug() << QString("ScText_Shared(%2) %1").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 }
 
 void ScText_Shared::clear()
 {
-	while (!this->isEmpty())
-		delete this->takeFirst(); 
-	QList<ScText*>::clear();
+	recordEdit(0, count(), 0);
+	for (int i = 0; i < runs.count(); ++i)
+	{
+		delete runs[i].parstyle;
+		releaseStyle(runs[i].style);
+	}
+	runs.clear();
+	text.clear();
+	flags.clear();
+	m_lastRun.storeRelaxed(0);
+	assert(m_styleRefs.isEmpty());
+
 	cursorPosition = 0;
 	selFirst = 0;
 	selLast = -1;
@@ -72,9 +81,9 @@ void ScText_Shared::clear()
 	marksCount = 0;
 }
 
-ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other) 
+ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 {
-	if (this != &other) 
+	if (this != &other)
 	{
 		defaultStyle   = other.defaultStyle;
 		trailingStyle  = other.trailingStyle;
@@ -84,23 +93,7 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 		trailingStyle.setContext( &pstyleContext );
 		orphanedCharStyle.setContext( other.defaultStyle.charStyle().context() );
 		clear();
-		QListIterator<ScText*> it( other );
-		ScText* elem;
-		while ( it.hasNext() )
-		{
-			elem = it.next();
-			ScText* elem2 = new ScText(*elem);
-			append(elem2);
-			if (elem2->parstyle)
-			{
-				elem2->parstyle->setContext( & pstyleContext );
-//					qDebug() << QString("StoryText::copy: * %1 align=%2").arg(elem2->parstyle->parent())
-//						   .arg(elem2->parstyle->alignment())
-//						   .arg((uint)elem2->parstyle->context()));
-					//				elem2->parstyle->charStyle().setContext( defaultStyle.charStyleContext());
-				replaceCharStyleContextInParagraph(count()-1, elem2->parstyle->charStyleContext());
-			}
-		}
+		copyRuns(other);
 		len = count();
 		cursorPosition = other.cursorPosition;
 		selFirst = other.selFirst;
@@ -108,68 +101,434 @@ ScText_Shared& ScText_Shared::operator= (const ScText_Shared& other)
 		marksCount = other.marksCount;
 		marksCountChanged = other.marksCountChanged;
 		pstyleContext.invalidate();
+		m_edits.clear();
+		m_editSerial = nextEditSerial++;
 //			qDebug() << QString("StoryText::copy: %1 align=%2 %3").arg(trailingStyle.parentStyle()->name())
 //				   .arg(trailingStyle.alignment()).arg((uint)trailingStyle.context());
-		replaceCharStyleContextInParagraph(len,  trailingStyle.charStyleContext());
 	}
 //			qDebug() << QString("ScText_Shared: %1 = %2").arg(reinterpret_cast<uint>(this)).arg(reinterpret_cast<uint>(&other));
 	return *this;
 }
 
-ScText_Shared::~ScText_Shared() 
+ScText_Shared::~ScText_Shared()
 {
 //		qDebug() << QString("~ScText_Shared() %1").arg(reinterpret_cast<uint>(this));
-	while (!this->isEmpty())
-		delete this->takeFirst(); 
+	clear();
+}
+
+/**
+	Copies text and runs of other. Paragraph styles are duplicated and
+	char styles are interned again with the context of their copied
+	paragraph style.
+ */
+void ScText_Shared::copyRuns(const ScText_Shared& other)
+{
+	text = other.text;
+	flags = other.flags;
+	runs = other.runs;
+	m_lastRun.storeRelaxed(0);
+
+	const StyleContext* context = trailingStyle.charStyleContext();
+	for (int i = runs.count() - 1; i >= 0; --i)
+	{
+		ScTextRun& run = runs[i];
+		if (text.at(run.end() - 1) == SpecialChars::PARSEP)
+		{
+			if (run.parstyle)
+				run.parstyle = new ParagraphStyle(*run.parstyle);
+			else
+				run.parstyle = new ParagraphStyle();
+			run.parstyle->setContext( & pstyleContext);
+			context = run.parstyle->charStyleContext();
+		}
+		// unique marks must not be duplicated
+		if (run.mark && run.mark->isUnique())
+			run.mark = nullptr;
+		CharStyle style(*run.style);
+		style.setContext(context);
+		run.style = internStyle(style);
+	}
+}
+
+int ScText_Shared::runAt(int pos) const
+{
+	assert(pos >= 0);
+	assert(pos < count());
+
+	// layout and painting mostly access text sequentially
+	int lastRun = m_lastRun.loadRelaxed();
+	if (lastRun < runs.count())
+	{
+		const ScTextRun& last = runs.at(lastRun);
+		if (last.start <= pos && pos < last.end())
+			return lastRun;
+		if (lastRun + 1 < runs.count() && last.end() == pos)
+		{
+			m_lastRun.storeRelaxed(lastRun + 1);
+			return lastRun + 1;
+		}
+	}
+
+	QVector<ScTextRun>::const_iterator it;
+	it = std::upper_bound(runs.constBegin(), runs.constEnd(), pos,
+						  [](int p, const ScTextRun& run) { return p < run.start; });
+	lastRun = (it - runs.constBegin()) - 1;
+	m_lastRun.storeRelaxed(lastRun);
+	return lastRun;
+}
+
+ParagraphStyle* ScText_Shared::parstyle(int pos) const
+{
+	assert(text.at(pos) == SpecialChars::PARSEP);
+	return runs.at(runAt(pos)).parstyle;
+}
+
+void ScText_Shared::setParstyle(int pos, ParagraphStyle* pstyle)
+{
+	assert(text.at(pos) == SpecialChars::PARSEP);
+	ScTextRun& run = runs[runAt(pos)];
+	assert(run.end() == pos + 1);
+	if (run.parstyle != pstyle)
+		delete run.parstyle;
+	run.parstyle = pstyle;
+	recordEdit(pos, pos + 1, pos + 1);
+}
+
+int ScText_Shared::embedded(int pos) const
+{
+	if (text.at(pos) != SpecialChars::OBJECT)
+		return 0;
+	return runs.at(runAt(pos)).embedded;
+}
+
+void ScText_Shared::setEmbedded(int pos, int obj)
+{
+	assert(text.at(pos) == SpecialChars::OBJECT);
+	runs[runAt(pos)].embedded = obj;
+	recordEdit(pos, pos + 1, pos + 1);
+}
+
+Mark* ScText_Shared::mark(int pos) const
+{
+	if (text.at(pos) != SpecialChars::OBJECT)
+		return nullptr;
+	return runs.at(runAt(pos)).mark;
+}
+
+void ScText_Shared::setMark(int pos, Mark* mrk)
+{
+	assert(text.at(pos) == SpecialChars::OBJECT);
+	runs[runAt(pos)].mark = mrk;
+	recordEdit(pos, pos + 1, pos + 1);
+}
+
+void ScText_Shared::insertChars(int pos, const QString& txt, const CharStyle& style)
+{
+	assert(pos >= 0);
+	assert(pos <= count());
+
+	int txtLen = txt.length();
+	if (txtLen == 0)
+		return;
+	recordEdit(pos, pos, pos + txtLen);
+
+	int index = splitRun(pos);
+	const CharStyle* interned = internStyle(style);
+
+	auto makeRun = [pos, interned](int start, int length) {
+		ScTextRun run;
+		run.start = pos + start;
+		run.length = length;
+		run.style = interned;
+		return run;
+	};
+
+	// paragraph separators end a run, objects get a run of their own
+	QVector<ScTextRun> newRuns;
+	int runStart = 0;
+	for (int i = 0; i < txtLen; ++i)
+	{
+		QChar ch = txt.at(i);
+		if (ch == SpecialChars::OBJECT)
+		{
+			if (i > runStart)
+				newRuns.append(makeRun(runStart, i - runStart));
+			newRuns.append(makeRun(i, 1));
+			runStart = i + 1;
+		}
+		else if (ch == SpecialChars::PARSEP)
+		{
+			newRuns.append(makeRun(runStart, i + 1 - runStart));
+			runStart = i + 1;
+		}
+	}
+	if (runStart < txtLen)
+		newRuns.append(makeRun(runStart, txtLen - runStart));
+
+	shiftRuns(index, txtLen);
+	runs.insert(index, newRuns.count(), ScTextRun());
+	for (int i = 0; i < newRuns.count(); ++i)
+	{
+		runs[index + i] = newRuns.at(i);
+		retainStyle(interned);
+	}
+	releaseStyle(interned);
+
+	text.insert(pos, txt);
+	flags.insert(pos, txtLen, 0);
+	len = count();
+
+	mergeRuns(index - 1, index + newRuns.count());
+}
+
+void ScText_Shared::removeChars(int pos, int length)
+{
+	assert(pos >= 0);
+	assert(pos + length <= count());
+
+	if (length <= 0)
+		return;
+	recordEdit(pos, pos + length, pos);
+
+	int firstRun = splitRun(pos);
+	int lastRun = splitRun(pos + length);
+	for (int i = firstRun; i < lastRun; ++i)
+	{
+		delete runs[i].parstyle;
+		releaseStyle(runs[i].style);
+	}
+	runs.remove(firstRun, lastRun - firstRun);
+	shiftRuns(firstRun, -length);
+
+	text.remove(pos, length);
+	flags.remove(pos, length);
+	len = count();
+
+	mergeRuns(firstRun - 1, firstRun);
+}
+
+void ScText_Shared::replaceChar(int pos, QChar ch)
+{
+	assert(pos >= 0);
+	assert(pos < count());
+
+	recordEdit(pos, pos + 1, pos + 1);
+	int index = splitRun(pos);
+	splitRun(pos + 1);
+
+	QChar oldCh = text.at(pos);
+	text[pos] = ch;
+
+	ScTextRun& run = runs[index];
+	if (oldCh == SpecialChars::OBJECT && ch != SpecialChars::OBJECT)
+	{
+		run.embedded = 0;
+		run.mark = nullptr;
+	}
+	if (oldCh == SpecialChars::PARSEP && ch != SpecialChars::PARSEP)
+	{
+		delete run.parstyle;
+		run.parstyle = nullptr;
+	}
+	mergeRuns(index - 1, index + 1);
+}
+
+void ScText_Shared::setCharStyleContext(int pos, int length, const StyleContext* newContext)
+{
+	modifyCharStyles(pos, length, [newContext](CharStyle& style) { style.setContext(newContext); });
+}
+
+void ScText_Shared::recordEdit(int pos, int oldEnd, int newEnd)
+{
+	ScTextEdit edit;
+	edit.serial = nextEditSerial++;
+	edit.pos = pos;
+	edit.oldEnd = oldEnd;
+	edit.newEnd = newEnd;
+	if (m_edits.count() >= maxRecordedEdits)
+		m_edits.remove(0, maxRecordedEdits / 2);
+	m_edits.append(edit);
+	m_editSerial = edit.serial;
+}
+
+bool ScText_Shared::mapRange(quint64 serial, int& first, int& last) const
+{
+	if (serial == m_editSerial)
+		return true;
+
+	int i = m_edits.count() - 1;
+	while (i >= 0 && m_edits.at(i).serial != serial)
+		--i;
+	if (i < 0)
+		return false;
+
+	for (++i; i < m_edits.count(); ++i)
+	{
+		const ScTextEdit& edit = m_edits.at(i);
+		if (edit.pos > last)
+			continue;
+		if (edit.oldEnd >= first)
+			return false;
+		first += edit.newEnd - edit.oldEnd;
+		last += edit.newEnd - edit.oldEnd;
+	}
+	return true;
+}
+
+bool ScText_Shared::canMergeRuns(const ScTextRun& left, const ScTextRun& right) const
+{
+	if (left.style != right.style)
+		return false;
+	if (text.at(left.end() - 1) == SpecialChars::PARSEP)
+		return false;
+	return (text.at(left.start) != SpecialChars::OBJECT) && (text.at(right.start) != SpecialChars::OBJECT);
 }
 
 /**
-	A char's stylecontext is the containing paragraph's style, 
+	Merges neighbouring runs with indices in [firstRun, lastRun] if they
+	share the same style.
+ */
+void ScText_Shared::mergeRuns(int firstRun, int lastRun)
+{
+	int i = qMax(firstRun, 0);
+	lastRun = qMin(lastRun, runs.count() - 1);
+	while (i < lastRun)
+	{
+		ScTextRun& left = runs[i];
+		const ScTextRun& right = runs.at(i + 1);
+		if (!canMergeRuns(left, right))
+		{
+			++i;
+			continue;
+		}
+		left.length += right.length;
+		left.parstyle = right.parstyle;
+		releaseStyle(right.style);
+		runs.remove(i + 1);
+		--lastRun;
+	}
+	m_lastRun.storeRelaxed(qMin(m_lastRun.loadRelaxed(), qMax(runs.count() - 1, 0)));
+}
+
+void ScText_Shared::shiftRuns(int firstRun, int delta)
+{
+	for (int i = firstRun; i < runs.count(); ++i)
+		runs[i].start += delta;
+}
+
+int ScText_Shared::splitRun(int pos)
+{
+	if (pos >= count())
+		return runs.count();
+
+	int index = runAt(pos);
+	ScTextRun& run = runs[index];
+	if (run.start == pos)
+		return index;
+
+	ScTextRun tail;
+	tail.start = pos;
+	tail.length = run.end() - pos;
+	tail.style = run.style;
+	tail.parstyle = run.parstyle;
+	retainStyle(tail.style);
+
+	run.length = pos - run.start;
+	run.parstyle = nullptr;
+	runs.insert(index + 1, tail);
+	return index + 1;
+}
+
+/**
+	Only uses the context pointer and the parent name, so that styles whose
+	context already went away can still be released.
+ */
+uint ScText_Shared::styleHash(const CharStyle& style)
+{
+	return qHash(reinterpret_cast<quintptr>(style.context())) ^ qHash(style.parent());
+}
+
+const CharStyle* ScText_Shared::internStyle(const CharStyle& style)
+{
+	QList<CharStyle*>& bucket = m_styleBuckets[styleHash(style)];
+	for (int i = 0; i < bucket.count(); ++i)
+	{
+		CharStyle* candidate = bucket.at(i);
+		if (candidate->context() != style.context())
+			continue;
+		if (candidate->name() == style.name() && candidate->equiv(style))
+		{
+			++m_styleRefs[candidate];
+			return candidate;
+		}
+	}
+	CharStyle* interned = new CharStyle(style);
+	bucket.append(interned);
+	m_styleRefs.insert(interned, 1);
+	return interned;
+}
+
+void ScText_Shared::retainStyle(const CharStyle* style)
+{
+	assert(m_styleRefs.contains(style));
+	++m_styleRefs[style];
+}
+
+void ScText_Shared::releaseStyle(const CharStyle* style)
+{
+	QHash<const CharStyle*, uint>::iterator it = m_styleRefs.find(style);
+	assert(it != m_styleRefs.end());
+	if (--it.value() > 0)
+		return;
+	m_styleRefs.erase(it);
+
+	uint hash = styleHash(*style);
+	QList<CharStyle*>& bucket = m_styleBuckets[hash];
+	bucket.removeOne(const_cast<CharStyle*>(style));
+	if (bucket.isEmpty())
+		m_styleBuckets.remove(hash);
+	delete style;
+}
+
+/**
+	A char's stylecontext is the containing paragraph's style,
 	This routines makes sure that all charstyles look for defaults
 	in the parstyle first.
 	*/
 void ScText_Shared::replaceCharStyleContextInParagraph(int pos, const StyleContext* newContext)
 {
 	assert (pos >= 0);
-	assert (pos <= size());
-	
-	if (pos < size())
-		value(pos)->setContext(newContext);
-	for (int i = pos - 1; i >= 0; --i)
-	{
-		if ( (at(i)->ch) == SpecialChars::PARSEP)
-			break;
-		value(i)->setContext(newContext);
-	}
+	assert (pos <= count());
+
+	int start = pos;
+	while (start > 0 && text.at(start - 1) != SpecialChars::PARSEP)
+		--start;
+	setCharStyleContext(start, qMin(pos + 1, count()) - start, newContext);
+
 #ifndef NDEBUG // skip assertions if we aren't debugging
 	// we are done here but will do a sanity check:
 	// assert that all chars point to the following parstyle
-	QListIterator<ScText*> it( *this );
 	const StyleContext* lastContext = nullptr;
-	while ( it.hasNext() )
+	for (int i = 0; i < runs.count(); ++i)
 	{
-		ScText* elem = it.next();
-		assert( elem );
-		if ( elem->ch.isNull() ) 
-		{
-			// nothing, see code in removeParSep
-		}
-		else if (elem->ch == SpecialChars::PARSEP)
+		const ScTextRun& run = runs.at(i);
+		assert( run.style );
+		assert( i == 0 || run.start == runs.at(i - 1).end() );
+		if (text.at(run.end() - 1) == SpecialChars::PARSEP)
 		{
-			assert( elem->parstyle );
-			if ( lastContext )
-			{
-				assert( lastContext == elem->parstyle->charStyleContext() );
-			}
+			if (run.parstyle)
+				assert( run.style->context() == run.parstyle->charStyleContext() );
+			if (lastContext)
+				assert( lastContext == run.style->context() );
 			lastContext = nullptr;
 		}
 		else if (lastContext == nullptr)
 		{
-			lastContext = elem->context();
+			lastContext = run.style->context();
 		}
-		else 
+		else
 		{
-			assert( lastContext == elem->context() );
+			assert( lastContext == run.style->context() );
 		}
 	}
 	if ( lastContext )
@@ -1,9 +1,12 @@
 #ifndef SCTEXT_SHARED_H
 #define SCTEXT_SHARED_H
 
+#include <QAtomicInt>
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QString>
+#include <QVector>
 #include <cassert>
 
 //#include "text/paragraphlayout.h"
@@ -13,11 +16,46 @@
 #include "styles/paragraphstyle.h"
 #include "styles/stylecontextproxy.h"
 
+class Mark;
 
-class SCRIBUS_API ScText_Shared : public QList<ScText*>
+/**
+ * A run of consecutive characters sharing the same CharStyle.
+ *
+ * A paragraph separator always ends the run containing it, inline objects
+ * and marks always occupy a run of their own. The CharStyle is interned by
+ * the owning ScText_Shared and is shared by all runs using it, so it must
+ * never be modified in place.
+ */
+struct ScTextRun
+{
+	int start { 0 };
+	int length { 0 };
+	const CharStyle* style { nullptr };
+	ParagraphStyle* parstyle { nullptr }; // only for runs ending with a PARSEP
+	int embedded { 0 };                   // only for OBJECT runs
+	Mark* mark { nullptr };               // only for OBJECT runs
+
+	int end() const { return start + length; }
+};
+
+
+/**
+ * A recorded change of a story: the chars in [pos, oldEnd) were replaced by
+ * the chars now in [pos, newEnd). Style changes have oldEnd == newEnd.
+ */
+struct ScTextEdit
+{
+	quint64 serial { 0 };
+	int pos { 0 };
+	int oldEnd { 0 };
+	int newEnd { 0 };
+};
+
+
+class SCRIBUS_API ScText_Shared
 {
 public:
-	ScText_Shared(const StyleContext* pstyles);	
+	ScText_Shared(const StyleContext* pstyles);
 	ScText_Shared(const ScText_Shared& other);
 	~ScText_Shared();
 
@@ -35,14 +73,122 @@ public:
 	ParagraphStyle trailingStyle;
 	CharStyle orphanedCharStyle;
 
+	/// the characters of the story as one contiguous UTF-16 buffer
+	QString text;
+	/// per character LayoutFlags
+	QVector<uint> flags;
+	/// style runs, sorted by start position and covering the whole text
+	QVector<ScTextRun> runs;
+
+	int count() const { return text.length(); }
+	QChar charAt(int pos) const { return text.at(pos); }
+
+	/// index of the run containing pos
+	int runAt(int pos) const;
+	const CharStyle& charStyle(int pos) const { return *runs.at(runAt(pos)).style; }
+
+	ParagraphStyle* parstyle(int pos) const;
+	/// takes ownership of pstyle and deletes the previous paragraph style at pos
+	void setParstyle(int pos, ParagraphStyle* pstyle);
+	int  embedded(int pos) const;
+	void setEmbedded(int pos, int obj);
+	Mark* mark(int pos) const;
+	void setMark(int pos, Mark* mrk);
+
 	void clear();
-	
+
+	/// inserts txt at pos, the new chars get style (including its context)
+	void insertChars(int pos, const QString& txt, const CharStyle& style);
+	void removeChars(int pos, int length);
+	void replaceChar(int pos, QChar ch);
+
 	/**
-	   A char's stylecontext is the containing paragraph's style, 
+	   Calls modify() on a copy of each distinct CharStyle in the range and
+	   replaces the run styles with the interned results.
+	 */
+	template<typename Modifier>
+	void modifyCharStyles(int pos, int length, Modifier modify);
+	void setCharStyleContext(int pos, int length, const StyleContext* newContext);
+
+	/// number of distinct interned char styles
+	int stylesCount() const { return m_styleRefs.count(); }
+
+	/// serial of the last change, unique among all stories
+	quint64 editSerial() const { return m_editSerial; }
+	/// records a change of the chars in [pos, oldEnd) which now occupy [pos, newEnd)
+	void recordEdit(int pos, int oldEnd, int newEnd);
+	/**
+	   Moves the char range [first, last] along with the changes done since
+	   the change with the given serial. Returns false if one of these changes
+	   touched the range or if they are not known any longer.
+	 */
+	bool mapRange(quint64 serial, int& first, int& last) const;
+
+	/**
+	   A char's stylecontext is the containing paragraph's style,
        This routines makes sure that all charstyles look for defaults
 	   in the parstyle first.
 	 */
 	void replaceCharStyleContextInParagraph(int pos, const StyleContext* newContext);
+
+private:
+	/// run of the last lookup, text is read from several threads during pre-shaping
+	mutable QAtomicInt m_lastRun { 0 };
+	QHash<uint, QList<CharStyle*> > m_styleBuckets;
+	QHash<const CharStyle*, uint> m_styleRefs;
+	quint64 m_editSerial { 0 };
+	/// the most recent changes, oldest first
+	QVector<ScTextEdit> m_edits;
+
+	void copyRuns(const ScText_Shared& other);
+	bool canMergeRuns(const ScTextRun& left, const ScTextRun& right) const;
+	void mergeRuns(int firstRun, int lastRun);
+	void shiftRuns(int firstRun, int delta);
+	/// makes sure a run starts at pos and returns its index
+	int  splitRun(int pos);
+
+	static uint styleHash(const CharStyle& style);
+	const CharStyle* internStyle(const CharStyle& style);
+	void retainStyle(const CharStyle* style);
+	void releaseStyle(const CharStyle* style);
 };
 
+
+template<typename Modifier>
+void ScText_Shared::modifyCharStyles(int pos, int length, Modifier modify)
+{
+	if (length <= 0)
+		return;
+	recordEdit(pos, pos + length, pos + length);
+	int firstRun = splitRun(pos);
+	int lastRun = splitRun(pos + length);
+
+	// old styles are released last, so modify() may still refer to them
+	QHash<const CharStyle*, const CharStyle*> replaced;
+	QVector<const CharStyle*> oldStyles;
+	oldStyles.reserve(lastRun - firstRun);
+	for (int i = firstRun; i < lastRun; ++i)
+	{
+		ScTextRun& run = runs[i];
+		const CharStyle* newStyle = replaced.value(run.style, nullptr);
+		if (!newStyle)
+		{
+			CharStyle style(*run.style);
+			modify(style);
+			newStyle = internStyle(style);
+			replaced.insert(run.style, newStyle);
+		}
+		retainStyle(newStyle);
+		oldStyles.append(run.style);
+		run.style = newStyle;
+	}
+	mergeRuns(firstRun - 1, lastRun);
+
+	for (int i = 0; i < oldStyles.count(); ++i)
+		releaseStyle(oldStyles.at(i));
+	QHash<const CharStyle*, const CharStyle*>::const_iterator it;
+	for (it = replaced.constBegin(); it != replaced.constEnd(); ++it)
+		releaseStyle(it.value());
+}
+
 #endif /*SCTEXT_SHARED_H*/
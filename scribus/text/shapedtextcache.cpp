@@ -5,88 +5,343 @@
  for which a new license (GPL+exception) is in place.
  */
 
+#include <utility>
+
+#include <QAtomicInt>
+#include <QCache>
+#include <QHash>
+#include <QList>
+#include <QSemaphore>
+#include <QString>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+
 #include "shapedtextcache.h"
 
-#include "index.h"
+#include "fonts/scface.h"
+#include "itextsource.h"
 #include "shapedtext.h"
+#include "styles/charstyle.h"
+#include "styles/paragraphstyle.h"
+#include "textshaper.h"
 
 
-class ShapedTextCacheImplementation {
-	
-	IndexedList<ShapedText> m_cache;
-	
-	
-public:
-	
-	// check if all ShapedText in the cache for this range are valid, i.e. source() != nullptr
-	bool contains(int charPos, uint len) const
+namespace
+{
+	/// maximum number of cached glyph clusters
+	const int maxCachedClusters = 200000;
+	/// number of chars preShape() looks ahead
+	const int preShapeChars = 16384;
+	/// fewer uncached chars are left to the layout
+	const int minPreShapeChars = 4096;
+
+	/// the char style attributes used by TextShaper for a run of chars
+	struct ShapingRun
 	{
-		int last = charPos + len - 1;
-		if (!m_cache.containsPosition(charPos) || !m_cache.containsPosition(last))
-			return false;
-		
-		ShapedText st = m_cache(charPos);
-		while (st.isValid() && st.lastChar() < last)
+		explicit ShapingRun(const CharStyle& style) :
+			font(style.font()),
+			fontSize(style.fontSize()),
+			scaleH(style.scaleH()),
+			scaleV(style.scaleV()),
+			wordTracking(style.wordTracking()),
+			language(style.language()),
+			fontVariant(style.fontVariant()),
+			fontFeatures(style.fontFeatures()),
+			effects(style.effects() & ScStyle_UserStyles)
+		{}
+
+		bool sameAttributes(const ShapingRun& other) const
+		{
+			return font == other.font && fontSize == other.fontSize
+				&& scaleH == other.scaleH && scaleV == other.scaleV
+				&& wordTracking == other.wordTracking && language == other.language
+				&& fontVariant == other.fontVariant && fontFeatures == other.fontFeatures
+				&& effects == other.effects;
+		}
+
+		bool operator==(const ShapingRun& other) const
 		{
-			st = m_cache(st.lastChar() + 1);
+			return length == other.length && sameAttributes(other);
 		}
-		
-		return st.isValid();
+
+		int length { 0 };
+		ScFace font;
+		double fontSize;
+		double scaleH;
+		double scaleV;
+		double wordTracking;
+		QString language;
+		QString fontVariant;
+		QString fontFeatures;
+		int effects;
+	};
+
+	struct ShapingKey
+	{
+		QString text;
+		QVector<int> flags;
+		// TextShaper looks at the chars next to the block for spacing and breaks
+		QChar before;
+		QChar after;
+		int direction { 0 };
+		QVector<ShapingRun> runs;
+		size_t hash { 0 };
+
+		bool operator==(const ShapingKey& other) const
+		{
+			return hash == other.hash && text == other.text && before == other.before
+				&& after == other.after && direction == other.direction
+				&& flags == other.flags && runs == other.runs;
+		}
+	};
+
+	size_t qHash(const ShapingKey& key, size_t seed = 0)
+	{
+		return key.hash ^ seed;
 	}
-	
-	
-	ShapedText get(int charPos, uint minLen) const
+
+	/// shaped glyphs and the position they were shaped at
+	struct CacheEntry
 	{
-		int last = charPos + minLen - 1;
-		if (!m_cache.containsPosition(charPos) || !m_cache.containsPosition(last))
-			return ShapedText::Invalid;
+		QList<GlyphCluster> glyphs;
+		int firstChar { 0 };
+	};
 
-		ShapedText result = m_cache(charPos);
-		if (!result.isValid())
-			return ShapedText::Invalid;
-		
-		if (!m_cache.isExactPosition(charPos))
+	/// a block shaped by preShape()
+	struct PendingBlock
+	{
+		int fromChar { 0 };
+		int toChar { 0 };
+		ShapingKey key;
+		bool shaped { false };
+		QList<GlyphCluster> glyphs;
+	};
+
+	/// shapes the blocks taken from nextBlock until none is left
+	void shapeBlocks(TextShaper& shaper, PendingBlock* blocks, int count, QAtomicInt& nextBlock)
+	{
+		for (int i = nextBlock.fetchAndAddRelaxed(1); i < count; i = nextBlock.fetchAndAddRelaxed(1))
 		{
-			result = result.split(charPos);
+			PendingBlock& block = blocks[i];
+			ShapedText shaped = shaper.shape(block.fromChar, block.toChar);
+			if (!shaped.isValid() || shaped.needsContext())
+				continue;
+			block.glyphs = shaped.glyphs();
+			block.shaped = true;
 		}
-		while (result.lastChar() < last)
+	}
+}
+
+
+class ShapedTextCacheImplementation {
+
+	QCache<ShapingKey, CacheEntry> m_cache;
+	int m_hits { 0 };
+	int m_misses { 0 };
+
+public:
+
+	ShapedTextCacheImplementation() : m_cache(maxCachedClusters) {}
+
+	ShapedText get(const ITextSource& story, int fromChar, int toChar, const ITextContext* context)
+	{
+		ShapingKey key;
+		const CacheEntry* entry = nullptr;
+		if (makeKey(story, fromChar, toChar, key))
+			entry = m_cache.object(key);
+		if (entry == nullptr)
 		{
-			ShapedText st = m_cache(result.lastChar() + 1);
-			if (st.source() == nullptr || !result.canCombine(st))
-				return ShapedText::Invalid;
-			result.combine(st);
+			++m_misses;
+			return ShapedText::Invalid;
+		}
+		++m_hits;
+
+		// glyph clusters refer to their chars and to the char styles of the story they were shaped for
+		ShapedText result(&story, fromChar, toChar, context);
+		QList<GlyphCluster>& glyphs = result.glyphs();
+		glyphs = entry->glyphs;
+		int delta = fromChar - entry->firstChar;
+		for (int i = 0; i < glyphs.count(); ++i)
+		{
+			GlyphCluster& cluster = glyphs[i];
+			cluster.shiftChars(delta);
+			cluster.setStyle(&story.charStyle(cluster.firstChar()));
 		}
 		return result;
 	}
-	
-	
-	void put(const ShapedText& txt)
+
+	void put(const ITextSource& story, int fromChar, int toChar, const ShapedText& txt)
 	{
-		int first = txt.firstChar();
-		int len = txt.lastChar() + 1 - first;
-		
-		m_cache.replace(first, len , txt);
+		if (!txt.isValid() || txt.needsContext())
+			return;
+		ShapingKey key;
+		if (!makeKey(story, fromChar, toChar, key))
+			return;
+		CacheEntry* entry = new CacheEntry();
+		entry->glyphs = txt.glyphs();
+		entry->firstChar = fromChar;
+		m_cache.insert(key, entry, qMax(1, entry->glyphs.count()));
 	}
-	
-	void clear(int charPos, uint len)
+
+	void clear()
 	{
-		put(ShapedText(nullptr, charPos, charPos + len - 1));
+		m_cache.clear();
+	}
+
+	void preShape(ITextSource& story, int firstChar)
+	{
+		const int threadCount = QThread::idealThreadCount();
+		if (threadCount < 2)
+			return;
+
+		// Making the keys also brings all char and paragraph styles up to date,
+		// the workers only read them.
+		QVector<PendingBlock> blocks;
+		int pendingChars = 0;
+		const int lastChar = qMin(story.length(), firstChar + preShapeChars);
+		for (int pos = firstChar; pos < lastChar; )
+		{
+			int next = story.nextBlockStart(pos);
+			PendingBlock block;
+			block.fromChar = pos;
+			block.toChar = next;
+			if (makeKey(story, pos, next, block.key) && !m_cache.contains(block.key))
+			{
+				pendingChars += next - pos;
+				blocks.append(block);
+			}
+			pos = next;
+		}
+		if (blocks.count() < 2 || pendingChars < minPreShapeChars)
+			return;
+
+		// Workers get their own fonts. This thread helps with the shared ones,
+		// so nothing is lost if the pool is busy.
+		PendingBlock* pending = blocks.data();
+		const int count = blocks.count();
+		QAtomicInt nextBlock(0);
+		QSemaphore finished;
+		int workers = 0;
+		for (int i = 1; i < qMin(threadCount, count); ++i)
+		{
+			bool started = QThreadPool::globalInstance()->tryStart([&story, pending, count, &nextBlock, &finished]()
+			{
+				ThreadFonts fonts;
+				TextShaper shaper(nullptr, story, 0);
+				shaper.setThreadFonts(&fonts);
+				shapeBlocks(shaper, pending, count, nextBlock);
+				finished.release();
+			});
+			if (!started)
+				break;
+			++workers;
+		}
+		TextShaper shaper(nullptr, story, 0);
+		shapeBlocks(shaper, pending, count, nextBlock);
+		finished.acquire(workers);
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (!pending[i].shaped)
+				continue;
+			CacheEntry* entry = new CacheEntry();
+			entry->glyphs = pending[i].glyphs;
+			entry->firstChar = pending[i].fromChar;
+			m_cache.insert(pending[i].key, entry, qMax(1, entry->glyphs.count()));
+		}
 	}
 
-	
+	int hits() const { return m_hits; }
+	int misses() const { return m_misses; }
+	int count() const { return m_cache.count(); }
+
+	void resetCounters()
+	{
+		m_hits = 0;
+		m_misses = 0;
+	}
+
+private:
+
+	// returns false if the block cannot be cached
+	static bool makeKey(const ITextSource& story, int fromChar, int toChar, ShapingKey& key)
+	{
+		if (toChar > story.length() || toChar < 0)
+			toChar = story.length();
+		if (fromChar >= toChar)
+			return false;
+
+		key.text = story.text(fromChar, toChar - fromChar);
+		key.before = (fromChar > 0) ? story.text(fromChar - 1) : QChar();
+		key.after = (toChar < story.length()) ? story.text(toChar) : QChar();
+		key.direction = static_cast<int>(story.paragraphStyle(fromChar).direction());
+		key.flags.resize(toChar - fromChar);
+
+		const CharStyle* lastStyle = nullptr;
+		for (int i = fromChar; i < toChar; ++i)
+		{
+			if (story.hasObject(i) || story.hasExpansionPoint(i))
+				return false;
+			// TextShaper changes the char style of paragraph effects
+			if (story.isBlockStart(i))
+			{
+				const ParagraphStyle& pstyle = story.paragraphStyle(i);
+				if (pstyle.hasDropCap() || pstyle.hasBullet() || pstyle.hasNum() || !pstyle.peCharStyleName().isEmpty())
+					return false;
+			}
+			key.flags[i - fromChar] = story.flags(i);
+
+			const CharStyle& style = story.charStyle(i);
+			if (&style != lastStyle)
+			{
+				lastStyle = &style;
+				ShapingRun run(style);
+				if (key.runs.isEmpty() || !key.runs.last().sameAttributes(run))
+					key.runs.append(run);
+			}
+			++key.runs.last().length;
+		}
+
+		size_t hash = ::qHash(key.text);
+		hash = qHashMulti(hash, key.before, key.after, key.direction);
+		hash = qHashRange(key.flags.constBegin(), key.flags.constEnd(), hash);
+		for (const ShapingRun& run : std::as_const(key.runs))
+			hash = qHashMulti(hash, run.length, run.font.scName(), run.fontSize, run.effects);
+		key.hash = hash;
+		return true;
+	}
 };
 
 
 ShapedTextCache::ShapedTextCache() : p_impl(new ShapedTextCacheImplementation()) {}
 
-bool ShapedTextCache::contains(int charPos, uint len) const
-{ return p_impl->contains(charPos, len); }
+ShapedTextCache& ShapedTextCache::instance()
+{
+	static ShapedTextCache instance;
+	return instance;
+}
+
+ShapedText ShapedTextCache::get(const ITextSource& story, int fromChar, int toChar, const ITextContext* context)
+{ return p_impl->get(story, fromChar, toChar, context); }
+
+void ShapedTextCache::put(const ITextSource& story, int fromChar, int toChar, const ShapedText& txt)
+{ p_impl->put(story, fromChar, toChar, txt); }
+
+void ShapedTextCache::clear()
+{ p_impl->clear(); }
+
+void ShapedTextCache::preShape(ITextSource& story, int firstChar)
+{ p_impl->preShape(story, firstChar); }
+
+int ShapedTextCache::hits() const
+{ return p_impl->hits(); }
 
-ShapedText ShapedTextCache::get(int charPos, uint minLen) const
-{ return p_impl->get(charPos, minLen); }
+int ShapedTextCache::misses() const
+{ return p_impl->misses(); }
 
-void ShapedTextCache::put(const ShapedText& txt)
-{ p_impl->put(txt); }
+void ShapedTextCache::resetCounters()
+{ p_impl->resetCounters(); }
 
-void ShapedTextCache::clear(int charPos, uint len)
-{ p_impl->clear(charPos, len); }
+int ShapedTextCache::count() const
+{ return p_impl->count(); }
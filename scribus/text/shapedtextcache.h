@@ -8,46 +8,71 @@
 #ifndef SHAPEDTEXTCACHE_H
 #define SHAPEDTEXTCACHE_H
 
-#include <QRectF>
-#include <QString>
 #include <QSharedPointer>
 
 #include "scribusapi.h"
 
-class CharStyle;
-class ParagraphStyle;
-struct TypoPrefs;
-class InlineFrame;
-class ExpansionPoint;
-class PageItem;
+class ITextContext;
+class ITextSource;
 class ShapedText;
 
 /**
- * This class is used to store instances of ShapedText. It can also return segments or combinations
+ * This class is used to store instances of ShapedText. Entries are found by the
+ * content of the shaped text, not by its position, so they stay valid when text
+ * in front of them changes and are shared by identical text blocks.
  */
 class SCRIBUS_API IShapedTextCache {
 
 public:
-	virtual bool contains(int charPos, uint len = 1) const = 0;
-	virtual ShapedText get(int charPos, uint minLen = 1) const = 0;
-	virtual void put(const ShapedText& txt) = 0;
-	virtual void clear(int charPos = 0, uint len = -1) = 0;
+	virtual ~IShapedTextCache() = default;
+
+	/// Returns the cached shaping of the chars [fromChar, toChar) of story or ShapedText::Invalid.
+	virtual ShapedText get(const ITextSource& story, int fromChar, int toChar, const ITextContext* context) = 0;
+	/// Stores the shaping of the chars [fromChar, toChar) of story if it does not depend on the text frame.
+	virtual void put(const ITextSource& story, int fromChar, int toChar, const ShapedText& txt) = 0;
+	virtual void clear() = 0;
 };
 
 
 class ShapedTextCacheImplementation;
 
 
+/**
+ * Application wide cache of shaped text blocks, usually paragraphs.
+ *
+ * The key is made of the text, its layout flags, the neighbouring chars and the
+ * style attributes used by TextShaper for each style run. Text which needs its
+ * frame for shaping (inline objects, page numbers, superscript, ...) and blocks
+ * starting with drop caps, bullets or numbers are never cached.
+ */
 class SCRIBUS_API ShapedTextCache : public IShapedTextCache
 {
 	QSharedPointer<ShapedTextCacheImplementation> p_impl;
-	
+
 public:
 	ShapedTextCache();
-	bool contains(int charPos, uint len = 1) const;
-	ShapedText get(int charPos, uint minLen = 1) const;
-	void put(const ShapedText& txt);
-	void clear(int charPos = 0, uint len = -1);
+
+	static ShapedTextCache& instance();
+
+	ShapedText get(const ITextSource& story, int fromChar, int toChar, const ITextContext* context) override;
+	void put(const ITextSource& story, int fromChar, int toChar, const ShapedText& txt) override;
+	void clear() override;
+
+	/**
+	 * Shapes the uncached blocks of story in the next few thousand chars from
+	 * firstChar on a thread pool and stores them. Called before line breaking,
+	 * so that long stories are shaped on all cores. The cache itself is only
+	 * used by the calling thread.
+	 */
+	void preShape(ITextSource& story, int firstChar);
+
+	/// Number of get() calls answered from the cache
+	int hits() const;
+	/// Number of get() calls which needed shaping
+	int misses() const;
+	void resetCounters();
+	/// Number of cached text blocks
+	int count() const;
 };
 
 
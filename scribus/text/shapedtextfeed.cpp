@@ -22,7 +22,7 @@ static bool visualGlyphRunComp(const GlyphCluster &r1, const GlyphCluster &r2)
 
 ShapedTextFeed::ShapedTextFeed(ITextSource* source, int firstChar, ITextContext* context, IShapedTextCache* cache) :
     m_textSource(source),
-//    m_context(context),
+    m_context(context),
 	m_cache(cache),
     m_shaper(context, *source, firstChar),
 	m_endChar(firstChar)
@@ -53,12 +53,12 @@ ShapedText ShapedTextFeed::getMore(int fromChar, int toChar)
 {
 	if (m_cache != nullptr)
 	{
-		int len = toChar - fromChar;
-		if (!m_cache->contains(fromChar, len))
-		{
-			m_cache->put(m_shaper.shape(fromChar, toChar));
-		}
-		return m_cache->get(fromChar, len);
+		ShapedText cached = m_cache->get(*m_textSource, fromChar, toChar, m_context);
+		if (cached.isValid())
+			return cached;
+		ShapedText shaped = m_shaper.shape(fromChar, toChar);
+		m_cache->put(*m_textSource, fromChar, toChar, shaped);
+		return shaped;
 	}
 	return m_shaper.shape(fromChar, toChar);
 }
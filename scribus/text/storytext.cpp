@@ -39,7 +39,6 @@ pageitem.cpp  -  description
 #include "desaxe/saxiohelper.h"
 #include "desaxe/digester.h"
 #include "desaxe/simple_actions.h"
-#include "shapedtextcache.h"
 
 using namespace icu;
 
@@ -57,8 +56,6 @@ StoryText::StoryText(ScribusDoc * doc_) : m_doc(doc_)
 	d->selFirst = 0;
 	d->selLast = -1;
 	
-	m_shapedTextCache = new ShapedTextCache();
-	
 	d->len = 0;
 	invalidateAll();
 }
@@ -69,7 +66,6 @@ StoryText::StoryText() : m_doc(nullptr)
 
 	d->selFirst = 0;
 	d->selLast = -1;
-	m_shapedTextCache = nullptr;
 }
 
 StoryText::StoryText(const StoryText & other) : m_doc(other.m_doc)
@@ -85,7 +81,6 @@ StoryText::StoryText(const StoryText & other) : m_doc(other.m_doc)
 	
 	d->selFirst = 0;
 	d->selLast = -1;
-	m_shapedTextCache = nullptr;
 
 	invalidateLayout();
 }
@@ -116,7 +111,7 @@ bool StoryText::hasBulletOrNum() const
 	bool lastWasPARSEP = true;
 	for (int i = 0; i < length(); ++i)
 	{
-		lastWasPARSEP = (d->at(i)->ch == SpecialChars::PARSEP);
+		lastWasPARSEP = (d->charAt(i) == SpecialChars::PARSEP);
 		if (!lastWasPARSEP)
 			continue;
 		const ParagraphStyle& paraStyle = paragraphStyle(i);
@@ -370,7 +365,7 @@ int StoryText::indexOf(const QString &str, int from, Qt::CaseSensitivity cs, int
 			int index = 0;
 			while ((index < strLen) && ((index + i) < storyLen))
 			{
-				if (qStr.at(index) != d->at(index + i)->ch)
+				if (qStr.at(index) != d->charAt(index + i))
 					break;
 				++index;
 			}
@@ -396,7 +391,7 @@ int StoryText::indexOf(const QString &str, int from, Qt::CaseSensitivity cs, int
 			while ((index < strLen) && ((index + i + diacriticsCounter) < storyLen))
 			{
 				const QChar &qChar = qStr.at(index);
-				const QChar &curChar = d->at(index + diacriticsCounter + i)->ch;
+				const QChar &curChar = d->charAt(index + diacriticsCounter + i);
 				qCharIsDiacritic   = SpecialChars::isArabicModifierLetter(qChar.unicode()) || (qChar.category() == QChar::Mark_NonSpacing);
 				curCharIsDiacritic = SpecialChars::isArabicModifierLetter(curChar.unicode()) || (curChar.category() == QChar::Mark_NonSpacing);
 				if (qCharIsDiacritic || curCharIsDiacritic)
@@ -419,7 +414,7 @@ int StoryText::indexOf(const QString &str, int from, Qt::CaseSensitivity cs, int
 				foundIndex = i;
 				while ((index + i + diacriticsCounter) < storyLen)
 				{
-					const QChar &curChar = d->at(index + diacriticsCounter + i)->ch;
+					const QChar &curChar = d->charAt(index + diacriticsCounter + i);
 					if (!SpecialChars::isArabicModifierLetter(curChar.unicode()) && (curChar.category() != QChar::Mark_NonSpacing))
 						break;
 					++diacriticsCounter;
@@ -444,7 +439,7 @@ int StoryText::indexOf(QChar ch, int from, Qt::CaseSensitivity cs) const
 	{
 		for (int i = from; i < textLength; ++i)
 		{
-			if (d->at(i)->ch == ch)
+			if (d->charAt(i) == ch)
 			{
 				foundIndex = i;
 				break;
@@ -455,7 +450,7 @@ int StoryText::indexOf(QChar ch, int from, Qt::CaseSensitivity cs) const
 	{
 		for (int i = from; i < textLength; ++i)
 		{
-			if (d->at(i)->ch.toLower() == ch)
+			if (d->charAt(i).toLower() == ch)
 			{
 				foundIndex = i;
 				break;
@@ -513,14 +508,16 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
 		else if (other.text(i) == SpecialChars::OBJECT)
 		{
 			insertChars(pos, SpecialChars::OBJECT);
-			item(pos)->embedded = other.item(i)->embedded;
-			item(pos)->mark = other.item(i)->mark;
-			if (item(pos)->mark)
+			d->setEmbedded(pos, other.d->embedded(i));
+			d->setMark(pos, other.d->mark(i));
+			if (d->mark(pos))
 			{
 				d->marksCount++;
 				d->marksCountChanged = true;
 			}
 			applyCharStyle(pos, 1, other.charStyle(i));
+			if (d->mark(pos))
+				updateMarkCharStyle(pos);
 			cstyleStart = i+1;
 			++pos;
 		}
@@ -546,7 +543,9 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
 	}
 	if ((d->selLast >= d->selFirst) && (d->selFirst <= oldPos) && (oldPos <= d->selLast))
 		d->selLast += (length() - oldLen);
-	invalidate(pos, length());
+	// the inserted chars are already invalidated, only the paragraph they end in is left
+	int parSep = d->text.indexOf(SpecialChars::PARSEP, pos);
+	invalidate(pos, (parSep < 0) ? length() : parSep + 1);
 }
 
 
@@ -555,22 +554,23 @@ void StoryText::insert(int pos, const StoryText& other, bool onlySelection)
  */
 void StoryText::insertParSep(int pos)
 {
-	ScText* it = item(pos);
-	if (!it->parstyle)
+	ParagraphStyle* pstyle = d->parstyle(pos);
+	if (!pstyle)
 	{
-		it->parstyle = new ParagraphStyle(paragraphStyle(pos+1));
-		it->parstyle->setContext( & d->pstyleContext);
+		pstyle = new ParagraphStyle(paragraphStyle(pos+1));
+		pstyle->setContext( & d->pstyleContext);
+		d->setParstyle(pos, pstyle);
 		// #7432 : when inserting a paragraph separator, apply/erase the trailing Style
 		if (pos >= signed(d->len - 1))
 		{
 			applyStyle(pos, d->trailingStyle);
 			d->trailingStyle.erase();
 		}
-//		it->parstyle->setName("para"); // DON'T TRANSLATE
-//		it->parstyle->charStyle().setName("cpara"); // DON'T TRANSLATE
-//		it->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext() );
+//		pstyle->setName("para"); // DON'T TRANSLATE
+//		pstyle->charStyle().setName("cpara"); // DON'T TRANSLATE
+//		pstyle->charStyle().setContext( d->defaultStyle.charStyleContext() );
 	}
-	d->replaceCharStyleContextInParagraph(pos, it->parstyle->charStyleContext());
+	d->replaceCharStyleContextInParagraph(pos, pstyle->charStyleContext());
 }
 /**
      need to remove the ParagraphStyle structure and replace all pointers
@@ -578,19 +578,14 @@ void StoryText::insertParSep(int pos)
  */
 void StoryText::removeParSep(int pos)
 {
-	ScText* it = item(pos);
-	if (it->parstyle)
-	{
-//		const CharStyle* oldP = & it->parstyle->charStyle();
-//		const CharStyle* newP = & that->paragraphStyle(pos+1).charStyle();
-//		d->replaceParentStyle(pos, oldP, newP);
-		delete it->parstyle;
-		it->parstyle = nullptr;
-	}
-	// demote this parsep so the assert code in replaceCharStyleContextInParagraph()
-	// doesn't choke:
-	it->ch = QChar();
-	d->replaceCharStyleContextInParagraph(pos, paragraphStyle(pos+1).charStyleContext());
+	// the chars of this paragraph now look for defaults in the following
+	// paragraph, move them there before their old context goes away
+	int start = pos;
+	while (start > 0 && d->charAt(start - 1) != SpecialChars::PARSEP)
+		--start;
+	d->setCharStyleContext(start, pos + 1 - start, paragraphStyle(pos+1).charStyleContext());
+	// demote this parsep, this also deletes its ParagraphStyle
+	d->replaceChar(pos, QChar());
 }
 
 void StoryText::removeChars(int pos, uint len)
@@ -616,26 +611,33 @@ void StoryText::removeChars(int pos, uint len)
 			--lastChar;
 		d->orphanedCharStyle = charStyle(lastChar);
 	}
-	for (int i = pos + static_cast<int>(len) - 1; i >= pos; --i)
+	int endPos = pos + static_cast<int>(len);
+	for (int i = pos; i < endPos; ++i)
 	{
-		ScText *it = d->at(i);
-		if (it->ch == SpecialChars::PARSEP)
-			removeParSep(i);
-		if ((it->ch == SpecialChars::OBJECT) && (it->mark != nullptr))
+		if (d->mark(i) != nullptr)
 			d->marksCount--;
-		d->takeAt(i);
-		d->len--;
-		delete it;
-		// #9592 : adjust d->selFirst and d->selLast, those values have to be
-		// consistent in functions such as select()
-		if (i <= d->selLast)
-			--d->selLast;
-		if (i < d->selFirst)
-			--d->selFirst;
-		if (static_cast<uint>(i + 1) <= d->cursorPosition && d->cursorPosition > 0)
-			d->cursorPosition--;
 	}
 
+	// #9592 : adjust d->selFirst and d->selLast, those values have to be
+	// consistent in functions such as select()
+	if (d->selLast >= pos)
+		d->selLast -= qMin(d->selLast - pos + 1, static_cast<int>(len));
+	if (d->selFirst > pos)
+		d->selFirst -= qMin(d->selFirst - pos, static_cast<int>(len));
+	if (d->cursorPosition > static_cast<uint>(pos))
+		d->cursorPosition -= qMin(d->cursorPosition - pos, len);
+
+	// chars in front of a removed PARSEP join the paragraph following the removed range
+	int parSep = d->text.indexOf(SpecialChars::PARSEP, pos);
+	if (parSep >= 0 && parSep < endPos)
+	{
+		int start = pos;
+		while (start > 0 && d->charAt(start - 1) != SpecialChars::PARSEP)
+			--start;
+		d->setCharStyleContext(start, pos - start, paragraphStyle(endPos).charStyleContext());
+	}
+	d->removeChars(pos, len);
+
 	if (oldMarksCount != d->marksCount)
 		d->marksCountChanged = true;
 
@@ -646,7 +648,9 @@ void StoryText::removeChars(int pos, uint len)
 		d->selFirst =  0;
 		d->selLast  = -1;
 	}
-	invalidate(pos, length());
+	// following paragraphs are not affected, only the one the removed range was in
+	parSep = d->text.indexOf(SpecialChars::PARSEP, pos);
+	invalidate(pos, (parSep < 0) ? length() : parSep + 1);
 }
 
 void StoryText::trim()
@@ -657,8 +661,8 @@ void StoryText::trim()
 	int pos = length() - 1;
 	for (int i = length() - 1; i >= 0; --i)
 	{
-		const ScText *it = d->at(i);
-		if ((it->ch == SpecialChars::PARSEP) || (it->ch.isSpace()))
+		QChar ch = d->charAt(i);
+		if ((ch == SpecialChars::PARSEP) || (ch.isSpace()))
 		{
 			pos--;
 			posCount++;
@@ -693,29 +697,32 @@ void StoryText::insertChars(int pos, const QString& txt, bool applyNeighbourStyl
 	
 	const StyleContext* cStyleContext = paragraphStyle(pos).charStyleContext();
 
-	ScText clone;
+	CharStyle clone;
 	if (applyNeighbourStyle)
 	{
 		int referenceChar = qMax(0, qMin(pos, length()-1));
 		clone.applyCharStyle(charStyle(referenceChar));
 		clone.setEffects(ScStyle_Default);
 	}
+	clone.setContext(cStyleContext);
 
-	for (int i = 0; i < txt.length(); ++i)
+	// insert up to and including each PARSEP, so that its paragraph style
+	// is set up before the following chars are inserted
+	int segmentStart = 0;
+	while (segmentStart < txt.length())
 	{
-		ScText* item = new ScText(clone);
-		item->ch= txt.at(i);
-		item->setContext(cStyleContext);
-		d->insert(pos + i, item);
-		d->len++;
-		if (item->ch == SpecialChars::PARSEP)
+		int parSep = txt.indexOf(SpecialChars::PARSEP, segmentStart);
+		int segmentEnd = (parSep >= 0) ? parSep + 1 : txt.length();
+		d->insertChars(pos + segmentStart, txt.mid(segmentStart, segmentEnd - segmentStart), clone);
+		if (parSep >= 0)
 		{
 //			qDebug() << QString("new PARSEP %2 at %1").arg(pos).arg(paragraphStyle(pos).name());
-			insertParSep(pos + i);
+			insertParSep(pos + parSep);
 		}
-		if (d->cursorPosition >= static_cast<uint>(pos + i))
-			d->cursorPosition++;
+		segmentStart = segmentEnd;
 	}
+	if (d->cursorPosition >= static_cast<uint>(pos))
+		d->cursorPosition += txt.length();
 
 	d->len = d->count();
 	if ((d->selLast >= d->selFirst) && (d->selFirst <= pos) && (pos <= d->selLast))
@@ -733,54 +740,42 @@ void StoryText::insertCharsWithSoftHyphens(int pos, const QString& txt, bool app
 	
 	if (txt.length() == 0)
 		return;
-	
-	const StyleContext* cStyleContext = paragraphStyle(pos).charStyleContext();
-
-	ScText clone;
-	if (applyNeighbourStyle)
-	{
-		int referenceChar = qMax(0, qMin(pos, length() - 1));
-		clone.applyCharStyle(charStyle(referenceChar));
-		clone.setEffects(ScStyle_Default);
-	}
 
-	int inserted = 0;
+	QString chars;
+	QVector<int> hyphens;
+	chars.reserve(txt.length());
 	for (int i = 0; i < txt.length(); ++i) 
 	{
 		QChar ch = txt.at(i);
-		int  index  = pos + inserted;
-		bool insert = true; 
+		int  index  = pos + chars.length();
 		if (ch == SpecialChars::SHYPHEN && index > 0)
 		{
-			ScText* lastItem = this->item(index - 1);
 			// qreal SHY means user provided SHY, single SHY is automatic one
-			if (lastItem->effects() & ScStyle_HyphenationPossible)
-				lastItem->setEffects(lastItem->effects() & ~ScStyle_HyphenationPossible);
+			bool lastIsHyphen;
+			if (chars.isEmpty())
+				lastIsHyphen = hasFlag(index - 1, ScLayout_HyphenationPossible);
 			else
+				lastIsHyphen = !hyphens.isEmpty() && (hyphens.last() == chars.length() - 1);
+			if (lastIsHyphen)
 			{
-				lastItem->setEffects(lastItem->effects() | ScStyle_HyphenationPossible);
-				insert = false;
+				if (chars.isEmpty())
+					clearFlag(index - 1, ScLayout_HyphenationPossible);
+				else
+					hyphens.removeLast();
+				chars += ch;
 			}
+			else if (chars.isEmpty())
+				setFlag(index - 1, ScLayout_HyphenationPossible);
+			else
+				hyphens.append(chars.length() - 1);
+			continue;
 		}
-		if (insert)
-		{
-			ScText * item = new ScText(clone);
-			item->ch = ch;
-			item->setContext(cStyleContext);
-			d->insert(index, item);
-			d->len++;
-			if (item->ch == SpecialChars::PARSEP)
-				insertParSep(index);
-			if (d->cursorPosition >= static_cast<uint>(index))
-				d->cursorPosition++;
-			++inserted;
-		}
+		chars += ch;
 	}
 
-	d->len = d->count();
-	if ((d->selLast >= d->selFirst) && (d->selFirst <= pos) && (pos <= d->selLast))
-		d->selLast += inserted;
-	invalidate(pos, pos + inserted);
+	insertChars(pos, chars, applyNeighbourStyle);
+	for (int i = 0; i < hyphens.count(); ++i)
+		setFlag(pos + hyphens.at(i), ScLayout_HyphenationPossible);
 }
 
 void StoryText::replaceChar(int pos, QChar ch)
@@ -791,18 +786,18 @@ void StoryText::replaceChar(int pos, QChar ch)
 	assert(pos >= 0);
 	assert(pos < length());
 
-	ScText* item = d->at(pos);
-	if (item->ch == ch)
+	QChar oldCh = d->charAt(pos);
+	if (oldCh == ch)
 		return;
 
 	uint oldMarksCount = d->marksCount;
 	
-	if (item->ch == SpecialChars::PARSEP)
+	if (oldCh == SpecialChars::PARSEP)
 		removeParSep(pos);
-	if ((item->ch == SpecialChars::OBJECT) && (item->mark != nullptr))
+	if ((oldCh == SpecialChars::OBJECT) && (d->mark(pos) != nullptr))
 		d->marksCount--;
-	item->ch = ch;
-	if (d->at(pos)->ch == SpecialChars::PARSEP)
+	d->replaceChar(pos, ch);
+	if (ch == SpecialChars::PARSEP)
 		insertParSep(pos);
 
 	if (oldMarksCount != d->marksCount)
@@ -878,14 +873,14 @@ void StoryText::hyphenateWord(int pos, uint len, const char* hyphens)
 //	QString dump("");
 	for (int i = pos; i < pos + signed(len); ++i)
 	{
-//		dump += d->at(i)->ch;
+//		dump += d->charAt(i);
 		if (hyphens && hyphens[i-pos] & 1)
 		{
-			d->at(i)->setEffects(d->at(i)->effects() | ScStyle_HyphenationPossible);
+			d->flags[i] |= ScLayout_HyphenationPossible;
 //			dump += "-";
 		}
 		else {
-			d->at(i)->setEffects(d->at(i)->effects() & ~ScStyle_HyphenationPossible);
+			d->flags[i] &= ~ScLayout_HyphenationPossible;
 		}
 	}
 //	qDebug() << QString("st: %1").arg(dump);
@@ -903,7 +898,7 @@ void StoryText::insertObject(int pos, int ob)
 		pos += length()+1;
 
 	insertChars(pos, SpecialChars::OBJECT);
-	this->d->at(pos)->embedded = ob;
+	d->setEmbedded(pos, ob);
 	m_doc->FrameItems[ob]->isEmbedded = true;   // this might not be enough...
 	m_doc->FrameItems[ob]->OwnPage = -1; // #10379: OwnPage is not meaningful for inline object
 }
@@ -916,11 +911,12 @@ void StoryText::insertMark(Mark* mark, int pos)
 		pos = d->cursorPosition;
 
 	insertChars(pos, SpecialChars::OBJECT, false);
-	d->at(pos)->mark = mark;
+	d->setMark(pos, mark);
 	if (mark)
 	{
 		d->marksCount++;
 		d->marksCountChanged = true;
+		updateMarkCharStyle(pos);
 	}
 }
 
@@ -930,7 +926,7 @@ void StoryText::replaceObject(int pos, int ob)
 		pos += length()+1;
 
 	replaceChar(pos, SpecialChars::OBJECT);
-	this->d->at(pos)->embedded = ob;
+	d->setEmbedded(pos, ob);
 	m_doc->FrameItems[ob]->isEmbedded = true;   // this might not be enough...
 	m_doc->FrameItems[ob]->OwnPage = -1; // #10379: OwnPage is not meaningful for inline object
 }
@@ -954,7 +950,7 @@ QString StoryText::plainText() const
 
 	for (int i = 0; i < len; ++i)
 	{
-		ch = d->at(i)->ch;
+		ch = d->charAt(i);
 		if (ch == SpecialChars::PARSEP)
 			ch = QLatin1Char('\n');
 		result += ch;
@@ -977,7 +973,7 @@ QChar StoryText::text(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return d->at(pos)->ch;
+	return d->charAt(pos);
 }
 
 QString StoryText::text(int pos, uint len) const
@@ -990,7 +986,7 @@ QString StoryText::text(int pos, uint len) const
 
 	QString result;
 	for (int i = pos; i < pos + signed(len); ++i)
-		result += d->at(i)->ch;
+		result += d->charAt(i);
 
 	return result;
 }
@@ -1024,7 +1020,7 @@ InlineFrame StoryText::object(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return InlineFrame(d->at(pos)->embedded);
+	return InlineFrame(d->embedded(pos));
 }
 
 
@@ -1084,7 +1080,7 @@ QString StoryText::textWithSoftHyphens(int pos, uint len) const
 	len = qMin((uint) (length() - pos), len);
 	for (int i = pos; i < pos+signed(len); ++i)
 	{
-		if (this->charStyle(i).effects() & ScStyle_HyphenationPossible 
+		if (hasFlag(i, ScLayout_HyphenationPossible)
 			// duplicate SHYPHEN if already present to indicate a user provided SHYPHEN:
 			|| this->text(i) == SpecialChars::SHYPHEN)
 		{
@@ -1106,9 +1102,10 @@ bool StoryText::hasObject(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	if (d->at(pos)->ch == SpecialChars::OBJECT)
-		return d->at(pos)->hasObject(m_doc);
-	return false;
+	if (d->charAt(pos) != SpecialChars::OBJECT)
+		return false;
+	int embedded = d->embedded(pos);
+	return (embedded > 0) && m_doc->FrameItems.contains(embedded);
 }
 
 
@@ -1120,7 +1117,10 @@ PageItem* StoryText::getItem(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return d->at(pos)->getItem(m_doc);
+	int embedded = d->embedded(pos);
+	if ((embedded > 0) && m_doc->FrameItems.contains(embedded))
+		return m_doc->FrameItems[embedded];
+	return nullptr;
 }
 
 int StoryText::findMark(const Mark* mrk, int startPos) const
@@ -1130,9 +1130,9 @@ int StoryText::findMark(const Mark* mrk, int startPos) const
 	int len = d->len;
 	for (int i = startPos; i < len; ++i)
 	{
-		if (d->at(i)->ch != SpecialChars::OBJECT)
+		if (d->charAt(i) != SpecialChars::OBJECT)
 			continue;
-		if (d->at(i)->hasMark(mrk))
+		if (mrk == nullptr ? (d->mark(i) != nullptr) : (d->mark(i) == mrk))
 			return i;
 	}
 
@@ -1147,12 +1147,12 @@ int StoryText::findNote(const TextNote* textNote) const
 	int len = d->len;
 	for (int i = 0; i < len; ++i)
 	{
-		const ScText* textItem = d->at(i);
-		if (textItem->ch != SpecialChars::OBJECT || textItem->mark == nullptr)
+		if (d->charAt(i) != SpecialChars::OBJECT)
 			continue;
-		if (textItem->mark->getType() != MARKNoteFrameType)
+		const Mark* textMark = d->mark(i);
+		if (textMark == nullptr || textMark->getType() != MARKNoteFrameType)
 			continue;
-		if (textItem->mark->getNotePtr() == textNote)
+		if (textMark->getNotePtr() == textNote)
 			return i;
 	}
 
@@ -1167,9 +1167,11 @@ bool StoryText::hasMark(int pos, const Mark* mrk) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	if (d->at(pos)->ch == SpecialChars::OBJECT)
-		return d->at(pos)->hasMark(mrk);
-	return false;
+	if (d->charAt(pos) != SpecialChars::OBJECT)
+		return false;
+	if (mrk == nullptr)
+		return d->mark(pos) != nullptr;
+	return d->mark(pos) == mrk;
 }
 
 bool StoryText::hasMark(int pos, MarkType markType) const
@@ -1180,10 +1182,10 @@ bool StoryText::hasMark(int pos, MarkType markType) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	const ScText* textItem = d->at(pos);
-	if (textItem->ch != SpecialChars::OBJECT)
+	if (d->charAt(pos) != SpecialChars::OBJECT)
 		return false;
-	return (textItem->mark && textItem->mark->isType(markType));
+	const Mark* textMark = d->mark(pos);
+	return (textMark && textMark->isType(markType));
 }
 
 Mark* StoryText::mark(int pos) const
@@ -1194,7 +1196,7 @@ Mark* StoryText::mark(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return d->at(pos)->mark;
+	return d->mark(pos);
 }
 
 
@@ -1234,6 +1236,17 @@ void StoryText::applyMarkCharstyle(Mark* mrk, CharStyle& currStyle) const
 		currStyle.setFeatures(s.featureList());
 }
 
+void StoryText::updateMarkCharStyle(int pos)
+{
+	Mark* mrk = d->mark(pos);
+	if (mrk == nullptr)
+		return;
+	CharStyle markStyle(d->charStyle(pos));
+	applyMarkCharstyle(mrk, markStyle);
+	if (!markStyle.equiv(d->charStyle(pos)))
+		d->modifyCharStyles(pos, 1, [this, mrk](CharStyle& style) { applyMarkCharstyle(mrk, style); });
+}
+
 void StoryText::replaceMark(int pos, Mark* mrk)
 {
 	if (pos < 0)
@@ -1242,12 +1255,14 @@ void StoryText::replaceMark(int pos, Mark* mrk)
 	assert(pos >= 0);
 	assert(pos < length());
 
-	ScText* textItem = this->d->at(pos);
-	if (textItem->mark)
-		this->d->marksCount--;
-	this->d->at(pos)->mark = mrk;
-	if (textItem->mark)
-		this->d->marksCount++;
+	if (d->mark(pos))
+		d->marksCount--;
+	d->setMark(pos, mrk);
+	if (d->mark(pos))
+	{
+		d->marksCount++;
+		updateMarkCharStyle(pos);
+	}
 
 	// Set marksCountChanged unconditionally to force text relayout
 	d->marksCountChanged = true;
@@ -1272,7 +1287,7 @@ LayoutFlags StoryText::flags(int pos) const
 	assert(pos >= 0);
 	assert(pos < length());
 
-	return  static_cast<LayoutFlags>(d->at(pos)->effects().value & ScStyle_NonUserStyles);
+	return static_cast<LayoutFlags>(d->flags.at(pos));
 }
 
 bool StoryText::hasFlag(int pos, LayoutFlags flags) const
@@ -1284,7 +1299,7 @@ bool StoryText::hasFlag(int pos, LayoutFlags flags) const
 	assert(pos < length());
 	assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
-	return (flags & d->at(pos)->effects().value) == flags;
+	return (flags & d->flags.at(pos)) == flags;
 }
 
 void StoryText::setFlag(int pos, LayoutFlags flags)
@@ -1296,7 +1311,7 @@ void StoryText::setFlag(int pos, LayoutFlags flags)
 	assert(pos < length());
 	assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
-	d->at(pos)->setEffects(flags | d->at(pos)->effects().value);
+	d->flags[pos] |= flags;
 }
 
 void StoryText::clearFlag(int pos, LayoutFlags flags)
@@ -1306,8 +1321,9 @@ void StoryText::clearFlag(int pos, LayoutFlags flags)
 
 	assert(pos >= 0);
 	assert(pos < length());
+	assert((flags & ScStyle_UserStyles) == ScStyle_None);
 
-	d->at(pos)->setEffects(~(flags & ScStyle_NonUserStyles) & d->at(pos)->effects().value);
+	d->flags[pos] &= ~static_cast<uint>(flags);
 }
 
 
@@ -1338,15 +1354,8 @@ const CharStyle & StoryText::charStyle(int pos) const
 	if (text(pos) == SpecialChars::PARSEP)
 		return paragraphStyle(pos).charStyle();
 	
-	StoryText* that = const_cast<StoryText *>(this);
-
-	if (hasMark(pos))
-	{
-		Mark* mrk = mark(pos);
-		applyMarkCharstyle(mrk, *that->d->at(pos)); // hack to keep note charstyles current
-	}
-	
-	return dynamic_cast<const CharStyle &> (*that->d->at(pos));
+	// note marks get their char style when inserted and during layout
+	return d->charStyle(pos);
 }
 
 const ParagraphStyle & StoryText::paragraphStyle() const
@@ -1364,32 +1373,19 @@ const ParagraphStyle & StoryText::paragraphStyle(int pos) const
 
 	assert(d);
 	
-	StoryText * that = const_cast<StoryText *> (this);
-//	assert( that->at(pos)->cab >= 0 );
-//	assert( that->at(pos)->cab < doc->docParagraphStyles.count() );
-//	return doc->docParagraphStyles[that->at(pos)->cab];
-	
-	while (pos < length() && that->d->at(pos)->ch != SpecialChars::PARSEP)
-		++pos;
+	pos = d->text.indexOf(SpecialChars::PARSEP, pos);
+	if (pos < 0)
+		return d->trailingStyle;
 
-	if (pos >= length())
-		return that->d->trailingStyle;
-	if ( !that->d->at(pos)->parstyle )
+	ParagraphStyle* parstyle = d->parstyle(pos);
+	if (!parstyle)
 	{
-		ScText* current = that->d->at(pos);
 		qDebug("inserting default parstyle at %i", pos);
-		current->parstyle = new ParagraphStyle();
-		current->parstyle->setContext( & d->pstyleContext);
-//		current->parstyle->setName( "para(paragraphStyle)" ); // DON'T TRANSLATE
-//		current->parstyle->charStyle().setName( "cpara(paragraphStyle)" ); // DON'T TRANSLATE
-//		current->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext());
-	}
-	else
-	{
-//		qDebug() << QString("using parstyle at %1").arg(pos);
+		parstyle = new ParagraphStyle();
+		parstyle->setContext( & d->pstyleContext);
+		d->setParstyle(pos, parstyle);
 	}
-	assert (that->d->at(pos)->parstyle);
-	return *that->d->at(pos)->parstyle;
+	return *parstyle;
 }
 
 const ParagraphStyle& StoryText::defaultStyle() const
@@ -1431,25 +1427,11 @@ void StoryText::applyCharStyle(int pos, uint len, const CharStyle& style )
 	if (len == 0)
 		return;
 
-//	int lastParStart = pos == 0? 0 : -1;
-	ScText* itText;
-	for (uint i = pos; i < pos + len; ++i)
-	{
-		itText = d->at(i);
-		// #6165 : applying style on last character applies style on whole text on next open 
-		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr)
-			itText->parstyle->charStyle().applyCharStyle(style);*/
-		
-		// Does not work well, do not reenable before checking #9337, #9376 and #9428
-		// #9173 et. al.: move charstyle to parstyle if whole paragraph is affected
-		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr && lastParStart >= 0)
-		{
-			eraseCharStyle(lastParStart, i - lastParStart, style);
-			itText->parstyle->charStyle().applyCharStyle(style);
-			lastParStart = i + 1;
-		}*/
-		itText->applyCharStyle(style);
-	}
+	// #6165 : applying style on last character applies style on whole text on next open,
+	// so the charstyle of the paragraph style is left alone here
+	// #9173 et. al.: moving the charstyle to the parstyle if the whole paragraph is affected
+	// does not work well, do not reenable before checking #9337, #9376 and #9428
+	d->modifyCharStyles(pos, len, [&style](CharStyle& charStyle) { charStyle.applyCharStyle(style); });
 	// Does not work well, do not reenable before checking #9337, #9376 and #9428
 	/*if (pos + signed(len) == length() && lastParStart >= 0)
 	{
@@ -1473,15 +1455,16 @@ void StoryText::eraseCharStyle(int pos, uint len, const CharStyle& style )
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (uint i = pos; i < pos + len; ++i)
+	// FIXME?? see #6165 : should we really erase charstyle of paragraph style??
+	int parSep = d->text.indexOf(SpecialChars::PARSEP, pos);
+	while (parSep >= 0 && parSep < pos + signed(len))
 	{
-		itText = d->at(i);
-		// FIXME?? see #6165 : should we really erase charstyle of paragraph style??
-		if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr)
-			itText->parstyle->charStyle().eraseCharStyle(style);
-		itText->eraseCharStyle(style);
+		ParagraphStyle* parstyle = d->parstyle(parSep);
+		if (parstyle != nullptr)
+			parstyle->charStyle().eraseCharStyle(style);
+		parSep = d->text.indexOf(SpecialChars::PARSEP, parSep + 1);
 	}
+	d->modifyCharStyles(pos, len, [&style](CharStyle& charStyle) { charStyle.eraseCharStyle(style); });
 	// Does not work well, do not reenable before checking #9337, #9376 and #9428
 	/*if (pos + signed(len) == length())
 	{
@@ -1500,22 +1483,21 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	assert(pos <= length());
 
 	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP)
+	while (i < length() && d->charAt(i) != SpecialChars::PARSEP)
 		++i;
 
 	if (i < length())
 	{
-		if (!d->at(i)->parstyle)
+		ParagraphStyle* parstyle = d->parstyle(i);
+		if (!parstyle)
 		{
 			qDebug("PARSEP without style at pos %i", i);
-			d->at(i)->parstyle = new ParagraphStyle();
-			d->at(i)->parstyle->setContext( & d->pstyleContext);
-//			d->at(i)->parstyle->setName( "para(applyStyle)" ); // DON'T TRANSLATE
-//			d->at(i)->parstyle->charStyle().setName( "cpara(applyStyle)" ); // DON'T TRANSLATE
-//			d->at(i)->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext() );
+			parstyle = new ParagraphStyle();
+			parstyle->setContext( & d->pstyleContext);
+			d->setParstyle(i, parstyle);
 		}
 //		qDebug() << QString("applying parstyle %2 at %1 for %3").arg(i).arg(paragraphStyle(pos).name()).arg(pos);
-		d->at(i)->parstyle->applyStyle(style);
+		parstyle->applyStyle(style);
 	}
 	else
 	{
@@ -1525,12 +1507,11 @@ void StoryText::applyStyle(int pos, const ParagraphStyle& style, bool rmDirectFo
 	}
 	if (rmDirectFormatting)
 	{
-		--i;
-		while (i >= 0 && d->at(i)->ch != SpecialChars::PARSEP)
-		{
-			d->at(i)->eraseDirectFormatting();
-			--i;
-		}
+		int start = i;
+		while (start > 0 && d->charAt(start - 1) != SpecialChars::PARSEP)
+			--start;
+		d->modifyCharStyles(start, i - start, [](CharStyle& charStyle) { charStyle.eraseDirectFormatting(); });
+		i = start - 1;
 	}
 	invalidate(pos, qMin(i, length()));
 }
@@ -1544,22 +1525,21 @@ void StoryText::eraseStyle(int pos, const ParagraphStyle& style)
 	assert(pos <= length());
 		
 	int i = pos;
-	while (i < length() && d->at(i)->ch != SpecialChars::PARSEP)
+	while (i < length() && d->charAt(i) != SpecialChars::PARSEP)
 		++i;
 
 	if (i < length())
 	{
-		if (!d->at(i)->parstyle)
+		ParagraphStyle* parstyle = d->parstyle(i);
+		if (!parstyle)
 		{
 			qDebug("PARSEP without style at pos %i", i);
-			d->at(i)->parstyle = new ParagraphStyle();
-			d->at(i)->parstyle->setContext( & d->pstyleContext);
-//			d->at(i)->parstyle->setName( "para(eraseStyle)" ); // DON'T TRANSLATE
-//			d->at(i)->parstyle->charStyle().setName( "cpara(eraseStyle)" ); // DON'T TRANSLATE
-//			d->at(i)->parstyle->charStyle().setContext( d->defaultStyle.charStyleContext());
+			parstyle = new ParagraphStyle();
+			parstyle->setContext( & d->pstyleContext);
+			d->setParstyle(i, parstyle);
 		}
 		//		qDebug() << QString("applying parstyle %2 at %1 for %3").arg(i).arg(paragraphStyle(pos).name()).arg(pos);
-		d->at(i)->parstyle->eraseStyle(style);
+		parstyle->eraseStyle(style);
 	}
 	else {
 		// not happy about this but inserting a new PARSEP makes more trouble
@@ -1587,15 +1567,9 @@ void StoryText::setCharStyle(int pos, uint len, const CharStyle& style)
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (uint i = pos; i < pos + len; ++i)
-	{
-		itText = d->at(i);
-		// #6165 : applying style on last character applies style on whole text on next open 
-		/*if (itText->ch == SpecialChars::PARSEP && itText->parstyle != nullptr)
-			itText->parstyle->charStyle() = style;*/
-		itText->setStyle(style);
-	}
+	// #6165 : applying style on last character applies style on whole text on next open,
+	// so the charstyle of the paragraph style is left alone here
+	d->modifyCharStyles(pos, len, [&style](CharStyle& charStyle) { charStyle.setStyle(style); });
 	
 	invalidate(pos, pos + len);
 }
@@ -1633,14 +1607,21 @@ void StoryText::replaceNamedResources(ResourceCollection& newNames)
 	if (len == 0)
 		return;
 	
-	ScText* itText;
-	for (int i = 0; i < len; ++i)
+	auto replaceInCharStyle = [&newNames](CharStyle& charStyle) { charStyle.replaceNamedResources(newNames); };
+	int start = 0;
+	while (start < len)
 	{
-		itText = d->at(i);
-		if (itText->parstyle)
-			itText->parstyle->replaceNamedResources(newNames);
+		int parSep = d->text.indexOf(SpecialChars::PARSEP, start);
+		int end = (parSep >= 0) ? parSep : len;
+		d->modifyCharStyles(start, end - start, replaceInCharStyle);
+		if (parSep < 0)
+			break;
+		ParagraphStyle* parstyle = d->parstyle(parSep);
+		if (parstyle)
+			parstyle->replaceNamedResources(newNames);
 		else
-			itText->replaceNamedResources(newNames);
+			d->modifyCharStyles(parSep, 1, replaceInCharStyle);
+		start = parSep + 1;
 	}
 	
 	invalidate(0, len);	
@@ -1660,7 +1641,7 @@ void StoryText::fixLegacyFormatting()
 
 	for (int i = 0; i < length(); ++ i)
 	{
-		if (d->at(i)->ch == SpecialChars::PARSEP)
+		if (d->charAt(i) == SpecialChars::PARSEP)
 			fixLegacyFormatting(i);
 	}
 	fixLegacyFormatting( length() );
@@ -1678,7 +1659,7 @@ void StoryText::fixLegacyFormatting(int pos)
 	assert(pos <= length());
 
 	int i = pos;
-	while (i > 0 && d->at(i - 1)->ch != SpecialChars::PARSEP)
+	while (i > 0 && d->charAt(i - 1) != SpecialChars::PARSEP)
 		--i;
 
 	const ParagraphStyle& parStyle = this->paragraphStyle(pos);
@@ -1687,12 +1668,12 @@ void StoryText::fixLegacyFormatting(int pos)
 	if (parStyle.hasParent())
 	{
 		int start = i;
-		while ((i < length()) && (d->at(i)->ch != SpecialChars::PARSEP))
-		{
-			d->at(i)->validate();
-			d->at(i)->eraseCharStyle( parStyle.charStyle() );
+		while ((i < length()) && (d->charAt(i) != SpecialChars::PARSEP))
 			++i;
-		}
+		d->modifyCharStyles(start, i - start, [&parStyle](CharStyle& charStyle) {
+			charStyle.validate();
+			charStyle.eraseCharStyle( parStyle.charStyle() );
+		});
 		invalidate(start, qMin(i + 1, length()));
 	}
 }
@@ -1704,28 +1685,14 @@ uint StoryText::nrOfParagraph() const
 
 uint StoryText::nrOfParagraph(int pos) const
 {
-	uint result = 0;
-	bool lastWasPARSEP = true;
 	pos = qMin(pos, length());
-	for (int i = 0; i < pos; ++i)
-	{
-		lastWasPARSEP = d->at(i)->ch == SpecialChars::PARSEP;
-		if (lastWasPARSEP)
-			++result;
-	}
-	return result;
+	return QStringView(d->text).left(qMax(pos, 0)).count(SpecialChars::PARSEP);
 }
 
 uint StoryText::nrOfParagraphs() const
 {
-	uint result = 0;
-	bool lastWasPARSEP = true;
-	for (int i = 0; i < length(); ++i)
-	{
-		lastWasPARSEP = d->at(i)->ch == SpecialChars::PARSEP;
-		if (lastWasPARSEP)
-			++result;
-	}
+	uint result = d->text.count(SpecialChars::PARSEP);
+	bool lastWasPARSEP = (length() == 0) || (d->charAt(length() - 1) == SpecialChars::PARSEP);
 	return lastWasPARSEP ? result : result + 1;
 }
 
@@ -1739,10 +1706,12 @@ int StoryText::startOfParagraph(uint index) const
 	if (index == 0)
 		return 0;
 
-	for (int i = 0; i < length(); ++i)
+	int i = d->text.indexOf(SpecialChars::PARSEP);
+	while (i >= 0)
 	{
-		if (d->at(i)->ch == SpecialChars::PARSEP && ! --index)
+		if (! --index)
 			return i + 1;
+		i = d->text.indexOf(SpecialChars::PARSEP, i + 1);
 	}
 	return length();
 }
@@ -1755,27 +1724,33 @@ int StoryText::endOfParagraph() const
 int StoryText::endOfParagraph(uint index) const
 {
 	++index;
-	for (int i = 0; i < length(); ++i)
+	int i = d->text.indexOf(SpecialChars::PARSEP);
+	while (i >= 0)
 	{
-		if (d->at(i)->ch == SpecialChars::PARSEP && ! --index)
+		if (! --index)
 			return i;
+		i = d->text.indexOf(SpecialChars::PARSEP, i + 1);
 	}
 	return length();
 }
 
 uint StoryText::nrOfRuns() const
 {
-	return length();
+	return d->runs.count();
 }
 
 int StoryText::startOfRun(uint index) const
 {
-	return index;
+	if (index >= nrOfRuns())
+		return length();
+	return d->runs.at(index).start;
 }
 
 int StoryText::endOfRun(uint index) const
 {
-	return index + 1;
+	if (index >= nrOfRuns())
+		return length();
+	return d->runs.at(index).end();
 }
 
 // positioning. all positioning methods return char positions
@@ -2050,71 +2025,59 @@ void StoryText::fixSurrogateSelection()
 		d->selLast++;
 }
 
-BreakIterator* StoryText::m_graphemeIterator = nullptr;
+thread_local std::unique_ptr<BreakIterator> StoryText::m_graphemeIterator;
 
 BreakIterator* StoryText::getGraphemeIterator()
 {
 	UErrorCode status = U_ZERO_ERROR;
-	if (m_graphemeIterator == nullptr)
-		m_graphemeIterator = BreakIterator::createCharacterInstance(Locale(), status);
+	if (!m_graphemeIterator)
+		m_graphemeIterator.reset(BreakIterator::createCharacterInstance(Locale(), status));
 
 	if (U_FAILURE(status))
-	{
-		delete m_graphemeIterator;
-		m_graphemeIterator = nullptr;
-	}
+		m_graphemeIterator.reset();
 
-	return m_graphemeIterator;
+	return m_graphemeIterator.get();
 }
 
-BreakIterator* StoryText::m_wordIterator = nullptr;
+thread_local std::unique_ptr<BreakIterator> StoryText::m_wordIterator;
 
 BreakIterator* StoryText::getWordIterator()
 {
 	UErrorCode status = U_ZERO_ERROR;
-	if (m_wordIterator == nullptr)
-		m_wordIterator = BreakIterator::createWordInstance(Locale(), status);
+	if (!m_wordIterator)
+		m_wordIterator.reset(BreakIterator::createWordInstance(Locale(), status));
 
 	if (U_FAILURE(status))
-	{
-		delete m_wordIterator;
-		m_wordIterator = nullptr;
-	}
-	return m_wordIterator;
+		m_wordIterator.reset();
+	return m_wordIterator.get();
 }
 
-BreakIterator* StoryText::m_sentenceIterator = nullptr;
+thread_local std::unique_ptr<BreakIterator> StoryText::m_sentenceIterator;
 
 BreakIterator* StoryText::getSentenceIterator()
 {
 	UErrorCode status = U_ZERO_ERROR;
-	if (m_sentenceIterator == nullptr)
-		m_sentenceIterator = BreakIterator::createSentenceInstance(Locale(), status);
+	if (!m_sentenceIterator)
+		m_sentenceIterator.reset(BreakIterator::createSentenceInstance(Locale(), status));
 
 	if (U_FAILURE(status))
-	{
-		delete m_sentenceIterator;
-		m_sentenceIterator = nullptr;
-	}
+		m_sentenceIterator.reset();
 
-	return m_sentenceIterator;
+	return m_sentenceIterator.get();
 }
 
-BreakIterator* StoryText::m_lineIterator = nullptr;
+thread_local std::unique_ptr<BreakIterator> StoryText::m_lineIterator;
 
 BreakIterator* StoryText::getLineIterator()
 {
 	UErrorCode status = U_ZERO_ERROR;
-	if (m_lineIterator == nullptr)
-		m_lineIterator = BreakIterator::createLineInstance(Locale(), status);
+	if (!m_lineIterator)
+		m_lineIterator.reset(BreakIterator::createLineInstance(Locale(), status));
 
 	if (U_FAILURE(status))
-	{
-		delete m_lineIterator;
-		m_lineIterator = nullptr;
-	}
+		m_lineIterator.reset();
 
-	return m_lineIterator;
+	return m_lineIterator.get();
 }
 
 void StoryText::selectAll()
@@ -2158,13 +2121,27 @@ void StoryText::invalidateAll()
 	invalidate(0, length());
 }
 
+quint64 StoryText::editSerial() const
+{
+	return d->editSerial();
+}
+
+bool StoryText::mapRange(quint64 serial, int& first, int& last) const
+{
+	return d->mapRange(serial, first, last);
+}
+
 void StoryText::invalidate(int firstItem, int endItem)
 {
-	for (int i = firstItem; i < endItem; ++i)
+	// paragraph styles are modified in place, so record the range as changed too
+	d->recordEdit(firstItem, qMax(firstItem, endItem), qMax(firstItem, endItem));
+	int parSep = d->text.indexOf(SpecialChars::PARSEP, qMax(firstItem, 0));
+	while (parSep >= 0 && parSep < endItem)
 	{
-		ParagraphStyle* par = item(i)->parstyle;
+		ParagraphStyle* par = d->parstyle(parSep);
 		if (par)
 			par->charStyleContext()->invalidate();
+		parSep = d->text.indexOf(SpecialChars::PARSEP, parSep + 1);
 	}
 	if (!signalsBlocked())
 		emit changed(firstItem, endItem);
@@ -2184,19 +2161,6 @@ void StoryText::validate()
 }
 */
 
-ScText* StoryText::item(int index)
-{
-	assert( index < length() );
-	return this->d->at(index);
-}
-
-const ScText* StoryText::item(int index) const
-{
-	assert( index < length() );
-	return this->d->at(index);
-}
-
-
 using namespace desaxe;
 
 void StoryText::saxx(SaxHandler& handler, const Xml_string& elemtag) const
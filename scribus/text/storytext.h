@@ -26,6 +26,7 @@ pageitem.cpp  -  description
 #define STORYTEXT_H_
 
 #include <cassert>
+#include <memory>
 #include <QObject>
 #include <QString>
 #include <QList>
@@ -47,7 +48,6 @@ class PageItem;
 class ResourceCollection;
 class ScribusDoc;
 class ScText_Shared;
-class ShapedTextCache;
 class TextNote;
 
 U_NAMESPACE_BEGIN
@@ -275,8 +275,6 @@ public:
 	
 // layout helpers
 
-	ShapedTextCache* shapedTextCache() { return m_shapedTextCache; }
-
 	LayoutFlags flags(int pos) const;
 	bool hasFlag(int pos, LayoutFlags flag) const;
 	void setFlag(int pos, LayoutFlags flag);
@@ -289,6 +287,15 @@ public:
 	/// call this if the shape of the paragraph changes (redos layout)
 	void invalidateLayout();
 
+	/// serial of the last change of the text or its styles
+	quint64 editSerial() const;
+	/**
+	   Moves the char range [first, last] along with the changes done after
+	   editSerial() returned serial. Returns false if the range itself was
+	   changed or if the changes are not known any longer.
+	 */
+	bool mapRange(quint64 serial, int& first, int& last) const;
+
 public slots:
 	/// call this if some logical style changes (redos shaping and layout)
 	void invalidateAll();
@@ -297,17 +304,17 @@ signals:
 	void changed(int firstItem, int endItem);
 
 private:
-	ScText * item(int index);
-	const ScText * item(int index) const;
 	void fixSurrogateSelection();
+	/// gives the note mark at pos the char style of its notes style
+	void updateMarkCharStyle(int pos);
 	
 private:
 	ScribusDoc * m_doc;
-	ShapedTextCache* m_shapedTextCache;
-	static icu::BreakIterator* m_graphemeIterator;
-	static icu::BreakIterator* m_wordIterator;
-	static icu::BreakIterator* m_sentenceIterator;
-	static icu::BreakIterator* m_lineIterator;
+	// ICU break iterators are not thread safe, text is shaped on several threads
+	static thread_local std::unique_ptr<icu::BreakIterator> m_graphemeIterator;
+	static thread_local std::unique_ptr<icu::BreakIterator> m_wordIterator;
+	static thread_local std::unique_ptr<icu::BreakIterator> m_sentenceIterator;
+	static thread_local std::unique_ptr<icu::BreakIterator> m_lineIterator;
 
 	QString textWithSoftHyphens (int pos, uint len) const;
 	void    insertCharsWithSoftHyphens(int pos, const QString& txt, bool applyNeighbourStyle = false);
@@ -207,6 +207,12 @@ void TextLayout::addColumn(double colLeft, double colWidth)
 	m_box->setWidth(m_frame->width());
 }
 
+void TextLayout::shiftChars(int delta)
+{
+	m_box->shiftChars(delta);
+	m_lastMagicPos = -1;
+}
+
 void TextLayout::clear() 
 {
 	delete m_box;
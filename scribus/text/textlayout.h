@@ -69,6 +69,8 @@ public:
 	void appendLine(LineBox* ls);
 	void removeLastLine ();
 	void addColumn(double colLeft, double colWidth);
+	/// Moves all boxes by delta chars, for a layout whose text moved as a whole.
+	void shiftChars(int delta);
 
 	void clear();
 
@@ -6,6 +6,8 @@
 #include <harfbuzz/hb-ft.h>
 #include <harfbuzz/hb-icu.h>
 #include <unicode/brkiter.h>
+
+#include <QFile>
 #include <unicode/ubidi.h>
 
 #include "scrptrun.h"
@@ -19,6 +21,41 @@
 
 using namespace icu;
 
+ThreadFonts::ThreadFonts()
+{
+	if (FT_Init_FreeType(&m_library))
+		m_library = nullptr;
+}
+
+ThreadFonts::~ThreadFonts()
+{
+	// the fonts hold the last references to their FreeType faces
+	for (hb_font_t* hbFont : std::as_const(m_fonts))
+		hb_font_destroy(hbFont);
+	m_fonts.clear();
+	if (m_library)
+		FT_Done_FreeType(m_library);
+}
+
+hb_font_t* ThreadFonts::hbFont(const ScFace& face)
+{
+	const QString fontPath = face.fontPath();
+	auto it = m_fonts.constFind(fontPath);
+	if (it != m_fonts.constEnd())
+		return it.value();
+
+	hb_font_t* hbFont = nullptr;
+	FT_Face ftFace = nullptr;
+	if (m_library && !face.fontFilePath().isEmpty()
+		&& !FT_New_Face(m_library, QFile::encodeName(face.fontFilePath()), face.faceIndex(), &ftFace))
+	{
+		hbFont = reinterpret_cast<hb_font_t*>(face.createHbFont(ftFace));
+		FT_Done_Face(ftFace);
+	}
+	m_fonts.insert(fontPath, hbFont);
+	return hbFont;
+}
+
 TextShaper::TextShaper(ITextContext* context, ITextSource &story, int firstChar, bool singlePar)
 	: m_context(context),
 	m_story(story),
@@ -333,7 +370,18 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 		const CharStyle &style = m_story.charStyle(m_textMap.value(textRun.start));
 
 		const ScFace &scFace = style.font();
-		hb_font_t *hbFont = reinterpret_cast<hb_font_t*>(scFace.hbFont());
+		hb_font_t *hbFont = nullptr;
+		if (m_threadFonts != nullptr)
+		{
+			hbFont = m_threadFonts->hbFont(scFace);
+			if (hbFont == nullptr)
+			{
+				m_textMap.clear();
+				return ShapedText::Invalid;
+			}
+		}
+		else
+			hbFont = reinterpret_cast<hb_font_t*>(scFace.hbFont());
 		if (hbFont == nullptr)
 			continue;
 
@@ -481,6 +529,13 @@ ShapedText TextShaper::shape(int fromPos, int toPos)
 				    (ch == SpecialChars::LINEBREAK || ch == SpecialChars::PARSEP ||
 				     ch == SpecialChars::FRAMEBREAK || ch == SpecialChars::COLBREAK))
 				{
+					// other emulated glyphs are looked up in the shared font data
+					if (m_threadFonts != nullptr && !ScFace::hasControlGlyph(ch.unicode()))
+					{
+						hb_buffer_destroy(hbBuffer);
+						m_textMap.clear();
+						return ShapedText::Invalid;
+					}
 					gl.glyph = scFace.emulateGlyph(ch.unicode());
 
 					GlyphMetrics metrics = scFace.glyphBBox(gl.glyph, style.fontSize());
@@ -1,6 +1,7 @@
 #ifndef TEXTSHAPER_H
 #define TEXTSHAPER_H
 
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QString>
@@ -8,6 +9,7 @@
 
 #include <unicode/uscript.h>
 
+#include "fonts/scface.h"
 #include "itextsource.h"
 #include "itextcontext.h"
 #include "shapedtext.h"
@@ -15,9 +17,34 @@
 class GlyphCluster;
 class StoryText;
 class PageItem;
+struct hb_font_t;
 
 using namespace icu;
 
+/**
+ * HarfBuzz fonts for shaping outside of the GUI thread.
+ *
+ * The HarfBuzz font of a ScFace is shared and resized for every text run, so
+ * each worker thread opens the font files again with its own FreeType library.
+ * Only fonts which HarfBuzz shapes with its own font functions are supported.
+ * An instance must only be used by one thread.
+ */
+class ThreadFonts
+{
+public:
+	ThreadFonts();
+	~ThreadFonts();
+
+	/// Returns the HarfBuzz font for face or nullptr if it is not supported.
+	hb_font_t* hbFont(const ScFace& face);
+
+private:
+	Q_DISABLE_COPY(ThreadFonts)
+
+	FT_Library m_library { nullptr };
+	QHash<QString, hb_font_t*> m_fonts;
+};
+
 class TextShaper
 {
 public:
@@ -26,6 +53,12 @@ public:
 
 	ShapedText shape(int fromPos, int toPos);
 
+	/**
+	 * Makes the shaper use fonts which belong to the current thread. shape() then
+	 * returns ShapedText::Invalid for text it cannot shape without the shared font data.
+	 */
+	void setThreadFonts(ThreadFonts* fonts) { m_threadFonts = fonts; }
+
 private:
 	struct TextRun {
 		TextRun(int s, int l, int d)
@@ -61,6 +94,7 @@ private:
 	QList<FeaturesRun> itemizeFeatures(const TextRun &run) const;
 
 	ITextContext* m_context { nullptr };
+	ThreadFonts* m_threadFonts { nullptr };
 	bool m_contextNeeded { false };
 	ITextSource& m_story;
 	int m_firstChar { 0 };
@@ -262,6 +262,8 @@ void PDFExportDialog::updateDocOptions()
 	m_opts.openAfterExport = openAfterExportCheckBox->isChecked();
 	m_opts.Thumbnails = Options->CheckBox1->isChecked();
 	m_opts.Compress = Options->Compression->isChecked();
+	m_opts.useObjectStreams = Options->ObjectStreams->isChecked();
+	m_opts.linearize = Options->Linearize->isChecked();
 	m_opts.CompressMethod = (PDFOptions::PDFCompression) Options->CMethod->currentIndex();
 	m_opts.Quality = Options->CQuality->currentIndex();
 	m_opts.Resolution = Options->Resolution->value();
@@ -271,6 +273,7 @@ void PDFExportDialog::updateDocOptions()
 	m_opts.OutlineList = Options->fontsToOutline();
 	m_opts.RecalcPic = Options->DSColor->isChecked();
 	m_opts.PicRes = Options->ValC->value();
+	m_opts.downsampleFilter = Options->downsampleFilterCombo->currentIndex();
 	m_opts.embedPDF = Options->EmbedPDF->isChecked();
 	m_opts.Bookmarks = Options->CheckBM->isChecked();
 	m_opts.Binding = Options->ComboBind->currentIndex();
@@ -5,6 +5,8 @@ a copyright and/or license notice that predates the release of Scribus 1.3.2
 for which a new license (GPL+exception) is in place.
 */
 
+#include <QLabel>
+
 #include "prefs_documentinformation.h"
 #include "prefsstructs.h"
 #include "scribusdoc.h"
@@ -16,6 +18,17 @@ Prefs_DocumentInformation::Prefs_DocumentInformation(QWidget* parent, ScribusDoc
 	scrollArea->viewport()->setAutoFillBackground(false);
 	scrollArea->widget()->setAutoFillBackground(false);
 
+	if (doc)
+	{
+		ScImagePool::Statistics stats = doc->imagePool().statistics();
+		const double MiB = 1024.0 * 1024.0;
+		QString imageMemory = tr("%1 images using %2 MiB, %3 MiB saved by frames sharing them")
+							  .arg(stats.images)
+							  .arg(stats.bytes / MiB, 0, 'f', 1)
+							  .arg(stats.savedBytes / MiB, 0, 'f', 1);
+		formLayout->addRow(tr("Images in Memory:"), new QLabel(imageMemory, tabDocument));
+	}
+
 	languageChange();
 
 	m_caption = tr("Document Information");
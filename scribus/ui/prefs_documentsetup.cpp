@@ -128,6 +128,7 @@ void Prefs_DocumentSetup::languageChange()
 	autosaveCheckBox->setToolTip( "<qt>" + tr( "When enabled, Scribus saves backup copies of your file each time the time period elapses" ) + "</qt>" );
 	autosaveIntervalSpinBox->setToolTip( "<qt>" + tr( "Time period between saving automatically" ) + "</qt>" );
 	undoLengthSpinBox->setToolTip( "<qt>" + tr("Set the length of the action history in steps. If set to 0 infinite amount of actions will be stored.") + "</qt>");
+	undoMemorySpinBox->setToolTip( "<qt>" + tr("Set the memory the action history may use. The oldest actions are removed when more memory is used. If set to 0 the memory is not limited.") + "</qt>");
 	applySizesToAllPagesCheckBox->setToolTip( "<qt>" + tr( "Apply the page size changes to all existing pages in the document" ) + "</qt>" );
 	applyMarginsToAllPagesCheckBox->setToolTip( "<qt>" + tr( "Apply the page size changes to all existing master pages in the document" ) + "</qt>" );
 	autosaveCountSpinBox->setToolTip("<qt>" + tr("Keep this many files during the editing session. Backup files will be removed when you close the document.") + "</qt>");
@@ -204,11 +205,17 @@ void Prefs_DocumentSetup::restoreDefaults(struct ApplicationPrefs *prefsData)
 	changeAutoDir->setEnabled(!prefsData->docSetupPrefs.AutoSaveLocation);
 	showAutosaveClockOnCanvasCheckBox->setChecked(prefsData->displayPrefs.showAutosaveClockOnCanvas);
 	undoCheckBox->setChecked(PrefsManager::instance().prefsFile->getContext("undo")->getBool("enabled", true));
+	// without an undo stack there is no history to limit
 	int undoLength = UndoManager::instance()->getHistoryLength();
-	if (undoLength == -1)
-		undoLengthSpinBox->setEnabled(false);
-	else
+	undoLengthSpinBox->setEnabled(undoCheckBox->isChecked() && (undoLength != -1));
+	if (undoLength != -1)
 		undoLengthSpinBox->setValue(undoLength);
+	int undoMemory = UndoManager::instance()->getHistoryMemoryLimit();
+	undoMemorySpinBox->setEnabled(undoCheckBox->isChecked() && (undoMemory != -1));
+	if (undoMemory == -1)
+		undoMemorySpinBox->setValue(PrefsManager::instance().prefsFile->getContext("undo")->getInt("historymemory", 256));
+	else
+		undoMemorySpinBox->setValue(undoMemory);
 	unitChange();
 }
 
@@ -239,6 +246,7 @@ void Prefs_DocumentSetup::saveGuiToPrefs(struct ApplicationPrefs *prefsData) con
 		UndoManager::instance()->clearStack();
 	UndoManager::instance()->setUndoEnabled(undoActive);
 	UndoManager::instance()->setAllHistoryLengths(undoLengthSpinBox->value());
+	UndoManager::instance()->setAllHistoryMemoryLimits(undoMemorySpinBox->value());
 	static PrefsContext *undoPrefs = PrefsManager::instance().prefsFile->getContext("undo");
 	undoPrefs->set("enabled", undoActive);
 }
@@ -401,6 +409,7 @@ void Prefs_DocumentSetup::setSize(const QString &newSize)
 void Prefs_DocumentSetup::slotUndo(bool isEnabled)
 {
 	undoLengthSpinBox->setEnabled(isEnabled);
+	undoMemorySpinBox->setEnabled(isEnabled);
 }
 
 void Prefs_DocumentSetup::getResizeDocumentPages(bool &resizePages, bool &resizeMasterPages, bool &resizePageMargins, bool &resizeMasterPageMargins)
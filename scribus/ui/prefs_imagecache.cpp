@@ -28,6 +28,8 @@ void Prefs_ImageCache::languageChange()
 	cacheSizeLimitSpinBox->setToolTip( "<qt>"+ tr("Limit the total size of all files in the image cache directory to this amount")+"</qt>" );
 	cacheEntryLimitSpinBox->setToolTip( "<qt>" + tr( "Limit the number of cache entries to this number" ) + "</qt>" );
 	compressionLevelSpinBox->setToolTip( "<qt>" + tr( "Set the level of compression for images in the cache. Higher values result in smaller cache files but also make writes to the cache slower." ) + "</qt>" );
+	memoryPoolLimitSpinBox->setToolTip( "<qt>" + tr( "Limit the memory used by decoded images kept for reuse by frames showing the same image. Frames showing an image keep it in memory beyond this limit." ) + "</qt>" );
+	fontSubsetCacheLimitSpinBox->setToolTip( "<qt>" + tr( "Limit the total size of the font subsets kept on disk for reuse by later PDF exports. Set to 0 to disable the font subset cache." ) + "</qt>" );
 }
 
 void Prefs_ImageCache::restoreDefaults(struct ApplicationPrefs *prefsData)
@@ -36,6 +38,8 @@ void Prefs_ImageCache::restoreDefaults(struct ApplicationPrefs *prefsData)
 	cacheSizeLimitSpinBox->setValue(prefsData->imageCachePrefs.maxCacheSizeMiB);
 	cacheEntryLimitSpinBox->setValue(prefsData->imageCachePrefs.maxCacheEntries);
 	compressionLevelSpinBox->setValue(prefsData->imageCachePrefs.compressionLevel);
+	memoryPoolLimitSpinBox->setValue(prefsData->imageCachePrefs.memoryPoolSizeMiB);
+	fontSubsetCacheLimitSpinBox->setValue(prefsData->imageCachePrefs.fontSubsetCacheSizeMiB);
 }
 
 void Prefs_ImageCache::saveGuiToPrefs(struct ApplicationPrefs *prefsData) const
@@ -44,5 +48,7 @@ void Prefs_ImageCache::saveGuiToPrefs(struct ApplicationPrefs *prefsData) const
 	prefsData->imageCachePrefs.maxCacheSizeMiB = cacheSizeLimitSpinBox->value();
 	prefsData->imageCachePrefs.maxCacheEntries = cacheEntryLimitSpinBox->value();
 	prefsData->imageCachePrefs.compressionLevel = compressionLevelSpinBox->value();
+	prefsData->imageCachePrefs.memoryPoolSizeMiB = memoryPoolLimitSpinBox->value();
+	prefsData->imageCachePrefs.fontSubsetCacheSizeMiB = fontSubsetCacheLimitSpinBox->value();
 }
 
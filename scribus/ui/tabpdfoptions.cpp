@@ -188,6 +188,7 @@ TabPDFOptions::TabPDFOptions(QWidget* parent, PDFOptions & Optionen,
 	connect(NoEmbedded, SIGNAL(clicked()), this, SLOT(EnablePGI2()));
 	connect(PDFVersionCombo, SIGNAL(activated(int)), this, SLOT(EnablePDFX(int)));
 	connect(Encry, SIGNAL(clicked()), this, SLOT(ToggleEncr()));
+	connect(Linearize, SIGNAL(clicked()), this, SLOT(ToggleLinearize()));
 	connect(UseLPI, SIGNAL(clicked()), this, SLOT(EnableLPI2()));
 	connect(LPIcolor, SIGNAL(activated(int)), this, SLOT(SelLPIcol(int)));
 	connect(CMethod, SIGNAL(activated(int)), this, SLOT(handleCompressionMethod(int)));
@@ -212,10 +213,13 @@ TabPDFOptions::TabPDFOptions(QWidget* parent, PDFOptions & Optionen,
 	Resolution->setToolTip( "<qt>" + tr( "Export resolution of text and vector graphics. This does not affect the resolution of bitmap images like photos." ) + "</qt>" );
 	EmbedPDF->setToolTip( "<qt>" + tr( "Export PDFs in image frames as embedded PDFs. This does *not* yet take care of colorspaces, so you should know what you are doing before setting this to 'true'." ) + "</qt>" );
 	Compression->setToolTip( "<qt>" + tr( "Enables lossless compression of text and graphics. Unless you have a reason, leave this checked. This reduces PDF file size." ) + "</qt>" );
+	ObjectStreams->setToolTip( "<qt>" + tr( "Packs small objects such as page and font dictionaries into compressed object streams and writes a compressed cross-reference table. This reduces PDF file size. Needs PDF 1.5 or later and is not used for encrypted or linearized files." ) + "</qt>" );
+	Linearize->setToolTip( "<qt>" + tr( "Orders the PDF file so that web browsers and viewers can show the first page while the rest of the file is still downloading. Linearized files do not use object streams. Not used for encrypted files." ) + "</qt>" );
 	CMethod->setToolTip( "<qt>" + tr( "Method of compression to use for images. Automatic allows Scribus to choose the best method. ZIP is lossless and good for images with solid colors. JPEG is better at creating smaller PDF files which have many photos (with slight image quality loss possible). Leave it set to Automatic unless you have a need for special compression options." ) + "</qt>");
 	CQuality->setToolTip( "<qt>" + tr( "Compression quality levels for lossy compression methods: Minimum (25%), Low (50%), Medium (75%), High (85%), Maximum (95%). Note that a quality level does not directly determine the size of the resulting image - both size and quality loss vary from image to image at any given quality level. Even with Maximum selected, there is always some quality loss with jpeg." ) + "</qt>");
 	DSColor->setToolTip( "<qt>" + tr( "Limits the resolution of your bitmap images to the selected DPI. Images with a lower resolution will be left untouched. Leaving this unchecked will render them at their native resolution. Enabling this will increase memory usage and slow down export." ) + "</qt>" );
 	ValC->setToolTip( "<qt>" + tr( "DPI (Dots Per Inch) for image export") + "</qt>" );
+	downsampleFilterCombo->setToolTip( "<qt>" + tr( "Filter used when images are downsampled. Box is the fastest, Bilinear is smoother and Lanczos keeps the most detail but is the slowest." ) + "</qt>" );
 
 	// Tooltips : Fonts tab
 	EmbedFonts->setToolTip( "<qt>" + tr( "Embed fonts into the PDF. Embedding the fonts will preserve the layout and appearance of your document." ) + "</qt>");
@@ -357,6 +361,9 @@ void TabPDFOptions::restoreDefaults(PDFOptions & Optionen,
 	Resolution->setValue(Opts.Resolution);
 	EmbedPDF->setChecked(Opts.embedPDF);
 	Compression->setChecked( Opts.Compress );
+	ObjectStreams->setChecked( Opts.useObjectStreams );
+	Linearize->setChecked( Opts.linearize );
+	ToggleLinearize();
 	CMethod->setCurrentIndex(Opts.CompressMethod);
 	CQuality->setCurrentIndex(Opts.Quality);
 	if (Opts.CompressMethod == 3)
@@ -364,6 +371,8 @@ void TabPDFOptions::restoreDefaults(PDFOptions & Optionen,
 	DSColor->setChecked(Opts.RecalcPic);
 	ValC->setValue(Opts.PicRes);
 	ValC->setEnabled(DSColor->isChecked());
+	downsampleFilterCombo->setCurrentIndex(Opts.downsampleFilter);
+	downsampleFilterCombo->setEnabled(DSColor->isChecked());
 
 	m_docFonts = DocFonts.keys();
 	if (Opts.Version == PDFVersion::PDF_X1a ||
@@ -652,11 +661,14 @@ void TabPDFOptions::storeValues(PDFOptions& pdfOptions)
 {
 	pdfOptions.Thumbnails = CheckBox1->isChecked();
 	pdfOptions.Compress = Compression->isChecked();
+	pdfOptions.useObjectStreams = ObjectStreams->isChecked();
+	pdfOptions.linearize = Linearize->isChecked();
 	pdfOptions.CompressMethod = (PDFOptions::PDFCompression) CMethod->currentIndex();
 	pdfOptions.Quality = CQuality->currentIndex();
 	pdfOptions.Resolution = Resolution->value();
 	pdfOptions.RecalcPic = DSColor->isChecked();
 	pdfOptions.PicRes = ValC->value();
+	pdfOptions.downsampleFilter = downsampleFilterCombo->currentIndex();
 	pdfOptions.Bookmarks = CheckBM->isChecked();
 	pdfOptions.Binding = ComboBind->currentIndex();
 	pdfOptions.MirrorH = MirrorH->isChecked();
@@ -778,6 +790,12 @@ void TabPDFOptions::ToggleEncr()
 	groupPass->setEnabled(setter);
 }
 
+void TabPDFOptions::ToggleLinearize()
+{
+	// the linearizer only handles classic cross-reference tables
+	ObjectStreams->setEnabled(!Linearize->isChecked());
+}
+
 void TabPDFOptions::enableCMS(bool enable)
 {
 	QSignalBlocker blocker(PDFVersionCombo);
@@ -1217,6 +1235,7 @@ void TabPDFOptions::DoDownsample()
 	}
 	else
 		ValC->setEnabled(false);
+	downsampleFilterCombo->setEnabled(DSColor->isChecked());
 }
 
 void TabPDFOptions::EmbeddingModeChange()
@@ -70,6 +70,7 @@ signals:
 public slots:
 	void doDocBleeds();
 	void ToggleEncr();
+	void ToggleLinearize();
 	void EnablePDFX(int a);
 	void DoDownsample();
 	void EmbeddingModeChange();
@@ -275,6 +275,7 @@ void UndoManager::switchStack(const QString& stackName)
 		m_stacks[m_currentDoc] = UndoStack();
 
 	m_stacks[m_currentDoc].setMaxSize(prefs_->getInt("historylength", 100));
+	m_stacks[m_currentDoc].setMaxMemory(prefs_->getInt("historymemory", 256) * qint64(1024 * 1024));
 	for (size_t i = 0; i < m_undoGuis.size(); ++i)
 		setState(m_undoGuis[i]);
 
@@ -361,7 +362,8 @@ void UndoManager::action(UndoObject* target, UndoState* state, QPixmap *targetPi
 	{
 //		qDebug() << "UndoManager: Action executed:" << target->getUName() << state->getName();
 		state->setUndoObject(target);
-		if (m_stacks[m_currentDoc].action(state))
+		int poppedActions = m_stacks[m_currentDoc].action(state);
+		for (int i = 0; i < poppedActions; ++i)
 			emit popBack();
 	}
 	if (targetPixmap)
@@ -512,6 +514,37 @@ int UndoManager::getHistoryLength() const
 	return -1;
 }
 
+void UndoManager::setHistoryMemoryLimit(int mib)
+{
+	if (mib < 0)
+		return;
+	m_stacks[m_currentDoc].setMaxMemory(mib * qint64(1024 * 1024));
+	prefs_->set("historymemory", mib);
+	for (size_t i = 0; i < m_undoGuis.size(); ++i)
+		setState(m_undoGuis[i]);
+	setTexts();
+}
+
+void UndoManager::setAllHistoryMemoryLimits(int mib)
+{
+	if (mib < 0)
+		return;
+	for (StackMap::Iterator it = m_stacks.begin(); it != m_stacks.end(); ++it)
+		it.value().setMaxMemory(mib * qint64(1024 * 1024));
+	prefs_->set("historymemory", mib);
+	for (size_t i = 0; i < m_undoGuis.size(); ++i)
+		setState(m_undoGuis[i]);
+	setTexts();
+}
+
+int UndoManager::getHistoryMemoryLimit() const
+{
+	auto currentStackIt = m_stacks.constFind(m_currentDoc);
+	if (currentStackIt != m_stacks.constEnd())
+		return static_cast<int>(currentStackIt->maxMemory() / (1024 * 1024));
+	return -1;
+}
+
 bool UndoManager::isGlobalMode() const
 {
 	return m_currentUndoObjectId == -1;
@@ -257,6 +257,12 @@ public:
 	 */
 	int getHistoryLength() const;
 
+	/**
+	 * @brief Returns the memory limit of the undostack in MiB, 0 if memory is not limited.
+	 * @return the memory limit of the undostack in MiB or -1 if there is no current stack
+	 */
+	int getHistoryMemoryLimit() const;
+
 	/**
 	 * @brief Returns true if in global mode and false if in object specific mode.
 	 * @return true if in global mode and false if in object specific mode
@@ -769,6 +775,15 @@ public slots:
 	void setHistoryLength(int steps);
 	void setAllHistoryLengths(int steps);
 
+	/**
+	 * @brief Sets the memory limit of the undo stack.
+	 *
+	 * The oldest UndoStates are removed when the stored states use more memory.
+	 * @param mib memory limit in MiB, 0 for no limit
+	 */
+	void setHistoryMemoryLimit(int mib);
+	void setAllHistoryMemoryLimits(int mib);
+
 signals:
 	/**
 	 * @brief Emitted when a new undo action is stored to the undo stack.
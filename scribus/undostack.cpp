@@ -33,17 +33,27 @@ UndoStack::UndoStack(int maxSize) : m_maxSize(maxSize)
 
 }
 
-bool UndoStack::action(UndoState *state)
+int UndoStack::action(UndoState *state)
 {
+	// the newest undo action may have grown, f.e. while typing text
+	if (!m_undoActions.empty())
+		recountMemory(m_undoActions[0]);
+	for (size_t i = 0; i < m_redoActions.size(); ++i)
+	{
+		uncountMemory(m_redoActions[i]);
+		delete m_redoActions[i];
+	}
 	m_redoActions.clear();
 	m_undoActions.insert(m_undoActions.begin(), state);
-	bool needsPopping = checkSize(); // only store maxSize_ amount of actions
+	recountMemory(state);
 
-	return needsPopping;
+	return checkSize(); // only store maxSize_ amount of actions
 }
 
 bool UndoStack::undo(uint steps, int objectId)
 {
+	if (!m_undoActions.empty())
+		recountMemory(m_undoActions[0]);
 	for (uint i = 0; i < steps && !m_undoActions.empty(); ++i)
 	{
 		UndoState *tmpUndoState = nullptr;
@@ -80,6 +90,8 @@ bool UndoStack::undo(uint steps, int objectId)
 		{
 			m_redoActions.insert(m_redoActions.begin(), tmpUndoState); // push to the redo actions
 			tmpUndoState->undo();
+			// restore code stores values in the state it restores
+			recountMemory(tmpUndoState);
 		}
 	}
 	return true;
@@ -87,6 +99,8 @@ bool UndoStack::undo(uint steps, int objectId)
 
 bool UndoStack::redo(uint steps, int objectId)
 {
+	if (!m_undoActions.empty())
+		recountMemory(m_undoActions[0]);
 	for (uint i = 0; i < steps && !m_redoActions.empty(); ++i)
 	{
 		UndoState *tmpRedoState = nullptr;
@@ -123,6 +137,7 @@ bool UndoStack::redo(uint steps, int objectId)
 		{
 			m_undoActions.insert(m_undoActions.begin(), tmpRedoState); // push to the undo actions
 			tmpRedoState->redo();
+			recountMemory(tmpRedoState);
 		}
 	}
 	return true;
@@ -154,22 +169,66 @@ void UndoStack::setMaxSize(uint maxSize)
 	checkSize(); // we may need to remove actions
 }
 
-bool UndoStack::checkSize()
+qint64 UndoStack::maxMemory() const
+{
+	return m_maxMemory;
+}
+
+void UndoStack::setMaxMemory(qint64 maxMemory)
+{
+	m_maxMemory = qMax(qint64(0), maxMemory);
+	if (!m_undoActions.empty())
+		recountMemory(m_undoActions[0]);
+	checkSize(); // we may need to remove actions
+}
+
+qint64 UndoStack::memoryUsage() const
+{
+	return m_memoryUsage;
+}
+
+bool UndoStack::exceedsLimits() const
 {
-	if (m_maxSize == 0) // 0 marks for infinite stack size
-		return false;
+	// 0 marks for infinite stack size and memory
+	return (m_maxSize > 0 && size() > m_maxSize) || (m_maxMemory > 0 && m_memoryUsage > m_maxMemory);
+}
 
-	bool needsPopping = size () > m_maxSize;
+int UndoStack::checkSize()
+{
+	int poppedUndoActions = 0;
 
-	while (size() > m_maxSize)
+	while (exceedsLimits() && (!m_redoActions.empty() || m_undoActions.size() > 1))
 	{
+		UndoState *state = nullptr;
 		if (!m_redoActions.empty()) // clear redo actions first
+		{
+			state = m_redoActions.back();
 			m_redoActions.pop_back();
+		}
 		else
+		{
+			state = m_undoActions.back();
 			m_undoActions.pop_back();
+			++poppedUndoActions;
+		}
+		uncountMemory(state);
+		delete state;
 	}
 
-	return needsPopping;
+	return poppedUndoActions;
+}
+
+void UndoStack::recountMemory(const UndoState* state)
+{
+	qint64 memory = state->memoryUsage();
+	qint64& counted = m_countedMemory[state];
+	m_memoryUsage += memory - counted;
+	counted = memory;
+}
+
+void UndoStack::uncountMemory(const UndoState* state)
+{
+	m_memoryUsage -= m_countedMemory.take(state);
 }
 
 void UndoStack::clear()
@@ -180,6 +239,8 @@ void UndoStack::clear()
 		delete m_redoActions[i];
 	m_undoActions.clear();
 	m_redoActions.clear();
+	m_memoryUsage = 0;
+	m_countedMemory.clear();
 }
 
 UndoState* UndoStack::getNextUndo(int objectId)
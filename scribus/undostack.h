@@ -29,6 +29,10 @@ for which a new license (GPL+exception) is in place.
 
 #include <vector>
 
+#include <QHash>
+
+#include <QtGlobal>
+
 class UndoState;
 class TransactionState;
 
@@ -42,9 +46,9 @@ public:
 
     /* Used to push a new action to the stack. UndoState in the parameter will then
      * become the first undo action in the stack and all the redo actions will be
-     * cleared. If maximum size of the stack is hit and an action needs to be removed
-     * this function returns true. */
-    bool action(UndoState *state);
+     * cleared. If maximum size or memory limit of the stack is hit the oldest actions
+     * are removed and this function returns how many undo actions were removed. */
+    int action(UndoState *state);
 
     /* undo number of steps actions (these will then become redo actions) */
     bool undo(uint steps, int objectId);
@@ -65,6 +69,15 @@ public:
      * function setUndoEnabled(bool) from UndoManager should be used */
     void setMaxSize(uint maxSize);
 
+    /* maximum number of bytes used by the actions stored in the stack */
+    qint64 maxMemory() const;
+    /* Change the memory limit of the stack in bytes, 0 for no limit. Actions are
+     * removed in the same order as with setMaxSize(), the newest undo action is
+     * always kept. */
+    void setMaxMemory(qint64 maxMemory);
+    /* approximate number of bytes used by the actions stored in the stack */
+    qint64 memoryUsage() const;
+
     void clear();
 
     UndoState* getNextUndo(int objectId);
@@ -79,10 +92,21 @@ private:
 
     /* maximum amount of actions stored, 0 for no limit */
     uint m_maxSize { 0 };
-
-    /* returns true if an action was popped from the stack */
-    /* assures that we only hold the maxSize_ number of UndoStates */
-    bool checkSize();
+    /* maximum amount of bytes used by the actions, 0 for no limit */
+    qint64 m_maxMemory { 0 };
+    /* bytes used by all actions, the sum of m_countedMemory */
+    qint64 m_memoryUsage { 0 };
+    /* bytes counted for each action when it was last measured */
+    QHash<const UndoState*, qint64> m_countedMemory;
+
+    /* returns the number of undo actions popped from the stack */
+    /* assures that we only hold the maxSize_ number of UndoStates within maxMemory_ */
+    int checkSize();
+    bool exceedsLimits() const;
+    /* measures an action again, restoring and typing text change actions after they were pushed */
+    void recountMemory(const UndoState* state);
+    /* removes an action from the memory usage, with the size it was counted with */
+    void uncountMemory(const UndoState* state);
 
     friend class UndoManager; // UndoManager needs access to undoActions_ and redoActions_
                               // for updating the attached UndoGui widgets
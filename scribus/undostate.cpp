@@ -24,9 +24,30 @@ for which a new license (GPL+exception) is in place.
  *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.             *
  ***************************************************************************/
 
+#include <QSet>
+
 #include "undostate.h"
 #include "undoobject.h"
 
+namespace
+{
+	/// states use the same few keys, so every key string is stored only once
+	QString sharedKey(const QString& key)
+	{
+		static QSet<QString> keys;
+		return *keys.insert(key);
+	}
+
+	qint64 valueUsage(const QVariant& value)
+	{
+		if (value.typeId() == QMetaType::QString)
+			return static_cast<const QString*>(value.constData())->capacity() * sizeof(QChar);
+		if (value.typeId() == QMetaType::QByteArray)
+			return static_cast<const QByteArray*>(value.constData())->capacity();
+		return 0;
+	}
+}
+
 UndoState::UndoState(const QString& name, const QString& description, QPixmap* pixmap) :
 	m_actionName(name),
 	m_actionDescription(description),
@@ -88,6 +109,11 @@ UndoObject* UndoState::undoObject()
 	return m_undoObject;
 }
 
+qint64 UndoState::memoryUsage() const
+{
+	return sizeof(UndoState);
+}
+
 /*** SimpleState **************************************************************/
 
 SimpleState::SimpleState(const QString& name, const QString& description, QPixmap* pixmap)
@@ -98,23 +124,33 @@ SimpleState::SimpleState(const QString& name, const QString& description, QPixma
 
 bool SimpleState::contains(const QString& key) const
 {
-	return m_values.contains(key);
+	return find(key) != nullptr;
+}
+
+const QVariant* SimpleState::find(const QString& key) const
+{
+	for (const Entry& entry : m_values)
+	{
+		if (entry.first == key)
+			return &entry.second;
+	}
+	return nullptr;
 }
 
 QVariant SimpleState::variant(const QString& key, const QVariant& def) const
 {
-	QMap<QString, QVariant>::const_iterator it = m_values.constFind(key);
-	if (it != m_values.constEnd())
-		return it.value();
+	const QVariant* value = find(key);
+	if (value)
+		return *value;
 
 	return def;
 }
 
 QString SimpleState::get(const QString& key, const QString& def) const
 {
-	QMap<QString, QVariant>::const_iterator it = m_values.constFind(key);
-	if (it != m_values.constEnd())
-		return it.value().toString();
+	const QVariant* value = find(key);
+	if (value)
+		return value->toString();
 
 	return def;
 }
@@ -189,49 +225,71 @@ void* SimpleState::getVoidPtr(const QString& key, void* def) const
 }
 
 
+void SimpleState::setValue(const QString& key, const QVariant& value)
+{
+	for (Entry& entry : m_values)
+	{
+		if (entry.first == key)
+		{
+			entry.second = value;
+			return;
+		}
+	}
+	m_values.emplace_back(sharedKey(key), value);
+}
+
 void SimpleState::set(const QString& key)
 {
-	m_values[key] = QVariant();
+	setValue(key, QVariant());
 }
 
 void SimpleState::set(const QString& key, const QString& value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, bool value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, int value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, qlonglong value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, uint value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, qulonglong value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, double value)
 {
-	m_values[key] = QVariant(value);
+	setValue(key, QVariant(value));
 }
 
 void SimpleState::set(const QString& key, void* ptr)
 {
-	m_values[key] = QVariant::fromValue<void*>(ptr);
+	setValue(key, QVariant::fromValue<void*>(ptr));
+}
+
+qint64 SimpleState::memoryUsage() const
+{
+	qint64 usage = UndoState::memoryUsage() + sizeof(SimpleState) - sizeof(UndoState);
+	usage += m_values.capacity() * sizeof(Entry);
+	for (const Entry& entry : m_values)
+		usage += valueUsage(entry.second);
+	return usage;
 }
 
 /*** TransactionState *****************************************************/
@@ -357,6 +415,18 @@ void TransactionState::redo() // redo all attached states
 	}
 }
 
+qint64 TransactionState::memoryUsage() const
+{
+	qint64 usage = UndoState::memoryUsage() + sizeof(TransactionState) - sizeof(UndoState);
+	usage += m_states.capacity() * sizeof(UndoState*);
+	for (const UndoState* state : m_states)
+	{
+		if (state)
+			usage += state->memoryUsage();
+	}
+	return usage;
+}
+
 TransactionState::~TransactionState()
 {
 	for (size_t i = 0; i < m_states.size(); ++i)
@@ -375,3 +445,12 @@ void* ScItemsState::getItem(const QString& itemname) const
 		return pointerMap.value(itemname, nullptr);
 	return nullptr;
 }
+
+qint64 ScItemsState::memoryUsage() const
+{
+	qint64 usage = SimpleState::memoryUsage() + sizeof(ScItemsState) - sizeof(SimpleState);
+	usage += insertItemPos.capacity() * sizeof(QPair<void*, int>);
+	for (auto it = pointerMap.cbegin(); it != pointerMap.cend(); ++it)
+		usage += sizeof(QString) + sizeof(void*) + it.key().capacity() * sizeof(QChar);
+	return usage;
+}
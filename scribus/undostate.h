@@ -28,6 +28,7 @@ for which a new license (GPL+exception) is in place.
 #define UNDOSTATE_H
 
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 #include <QMap>
@@ -119,6 +120,13 @@ public:
 	virtual void setUndoObject(UndoObject *object);
 	/** @brief return the UndoObject this state belongs to */
 	virtual UndoObject* undoObject();
+	/**
+	 * @brief Approximate number of bytes held by this state
+	 *
+	 * Used by UndoStack to keep the action history within its memory limit. Name,
+	 * description and icon are not counted as they are usually shared between states.
+	 */
+	virtual qint64 memoryUsage() const;
 
 	int transactionCode { 0 };
 
@@ -138,8 +146,9 @@ private:
 /**
  * @brief SimpleState provides a simple implementation of the UndoState.
  *
- * SimpleState uses a <code>QMap</code> to store key-value pairs that can be queried and
- * set using it's get() and set() methods.
+ * SimpleState stores key-value pairs that can be queried and set using it's get() and
+ * set() methods. States hold only a few values, so they are kept in a small vector
+ * searched linearly, and the keys are shared between all states.
  *
  * @author Riku Leino tsoots@gmail.com
  * @date December 2004
@@ -358,11 +367,17 @@ public:
 	*/
 	void set(const QString& key, void* ptr);
 
+	qint64 memoryUsage() const override;
+
 private:
-	/** @brief QMap to store key-value pairs */
-	QMap<QString, QVariant> m_values;
+	using Entry = std::pair<QString, QVariant>;
 
+	/** @brief key-value pairs in the order they were set */
+	std::vector<Entry> m_values;
+
+	const QVariant* find(const QString& key) const;
 	QVariant variant(const QString& key, const QVariant& def) const;
+	void setValue(const QString& key, const QVariant& value);
 };
 
 /*** ItemState ***************************************************************************/
@@ -379,6 +394,8 @@ public:
 	void setItem(const C &c) { item_ = c; }
 	C getItem() const { return item_; }
 
+	qint64 memoryUsage() const override { return SimpleState::memoryUsage() + sizeof(C); }
+
 private:
 	C item_;
 };
@@ -397,6 +414,8 @@ public:
 	void* getItem(const QString& itemname) const;
 	QList< QPair<void*, int> > insertItemPos;
 
+	qint64 memoryUsage() const override;
+
 private:
 	QMap<QString,void*> pointerMap;
 };
@@ -423,11 +442,63 @@ public:
 	const C& getOldState() const { return m_oldState; }
 	const C& getNewState() const { return m_newState; }
 
+	qint64 memoryUsage() const override { return SimpleState::memoryUsage() + 2 * sizeof(C); }
+
 private:
 	C m_oldState;
 	C m_newState;
 };
 
+/*** ScGeometryState for moving, resizing and rotating items ******************************/
+
+/**
+ * @brief Geometry of an item before and after it was moved, resized or rotated
+ *
+ * These are the most frequent actions in the history, so their values are stored in
+ * plain members instead of the key-value pairs of SimpleState. Values not recorded
+ * for an action stay 0.
+ */
+class SCRIBUS_API ScGeometryState : public SimpleState
+{
+public:
+	enum Action
+	{
+		Move,
+		Resize,
+		Rotate
+	};
+
+	struct Geometry
+	{
+		double xPos { 0.0 };
+		double yPos { 0.0 };
+		double width { 0.0 };
+		double height { 0.0 };
+		double rotation { 0.0 };
+	};
+
+	ScGeometryState(Action action, const QString& name, const QString& description = QString(), QPixmap* pixmap = nullptr)
+		: SimpleState(name, description, pixmap), m_action(action)
+	{
+	}
+
+	~ScGeometryState() override = default;
+
+	Action action() const { return m_action; }
+
+	Geometry& oldGeometry() { return m_oldGeometry; }
+	Geometry& newGeometry() { return m_newGeometry; }
+	const Geometry& oldGeometry() const { return m_oldGeometry; }
+	const Geometry& newGeometry() const { return m_newGeometry; }
+
+	qint64 memoryUsage() const override { return SimpleState::memoryUsage() + sizeof(ScGeometryState) - sizeof(SimpleState); }
+
+private:
+	Action m_action;
+	Geometry m_oldGeometry;
+	Geometry m_newGeometry;
+};
+
 /*** TransactionState ********************************************************************/
 
 /**
@@ -504,6 +575,8 @@ public:
 	/** @brief redo all UndoStates in this transaction */
 	void redo();
 
+	qint64 memoryUsage() const override;
+
 private:
 	/** @brief Number of undo states stored in this transaction */
 	uint m_size { 0 };
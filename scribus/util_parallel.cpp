@@ -0,0 +1,56 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include "util_parallel.h"
+
+void parallelFor(int count, int minChunk, const std::function<void(int first, int last)>& func)
+{
+	if (count <= 0)
+		return;
+	const int threadCount = QThread::idealThreadCount();
+	// a few chunks per thread even out rows which take longer than others
+	const int chunkCount = qMin(4 * threadCount, count / qMax(1, minChunk));
+	if (threadCount < 2 || chunkCount < 2)
+	{
+		func(0, count);
+		return;
+	}
+
+	const int chunkSize = (count + chunkCount - 1) / chunkCount;
+	QAtomicInt nextChunk(0);
+	auto work = [&]()
+	{
+		for (int chunk = nextChunk.fetchAndAddRelaxed(1); chunk < chunkCount; chunk = nextChunk.fetchAndAddRelaxed(1))
+		{
+			int first = chunk * chunkSize;
+			int last = qMin(count, first + chunkSize);
+			if (first < last)
+				func(first, last);
+		}
+	};
+
+	QSemaphore finished;
+	int workers = 0;
+	for (int i = 1; i < qMin(threadCount, chunkCount); ++i)
+	{
+		bool started = QThreadPool::globalInstance()->tryStart([&work, &finished]()
+		{
+			work();
+			finished.release();
+		});
+		if (!started)
+			break;
+		++workers;
+	}
+	work();
+	finished.acquire(workers);
+}
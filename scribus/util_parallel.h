@@ -0,0 +1,24 @@
+/*
+For general Scribus (>=1.3.2) copyright and licensing information please refer
+to the COPYING file provided with the program. Following this notice may exist
+a copyright and/or license notice that predates the release of Scribus 1.3.2
+for which a new license (GPL+exception) is in place.
+*/
+#ifndef _UTIL_PARALLEL_H
+#define _UTIL_PARALLEL_H
+
+#include <functional>
+
+#include "scribusapi.h"
+
+/**
+ * @brief Split the range [0, count) into chunks and call @a func for each of them on the global thread pool
+ *
+ * The calling thread works on chunks too and returns once all of them are done, so
+ * nothing is lost when the pool is busy. Ranges smaller than two chunks of @a minChunk
+ * items are handled by the calling thread alone.
+ * @param func called with the first and one past the last index of a chunk
+ */
+void SCRIBUS_API parallelFor(int count, int minChunk, const std::function<void(int first, int last)>& func);
+
+#endif